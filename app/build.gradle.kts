@@ -70,6 +70,11 @@ android {
         }
     }
 
+    // Sound banks, the progression catalog and the endgame table are mmapped straight from the APK, which requires them stored uncompressed
+    androidResources {
+        noCompress += listOf("tpbank", "tpprog", "tpend")
+    }
+
     externalNativeBuild {
         cmake {
             path = file("src/main/cpp/CMakeLists.txt")
@@ -0,0 +1,136 @@
+#include "audio_mixer.h"
+#include "mix_kernels.h"
+#include "wav_decoder.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <memory>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+constexpr int kSampleRate = 48000;
+constexpr int kCallbackFrames = MixKernels::kBlockFrames;
+
+std::vector<float> makeSignal(size_t count) {
+    std::vector<float> signal(count);
+    for (size_t i = 0; i < count; ++i) {
+        signal[i] = 0.25f * std::sin(0.01f * static_cast<float>(i));
+    }
+    return signal;
+}
+
+// One second of a tone per channel
+PcmBuffer makeTone(int channelCount) {
+    PcmBuffer pcm;
+    pcm.channelCount = channelCount;
+    pcm.sampleRate = kSampleRate;
+    pcm.samples.resize(static_cast<size_t>(kSampleRate) * channelCount);
+    for (int f = 0; f < kSampleRate; ++f) {
+        for (int ch = 0; ch < channelCount; ++ch) {
+            double phase = 2.0 * M_PI * (440.0 + 3.0 * ch) * f / kSampleRate;
+            pcm.samples[f * channelCount + ch] = static_cast<float>(0.25 * std::sin(phase));
+        }
+    }
+    return pcm;
+}
+
+} // namespace
+
+void BM_MixMonoToStereo(benchmark::State& state) {
+    size_t frames = static_cast<size_t>(state.range(0));
+    std::vector<float> src = makeSignal(frames);
+    std::vector<float> dst(frames * 2);
+
+    for (auto _ : state) {
+        MixKernels::mixMonoToStereo(src.data(), dst.data(), frames, 0.5f);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_MixMonoToStereo)->Arg(kCallbackFrames)->Arg(4096);
+
+void BM_MixStereo(benchmark::State& state) {
+    size_t frames = static_cast<size_t>(state.range(0));
+    std::vector<float> src = makeSignal(frames * 2);
+    std::vector<float> dst(frames * 2);
+
+    for (auto _ : state) {
+        MixKernels::mixStereo(src.data(), dst.data(), frames, 0.5f);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_MixStereo)->Arg(kCallbackFrames)->Arg(4096);
+
+void BM_MixStereoRamp(benchmark::State& state) {
+    size_t frames = static_cast<size_t>(state.range(0));
+    std::vector<float> src = makeSignal(frames * 2);
+    std::vector<float> dst(frames * 2);
+
+    for (auto _ : state) {
+        MixKernels::mixStereoRamp(src.data(), dst.data(), frames, 0.0f, 1.0f / frames);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * frames);
+}
+BENCHMARK(BM_MixStereoRamp)->Arg(kCallbackFrames);
+
+void BM_Int16ToFloat(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    std::vector<int16_t> src(count);
+    for (size_t i = 0; i < count; ++i) src[i] = static_cast<int16_t>(i * 37);
+    std::vector<float> dst(count);
+
+    for (auto _ : state) {
+        MixKernels::int16ToFloat(src.data(), dst.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Int16ToFloat)->Arg(kCallbackFrames * 2);
+
+void BM_Clamp(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    std::vector<float> buffer = makeSignal(count);
+
+    for (auto _ : state) {
+        MixKernels::clamp(buffer.data(), count);
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * count);
+}
+BENCHMARK(BM_Clamp)->Arg(kCallbackFrames * 2);
+
+// One device callback of looping stereo voices through SoundMixer;
+// args are voice count and SampleEncoding
+void BM_MixerCallback(benchmark::State& state) {
+    int voiceCount = static_cast<int>(state.range(0));
+    SampleEncoding encoding = static_cast<SampleEncoding>(state.range(1));
+    SampleStore store = SampleStore::fromPcm(makeTone(2), encoding);
+
+    std::vector<std::unique_ptr<AudioData>> voices;
+    SoundMixer mixer;
+    for (int v = 0; v < voiceCount; ++v) {
+        voices.emplace_back(new AudioData());
+        voices.back()->store = store;
+        voices.back()->isLoaded = true;
+        voices.back()->isLooping = true;
+        mixer.play(v, voices.back().get(), 1.0f / voiceCount);
+    }
+
+    std::vector<float> output(kCallbackFrames * 2);
+    for (auto _ : state) {
+        mixer.render(output.data(), kCallbackFrames);
+        benchmark::ClobberMemory();
+    }
+    state.SetLabel(sampleEncodingText(encoding));
+    state.SetItemsProcessed(state.iterations() * kCallbackFrames * voiceCount);
+}
+BENCHMARK(BM_MixerCallback)
+    ->ArgsProduct({{1, 8, 32}, {static_cast<int>(SampleEncoding::Float32),
+                                static_cast<int>(SampleEncoding::Int16),
+                                static_cast<int>(SampleEncoding::ImaAdpcm)}});
@@ -0,0 +1,58 @@
+#include "event_bus.h"
+#include "frame_arena.h"
+
+#include <benchmark/benchmark.h>
+
+#include <cstring>
+
+using namespace TrashPiles;
+
+// Per-frame work that does not need Skia: the event fan-out the renderer and
+// audio drain at the start of a frame, and the arena copies of draw-call text
+
+// Publish a batch of events and drain it on each subscriber, as the renderer
+// and audio threads do every frame; args are batch size and subscriber count
+void BM_EventFanOut(benchmark::State& state) {
+    int batch = static_cast<int>(state.range(0));
+    int subscriberCount = static_cast<int>(state.range(1));
+
+    EventBus bus;
+    EventBus::Subscriber* subscribers[EventBus::kMaxSubscribers];
+    for (int s = 0; s < subscriberCount; ++s) {
+        subscribers[s] = bus.subscribe("benchmark");
+    }
+
+    GameEvent event;
+    event.type = GameEventType::CardDealt;
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            event.card = i & 63;
+            event.slot = i % 10;
+            bus.publish(event);
+        }
+
+        GameEvent out;
+        for (int s = 0; s < subscriberCount; ++s) {
+            while (bus.poll(subscribers[s], out)) benchmark::DoNotOptimize(out);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * batch * subscriberCount);
+}
+BENCHMARK(BM_EventFanOut)->Args({20, 2})->Args({60, 2})->Args({60, 4});
+
+// A frame's worth of UI labels copied into the arena, then the reset
+void BM_FrameArenaText(benchmark::State& state) {
+    static const char* const kLabels[] = {"Draw", "Discard", "Round 3", "Your turn", "Player 2 wins!"};
+    int labels = static_cast<int>(state.range(0));
+
+    FrameArena arena;
+    for (auto _ : state) {
+        for (int i = 0; i < labels; ++i) {
+            const char* label = kLabels[i % 5];
+            benchmark::DoNotOptimize(arena.copyString(label, std::strlen(label)));
+        }
+        arena.reset();
+    }
+    state.SetItemsProcessed(state.iterations() * labels);
+}
+BENCHMARK(BM_FrameArenaText)->Arg(16)->Arg(128);
@@ -0,0 +1,247 @@
+#include "card_tracker.h"
+#include "endgame_table.h"
+#include "game_core.h"
+#include "hand_kernels.h"
+#include "hint_advisor.h"
+#include "skill_effect_table.h"
+#include "transposition_table.h"
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+GameCommand makeCommand(GameCommandType type, int32_t playerId = -1, int32_t slot = -1, int32_t value = 0) {
+    GameCommand command;
+    command.type = type;
+    command.playerId = playerId;
+    command.slot = slot;
+    command.value = value;
+    return command;
+}
+
+void startGame(GameCore& core, int players) {
+    core.apply(makeCommand(GameCommandType::InitializeGame, -1, -1, players));
+    core.apply(makeCommand(GameCommandType::StartGame));
+}
+
+// One player turn: draw, place the first fitting card, end the turn
+void playTurn(GameCore& core) {
+    int player = core.currentPlayer();
+    core.apply(makeCommand(GameCommandType::DrawCard, player));
+    uint32_t slots = core.placeableSlots(player, core.heldCard());
+    if (slots) core.apply(makeCommand(GameCommandType::PlaceCard, player, __builtin_ctz(slots)));
+    if (core.phase() == GamePhase::Playing) core.apply(makeCommand(GameCommandType::EndTurn, player));
+}
+
+} // namespace
+
+// A new match: core setup (queue and RNG seeding), shuffle and first-round
+// deal, without an event bus. The rules have no way back to setup from a
+// round in play, so each iteration builds its own core.
+void BM_ShuffleAndDeal(benchmark::State& state) {
+    StateBlock block;
+    int players = static_cast<int>(state.range(0));
+    uint32_t seed = 1;
+
+    for (auto _ : state) {
+        GameCore core(block, nullptr, seed++);
+        startGame(core, players);
+        benchmark::DoNotOptimize(core.handCard(players - 1, 0));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_ShuffleAndDeal)->Arg(2)->Arg(kStateMaxPlayers);
+
+// Placeable slots for every card against one dealt hand
+void BM_MoveGeneration(benchmark::State& state) {
+    StateBlock block;
+    GameCore core(block, nullptr, 2);
+    startGame(core, 2);
+
+    for (auto _ : state) {
+        uint32_t any = 0;
+        for (int card = 0; card < GameCore::kDeckSize; ++card) {
+            any |= core.placeableSlots(0, card);
+        }
+        benchmark::DoNotOptimize(any);
+    }
+    state.SetItemsProcessed(state.iterations() * GameCore::kDeckSize);
+}
+BENCHMARK(BM_MoveGeneration);
+
+// Win check and penalty score for every seat
+void BM_WinAndScore(benchmark::State& state) {
+    StateBlock block;
+    GameCore core(block, nullptr, 3);
+    startGame(core, kStateMaxPlayers);
+    for (int turn = 0; turn < 40 && core.phase() == GamePhase::Playing; ++turn) playTurn(core);
+
+    for (auto _ : state) {
+        int total = 0;
+        for (int player = 0; player < core.playerCount(); ++player) {
+            total += core.hasWon(player) ? 0 : core.penaltyScore(player);
+        }
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(state.iterations() * core.playerCount());
+}
+BENCHMARK(BM_WinAndScore);
+
+// Whole rounds of scripted play through validate and execute
+void BM_PlayRound(benchmark::State& state) {
+    StateBlock block;
+    GameCore core(block, nullptr, 4);
+    int64_t turns = 0;
+
+    for (auto _ : state) {
+        startGame(core, 2);
+        while (core.phase() == GamePhase::Playing) {
+            playTurn(core);
+            ++turns;
+        }
+        core.apply(makeCommand(GameCommandType::EndGame));
+        core.apply(makeCommand(GameCommandType::ResetGame));
+    }
+    state.SetItemsProcessed(turns);
+}
+BENCHMARK(BM_PlayRound);
+
+// A batch of commands through the queue and one state publish per tick;
+// pause and resume alternate so every command executes
+void BM_CommandBatch(benchmark::State& state) {
+    StateBlock block;
+    GameCore core(block, nullptr, 5);
+    startGame(core, 2);
+    int batch = static_cast<int>(state.range(0));
+
+    for (auto _ : state) {
+        for (int i = 0; i < batch; ++i) {
+            core.submit(makeCommand((i & 1) ? GameCommandType::ResumeGame : GameCommandType::PauseGame));
+        }
+        benchmark::DoNotOptimize(core.tick());
+    }
+    state.SetItemsProcessed(state.iterations() * batch);
+}
+BENCHMARK(BM_CommandBatch)->Arg(1)->Arg(16)->Arg(GameCore::kMaxBatch);
+
+// Fill the table with score and non-score effects spread over every seat
+void fillEffects(SkillEffectTable& table, int effects) {
+    for (int i = 0; i < effects; ++i) {
+        auto type = static_cast<SkillEffectKind>(i % SkillEffectTable::kTypeCount);
+        table.add(i % kStateMaxPlayers, type, 1.25f, (i % 3 == 0) ? SkillEffectTable::kPermanent : 1 << 30);
+    }
+}
+
+// Round-end scoring for every seat; flat however many effects are active
+void BM_EffectScoring(benchmark::State& state) {
+    SkillEffectTable table;
+    fillEffects(table, static_cast<int>(state.range(0)));
+    int32_t base[kStateMaxPlayers] = {3, 7, 0, 10};
+    int32_t scores[kStateMaxPlayers];
+
+    for (auto _ : state) {
+        table.scores(base, scores, kStateMaxPlayers);
+        benchmark::DoNotOptimize(scores);
+    }
+    state.SetItemsProcessed(state.iterations() * kStateMaxPlayers);
+}
+BENCHMARK(BM_EffectScoring)->Arg(0)->Arg(16)->Arg(SkillEffectTable::kMaxEffects);
+
+// The start-of-turn decrement over every slot
+void BM_EffectTurn(benchmark::State& state) {
+    SkillEffectTable table;
+    fillEffects(table, SkillEffectTable::kMaxEffects);
+
+    for (auto _ : state) {
+        table.advanceTurn();
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * SkillEffectTable::kMaxEffects);
+}
+BENCHMARK(BM_EffectTurn);
+
+// Penalty and completion over a batch of rollout hands
+void BM_HandBatch(benchmark::State& state) {
+    size_t count = static_cast<size_t>(state.range(0));
+    std::mt19937 random(46);
+    std::vector<uint16_t> slots(count, HandKernels::kFullHand), faceUp(count);
+    for (uint16_t& mask : faceUp) mask = static_cast<uint16_t>(random() & HandKernels::kFullHand);
+    std::vector<uint8_t> penalties(count), complete(count);
+
+    for (auto _ : state) {
+        HandKernels::penalties(slots.data(), faceUp.data(), penalties.data(), count);
+        benchmark::DoNotOptimize(HandKernels::completeHands(slots.data(), faceUp.data(), complete.data(), count));
+        benchmark::ClobberMemory();
+    }
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(count));
+}
+BENCHMARK(BM_HandBatch)->Arg(64)->Arg(4096);
+
+// A discard and the hint odds after it, as the AI asks each turn
+void BM_TrackerOdds(benchmark::State& state) {
+    CardTracker tracker;
+    float odds[CardTracker::kRankCount];
+    int card = 0;
+
+    for (auto _ : state) {
+        tracker.discarded(card | kCardFaceUp);
+        tracker.rankOdds(0, odds);
+        benchmark::DoNotOptimize(odds);
+        benchmark::DoNotOptimize(tracker.fitOdds(0, 0x2A5));
+        // Start over before the pile is full
+        if (++card == CardTracker::kCardCount) {
+            tracker.reset();
+            card = 0;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TrackerOdds);
+
+// Position from the tracker and a tablebase read, as a late-round AI turn
+void BM_EndgameAdvice(benchmark::State& state) {
+    std::vector<uint8_t> image;
+    EndgameSolver().build(image);
+    EndgameTableView table;
+    table.open(image.data(), image.size());
+
+    CardTracker tracker;
+    for (int card = 0; card < 20; ++card) tracker.revealed(card * 2);
+    HandBits hand;
+    hand.slots = HandKernels::kFullHand;
+    hand.faceUp = static_cast<uint16_t>(HandKernels::kFullHand & ~0x124u);
+
+    for (auto _ : state) {
+        EndgamePosition position;
+        EndgameAdvice advice;
+        EndgamePosition::from(hand, tracker, 0, &position);
+        benchmark::DoNotOptimize(table.advise(position, makeCardCode(5, 1, true), &advice));
+        benchmark::DoNotOptimize(advice);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EndgameAdvice);
+
+// A hint for an unchanged position: evaluated once, then answered from the cache
+void BM_HintCache(benchmark::State& state) {
+    StateBlock block;
+    GameCore core(block, nullptr, 42);
+    core.apply(makeCommand(GameCommandType::InitializeGame, -1, -1, 4));
+    core.apply(makeCommand(GameCommandType::StartGame));
+    core.apply(makeCommand(GameCommandType::DrawCard, 0, -1, 0));
+    core.apply(makeCommand(GameCommandType::EndTurn, 0));
+
+    TranspositionTable table;
+    HintAdvisor advisor(table);
+    bool cached = state.range(0) != 0;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(cached ? advisor.hint(core, 1) : HintAdvisor::evaluate(core, 1));
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_HintCache)->Arg(0)->Arg(1);
@@ -0,0 +1,29 @@
+#ifndef TRASHPILES_AUDIO_BACKEND_H
+#define TRASHPILES_AUDIO_BACKEND_H
+
+#include "audio_mixer.h"
+
+namespace TrashPiles {
+
+/**
+ * Output backend
+ * Pulls stereo float buffers from a render source and delivers them
+ * somewhere: a device stream (OboeBackend) or memory and a WAV file
+ * (OfflineBackend). The mixers never know which one drives them.
+ */
+class AudioBackend {
+public:
+    virtual ~AudioBackend() = default;
+
+    // Binds the source and prepares the output; the source must outlive the backend
+    virtual bool open(AudioRenderSource* source) = 0;
+    virtual bool start() = 0;
+    virtual void stop() = 0;
+    virtual void close() = 0;
+
+    virtual int sampleRate() const = 0;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_AUDIO_BACKEND_H
@@ -0,0 +1,390 @@
+#include "audio_mixer.h"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace TrashPiles {
+
+bool mixVoice(AudioData* voice, float* output, int numFrames, float gain, float* scratch,
+              float gainStep) {
+    const SampleStore& store = voice->store;
+    int frameCount = store.frameCount();
+    int done = 0;
+
+    while (done < numFrames) {
+        if (voice->cursor.frame >= frameCount) {
+            if (!voice->isLooping) return false;
+            voice->cursor.seek(0);
+        }
+
+        int frames = std::min({numFrames - done,
+                               frameCount - voice->cursor.frame,
+                               MixKernels::kBlockFrames});
+        store.decode(voice->cursor, frames, scratch);
+
+        if (gainStep != 0.0f) {
+            float start = gain + static_cast<float>(done) * gainStep;
+            if (store.channelCount() == 2) {
+                MixKernels::mixStereoRamp(scratch, output + done * 2, frames, start, gainStep);
+            } else {
+                MixKernels::mixMonoToStereoRamp(scratch, output + done * 2, frames, start, gainStep);
+            }
+        } else if (store.channelCount() == 2) {
+            MixKernels::mixStereo(scratch, output + done * 2, frames, gain);
+        } else {
+            MixKernels::mixMonoToStereo(scratch, output + done * 2, frames, gain);
+        }
+        done += frames;
+    }
+    return true;
+}
+
+bool ScheduledCommands::post(const MixerCommand& command) {
+    std::lock_guard<std::mutex> lock(m_postLock);
+    bool scheduled = command.frame != kFrameNow;
+    if (scheduled && m_scheduled.load(std::memory_order_relaxed) >= kMaxScheduled) return false;
+    uint32_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) >= kCapacity) return false;
+
+    m_ring[head % kCapacity] = command;
+    if (scheduled) m_scheduled.fetch_add(1, std::memory_order_relaxed);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void ScheduledCommands::collect(int64_t now) {
+    uint32_t tail = m_tail.load(std::memory_order_relaxed);
+    uint32_t head = m_head.load(std::memory_order_acquire);
+
+    // Anything that doesn't fit stays in the ring until the pending list drains
+    while (tail != head && m_pendingCount < kCapacity) {
+        Pending pending = {m_ring[tail % kCapacity], m_ring[tail % kCapacity].frame != kFrameNow};
+        if (!pending.scheduled) pending.command.frame = now;
+
+        // Insertion keeps frame order, and post order among equal frames
+        uint32_t at = m_pendingCount;
+        while (at > 0 && m_pending[at - 1].command.frame > pending.command.frame) {
+            m_pending[at] = m_pending[at - 1];
+            --at;
+        }
+        m_pending[at] = pending;
+        ++m_pendingCount;
+        ++tail;
+    }
+    m_tail.store(tail, std::memory_order_release);
+}
+
+int64_t ScheduledCommands::nextFrame() const {
+    return m_pendingCount ? m_pending[0].command.frame : std::numeric_limits<int64_t>::max();
+}
+
+bool ScheduledCommands::popDue(int64_t frame, MixerCommand& out) {
+    if (m_pendingCount == 0 || m_pending[0].command.frame > frame) return false;
+
+    out = m_pending[0].command;
+    if (m_pending[0].scheduled) m_scheduled.fetch_sub(1, std::memory_order_relaxed);
+    std::copy(m_pending + 1, m_pending + m_pendingCount, m_pending);
+    --m_pendingCount;
+    return true;
+}
+
+void SoundMixer::render(float* output, int32_t numFrames) {
+    std::memset(output, 0, static_cast<size_t>(numFrames) * 2 * sizeof(float));
+
+    int64_t position = m_framePosition.load(std::memory_order_relaxed);
+    m_commands.collect(position);
+
+    // Split the buffer at every scheduled command so each lands on its frame;
+    // late commands apply at the start of this buffer
+    int done = 0;
+    while (done < numFrames) {
+        MixerCommand command;
+        while (m_commands.popDue(position + done, command)) {
+            apply(command);
+        }
+        int frames = static_cast<int>(std::min<int64_t>(numFrames - done,
+                                                        m_commands.nextFrame() - (position + done)));
+        mixVoices(output + done * 2, frames);
+        done += frames;
+    }
+
+    // Prevent clipping
+    MixKernels::clamp(output, static_cast<size_t>(numFrames) * 2);
+
+    m_framePosition.store(position + numFrames, std::memory_order_release);
+}
+
+void SoundMixer::mixVoices(float* output, int numFrames) {
+    // Mix all playing sounds
+    int voiceCount = m_voiceCount.load(std::memory_order_acquire);
+    for (int id = 0; id < voiceCount; ++id) {
+        AudioData* voice = m_voices[id].load(std::memory_order_acquire);
+        if (!voice) continue;
+
+        if (voice->restartPending.exchange(false, std::memory_order_acq_rel)) {
+            voice->cursor.seek(0);
+        }
+
+        float gain = voice->volume.load(std::memory_order_relaxed) *
+                     m_voiceGain[id].load(std::memory_order_relaxed) *
+                     m_masterVolume.load(std::memory_order_relaxed);
+        bool playing = mixVoice(voice, output, numFrames, gain, m_scratch);
+
+        // Free the slot unless a new play call has re-armed it meanwhile
+        if (!playing && !voice->restartPending.load(std::memory_order_acquire)) {
+            m_voices[id].compare_exchange_strong(voice, nullptr, std::memory_order_acq_rel);
+        }
+    }
+}
+
+void SoundMixer::apply(const MixerCommand& command) {
+    switch (command.type) {
+        case MixerCommand::Type::PlaySound:
+            play(command.id, command.data, command.volume);
+            break;
+        case MixerCommand::Type::StopSound:
+            stop(command.id);
+            break;
+        default:
+            break;
+    }
+}
+
+void SoundMixer::play(int soundId, AudioData* data, float volume) {
+    m_voiceGain[soundId].store(volume, std::memory_order_relaxed);
+    data->restartPending.store(true, std::memory_order_release);
+    m_voices[soundId].store(data, std::memory_order_release);
+
+    int count = m_voiceCount.load(std::memory_order_relaxed);
+    while (soundId >= count &&
+           !m_voiceCount.compare_exchange_weak(count, soundId + 1, std::memory_order_release)) {
+    }
+}
+
+void SoundMixer::stop(int soundId) {
+    m_voices[soundId].store(nullptr, std::memory_order_release);
+}
+
+void SoundMixer::stopAll() {
+    for (auto& voice : m_voices) {
+        voice.store(nullptr, std::memory_order_release);
+    }
+}
+
+bool SoundMixer::isPlaying(int soundId) const {
+    return m_voices[soundId].load(std::memory_order_acquire) != nullptr;
+}
+
+bool SoundMixer::schedulePlay(int64_t frame, int soundId, AudioData* data, float volume) {
+    if (!data || soundId < 0 || soundId >= kMaxVoices) return false;
+
+    MixerCommand command;
+    command.frame = frame;
+    command.type = MixerCommand::Type::PlaySound;
+    command.id = soundId;
+    command.data = data;
+    command.volume = volume;
+    return m_commands.post(command);
+}
+
+bool SoundMixer::scheduleStop(int64_t frame, int soundId) {
+    if (soundId < 0 || soundId >= kMaxVoices) return false;
+
+    MixerCommand command;
+    command.frame = frame;
+    command.type = MixerCommand::Type::StopSound;
+    command.id = soundId;
+    return m_commands.post(command);
+}
+
+void MusicMixer::render(float* output, int32_t numFrames) {
+    std::memset(output, 0, static_cast<size_t>(numFrames) * 2 * sizeof(float));
+
+    int64_t position = m_framePosition.load(std::memory_order_relaxed);
+    m_commands.collect(position);
+
+    int done = 0;
+    while (done < numFrames) {
+        MixerCommand command;
+        while (m_commands.popDue(position + done, command)) {
+            apply(command);
+        }
+        int frames = static_cast<int>(std::min<int64_t>(numFrames - done,
+                                                        m_commands.nextFrame() - (position + done)));
+        if (!m_paused) {
+            for (Track& outgoing : m_outgoing) mixTrack(outgoing, output + done * 2, frames);
+            mixTrack(m_current, output + done * 2, frames);
+        }
+        done += frames;
+    }
+
+    m_framePosition.store(position + numFrames, std::memory_order_release);
+}
+
+bool MusicMixer::mixTrack(Track& track, float* output, int numFrames) {
+    if (!track.data) return false;
+
+    float gain = track.data->volume.load(std::memory_order_relaxed) * track.gain *
+                 m_masterVolume.load(std::memory_order_relaxed);
+    int done = 0;
+    while (done < numFrames) {
+        // Fades render in their own span so the ramp ends exactly on its target
+        int frames = numFrames - done;
+        float step = 0.0f;
+        if (track.fadeFramesLeft > 0) {
+            frames = std::min(frames, track.fadeFramesLeft);
+            step = track.fadeStep;
+        }
+
+        bool playing = mixVoice(track.data, output + done * 2, frames, gain * track.fade,
+                                m_scratch, gain * step);
+        if (track.fadeFramesLeft > 0) {
+            track.fadeFramesLeft -= frames;
+            track.fade = track.fadeFramesLeft > 0 ? track.fade + step * frames : track.fadeTarget;
+        }
+        if (!playing || (track.fadeFramesLeft == 0 && track.fade == 0.0f)) {
+            track = Track();
+            return false;
+        }
+        done += frames;
+    }
+    return true;
+}
+
+void MusicMixer::apply(const MixerCommand& command) {
+    AudioData* data = command.data;
+
+    switch (command.type) {
+        case MixerCommand::Type::PlayMusic:
+        case MixerCommand::Type::CrossfadeMusic: {
+            bool fade = command.type == MixerCommand::Type::CrossfadeMusic && command.fadeFrames > 0;
+            data->isLooping = command.loop;
+            m_paused = false;
+
+            // Already the playing track: keep its position
+            if (fade && data == m_current.data) {
+                m_current.gain = command.volume;
+                break;
+            }
+
+            if (fade) {
+                fadeOutCurrent(command.fadeFrames);
+            } else {
+                for (Track& outgoing : m_outgoing) outgoing = Track();
+            }
+            // The new track restarts its cursor, so it cannot also fade out
+            for (Track& outgoing : m_outgoing) {
+                if (outgoing.data == data) outgoing = Track();
+            }
+
+            data->cursor.seek(0);
+            m_current = Track();
+            m_current.data = data;
+            m_current.gain = command.volume;
+            if (fade) {
+                m_current.fade = 0.0f;
+                m_current.fadeStep = 1.0f / command.fadeFrames;
+                m_current.fadeFramesLeft = command.fadeFrames;
+            }
+            break;
+        }
+        case MixerCommand::Type::StopMusic:
+            if (command.fadeFrames > 0) {
+                fadeOutCurrent(command.fadeFrames);
+            } else {
+                for (Track& outgoing : m_outgoing) outgoing = Track();
+            }
+            m_current = Track();
+            break;
+        case MixerCommand::Type::PauseMusic:
+            m_paused = true;
+            break;
+        case MixerCommand::Type::ResumeMusic:
+            m_paused = false;
+            break;
+        default:
+            break;
+    }
+}
+
+void MusicMixer::fadeOutCurrent(int fadeFrames) {
+    if (!m_current.data) return;
+
+    // A free slot, else the quietest track still fading
+    Track* slot = &m_outgoing[0];
+    for (Track& outgoing : m_outgoing) {
+        if (!outgoing.data) {
+            slot = &outgoing;
+            break;
+        }
+        if (outgoing.fade < slot->fade) slot = &outgoing;
+    }
+
+    // From wherever its gain is, including partway through a fade in
+    *slot = m_current;
+    slot->fadeTarget = 0.0f;
+    slot->fadeStep = -slot->fade / fadeFrames;
+    slot->fadeFramesLeft = fadeFrames;
+}
+
+bool MusicMixer::post(MixerCommand::Type type, AudioData* data, bool loop, float volume,
+                      int fadeFrames, int64_t frame) {
+    MixerCommand command;
+    command.frame = frame;
+    command.type = type;
+    command.data = data;
+    command.loop = loop;
+    command.volume = volume;
+    command.fadeFrames = fadeFrames;
+    return m_commands.post(command);
+}
+
+bool MusicMixer::play(AudioData* data, bool loop, float volume, int64_t frame) {
+    if (!data || !data->isLoaded || data->store.empty()) return false;
+    return post(MixerCommand::Type::PlayMusic, data, loop, volume, 0, frame);
+}
+
+bool MusicMixer::crossfadeTo(AudioData* data, bool loop, float volume, int fadeFrames, int64_t frame) {
+    if (!data || !data->isLoaded || data->store.empty()) return false;
+    return post(MixerCommand::Type::CrossfadeMusic, data, loop, volume, fadeFrames, frame);
+}
+
+bool MusicMixer::stop(int fadeFrames, int64_t frame) {
+    return post(MixerCommand::Type::StopMusic, nullptr, false, 1.0f, fadeFrames, frame);
+}
+
+bool MusicMixer::pause(int64_t frame) {
+    return post(MixerCommand::Type::PauseMusic, nullptr, false, 1.0f, 0, frame);
+}
+
+bool MusicMixer::resume(int64_t frame) {
+    return post(MixerCommand::Type::ResumeMusic, nullptr, false, 1.0f, 0, frame);
+}
+
+bool MixBus::add(AudioRenderSource* source) {
+    if (!source || m_sourceCount >= kMaxSources) return false;
+    m_sources[m_sourceCount++] = source;
+    return true;
+}
+
+void MixBus::render(float* output, int32_t numFrames) {
+    if (m_sourceCount == 0) {
+        std::memset(output, 0, static_cast<size_t>(numFrames) * 2 * sizeof(float));
+        return;
+    }
+
+    m_sources[0]->render(output, numFrames);
+    for (int i = 1; i < m_sourceCount; ++i) {
+        for (int done = 0; done < numFrames; done += MixKernels::kBlockFrames) {
+            int frames = std::min<int>(numFrames - done, MixKernels::kBlockFrames);
+            m_sources[i]->render(m_scratch, frames);
+            MixKernels::mixStereo(m_scratch, output + done * 2, frames, 1.0f);
+        }
+    }
+
+    if (m_sourceCount > 1) {
+        MixKernels::clamp(output, static_cast<size_t>(numFrames) * 2);
+    }
+}
+
+} // namespace TrashPiles
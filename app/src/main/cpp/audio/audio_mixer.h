@@ -0,0 +1,213 @@
+#ifndef TRASHPILES_AUDIO_MIXER_H
+#define TRASHPILES_AUDIO_MIXER_H
+
+#include "sample_store.h"
+#include "mix_kernels.h"
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+
+namespace TrashPiles {
+
+// Audio data structure
+// Samples stay in their compact storage encoding at the output stream rate;
+// the mixers widen them to float a block at a time
+struct AudioData {
+    SampleStore store;
+    bool isLoaded = false;
+    DecodeCursor cursor;
+    bool isLooping = false;
+    // The asset's own level, under any per-play gain; written by control
+    // threads, read by the render thread, relaxed
+    std::atomic<float> volume{1.0f};
+
+    // Set by the play call, consumed by the mixer, which owns the cursor
+    std::atomic<bool> restartPending{false};
+};
+
+// Decodes and accumulates up to numFrames of a voice into a stereo buffer,
+// with gain ramping by gainStep per frame. Returns false once a non-looping
+// voice has run out.
+bool mixVoice(AudioData* voice, float* output, int numFrames, float gain, float* scratch,
+              float gainStep = 0.0f);
+
+/**
+ * Pull source for an output backend
+ * render() fills numFrames of interleaved stereo float and must be
+ * real-time safe: no locks, allocation or logging.
+ */
+class AudioRenderSource {
+public:
+    virtual ~AudioRenderSource() = default;
+    virtual void render(float* output, int32_t numFrames) = 0;
+};
+
+// Frame value meaning "at the start of the next rendered buffer"
+constexpr int64_t kFrameNow = -1;
+
+struct MixerCommand {
+    enum class Type : uint8_t {
+        PlaySound,      // id, data, volume
+        StopSound,      // id
+        PlayMusic,      // data, volume, loop
+        CrossfadeMusic, // data, volume, loop, fadeFrames
+        StopMusic,      // fadeFrames
+        PauseMusic,
+        ResumeMusic
+    };
+
+    int64_t frame = kFrameNow;
+    Type type = Type::PlaySound;
+    int id = 0;
+    AudioData* data = nullptr;
+    float volume = 1.0f;
+    bool loop = false;
+    int fadeFrames = 0;
+};
+
+/**
+ * Commands scheduled against a mixer's frame clock
+ * post() may be called from any control thread; producers serialize on a
+ * mutex, the render thread never locks. The render thread collects posted
+ * commands into a frame-sorted pending list and applies each exactly at its
+ * frame, splitting the buffer there.
+ *
+ * At most kMaxScheduled commands with an explicit frame wait at once, so
+ * commands scheduled far ahead cannot crowd out kFrameNow ones, which
+ * always find room and apply at the start of the next buffer.
+ */
+class ScheduledCommands {
+public:
+    static constexpr uint32_t kCapacity = 64;
+    static constexpr uint32_t kMaxScheduled = kCapacity - 16;
+
+    // False if the queue is full, or for a command with a frame, if
+    // kMaxScheduled such commands are waiting
+    bool post(const MixerCommand& command);
+
+    // Render thread only
+    void collect(int64_t now);
+    int64_t nextFrame() const;
+    bool popDue(int64_t frame, MixerCommand& out);
+
+private:
+    std::mutex m_postLock;
+    MixerCommand m_ring[kCapacity];
+    std::atomic<uint32_t> m_head{0};    // Next slot to write
+    std::atomic<uint32_t> m_tail{0};    // Next slot to read
+
+    std::atomic<uint32_t> m_scheduled{0};   // Posted with a frame, not yet applied
+
+    struct Pending {
+        MixerCommand command;
+        bool scheduled;
+    };
+    Pending m_pending[kCapacity];
+    uint32_t m_pendingCount = 0;
+};
+
+/**
+ * Sound effect mixer
+ * One voice slot per sound id; replaying an id restarts it. Immediate
+ * play/stop go through lock-free slots; scheduled ones land on an exact
+ * frame of framePosition(). Each play carries its own gain, kept with the
+ * voice, so it never changes the shared AudioData.
+ */
+class SoundMixer : public AudioRenderSource {
+public:
+    static constexpr int kMaxVoices = 256;
+
+    void render(float* output, int32_t numFrames) override;
+
+    void play(int soundId, AudioData* data, float volume = 1.0f);
+    void stop(int soundId);
+    void stopAll();
+    bool isPlaying(int soundId) const;
+    void setMasterVolume(float volume) { m_masterVolume.store(volume, std::memory_order_relaxed); }
+
+    // Frames rendered since the mixer was created
+    int64_t framePosition() const { return m_framePosition.load(std::memory_order_acquire); }
+
+    bool schedulePlay(int64_t frame, int soundId, AudioData* data, float volume);
+    bool scheduleStop(int64_t frame, int soundId);
+
+private:
+    std::atomic<AudioData*> m_voices[kMaxVoices] = {};
+    std::atomic<float> m_voiceGain[kMaxVoices] = {};    // Set before the voice is published
+    std::atomic<int> m_voiceCount{0};
+    std::atomic<float> m_masterVolume{1.0f};
+    std::atomic<int64_t> m_framePosition{0};
+    ScheduledCommands m_commands;
+    float m_scratch[MixKernels::kBlockFrames * 2];
+
+    void apply(const MixerCommand& command);
+    void mixVoices(float* output, int numFrames);
+};
+
+/**
+ * Background music mixer
+ * One playing track plus the tracks still fading out. A crossfade started
+ * while another runs lets the earlier outgoing track finish its own fade
+ * from wherever its gain is. All changes are commands on the music clock,
+ * so the render thread alone touches track cursors; pause keeps the cursor
+ * where it stopped.
+ */
+class MusicMixer : public AudioRenderSource {
+public:
+    void render(float* output, int32_t numFrames) override;
+
+    bool play(AudioData* data, bool loop, float volume, int64_t frame = kFrameNow);
+    bool crossfadeTo(AudioData* data, bool loop, float volume, int fadeFrames, int64_t frame = kFrameNow);
+    bool stop(int fadeFrames = 0, int64_t frame = kFrameNow);
+    bool pause(int64_t frame = kFrameNow);
+    bool resume(int64_t frame = kFrameNow);
+    void setMasterVolume(float volume) { m_masterVolume.store(volume, std::memory_order_relaxed); }
+
+    int64_t framePosition() const { return m_framePosition.load(std::memory_order_acquire); }
+
+private:
+    struct Track {
+        AudioData* data = nullptr;
+        float gain = 1.0f;          // The play command's volume
+        float fade = 1.0f;
+        float fadeTarget = 1.0f;
+        float fadeStep = 0.0f;
+        int fadeFramesLeft = 0;
+    };
+
+    static constexpr int kMaxOutgoing = 4;
+
+    Track m_current;
+    Track m_outgoing[kMaxOutgoing];
+    bool m_paused = false;
+    std::atomic<float> m_masterVolume{1.0f};
+    std::atomic<int64_t> m_framePosition{0};
+    ScheduledCommands m_commands;
+    float m_scratch[MixKernels::kBlockFrames * 2];
+
+    bool post(MixerCommand::Type type, AudioData* data, bool loop, float volume,
+              int fadeFrames, int64_t frame);
+    void apply(const MixerCommand& command);
+    void fadeOutCurrent(int fadeFrames);
+    bool mixTrack(Track& track, float* output, int numFrames);
+};
+
+/**
+ * Sums several sources into one output, for backends with a single stream
+ */
+class MixBus : public AudioRenderSource {
+public:
+    static constexpr int kMaxSources = 4;
+
+    bool add(AudioRenderSource* source);
+    void render(float* output, int32_t numFrames) override;
+
+private:
+    AudioRenderSource* m_sources[kMaxSources] = {};
+    int m_sourceCount = 0;
+    float m_scratch[MixKernels::kBlockFrames * 2];
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_AUDIO_MIXER_H
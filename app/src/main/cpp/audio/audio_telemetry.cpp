@@ -0,0 +1,97 @@
+#include "audio_telemetry.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+void CallbackHistogram::record(int64_t durationNanos) {
+    int64_t micros = std::max<int64_t>(0, durationNanos / 1000);
+    int bucket = 0;
+    while (bucket < kBucketCount - 1 && (micros >> (bucket + 1)) != 0) {
+        ++bucket;
+    }
+
+    // Single writer: plain load/store pairs are enough, readers only need
+    // each value to be torn-free
+    m_buckets[bucket].store(m_buckets[bucket].load(std::memory_order_relaxed) + 1,
+                            std::memory_order_relaxed);
+    m_totalNanos.store(m_totalNanos.load(std::memory_order_relaxed) + durationNanos,
+                       std::memory_order_relaxed);
+    if (durationNanos > m_maxNanos.load(std::memory_order_relaxed)) {
+        m_maxNanos.store(durationNanos, std::memory_order_relaxed);
+    }
+    m_count.store(m_count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void CallbackHistogram::reset() {
+    for (auto& bucket : m_buckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    m_count.store(0, std::memory_order_relaxed);
+    m_totalNanos.store(0, std::memory_order_relaxed);
+    m_maxNanos.store(0, std::memory_order_relaxed);
+}
+
+int64_t CallbackHistogram::meanNanos() const {
+    uint64_t n = count();
+    return n ? m_totalNanos.load(std::memory_order_relaxed) / static_cast<int64_t>(n) : 0;
+}
+
+void CallbackHistogram::buckets(uint64_t out[kBucketCount]) const {
+    for (int i = 0; i < kBucketCount; ++i) {
+        out[i] = m_buckets[i].load(std::memory_order_relaxed);
+    }
+}
+
+void BufferSizeTuner::reset(int framesPerBurst, int capacityFrames, int initialFrames,
+                            int64_t shrinkAfterFrames) {
+    m_framesPerBurst = std::max(1, framesPerBurst);
+    m_capacityFrames = std::max(m_framesPerBurst, capacityFrames);
+    m_floorFrames = m_framesPerBurst;
+    m_shrinkAfterFrames = shrinkAfterFrames;
+    m_cleanFrames = 0;
+    m_lastXrunCount = 0;
+    m_bufferFrames.store(std::max(m_floorFrames, std::min(m_capacityFrames, initialFrames)),
+                         std::memory_order_relaxed);
+    m_lowestStableFrames.store(0, std::memory_order_relaxed);
+}
+
+int BufferSizeTuner::update(int32_t xrunCount, int numFrames) {
+    int size = m_bufferFrames.load(std::memory_order_relaxed);
+
+    if (xrunCount > m_lastXrunCount) {
+        // This size is too small on this device; never come back down to it
+        m_lastXrunCount = xrunCount;
+        m_floorFrames = std::max(m_floorFrames, std::min(m_capacityFrames, size + m_framesPerBurst));
+        m_cleanFrames = 0;
+        if (m_lowestStableFrames.load(std::memory_order_relaxed) <= size) {
+            m_lowestStableFrames.store(0, std::memory_order_relaxed);
+        }
+        size = std::min(m_capacityFrames, size + m_framesPerBurst);
+        m_bufferFrames.store(size, std::memory_order_relaxed);
+        return size;
+    }
+
+    m_cleanFrames += numFrames;
+    if (m_shrinkAfterFrames <= 0 || m_cleanFrames < m_shrinkAfterFrames) {
+        return size;
+    }
+
+    // A full clean stretch at this size: record it, then probe one burst lower
+    m_cleanFrames = 0;
+    int lowest = m_lowestStableFrames.load(std::memory_order_relaxed);
+    if (lowest == 0 || size < lowest) {
+        m_lowestStableFrames.store(size, std::memory_order_relaxed);
+    }
+    if (size - m_framesPerBurst >= m_floorFrames) {
+        size -= m_framesPerBurst;
+        m_bufferFrames.store(size, std::memory_order_relaxed);
+    }
+    return size;
+}
+
+void BufferSizeTuner::applied(int frames) {
+    if (frames <= 0) return;
+    m_bufferFrames.store(std::min(m_capacityFrames, frames), std::memory_order_relaxed);
+}
+
+} // namespace TrashPiles
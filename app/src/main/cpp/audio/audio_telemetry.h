@@ -0,0 +1,92 @@
+#ifndef TRASHPILES_AUDIO_TELEMETRY_H
+#define TRASHPILES_AUDIO_TELEMETRY_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Callback duration histogram
+ * Written by the audio thread only, readable from any thread. Buckets are
+ * powers of two in microseconds: bucket 0 is under 2 us, bucket i covers
+ * [2^i, 2^(i+1)) us and the last bucket collects everything above.
+ */
+class CallbackHistogram {
+public:
+    static constexpr int kBucketCount = 16;
+
+    void record(int64_t durationNanos);
+    void reset();
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    int64_t meanNanos() const;
+    int64_t maxNanos() const { return m_maxNanos.load(std::memory_order_relaxed); }
+    void buckets(uint64_t out[kBucketCount]) const;
+
+private:
+    std::atomic<uint64_t> m_buckets[kBucketCount] = {};
+    std::atomic<uint64_t> m_count{0};
+    std::atomic<int64_t> m_totalNanos{0};
+    std::atomic<int64_t> m_maxNanos{0};
+};
+
+/**
+ * Adaptive output buffer size
+ * Starts from the given size and steps by one burst: up as soon as the
+ * stream reports a new underrun, down after a stretch of clean playback.
+ * A size that ever underran becomes a floor, so the buffer settles on the
+ * smallest size with no underruns instead of oscillating around it.
+ *
+ * update() runs on the audio thread; the getters are safe from any thread.
+ */
+class BufferSizeTuner {
+public:
+    // shrinkAfterFrames of clean playback before trying one burst smaller;
+    // 0 only ever grows (for streams where latency does not matter)
+    void reset(int framesPerBurst, int capacityFrames, int initialFrames, int64_t shrinkAfterFrames);
+
+    // Feeds the stream's cumulative underrun count after a callback of numFrames.
+    // Returns the buffer size the stream should use.
+    int update(int32_t xrunCount, int numFrames);
+
+    // The size the stream actually took after a resize; devices round to
+    // their own granularity or refuse, and later steps start from this
+    void applied(int frames);
+
+    int bufferFrames() const { return m_bufferFrames.load(std::memory_order_relaxed); }
+    int framesPerBurst() const { return m_framesPerBurst; }
+    int capacityFrames() const { return m_capacityFrames; }
+
+    // Smallest size that played a full clean stretch, 0 until one has
+    int lowestStableFrames() const { return m_lowestStableFrames.load(std::memory_order_relaxed); }
+
+private:
+    int m_framesPerBurst = 0;
+    int m_capacityFrames = 0;
+    int m_floorFrames = 0;
+    int64_t m_shrinkAfterFrames = 0;
+    int64_t m_cleanFrames = 0;
+    int32_t m_lastXrunCount = 0;
+
+    std::atomic<int> m_bufferFrames{0};
+    std::atomic<int> m_lowestStableFrames{0};
+};
+
+// Output stream health, sampled on request
+struct AudioStreamStats {
+    uint64_t callbackCount = 0;
+    int32_t xrunCount = 0;              // Underruns reported by the device, -1 if unsupported
+    int bufferSizeFrames = 0;
+    int framesPerBurst = 0;
+    int bufferCapacityFrames = 0;
+    int lowestStableFrames = 0;         // Smallest buffer that played a clean stretch
+    double latencyMillis = -1.0;        // Output latency, -1 if the device cannot tell
+    int64_t callbackMeanNanos = 0;
+    int64_t callbackMaxNanos = 0;
+    uint64_t callbackHistogram[CallbackHistogram::kBucketCount] = {};
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_AUDIO_TELEMETRY_H
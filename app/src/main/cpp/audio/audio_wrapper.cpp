@@ -1,155 +1,61 @@
 #include "audio_wrapper.h"
-#include <oboe/Oboe.h>
+#include "wav_decoder.h"
+#include "resampler.h"
+#include "mix_kernels.h"
+#include "sound_bank.h"
+#include "../trace/trace.h"
+#include "../game_engine/mapped_asset.h"
 #include <android/log.h>
 #include <string>
 #include <map>
 #include <vector>
 #include <cstring>
 #include <cmath>
+#include <algorithm>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
+#include <chrono>
 
 namespace TrashPiles {
 
-// Audio data structure
-struct AudioData {
-    std::vector<float> samples;
-    bool isLoaded = false;
-    int currentSample = 0;
-    bool isLooping = false;
-    float volume = 1.0f;
-};
+// Storage chosen per bank: SFX are short and transient-heavy, so they stay
+// lossless; music dominates resident memory and takes the 4:1 ADPCM saving
+static constexpr SampleEncoding kSoundEncoding = SampleEncoding::Int16;
+static constexpr SampleEncoding kMusicEncoding = SampleEncoding::ImaAdpcm;
 
 // Static instance for asset manager access
 static AAssetManager* g_assetManager = nullptr;
 
-// Audio callback for sound effects
-class SoundCallback : public oboe::AudioStreamCallback {
-public:
-    oboe::DataCallbackResult onAudioReady(
-        oboe::AudioStream* audioStream,
-        void* audioData,
-        int32_t numFrames) override {
-        
-        float* outputData = static_cast<float*>(audioData);
-        
-        // Clear buffer
-        std::memset(outputData, 0, numFrames * audioStream->getChannelCount() * sizeof(float));
-        
-        // Mix all playing sounds
-        for (auto& pair : m_playingSounds) {
-            AudioData* audioData = pair.second;
-            if (!audioData->isLoaded || audioData->samples.empty()) continue;
-            
-            for (int frame = 0; frame < numFrames; ++frame) {
-                if (audioData->currentSample >= static_cast<int>(audioData->samples.size())) {
-                    if (audioData->isLooping) {
-                        audioData->currentSample = 0;
-                    } else {
-                        continue; // Sound finished
-                    }
-                }
-                
-                float sample = audioData->samples[audioData->currentSample++];
-                sample *= audioData->volume * m_masterVolume;
-                
-                // Mix to stereo channels
-                outputData[frame * 2] += sample;     // Left
-                outputData[frame * 2 + 1] += sample; // Right
-                
-                // Prevent clipping
-                outputData[frame * 2] = std::max(-1.0f, std::min(1.0f, outputData[frame * 2]));
-                outputData[frame * 2 + 1] = std::max(-1.0f, std::min(1.0f, outputData[frame * 2 + 1]));
-            }
-        }
-        
-        return oboe::DataCallbackResult::Continue;
-    }
-    
-    void addPlayingSound(const std::string& name, AudioData* data) {
-        m_playingSounds[name] = data;
-    }
-    
-    void removePlayingSound(const std::string& name) {
-        m_playingSounds.erase(name);
-    }
-    
-    void setMasterVolume(float volume) {
-        m_masterVolume = volume;
-    }
-    
-private:
-    std::map<std::string, AudioData*> m_playingSounds;
-    float m_masterVolume = 1.0f;
-};
-
-// Music callback for background music
-class MusicCallback : public oboe::AudioStreamCallback {
-public:
-    oboe::DataCallbackResult onAudioReady(
-        oboe::AudioStream* audioStream,
-        void* audioData,
-        int32_t numFrames) override {
-        
-        float* outputData = static_cast<float*>(audioData);
-        
-        if (!m_currentMusic || !m_currentMusic->isLoaded || m_currentMusic->samples.empty()) {
-            std::memset(outputData, 0, numFrames * audioStream->getChannelCount() * sizeof(float));
-            return oboe::DataCallbackResult::Continue;
-        }
-        
-        for (int frame = 0; frame < numFrames; ++frame) {
-            if (m_currentMusic->currentSample >= static_cast<int>(m_currentMusic->samples.size())) {
-                if (m_currentMusic->isLooping) {
-                    m_currentMusic->currentSample = 0;
-                } else {
-                    m_currentMusic = nullptr;
-                    std::memset(outputData + frame * 2, 0, (numFrames - frame) * 2 * sizeof(float));
-                    break;
-                }
-            }
-            
-            float sample = m_currentMusic->samples[m_currentMusic->currentSample++];
-            sample *= m_currentMusic->volume * m_masterVolume;
-            
-            outputData[frame * 2] = sample;     // Left
-            outputData[frame * 2 + 1] = sample; // Right
-        }
-        
-        return oboe::DataCallbackResult::Continue;
-    }
-    
-    void setMusic(AudioData* data) {
-        m_currentMusic = data;
-    }
-    
-    void stop() {
-        m_currentMusic = nullptr;
-    }
-    
-    void setMasterVolume(float volume) {
-        m_masterVolume = volume;
-    }
-    
-private:
-    AudioData* m_currentMusic = nullptr;
-    float m_masterVolume = 1.0f;
-};
-
-static SoundCallback g_soundCallback;
-static MusicCallback g_musicCallback;
+// Packed banks built by tools/soundbank_packer; loose WAVs are the fallback
+static const char* kSoundBankPath = "sounds.tpbank";
+static const char* kMusicBankPath = "music.tpbank";
 
 AudioWrapper::AudioWrapper() 
-    : m_soundVolume(1.0f), 
+    : m_soundSource(this),
+      m_soundVolume(1.0f), 
       m_musicVolume(0.7f), 
       m_masterVolume(1.0f),
       m_initialized(false),
-      m_musicPlaying(false) {
+      m_musicPlaying(false),
+      m_musicPaused(false),
+      m_outputSampleRate(0),
+      m_eventBus(nullptr),
+      m_eventSubscriber(nullptr),
+      m_preloadStarted(false),
+      m_soundBankReady(false),
+      m_musicBankReady(false) {
+    for (auto& entry : m_soundTable) {
+        entry.store(nullptr, std::memory_order_relaxed);
+    }
+    applyChannelVolumes();
     LOGI("AudioWrapper created");
 }
 
 AudioWrapper::~AudioWrapper() {
     cleanup();
+    if (m_eventBus) {
+        m_eventBus->unsubscribe(m_eventSubscriber.exchange(nullptr));
+    }
     LOGI("AudioWrapper destroyed");
 }
 
@@ -158,87 +64,119 @@ void AudioWrapper::setAssetManager(AAssetManager* assetManager) {
 }
 
 bool AudioWrapper::initialize() {
+    if (!openStreams()) return false;
+    
+    // Banks are prepared at the stream rate, so start only once it is known
+    preloadSoundBanks();
+    
+    return true;
+}
+
+bool AudioWrapper::openStreams() {
     LOGI("Initializing audio engine with Oboe");
     
-    // Create audio stream for sound effects
-    oboe::AudioStreamBuilder soundBuilder;
-    soundBuilder.setDirection(oboe::Direction::Output);
-    soundBuilder.setPerformanceMode(oboe::PerformanceMode::LowLatency);
-    soundBuilder.setSharingMode(oboe::SharingMode::Shared);
-    soundBuilder.setFormat(oboe::AudioFormat::Float);
-    soundBuilder.setChannelCount(oboe::ChannelCount::Stereo);
-    soundBuilder.setSampleRate(44100);
-    soundBuilder.setCallback(&g_soundCallback);
-    
-    oboe::Result result = soundBuilder.openStream(m_soundStream);
-    if (result != oboe::Result::OK) {
-        LOGE("Failed to create sound stream: %s", oboe::convertToText(result));
+    // Sound effects on a low-latency stream at the device's native rate
+    m_soundBackend.reset(new OboeBackend(OboeBackend::Mode::LowLatency));
+    if (!m_soundBackend->open(&m_soundSource)) {
+        LOGE("Failed to create sound stream");
         return false;
     }
     
-    // Create audio stream for music
-    oboe::AudioStreamBuilder musicBuilder;
-    musicBuilder.setDirection(oboe::Direction::Output);
-    musicBuilder.setPerformanceMode(oboe::PerformanceMode::PowerSaving);
-    musicBuilder.setSharingMode(oboe::SharingMode::Shared);
-    musicBuilder.setFormat(oboe::AudioFormat::Float);
-    musicBuilder.setChannelCount(oboe::ChannelCount::Stereo);
-    musicBuilder.setSampleRate(44100);
-    musicBuilder.setCallback(&g_musicCallback);
+    m_outputSampleRate = m_soundBackend->sampleRate();
     
-    result = musicBuilder.openStream(m_musicStream);
-    if (result != oboe::Result::OK) {
-        LOGE("Failed to create music stream: %s", oboe::convertToText(result));
+    // Music at the same rate so one asset rate serves both
+    m_musicBackend.reset(new OboeBackend(OboeBackend::Mode::PowerSaving, m_outputSampleRate));
+    if (!m_musicBackend->open(&m_musicMixer)) {
+        LOGE("Failed to create music stream");
         return false;
     }
     
-    // Set buffer sizes for optimal performance
-    m_soundStream->setBufferSizeInFrames(m_soundStream->getBufferSizeInFrames() * 2);
-    m_musicStream->setBufferSizeInFrames(m_musicStream->getBufferSizeInFrames() * 2);
-    
     // Start streams
-    result = m_soundStream->requestStart();
-    if (result != oboe::Result::OK) {
-        LOGE("Failed to start sound stream: %s", oboe::convertToText(result));
+    if (!m_soundBackend->start() || !m_musicBackend->start()) {
         return false;
     }
     
-    result = m_musicStream->requestStart();
-    if (result != oboe::Result::OK) {
-        LOGE("Failed to start music stream: %s", oboe::convertToText(result));
+    m_initialized = true;
+    LOGI("Audio engine initialized successfully");
+    return true;
+}
+
+bool AudioWrapper::preloadSoundBanks() {
+    if (m_preloadStarted) return true;
+    if (!g_assetManager) {
+        LOGE("Cannot preload sound banks - asset manager not set");
         return false;
     }
     
-    m_initialized = true;
-    LOGI("Audio engine initialized successfully");
-    LOGI("Sound stream - Sample rate: %d, Buffer size: %d", 
-         m_soundStream->getSampleRate(), 
-         m_soundStream->getBufferSizeInFrames());
-    LOGI("Music stream - Sample rate: %d, Buffer size: %d", 
-         m_musicStream->getSampleRate(), 
-         m_musicStream->getBufferSizeInFrames());
+    m_preloadStarted = true;
+    m_preloadThread = std::thread([this]() {
+        auto start = std::chrono::steady_clock::now();
+        
+        loadSoundBank();
+        loadMusicBank();
+        
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        AudioMemoryStats stats = getMemoryStats();
+        LOGI("Sound banks ready in %lld ms: %d sounds (%zu bytes), %d music (%zu bytes)",
+             static_cast<long long>(elapsed.count()),
+             stats.soundCount, stats.soundBytes, stats.musicCount, stats.musicBytes);
+    });
+    return true;
+}
+
+bool AudioWrapper::loadSoundBank() {
+    if (!g_assetManager || m_outputSampleRate <= 0) {
+        LOGE("Cannot load sound bank - asset manager or stream rate not set");
+        return false;
+    }
+    
+    loadBank(kSoundBankPath, "sounds", kSoundEncoding, m_loadedSounds, m_soundBankMapping);
+    m_soundBankReady.store(true, std::memory_order_release);
+    
+    // Ids registered before this point; later ones resolve as they register
+    std::lock_guard<std::mutex> lock(m_registryLock);
+    resolveSoundTable();
+    return true;
+}
+
+bool AudioWrapper::loadMusicBank() {
+    if (!g_assetManager || m_outputSampleRate <= 0) {
+        LOGE("Cannot load music bank - asset manager or stream rate not set");
+        return false;
+    }
     
+    loadBank(kMusicBankPath, "music", kMusicEncoding, m_loadedMusic, m_musicBankMapping);
+    m_musicBankReady.store(true, std::memory_order_release);
     return true;
 }
 
+bool AudioWrapper::isSoundBankReady() const {
+    return m_soundBankReady.load(std::memory_order_acquire);
+}
+
 void AudioWrapper::cleanup() {
     if (!m_initialized) return;
     
     LOGI("Cleaning up audio engine");
     
+    AudioStreamStats soundStats = getPerformanceStats().sound;
+    LOGI("Sound stream: %llu callbacks, %d xruns, buffer %d frames (lowest stable %d), "
+         "callback mean %lld us, max %lld us",
+         static_cast<unsigned long long>(soundStats.callbackCount), soundStats.xrunCount,
+         soundStats.bufferSizeFrames, soundStats.lowestStableFrames,
+         static_cast<long long>(soundStats.callbackMeanNanos / 1000),
+         static_cast<long long>(soundStats.callbackMaxNanos / 1000));
+    
     stopAllSounds();
     stopMusic();
     
-    if (m_soundStream) {
-        m_soundStream->requestStop();
-        m_soundStream->close();
-        m_soundStream.reset();
-    }
+    m_soundBackend.reset();
+    m_musicBackend.reset();
     
-    if (m_musicStream) {
-        m_musicStream->requestStop();
-        m_musicStream->close();
-        m_musicStream.reset();
+    // The preload thread owns the banks until it finishes
+    if (m_preloadThread.joinable()) {
+        m_preloadThread.join();
     }
     
     // Clear loaded audio data
@@ -251,50 +189,81 @@ void AudioWrapper::cleanup() {
     
     m_loadedSounds.clear();
     m_loadedMusic.clear();
+    
+    // Registered ids stay valid across re-initialization; only their data goes
+    for (auto& entry : m_soundTable) {
+        entry.store(nullptr, std::memory_order_release);
+    }
+    
+    m_soundBankMapping.reset();
+    m_musicBankMapping.reset();
+    m_soundBankReady.store(false);
+    m_musicBankReady.store(false);
+    m_preloadStarted = false;
     m_initialized = false;
 }
 
-void AudioWrapper::playSound(const char* soundName) {
-    if (!m_initialized) {
-        LOGE("Cannot play sound - audio not initialized");
-        return;
-    }
+int AudioWrapper::registerSound(const char* soundName) {
+    if (!soundName) return -1;
     
-    if (!soundName) return;
+    std::lock_guard<std::mutex> lock(m_registryLock);
+    auto it = m_soundIds.find(soundName);
+    if (it != m_soundIds.end()) return it->second;
     
-    LOGI("Playing sound: %s", soundName);
+    if (m_soundNames.size() >= static_cast<size_t>(kMaxSounds)) {
+        LOGE("Sound table full, cannot register: %s", soundName);
+        return -1;
+    }
     
     std::string name(soundName);
-    
-    // Load sound if not already loaded
-    if (m_loadedSounds.find(name) == m_loadedSounds.end()) {
-        if (!loadSound(name)) {
-            LOGE("Failed to load sound: %s", soundName);
-            return;
-        }
+    int soundId = static_cast<int>(m_soundNames.size());
+    m_soundIds[name] = soundId;
+    m_soundNames.push_back(name);
+    if (m_soundBankReady.load(std::memory_order_acquire)) {
+        m_soundTable[soundId].store(findSound(name), std::memory_order_release);
     }
+    return soundId;
+}
+
+void AudioWrapper::playSound(int soundId, float volume) {
+    if (!m_initialized) {
+        LOGE("Cannot play sound - audio not initialized");
+        return;
+    }
+    
+    AudioData* audioData = resolveSound(soundId);
+    if (!audioData) return;
     
-    AudioData* audioData = m_loadedSounds[name];
-    if (!audioData || !audioData->isLoaded) {
-        LOGE("Sound data not available: %s", soundName);
+    TRACE_INSTANT("audio.play");
+    m_soundMixer.play(soundId, audioData, volume);
+}
+
+void AudioWrapper::playSoundAt(int soundId, int64_t frame, float volume) {
+    if (!m_initialized) {
+        LOGE("Cannot schedule sound - audio not initialized");
         return;
     }
     
-    // Reset to beginning and set volume
-    audioData->currentSample = 0;
-    audioData->volume = m_soundVolume;
+    AudioData* audioData = resolveSound(soundId);
+    if (!audioData) return;
     
-    // Add to playing sounds
-    g_soundCallback.addPlayingSound(name, audioData);
+    if (!m_soundMixer.schedulePlay(frame, soundId, audioData, volume)) {
+        LOGE("Sound schedule full, dropping sound %d at frame %lld", soundId, static_cast<long long>(frame));
+    }
 }
 
-void AudioWrapper::stopSound(const char* soundName) {
-    if (!m_initialized || !soundName) return;
+void AudioWrapper::stopSound(int soundId) {
+    if (!m_initialized || soundId < 0 || soundId >= kMaxSounds) return;
     
-    LOGI("Stopping sound: %s", soundName);
+    m_soundMixer.stop(soundId);
+}
+
+void AudioWrapper::stopSoundAt(int soundId, int64_t frame) {
+    if (!m_initialized || soundId < 0 || soundId >= kMaxSounds) return;
     
-    std::string name(soundName);
-    g_soundCallback.removePlayingSound(name);
+    if (!m_soundMixer.scheduleStop(frame, soundId)) {
+        LOGE("Sound schedule full, dropping stop of %d", soundId);
+    }
 }
 
 void AudioWrapper::stopAllSounds() {
@@ -302,195 +271,346 @@ void AudioWrapper::stopAllSounds() {
     
     LOGI("Stopping all sounds");
     
-    // Clear all playing sounds
-    g_soundCallback = SoundCallback(); // Reset callback
+    m_soundMixer.stopAll();
+}
+
+void AudioWrapper::attachEventBus(EventBus* bus) {
+    if (m_eventBus) {
+        m_eventBus->unsubscribe(m_eventSubscriber.exchange(nullptr));
+    }
+    
+    m_eventBus = bus;
+    if (!bus) return;
+    
+    EventBus::Subscriber* subscriber = bus->subscribe("audio");
+    if (!subscriber) {
+        LOGE("No free event bus subscriber slot for audio");
+        return;
+    }
+    m_eventSubscriber.store(subscriber, std::memory_order_release);
+}
+
+void AudioWrapper::bindEventSound(GameEventType type, int soundId, float volume) {
+    int index = static_cast<int>(type);
+    if (index < 0 || index >= static_cast<int>(GameEventType::Count)) return;
+    
+    m_eventSounds[index].volume.store(volume, std::memory_order_relaxed);
+    m_eventSounds[index].soundId.store(soundId, std::memory_order_release);
+}
+
+void AudioWrapper::drainEvents() {
+    EventBus::Subscriber* subscriber = m_eventSubscriber.load(std::memory_order_acquire);
+    if (!subscriber) return;
+    
+    GameEvent event;
+    while (m_eventBus->poll(subscriber, event)) {
+        const EventSound& binding = m_eventSounds[static_cast<int>(event.type)];
+        int soundId = binding.soundId.load(std::memory_order_acquire);
+        AudioData* audioData = resolveSound(soundId);
+        if (!audioData) continue;
+        
+        // Straight into the voice slot: this runs in the callback, which
+        // must not take the command queue's post lock
+        m_soundMixer.play(soundId, audioData, binding.volume.load(std::memory_order_relaxed) * event.volume);
+    }
+}
+
+void AudioWrapper::EventSoundSource::render(float* output, int32_t numFrames) {
+    // Events drained here start in this very buffer
+    m_owner->drainEvents();
+    m_owner->m_soundMixer.render(output, numFrames);
 }
 
 void AudioWrapper::playMusic(const char* musicName, bool loop) {
+    playMusicAt(musicName, kFrameNow, loop);
+}
+
+void AudioWrapper::playMusicAt(const char* musicName, int64_t frame, bool loop) {
     if (!m_initialized) {
         LOGE("Cannot play music - audio not initialized");
         return;
     }
     
-    if (!musicName) return;
+    AudioData* audioData = findMusic(musicName);
+    if (!audioData) return;
     
     LOGI("Playing music: %s (loop: %s)", musicName, loop ? "yes" : "no");
     
-    std::string name(musicName);
-    
-    // Load music if not already loaded
-    if (m_loadedMusic.find(name) == m_loadedMusic.end()) {
-        if (!loadMusic(name)) {
-            LOGE("Failed to load music: %s", musicName);
-            return;
-        }
+    if (m_musicMixer.play(audioData, loop, 1.0f, toMusicFrame(frame))) {
+        m_musicPlaying = true;
+        m_musicPaused = false;
     }
-    
-    AudioData* audioData = m_loadedMusic[name];
-    if (!audioData || !audioData->isLoaded) {
-        LOGE("Music data not available: %s", musicName);
+}
+
+void AudioWrapper::crossfadeMusic(const char* musicName, int64_t frame, int fadeFrames, bool loop) {
+    if (!m_initialized) {
+        LOGE("Cannot crossfade music - audio not initialized");
         return;
     }
     
-    // Set up music playback
-    audioData->currentSample = 0;
-    audioData->isLooping = loop;
-    audioData->volume = m_musicVolume;
+    AudioData* audioData = findMusic(musicName);
+    if (!audioData) return;
     
-    g_musicCallback.setMusic(audioData);
-    m_musicPlaying = true;
+    LOGI("Crossfading to music: %s over %d frames", musicName, fadeFrames);
+    
+    if (m_musicMixer.crossfadeTo(audioData, loop, 1.0f, fadeFrames, toMusicFrame(frame))) {
+        m_musicPlaying = true;
+        m_musicPaused = false;
+    }
 }
 
 void AudioWrapper::stopMusic() {
+    stopMusicAt(kFrameNow);
+}
+
+void AudioWrapper::stopMusicAt(int64_t frame, int fadeFrames) {
     if (!m_initialized) return;
     
     LOGI("Stopping music");
     
-    g_musicCallback.stop();
+    m_musicMixer.stop(fadeFrames, toMusicFrame(frame));
     m_musicPlaying = false;
+    m_musicPaused = false;
 }
 
 void AudioWrapper::pauseMusic() {
-    if (!m_initialized || !m_musicPlaying) return;
+    if (!m_initialized || !m_musicPlaying || m_musicPaused) return;
     
     LOGI("Pausing music");
     
-    // TODO: Implement pause functionality
-    // This would require storing current position and stopping playback
+    // The track keeps its cursor; resume continues from the same frame
+    if (m_musicMixer.pause()) {
+        m_musicPaused = true;
+    }
 }
 
 void AudioWrapper::resumeMusic() {
-    if (!m_initialized) return;
+    if (!m_initialized || !m_musicPaused) return;
     
     LOGI("Resuming music");
     
-    // TODO: Implement resume functionality
-    // This would require restoring stored position
+    if (m_musicMixer.resume()) {
+        m_musicPaused = false;
+    }
 }
 
-void AudioWrapper::setSoundVolume(float volume) {
-    m_soundVolume = std::max(0.0f, std::min(1.0f, volume));
-    LOGI("Sound volume set to: %.2f", m_soundVolume);
+int64_t AudioWrapper::getFramePosition() const {
+    return m_soundMixer.framePosition();
+}
+
+int64_t AudioWrapper::toMusicFrame(int64_t frame) const {
+    if (frame == kFrameNow) return kFrameNow;
     
-    // Update currently playing sounds
-    for (auto& pair : m_loadedSounds) {
-        pair.second->volume = m_soundVolume;
+    // Both streams run at the same rate; carry the offset between their clocks over
+    return frame - m_soundMixer.framePosition() + m_musicMixer.framePosition();
+}
+
+AudioData* AudioWrapper::resolveSound(int soundId) const {
+    if (soundId < 0 || soundId >= kMaxSounds) return nullptr;
+    
+    // Never load here: this runs right when the sound is due, possibly on
+    // the audio thread. Null until the bank is ready.
+    return m_soundTable[soundId].load(std::memory_order_acquire);
+}
+
+AudioData* AudioWrapper::findMusic(const char* musicName) const {
+    if (!musicName) return nullptr;
+    
+    if (!m_musicBankReady.load(std::memory_order_acquire)) {
+        LOGE("Music bank not ready yet: %s", musicName);
+        return nullptr;
+    }
+    
+    auto it = m_loadedMusic.find(musicName);
+    if (it == m_loadedMusic.end() || !it->second->isLoaded) {
+        LOGE("Music not in bank: %s", musicName);
+        return nullptr;
     }
+    return it->second;
+}
+
+void AudioWrapper::setSoundVolume(float volume) {
+    m_soundVolume.store(std::max(0.0f, std::min(1.0f, volume)), std::memory_order_relaxed);
+    LOGI("Sound volume set to: %.2f", m_soundVolume.load(std::memory_order_relaxed));
+    
+    // Applies to currently playing sounds too
+    applyChannelVolumes();
 }
 
 void AudioWrapper::setMusicVolume(float volume) {
-    m_musicVolume = std::max(0.0f, std::min(1.0f, volume));
-    LOGI("Music volume set to: %.2f", m_musicVolume);
+    m_musicVolume.store(std::max(0.0f, std::min(1.0f, volume)), std::memory_order_relaxed);
+    LOGI("Music volume set to: %.2f", m_musicVolume.load(std::memory_order_relaxed));
     
-    // Update current music
-    for (auto& pair : m_loadedMusic) {
-        pair.second->volume = m_musicVolume;
-    }
+    // Applies to the current music too
+    applyChannelVolumes();
 }
 
 void AudioWrapper::setMasterVolume(float volume) {
-    m_masterVolume = std::max(0.0f, std::min(1.0f, volume));
-    LOGI("Master volume set to: %.2f", m_masterVolume);
+    m_masterVolume.store(std::max(0.0f, std::min(1.0f, volume)), std::memory_order_relaxed);
+    LOGI("Master volume set to: %.2f", m_masterVolume.load(std::memory_order_relaxed));
     
-    // Update callbacks
-    g_soundCallback.setMasterVolume(m_masterVolume);
-    g_musicCallback.setMasterVolume(m_masterVolume);
+    applyChannelVolumes();
+}
+
+void AudioWrapper::applyChannelVolumes() {
+    // Channel volumes scale the whole mixer, leaving asset and per-play gains alone
+    float master = m_masterVolume.load(std::memory_order_relaxed);
+    m_soundMixer.setMasterVolume(master * m_soundVolume.load(std::memory_order_relaxed));
+    m_musicMixer.setMasterVolume(master * m_musicVolume.load(std::memory_order_relaxed));
 }
 
 bool AudioWrapper::isMusicPlaying() const {
-    return m_musicPlaying;
+    return m_musicPlaying && !m_musicPaused;
 }
 
-bool AudioWrapper::isSoundPlaying(const char* soundName) const {
-    if (!soundName) return false;
+bool AudioWrapper::isSoundPlaying(int soundId) const {
+    if (!m_initialized || soundId < 0 || soundId >= kMaxSounds) return false;
     
-    // TODO: Check if specific sound is playing
-    // This would require tracking playing sounds in the callback
-    return false;
+    return m_soundMixer.isPlaying(soundId);
 }
 
-bool AudioWrapper::loadSound(const std::string& soundName) {
-    if (!g_assetManager) {
-        LOGE("Asset manager not set");
-        return false;
+int AudioWrapper::getOutputSampleRate() const {
+    return m_outputSampleRate;
+}
+
+AudioMemoryStats AudioWrapper::getMemoryStats() const {
+    AudioMemoryStats stats;
+    if (m_soundBankReady.load(std::memory_order_acquire)) {
+        for (const auto& pair : m_loadedSounds) {
+            stats.soundCount++;
+            stats.soundBytes += pair.second->store.memoryBytes();
+        }
     }
-    
-    std::string assetPath = "sounds/" + soundName + ".wav";
-    AAsset* asset = AAssetManager_open(g_assetManager, assetPath.c_str(), AASSET_MODE_BUFFER);
-    
-    if (!asset) {
-        LOGE("Failed to open sound asset: %s", assetPath.c_str());
-        return false;
+    if (m_musicBankReady.load(std::memory_order_acquire)) {
+        for (const auto& pair : m_loadedMusic) {
+            stats.musicCount++;
+            stats.musicBytes += pair.second->store.memoryBytes();
+        }
     }
+    return stats;
+}
+
+AudioPerformanceStats AudioWrapper::getPerformanceStats() const {
+    AudioPerformanceStats stats;
+    if (!m_initialized) return stats;
     
-    size_t assetSize = AAsset_getLength(asset);
-    const void* assetData = AAsset_getBuffer(asset);
-    
-    // Simple WAV loading (assumes 44.1kHz, 16-bit, mono)
-    // In a real implementation, you'd use a proper audio library
-    AudioData* audioData = new AudioData();
-    
-    // Skip WAV header (44 bytes) and convert 16-bit to float
-    const int16_t* pcmData = static_cast<const int16_t*>(static_cast<const void*>(
-        static_cast<const char*>(assetData) + 44));
-    int sampleCount = (assetSize - 44) / 2;
-    
-    audioData->samples.reserve(sampleCount);
-    for (int i = 0; i < sampleCount; ++i) {
-        float sample = static_cast<float>(pcmData[i]) / 32768.0f;
-        audioData->samples.push_back(sample);
+    m_soundBackend->fillStats(stats.sound);
+    m_musicBackend->fillStats(stats.music);
+    return stats;
+}
+
+void AudioWrapper::loadBank(const char* bankPath, const char* looseDir, SampleEncoding encoding,
+                            std::map<std::string, AudioData*, std::less<>>& bank,
+                            std::unique_ptr<MappedAsset>& mapping) {
+    std::unique_ptr<MappedAsset> asset(new MappedAsset());
+    SoundBankView view;
+    
+    if (asset->open(g_assetManager, bankPath) && view.open(asset->data(), asset->size())) {
+        bool needsResample = m_outputSampleRate > 0 && view.sampleRate() != m_outputSampleRate;
+        if (!needsResample) {
+            asset->prefault();
+        }
+        
+        for (size_t i = 0; i < view.entryCount(); ++i) {
+            AudioData* audioData = new AudioData();
+            audioData->store = view.entryStore(i);
+            
+            // Banks are built for the common device rate; anything else is
+            // converted here once, off the UI thread, into an owned copy
+            if (needsResample) {
+                PcmBuffer pcm;
+                audioData->store.decodeAll(pcm);
+                pcm.sampleRate = view.sampleRate();
+                Resampler::convert(pcm, m_outputSampleRate);
+                audioData->store = SampleStore::fromPcm(pcm, audioData->store.encoding());
+            }
+            
+            audioData->isLoaded = true;
+            bank[view.entryName(i)] = audioData;
+        }
+        
+        LOGI("Mapped %s: %zu entries at %d Hz%s", bankPath, view.entryCount(),
+             view.sampleRate(), needsResample ? " (resampled)" : "");
+        
+        // Borrowed stores point into the mapping, so it lives as long as the bank
+        if (!needsResample) {
+            mapping = std::move(asset);
+        }
+        return;
     }
     
-    audioData->isLoaded = true;
-    audioData->currentSample = 0;
-    
-    m_loadedSounds[soundName] = audioData;
-    
-    AAsset_close(asset);
+    // No packed bank in this build: decode the loose WAVs instead, still off the UI thread
+    LOGI("No %s, loading loose assets from %s/", bankPath, looseDir);
+    AAssetDir* dir = AAssetManager_openDir(g_assetManager, looseDir);
+    if (!dir) return;
     
-    LOGI("Loaded sound: %s (%d samples)", soundName.c_str(), sampleCount);
-    return true;
+    while (const char* fileName = AAssetDir_getNextFileName(dir)) {
+        std::string name(fileName);
+        size_t extension = name.rfind(".wav");
+        if (extension == std::string::npos || extension + 4 != name.size()) continue;
+        
+        AudioData* audioData = loadAudioAsset(std::string(looseDir) + "/" + name, encoding);
+        if (!audioData) continue;
+        
+        const SampleStore& store = audioData->store;
+        LOGI("Loaded %s (%d frames, %d ch, %s, %zu bytes)", fileName,
+             store.frameCount(), store.channelCount(),
+             sampleEncodingText(store.encoding()), store.memoryBytes());
+        bank[name.substr(0, extension)] = audioData;
+    }
+    AAssetDir_close(dir);
+}
+
+AudioData* AudioWrapper::findSound(const std::string& soundName) const {
+    auto it = m_loadedSounds.find(soundName);
+    if (it == m_loadedSounds.end() || !it->second->isLoaded) {
+        LOGE("Sound not in bank: %s", soundName.c_str());
+        return nullptr;
+    }
+    return it->second;
+}
+
+void AudioWrapper::resolveSoundTable() {
+    for (size_t id = 0; id < m_soundNames.size(); ++id) {
+        m_soundTable[id].store(findSound(m_soundNames[id]), std::memory_order_release);
+    }
 }
 
-bool AudioWrapper::loadMusic(const std::string& musicName) {
+AudioData* AudioWrapper::loadAudioAsset(const std::string& assetPath, SampleEncoding encoding) {
     if (!g_assetManager) {
         LOGE("Asset manager not set");
-        return false;
+        return nullptr;
     }
     
-    std::string assetPath = "music/" + musicName + ".wav";
     AAsset* asset = AAssetManager_open(g_assetManager, assetPath.c_str(), AASSET_MODE_BUFFER);
-    
     if (!asset) {
-        LOGE("Failed to open music asset: %s", assetPath.c_str());
-        return false;
+        LOGE("Failed to open audio asset: %s", assetPath.c_str());
+        return nullptr;
     }
     
     size_t assetSize = AAsset_getLength(asset);
-    const void* assetData = AAsset_getBuffer(asset);
+    const uint8_t* assetData = static_cast<const uint8_t*>(AAsset_getBuffer(asset));
     
-    // Simple WAV loading
-    AudioData* audioData = new AudioData();
+    PcmBuffer pcm;
+    WavError error = WavError::None;
+    bool decoded = decodeWav(assetData, assetSize, pcm, &error);
+    AAsset_close(asset);
     
-    const int16_t* pcmData = static_cast<const int16_t*>(static_cast<const void*>(
-        static_cast<const char*>(assetData) + 44));
-    int sampleCount = (assetSize - 44) / 2;
+    if (!decoded) {
+        LOGE("Failed to decode %s: %s", assetPath.c_str(), wavErrorText(error));
+        return nullptr;
+    }
     
-    audioData->samples.reserve(sampleCount);
-    for (int i = 0; i < sampleCount; ++i) {
-        float sample = static_cast<float>(pcmData[i]) / 32768.0f;
-        audioData->samples.push_back(sample);
+    // Convert once here so the callbacks never resample
+    if (m_outputSampleRate > 0 && pcm.sampleRate != m_outputSampleRate) {
+        LOGI("Resampling %s: %d Hz -> %d Hz", assetPath.c_str(), pcm.sampleRate, m_outputSampleRate);
+        Resampler::convert(pcm, m_outputSampleRate);
     }
     
+    AudioData* audioData = new AudioData();
+    audioData->store = SampleStore::fromPcm(pcm, encoding);
     audioData->isLoaded = true;
-    audioData->currentSample = 0;
-    
-    m_loadedMusic[musicName] = audioData;
-    
-    AAsset_close(asset);
-    
-    LOGI("Loaded music: %s (%d samples)", musicName.c_str(), sampleCount);
-    return true;
+    return audioData;
 }
 
-} // namespace TrashPiles
\ No newline at end of file
+} // namespace TrashPiles
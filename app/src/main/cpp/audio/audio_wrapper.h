@@ -1,17 +1,42 @@
 #ifndef TRASHPILES_AUDIO_WRAPPER_H
 #define TRASHPILES_AUDIO_WRAPPER_H
 
-#include <oboe/Oboe.h>
 #include <android/log.h>
+#include "sample_store.h"
+#include "audio_mixer.h"
+#include "oboe_backend.h"
+#include "../gcms/event_bus.h"
 #include <string>
 #include <map>
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <thread>
 
 #define LOG_TAG "TrashPiles-Audio"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
+struct AAssetManager;
+
 namespace TrashPiles {
 
+class MappedAsset;
+
+// Resident sample memory per bank
+struct AudioMemoryStats {
+    int soundCount = 0;
+    size_t soundBytes = 0;
+    int musicCount = 0;
+    size_t musicBytes = 0;
+};
+
+struct AudioPerformanceStats {
+    AudioStreamStats sound;
+    AudioStreamStats music;
+};
+
 /**
  * Audio Wrapper - Interfaces with Oboe Audio Engine
  * Handles all audio playback for the game
@@ -21,21 +46,60 @@ public:
     AudioWrapper();
     ~AudioWrapper();
     
+    // Asset management
+    static void setAssetManager(AAssetManager* assetManager);
+    
     // Initialization
     bool initialize();
     void cleanup();
     
+    // Sound banks are mapped and prepared on a background thread, started by
+    // initialize(). Play calls never load assets; until a bank is ready its
+    // sounds are skipped.
+    bool preloadSoundBanks();
+    bool isSoundBankReady() const;
+    
+    // The steps of initialize(), for callers that schedule startup themselves.
+    // The bank loads need the open streams' rate, are independent of each
+    // other and may run on separate threads; use them instead of
+    // preloadSoundBanks(), not as well.
+    bool openStreams();
+    bool loadSoundBank();
+    bool loadMusicBank();
+    
     // Sound effects
-    void playSound(const char* soundName);
-    void stopSound(const char* soundName);
+    // Names are registered once for a dense id; the play path takes the id
+    // and indexes a flat table, with no string work per call
+    static constexpr int kMaxSounds = SoundMixer::kMaxVoices;
+    int registerSound(const char* soundName);  // -1 if the table is full
+    void playSound(int soundId, float volume = 1.0f);
+    void stopSound(int soundId);
     void stopAllSounds();
     
+    // Game events
+    // Subscribes to the bus and drains it at the top of every sound stream
+    // callback, so a bound event starts its sound in the next buffer without
+    // a JNI call. Bindings may change at any time; -1 unbinds.
+    void attachEventBus(EventBus* bus);
+    void bindEventSound(GameEventType type, int soundId, float volume = 1.0f);
+    
     // Background music
     void playMusic(const char* musicName, bool loop = true);
     void stopMusic();
     void pauseMusic();
     void resumeMusic();
     
+    // Audio clock
+    // Frames rendered on the sound stream. The *At calls take a frame on this
+    // clock (or kFrameNow) and start or stop exactly on it, so cues can be
+    // locked to the animation timeline. Music is translated onto its own stream.
+    int64_t getFramePosition() const;
+    void playSoundAt(int soundId, int64_t frame, float volume = 1.0f);
+    void stopSoundAt(int soundId, int64_t frame);
+    void playMusicAt(const char* musicName, int64_t frame, bool loop = true);
+    void crossfadeMusic(const char* musicName, int64_t frame, int fadeFrames, bool loop = true);
+    void stopMusicAt(int64_t frame, int fadeFrames = 0);
+    
     // Volume control
     void setSoundVolume(float volume);  // 0.0 to 1.0
     void setMusicVolume(float volume);  // 0.0 to 1.0
@@ -43,30 +107,83 @@ public:
     
     // State
     bool isMusicPlaying() const;
-    bool isSoundPlaying(const char* soundName) const;
+    bool isSoundPlaying(int soundId) const;
+    int getOutputSampleRate() const;
+    AudioMemoryStats getMemoryStats() const;
+    AudioPerformanceStats getPerformanceStats() const;
     
 private:
-    std::shared_ptr<oboe::AudioStream> m_soundStream;
-    std::shared_ptr<oboe::AudioStream> m_musicStream;
+    // Sound stream source: consumes game events, then mixes
+    class EventSoundSource : public AudioRenderSource {
+    public:
+        explicit EventSoundSource(AudioWrapper* owner) : m_owner(owner) {}
+        void render(float* output, int32_t numFrames) override;
+    private:
+        AudioWrapper* m_owner;
+    };
     
-    float m_soundVolume;
-    float m_musicVolume;
-    float m_masterVolume;
+    // Mixers render into whichever backend drives them
+    SoundMixer m_soundMixer;
+    EventSoundSource m_soundSource;
+    MusicMixer m_musicMixer;
+    std::unique_ptr<OboeBackend> m_soundBackend;
+    std::unique_ptr<OboeBackend> m_musicBackend;
     
-    bool m_initialized;
+    // Set from the control thread; the audio callback reads the sound volume
+    // for event plays, and each mixer applies master times its channel
+    std::atomic<float> m_soundVolume;
+    std::atomic<float> m_musicVolume;
+    std::atomic<float> m_masterVolume;
+    
+    std::atomic<bool> m_initialized;    // Set by whichever thread opens the streams
     bool m_musicPlaying;
+    bool m_musicPaused;
     
-    // Asset management
-    static void setAssetManager(AAssetManager* assetManager);
+    // Device native rate; assets are converted to it at load
+    int m_outputSampleRate;
     
     // Audio data structures
-    struct AudioData;
-    std::map<std::string, AudioData*> m_loadedSounds;
-    std::map<std::string, AudioData*> m_loadedMusic;
+    // Written only by the preload thread, read only after the matching ready flag.
+    // Transparent comparators let lookups by C string skip building a std::string.
+    std::map<std::string, AudioData*, std::less<>> m_loadedSounds;
+    std::map<std::string, AudioData*, std::less<>> m_loadedMusic;
+    
+    // Registered sound ids; the table resolves to bank data once it is ready.
+    // Entries are atomic because the audio thread reads them for events.
+    std::mutex m_registryLock;
+    std::map<std::string, int, std::less<>> m_soundIds;
+    std::vector<std::string> m_soundNames;
+    std::atomic<AudioData*> m_soundTable[kMaxSounds];
+    
+    // Event subscription and per-type sound bindings
+    struct EventSound {
+        std::atomic<int> soundId{-1};
+        std::atomic<float> volume{1.0f};
+    };
+    EventBus* m_eventBus;
+    std::atomic<EventBus::Subscriber*> m_eventSubscriber;
+    EventSound m_eventSounds[static_cast<int>(GameEventType::Count)];
+    
+    // Asynchronous bank preload
+    std::thread m_preloadThread;
+    bool m_preloadStarted;
+    std::atomic<bool> m_soundBankReady;
+    std::atomic<bool> m_musicBankReady;
+    std::unique_ptr<MappedAsset> m_soundBankMapping;
+    std::unique_ptr<MappedAsset> m_musicBankMapping;
     
     // Loading methods
-    bool loadSound(const std::string& soundName);
-    bool loadMusic(const std::string& musicName);
+    void loadBank(const char* bankPath, const char* looseDir, SampleEncoding encoding,
+                  std::map<std::string, AudioData*, std::less<>>& bank,
+                  std::unique_ptr<MappedAsset>& mapping);
+    AudioData* loadAudioAsset(const std::string& assetPath, SampleEncoding encoding);
+    AudioData* findSound(const std::string& soundName) const;
+    AudioData* resolveSound(int soundId) const;
+    AudioData* findMusic(const char* musicName) const;
+    void applyChannelVolumes();
+    int64_t toMusicFrame(int64_t frame) const;
+    void resolveSoundTable();
+    void drainEvents();
 };
 
 } // namespace TrashPiles
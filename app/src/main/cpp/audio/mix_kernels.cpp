@@ -0,0 +1,92 @@
+#include "mix_kernels.h"
+#include <algorithm>
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace TrashPiles {
+namespace MixKernels {
+
+void int16ToFloat(const int16_t* __restrict src, float* __restrict dst, size_t count) {
+    constexpr float kScale = 1.0f / 32768.0f;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        int16x8_t s = vld1q_s16(src + i);
+        float32x4_t lo = vcvtq_f32_s32(vmovl_s16(vget_low_s16(s)));
+        float32x4_t hi = vcvtq_f32_s32(vmovl_s16(vget_high_s16(s)));
+        vst1q_f32(dst + i, vmulq_n_f32(lo, kScale));
+        vst1q_f32(dst + i + 4, vmulq_n_f32(hi, kScale));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] = static_cast<float>(src[i]) * kScale;
+    }
+}
+
+void mixMonoToStereo(const float* __restrict src, float* __restrict dst, size_t frames, float gain) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= frames; i += 4) {
+        float32x4_t s = vmulq_n_f32(vld1q_f32(src + i), gain);
+        float32x4x2_t d = vld2q_f32(dst + i * 2);
+        d.val[0] = vaddq_f32(d.val[0], s);
+        d.val[1] = vaddq_f32(d.val[1], s);
+        vst2q_f32(dst + i * 2, d);
+    }
+#endif
+    for (; i < frames; ++i) {
+        float s = src[i] * gain;
+        dst[i * 2] += s;
+        dst[i * 2 + 1] += s;
+    }
+}
+
+void mixStereo(const float* __restrict src, float* __restrict dst, size_t frames, float gain) {
+    size_t count = frames * 2;
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(dst + i, vmlaq_n_f32(vld1q_f32(dst + i), vld1q_f32(src + i), gain));
+    }
+#endif
+    for (; i < count; ++i) {
+        dst[i] += src[i] * gain;
+    }
+}
+
+void mixMonoToStereoRamp(const float* __restrict src, float* __restrict dst, size_t frames,
+                         float gain, float gainStep) {
+    for (size_t i = 0; i < frames; ++i) {
+        float s = src[i] * (gain + static_cast<float>(i) * gainStep);
+        dst[i * 2] += s;
+        dst[i * 2 + 1] += s;
+    }
+}
+
+void mixStereoRamp(const float* __restrict src, float* __restrict dst, size_t frames,
+                   float gain, float gainStep) {
+    for (size_t i = 0; i < frames; ++i) {
+        float g = gain + static_cast<float>(i) * gainStep;
+        dst[i * 2] += src[i * 2] * g;
+        dst[i * 2 + 1] += src[i * 2 + 1] * g;
+    }
+}
+
+void clamp(float* buffer, size_t count) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    float32x4_t lo = vdupq_n_f32(-1.0f);
+    float32x4_t hi = vdupq_n_f32(1.0f);
+    for (; i + 4 <= count; i += 4) {
+        vst1q_f32(buffer + i, vminq_f32(vmaxq_f32(vld1q_f32(buffer + i), lo), hi));
+    }
+#endif
+    for (; i < count; ++i) {
+        buffer[i] = std::max(-1.0f, std::min(1.0f, buffer[i]));
+    }
+}
+
+} // namespace MixKernels
+} // namespace TrashPiles
@@ -0,0 +1,39 @@
+#ifndef TRASHPILES_MIX_KERNELS_H
+#define TRASHPILES_MIX_KERNELS_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Mixer inner loops
+ * NEON on ARM, plain loops elsewhere (written so the compiler can vectorize
+ * them). All buffers are interleaved; stereo output is L/R pairs.
+ */
+namespace MixKernels {
+
+// Frames decoded per pass inside the audio callback
+constexpr int kBlockFrames = 256;
+
+void int16ToFloat(const int16_t* src, float* dst, size_t count);
+
+// dst[2i] += src[i] * gain, dst[2i+1] += src[i] * gain
+void mixMonoToStereo(const float* src, float* dst, size_t frames, float gain);
+
+// dst[i] += src[i] * gain over frames * 2 samples
+void mixStereo(const float* src, float* dst, size_t frames, float gain);
+
+// As above with a per-frame linear gain ramp: frame i uses gain + i * gainStep.
+// Only fades take this path, so it stays scalar.
+void mixMonoToStereoRamp(const float* src, float* dst, size_t frames, float gain, float gainStep);
+void mixStereoRamp(const float* src, float* dst, size_t frames, float gain, float gainStep);
+
+// Clamp to [-1, 1] once per callback after all voices are summed
+void clamp(float* buffer, size_t count);
+
+} // namespace MixKernels
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_MIX_KERNELS_H
@@ -0,0 +1,157 @@
+#include "mixer_timeline.h"
+#include <algorithm>
+#include <sstream>
+
+namespace TrashPiles {
+
+namespace {
+
+bool fail(std::string* error, int line, const std::string& message) {
+    if (error) *error = "line " + std::to_string(line) + ": " + message;
+    return false;
+}
+
+bool lookup(const std::map<std::string, int>& ids, const std::string& name, int& id) {
+    auto it = ids.find(name);
+    if (it == ids.end()) return false;
+    id = it->second;
+    return true;
+}
+
+AudioData* entry(const std::vector<AudioData*>& table, int id, size_t limit) {
+    return id >= 0 && static_cast<size_t>(id) < std::min(table.size(), limit) ? table[id] : nullptr;
+}
+
+} // namespace
+
+void MixerTimeline::add(const MixerEvent& event) {
+    // Keep frame order; events on the same frame apply in insertion order
+    auto at = std::upper_bound(m_events.begin(), m_events.end(), event,
+                               [](const MixerEvent& a, const MixerEvent& b) { return a.frame < b.frame; });
+    m_events.insert(at, event);
+}
+
+bool MixerTimeline::parse(const std::string& script,
+                          const std::map<std::string, int>& soundIds,
+                          const std::map<std::string, int>& trackIds,
+                          std::string* error) {
+    std::istringstream lines(script);
+    std::string line;
+    int lineNumber = 0;
+
+    while (std::getline(lines, line)) {
+        ++lineNumber;
+        line = line.substr(0, line.find('#'));
+
+        std::istringstream fields(line);
+        MixerEvent event;
+        std::string command;
+        if (!(fields >> event.frame)) {
+            if (line.find_first_not_of(" \t\r") == std::string::npos) continue;
+            return fail(error, lineNumber, "expected a frame number");
+        }
+        if (event.frame < 0) return fail(error, lineNumber, "negative frame");
+        if (!(fields >> command)) return fail(error, lineNumber, "missing command");
+
+        std::string name;
+        if (command == "play" || command == "stop") {
+            if (!(fields >> name) || !lookup(soundIds, name, event.id)) {
+                return fail(error, lineNumber, "unknown sound '" + name + "'");
+            }
+            event.type = command == "play" ? MixerEvent::Type::PlaySound : MixerEvent::Type::StopSound;
+            fields >> event.value;
+        } else if (command == "stop_all") {
+            event.type = MixerEvent::Type::StopAllSounds;
+        } else if (command == "music" || command == "crossfade") {
+            if (!(fields >> name) || !lookup(trackIds, name, event.id)) {
+                return fail(error, lineNumber, "unknown track '" + name + "'");
+            }
+            event.type = MixerEvent::Type::PlayMusic;
+            if (command == "crossfade") {
+                event.type = MixerEvent::Type::CrossfadeMusic;
+                if (!(fields >> event.fadeFrames) || event.fadeFrames < 0) {
+                    return fail(error, lineNumber, "missing fade length");
+                }
+            }
+            event.loop = true;
+            std::string mode;
+            if (fields >> mode) {
+                if (mode != "loop" && mode != "once") return fail(error, lineNumber, "expected loop or once");
+                event.loop = mode == "loop";
+                fields >> event.value;
+            }
+        } else if (command == "stop_music") {
+            event.type = MixerEvent::Type::StopMusic;
+            fields >> event.fadeFrames;
+        } else if (command == "pause_music") {
+            event.type = MixerEvent::Type::PauseMusic;
+        } else if (command == "resume_music") {
+            event.type = MixerEvent::Type::ResumeMusic;
+        } else if (command == "master") {
+            event.type = MixerEvent::Type::SetMasterVolume;
+            if (!(fields >> event.value)) return fail(error, lineNumber, "missing volume");
+        } else if (command == "end") {
+            m_endFrame = event.frame;
+            continue;
+        } else {
+            return fail(error, lineNumber, "unknown command '" + command + "'");
+        }
+        add(event);
+    }
+    return true;
+}
+
+int64_t MixerTimeline::lengthFrames(int sampleRate) const {
+    if (m_endFrame >= 0) return m_endFrame;
+    return (m_events.empty() ? 0 : m_events.back().frame) + sampleRate;
+}
+
+void MixerTimeline::run(SoundMixer& sounds, MusicMixer& music,
+                        const std::vector<AudioData*>& soundTable,
+                        const std::vector<AudioData*>& trackTable,
+                        OfflineBackend& backend, int64_t endFrame) const {
+    for (const MixerEvent& event : m_events) {
+        if (event.frame >= endFrame) break;
+        backend.render(event.frame - backend.framesRendered());
+
+        switch (event.type) {
+            case MixerEvent::Type::PlaySound:
+                if (AudioData* data = entry(soundTable, event.id, SoundMixer::kMaxVoices)) {
+                    sounds.play(event.id, data, event.value);
+                }
+                break;
+            case MixerEvent::Type::StopSound:
+                if (event.id >= 0 && event.id < SoundMixer::kMaxVoices) sounds.stop(event.id);
+                break;
+            case MixerEvent::Type::StopAllSounds:
+                sounds.stopAll();
+                break;
+            case MixerEvent::Type::PlayMusic:
+                if (AudioData* data = entry(trackTable, event.id, trackTable.size())) {
+                    music.play(data, event.loop, event.value);
+                }
+                break;
+            case MixerEvent::Type::CrossfadeMusic:
+                if (AudioData* data = entry(trackTable, event.id, trackTable.size())) {
+                    music.crossfadeTo(data, event.loop, event.value, event.fadeFrames);
+                }
+                break;
+            case MixerEvent::Type::StopMusic:
+                music.stop(event.fadeFrames);
+                break;
+            case MixerEvent::Type::PauseMusic:
+                music.pause();
+                break;
+            case MixerEvent::Type::ResumeMusic:
+                music.resume();
+                break;
+            case MixerEvent::Type::SetMasterVolume:
+                sounds.setMasterVolume(event.value);
+                music.setMasterVolume(event.value);
+                break;
+        }
+    }
+    backend.render(endFrame - backend.framesRendered());
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,77 @@
+#ifndef TRASHPILES_MIXER_TIMELINE_H
+#define TRASHPILES_MIXER_TIMELINE_H
+
+#include "audio_mixer.h"
+#include "offline_backend.h"
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace TrashPiles {
+
+struct MixerEvent {
+    enum class Type : uint8_t {
+        PlaySound,      // id = sound, value = volume
+        StopSound,      // id = sound
+        StopAllSounds,
+        PlayMusic,      // id = track, value = volume, loop
+        CrossfadeMusic, // id = track, value = volume, loop, fadeFrames
+        StopMusic,      // fadeFrames
+        PauseMusic,
+        ResumeMusic,
+        SetMasterVolume // value = volume
+    };
+
+    int64_t frame = 0;
+    Type type = Type::PlaySound;
+    int id = 0;
+    float value = 1.0f;
+    bool loop = false;
+    int fadeFrames = 0;
+};
+
+/**
+ * Scripted mixer events at exact output frames
+ * Drives an OfflineBackend: rendering is split at every event frame, so
+ * a render is a pure function of the script and the sample data.
+ *
+ * Text form, one event per line, '#' starts a comment:
+ *   <frame> play <sound> [volume]
+ *   <frame> stop <sound>
+ *   <frame> stop_all
+ *   <frame> music <track> [loop|once] [volume]
+ *   <frame> crossfade <track> <fade frames> [loop|once] [volume]
+ *   <frame> stop_music [fade frames]
+ *   <frame> pause_music
+ *   <frame> resume_music
+ *   <frame> master <volume>
+ *   <frame> end
+ */
+class MixerTimeline {
+public:
+    void add(const MixerEvent& event);
+
+    // Names map to indexes into the sound and track tables passed to run()
+    bool parse(const std::string& script,
+               const std::map<std::string, int>& soundIds,
+               const std::map<std::string, int>& trackIds,
+               std::string* error = nullptr);
+
+    // Frame of the end marker, or one second past the last event at the given rate
+    int64_t lengthFrames(int sampleRate) const;
+
+    // Applies events in frame order and renders up to endFrame
+    void run(SoundMixer& sounds, MusicMixer& music,
+             const std::vector<AudioData*>& soundTable,
+             const std::vector<AudioData*>& trackTable,
+             OfflineBackend& backend, int64_t endFrame) const;
+
+private:
+    std::vector<MixerEvent> m_events;
+    int64_t m_endFrame = -1;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_MIXER_TIMELINE_H
@@ -0,0 +1,150 @@
+#include "oboe_backend.h"
+#include "../trace/trace.h"
+
+namespace TrashPiles {
+
+// Clean playback needed before a low-latency stream tries a smaller buffer
+static constexpr int kShrinkAfterSeconds = 5;
+
+OboeBackend::OboeBackend(Mode mode, int sampleRate)
+    : m_mode(mode),
+      m_requestedSampleRate(sampleRate) {
+}
+
+OboeBackend::~OboeBackend() {
+    close();
+}
+
+bool OboeBackend::open(AudioRenderSource* source) {
+    if (!source) return false;
+    m_source = source;
+
+    // Without an explicit rate the device uses its native one, which keeps the
+    // system resampler out of the path and qualifies for the fast mixer track
+    oboe::AudioStreamBuilder builder;
+    builder.setDirection(oboe::Direction::Output);
+    builder.setPerformanceMode(m_mode == Mode::LowLatency
+                               ? oboe::PerformanceMode::LowLatency
+                               : oboe::PerformanceMode::PowerSaving);
+    builder.setSharingMode(oboe::SharingMode::Shared);
+    builder.setFormat(oboe::AudioFormat::Float);
+    builder.setChannelCount(oboe::ChannelCount::Stereo);
+    if (m_requestedSampleRate > 0) {
+        builder.setSampleRate(m_requestedSampleRate);
+    }
+    builder.setCallback(this);
+
+    oboe::Result result = builder.openStream(m_stream);
+    if (result != oboe::Result::OK) {
+        LOGE("Failed to open output stream: %s", oboe::convertToText(result));
+        return false;
+    }
+
+    attachTuner();
+    return true;
+}
+
+void OboeBackend::attachTuner() {
+    m_histogram.reset();
+    m_xrunSupported = m_stream->isXRunCountSupported();
+    m_xrunCount.store(m_xrunSupported ? 0 : -1, std::memory_order_relaxed);
+
+    bool lowLatency = m_mode == Mode::LowLatency;
+    int initialFrames = lowLatency
+        ? m_stream->getFramesPerBurst() * 2
+        : m_stream->getBufferSizeInFrames() * 2;
+    int64_t shrinkAfter = lowLatency && m_xrunSupported
+        ? static_cast<int64_t>(m_stream->getSampleRate()) * kShrinkAfterSeconds : 0;
+
+    m_tuner.reset(m_stream->getFramesPerBurst(), m_stream->getBufferCapacityInFrames(),
+                  initialFrames, shrinkAfter);
+
+    auto applied = m_stream->setBufferSizeInFrames(m_tuner.bufferFrames());
+    if (applied) {
+        // The device may round to its own granularity; track what it chose
+        m_tuner.reset(m_stream->getFramesPerBurst(), m_stream->getBufferCapacityInFrames(),
+                      applied.value(), shrinkAfter);
+    }
+}
+
+bool OboeBackend::start() {
+    if (!m_stream) return false;
+
+    oboe::Result result = m_stream->requestStart();
+    if (result != oboe::Result::OK) {
+        LOGE("Failed to start output stream: %s", oboe::convertToText(result));
+        return false;
+    }
+
+    LOGI("Output stream started - Sample rate: %d, Buffer size: %d",
+         m_stream->getSampleRate(), m_stream->getBufferSizeInFrames());
+    return true;
+}
+
+void OboeBackend::stop() {
+    if (m_stream) {
+        m_stream->requestStop();
+    }
+}
+
+void OboeBackend::close() {
+    if (m_stream) {
+        m_stream->requestStop();
+        m_stream->close();
+        m_stream.reset();
+    }
+    m_source = nullptr;
+}
+
+int OboeBackend::sampleRate() const {
+    return m_stream ? m_stream->getSampleRate() : 0;
+}
+
+oboe::DataCallbackResult OboeBackend::onAudioReady(
+    oboe::AudioStream* audioStream,
+    void* audioData,
+    int32_t numFrames) {
+
+    TRACE_THREAD_NAME("audio");
+    TRACE_SCOPE("audio.callback");
+    auto start = Clock::now();
+    m_source->render(static_cast<float*>(audioData), numFrames);
+    m_histogram.record(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        Clock::now() - start).count());
+
+    if (m_xrunSupported) {
+        auto xruns = audioStream->getXRunCount();
+        if (xruns) {
+            m_xrunCount.store(xruns.value(), std::memory_order_relaxed);
+
+            // AAudio allows resizing from the callback thread
+            int current = m_tuner.bufferFrames();
+            int wanted = m_tuner.update(xruns.value(), numFrames);
+            if (wanted != current) {
+                auto applied = audioStream->setBufferSizeInFrames(wanted);
+                m_tuner.applied(applied ? applied.value() : audioStream->getBufferSizeInFrames());
+            }
+        }
+    }
+
+    return oboe::DataCallbackResult::Continue;
+}
+
+void OboeBackend::fillStats(AudioStreamStats& stats) const {
+    stats.callbackCount = m_histogram.count();
+    stats.xrunCount = m_xrunCount.load(std::memory_order_relaxed);
+    stats.bufferSizeFrames = m_tuner.bufferFrames();
+    stats.framesPerBurst = m_tuner.framesPerBurst();
+    stats.bufferCapacityFrames = m_tuner.capacityFrames();
+    stats.lowestStableFrames = m_tuner.lowestStableFrames();
+    stats.callbackMeanNanos = m_histogram.meanNanos();
+    stats.callbackMaxNanos = m_histogram.maxNanos();
+    m_histogram.buckets(stats.callbackHistogram);
+
+    if (m_stream) {
+        auto latency = m_stream->calculateLatencyMillis();
+        stats.latencyMillis = latency ? latency.value() : -1.0;
+    }
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,68 @@
+#ifndef TRASHPILES_OBOE_BACKEND_H
+#define TRASHPILES_OBOE_BACKEND_H
+
+#include <oboe/Oboe.h>
+#include <android/log.h>
+#include "audio_backend.h"
+#include "audio_telemetry.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+
+#define LOG_TAG "TrashPiles-Audio"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+namespace TrashPiles {
+
+/**
+ * Device output through an Oboe stream
+ * The stream callback pulls from the render source, times itself into a
+ * histogram and retunes the buffer size from the device's underrun count.
+ * Low-latency streams start double-buffered and settle on the smallest
+ * size with no underruns; power-saving streams only ever grow.
+ */
+class OboeBackend : public AudioBackend, public oboe::AudioStreamCallback {
+public:
+    enum class Mode {
+        LowLatency,
+        PowerSaving
+    };
+
+    // sampleRate 0 lets the device pick its native rate
+    explicit OboeBackend(Mode mode, int sampleRate = 0);
+    ~OboeBackend() override;
+
+    bool open(AudioRenderSource* source) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+    int sampleRate() const override;
+
+    oboe::DataCallbackResult onAudioReady(
+        oboe::AudioStream* audioStream,
+        void* audioData,
+        int32_t numFrames) override;
+
+    void fillStats(AudioStreamStats& stats) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    Mode m_mode;
+    int m_requestedSampleRate;
+    AudioRenderSource* m_source = nullptr;
+    std::shared_ptr<oboe::AudioStream> m_stream;
+
+    // Telemetry; written by the callback, read from any thread
+    CallbackHistogram m_histogram;
+    BufferSizeTuner m_tuner;
+    bool m_xrunSupported = false;
+    std::atomic<int32_t> m_xrunCount{-1};
+
+    void attachTuner();
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_OBOE_BACKEND_H
@@ -0,0 +1,70 @@
+#include "offline_backend.h"
+#include "wav_decoder.h"
+#include "../trace/trace.h"
+#include <algorithm>
+#include <cstdio>
+
+namespace TrashPiles {
+
+OfflineBackend::OfflineBackend(int sampleRate, int bufferFrames)
+    : m_sampleRate(sampleRate),
+      m_bufferFrames(std::max(1, bufferFrames)) {
+}
+
+bool OfflineBackend::open(AudioRenderSource* source) {
+    if (!source || m_sampleRate <= 0) return false;
+    m_source = source;
+    m_buffer.assign(static_cast<size_t>(m_bufferFrames) * 2, 0.0f);
+    m_output.clear();
+    m_framesRendered = 0;
+    return true;
+}
+
+bool OfflineBackend::start() {
+    if (!m_source) return false;
+    m_running = true;
+    return true;
+}
+
+void OfflineBackend::stop() {
+    m_running = false;
+}
+
+void OfflineBackend::close() {
+    stop();
+    m_source = nullptr;
+}
+
+void OfflineBackend::render(int64_t numFrames) {
+    if (!m_running) return;
+
+    if (m_capture) {
+        m_output.reserve(m_output.size() + static_cast<size_t>(numFrames) * 2);
+    }
+
+    while (numFrames > 0) {
+        int frames = static_cast<int>(std::min<int64_t>(numFrames, m_bufferFrames));
+        TRACE_SCOPE("audio.callback");
+        m_source->render(m_buffer.data(), frames);
+        if (m_capture) {
+            m_output.insert(m_output.end(), m_buffer.begin(), m_buffer.begin() + frames * 2);
+        }
+        m_framesRendered += frames;
+        numFrames -= frames;
+    }
+}
+
+bool OfflineBackend::writeWav(const char* path) const {
+    PcmBuffer pcm;
+    pcm.samples = m_output;
+    pcm.channelCount = 2;
+    pcm.sampleRate = m_sampleRate;
+    std::vector<uint8_t> bytes = encodeWav(pcm);
+
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+    bool written = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+    return std::fclose(file) == 0 && written;
+}
+
+} // namespace TrashPiles
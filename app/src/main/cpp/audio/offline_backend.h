@@ -0,0 +1,52 @@
+#ifndef TRASHPILES_OFFLINE_BACKEND_H
+#define TRASHPILES_OFFLINE_BACKEND_H
+
+#include "audio_backend.h"
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Host backend that renders as fast as the CPU allows
+ * render() pulls from the source in fixed device-sized buffers and captures
+ * the output, which can be written out as a float WAV. Used by regression
+ * tests, the audio_render tool and the mixer benchmark.
+ */
+class OfflineBackend : public AudioBackend {
+public:
+    static constexpr int kDefaultBufferFrames = 192;
+
+    explicit OfflineBackend(int sampleRate, int bufferFrames = kDefaultBufferFrames);
+
+    bool open(AudioRenderSource* source) override;
+    bool start() override;
+    void stop() override;
+    void close() override;
+    int sampleRate() const override { return m_sampleRate; }
+
+    // Pulls numFrames from the source; a no-op unless started
+    void render(int64_t numFrames);
+
+    // Benchmarks turn capture off to time the mixer alone
+    void setCapture(bool capture) { m_capture = capture; }
+
+    int64_t framesRendered() const { return m_framesRendered; }
+    const std::vector<float>& output() const { return m_output; }
+
+    bool writeWav(const char* path) const;
+
+private:
+    int m_sampleRate;
+    int m_bufferFrames;
+    AudioRenderSource* m_source = nullptr;
+    bool m_running = false;
+    bool m_capture = true;
+    int64_t m_framesRendered = 0;
+    std::vector<float> m_buffer;
+    std::vector<float> m_output;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_OFFLINE_BACKEND_H
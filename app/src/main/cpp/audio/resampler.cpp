@@ -0,0 +1,145 @@
+#include "resampler.h"
+#include "wav_decoder.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+
+namespace TrashPiles {
+
+namespace {
+
+// Above this many exact phases the table is quantized instead
+constexpr size_t kMaxPhases = 1024;
+
+// Filter half-width in zero crossings of the narrower band; 16 keeps the
+// transition band well clear of the audible range at 44.1/48 kHz
+constexpr int kZeroCrossings = 16;
+
+// Passband edge as a fraction of the lower Nyquist frequency
+constexpr double kPassband = 0.95;
+
+// Kaiser beta for roughly 90 dB of stopband rejection
+constexpr double kKaiserBeta = 8.6;
+
+constexpr double kPi = 3.14159265358979323846;
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    double halfX = x * 0.5;
+    for (int k = 1; k < 32; ++k) {
+        term *= (halfX / k) * (halfX / k);
+        sum += term;
+        if (term < sum * 1e-12) break;
+    }
+    return sum;
+}
+
+double sinc(double x) {
+    if (std::fabs(x) < 1e-9) return 1.0;
+    return std::sin(kPi * x) / (kPi * x);
+}
+
+} // namespace
+
+Resampler::Resampler(int inputRate, int outputRate) {
+    size_t in = static_cast<size_t>(std::max(inputRate, 1));
+    size_t out = static_cast<size_t>(std::max(outputRate, 1));
+    size_t divisor = std::gcd(in, out);
+    m_upFactor = out / divisor;
+    m_downFactor = in / divisor;
+    m_phaseCount = std::min(m_upFactor, kMaxPhases);
+
+    if (isPassthrough()) {
+        m_tapCount = 0;
+        return;
+    }
+
+    // Cut off at the lower of the two Nyquist frequencies, in input-sample units
+    double cutoff = kPassband * std::min(1.0, static_cast<double>(m_upFactor) / m_downFactor);
+    double halfWidth = kZeroCrossings / cutoff;
+    m_tapCount = 2 * static_cast<int>(std::ceil(halfWidth));
+    int centerTap = m_tapCount / 2 - 1;
+    double kaiserNorm = 1.0 / besselI0(kKaiserBeta);
+
+    // One extra row so a quantized phase that rounds up to 1.0 stays in range
+    m_coefficients.assign((m_phaseCount + 1) * m_tapCount, 0.0f);
+    std::vector<double> taps(m_tapCount);
+    for (size_t phase = 0; phase <= m_phaseCount; ++phase) {
+        double fraction = static_cast<double>(phase) / m_phaseCount;
+        float* row = &m_coefficients[phase * m_tapCount];
+        double sum = 0.0;
+        std::fill(taps.begin(), taps.end(), 0.0);
+        for (int k = 0; k < m_tapCount; ++k) {
+            double t = fraction + centerTap - k;
+            double x = t / halfWidth;
+            if (std::fabs(x) >= 1.0) continue;
+            double window = besselI0(kKaiserBeta * std::sqrt(1.0 - x * x)) * kaiserNorm;
+            taps[k] = cutoff * sinc(cutoff * t) * window;
+            sum += taps[k];
+        }
+        // Normalize each phase to unity DC gain so no phase adds ripple
+        for (int k = 0; k < m_tapCount; ++k) {
+            row[k] = static_cast<float>(taps[k] / sum);
+        }
+    }
+}
+
+size_t Resampler::outputFrameCount(size_t inputFrames) const {
+    uint64_t scaled = static_cast<uint64_t>(inputFrames) * m_upFactor;
+    return static_cast<size_t>((scaled + m_downFactor - 1) / m_downFactor);
+}
+
+size_t Resampler::phaseForOutput(size_t remainder) const {
+    if (m_phaseCount == m_upFactor) return remainder;
+    return static_cast<size_t>(
+        (static_cast<uint64_t>(remainder) * m_phaseCount + m_upFactor / 2) / m_upFactor);
+}
+
+void Resampler::process(const float* input, size_t inputFrames, int channelCount,
+                        std::vector<float>& output) const {
+    if (isPassthrough()) {
+        output.assign(input, input + inputFrames * channelCount);
+        return;
+    }
+
+    size_t outputFrames = outputFrameCount(inputFrames);
+    output.assign(outputFrames * channelCount, 0.0f);
+
+    int64_t centerTap = m_tapCount / 2 - 1;
+    int64_t lastFrame = static_cast<int64_t>(inputFrames);
+
+    for (size_t n = 0; n < outputFrames; ++n) {
+        uint64_t position = static_cast<uint64_t>(n) * m_downFactor;
+        int64_t index = static_cast<int64_t>(position / m_upFactor);
+        size_t phase = phaseForOutput(static_cast<size_t>(position % m_upFactor));
+        const float* row = &m_coefficients[phase * m_tapCount];
+        int64_t first = index - centerTap;
+        float* dst = &output[n * channelCount];
+
+        // Taps that fall outside the input read as silence
+        int kBegin = static_cast<int>(std::max<int64_t>(0, -first));
+        int kEnd = static_cast<int>(std::min<int64_t>(m_tapCount, lastFrame - first));
+        for (int ch = 0; ch < channelCount; ++ch) {
+            const float* src = input + (first + kBegin) * channelCount + ch;
+            float acc = 0.0f;
+            for (int k = kBegin; k < kEnd; ++k) {
+                acc += row[k] * src[(k - kBegin) * channelCount];
+            }
+            dst[ch] = acc;
+        }
+    }
+}
+
+void Resampler::convert(PcmBuffer& buffer, int targetRate) {
+    if (buffer.sampleRate == targetRate || buffer.channelCount <= 0) return;
+
+    Resampler resampler(buffer.sampleRate, targetRate);
+    std::vector<float> converted;
+    resampler.process(buffer.samples.data(), buffer.frameCount(), buffer.channelCount, converted);
+    buffer.samples.swap(converted);
+    buffer.sampleRate = targetRate;
+}
+
+} // namespace TrashPiles
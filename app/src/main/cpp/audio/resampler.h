@@ -0,0 +1,46 @@
+#ifndef TRASHPILES_RESAMPLER_H
+#define TRASHPILES_RESAMPLER_H
+
+#include <cstddef>
+#include <vector>
+
+namespace TrashPiles {
+
+struct PcmBuffer;
+
+/**
+ * Polyphase windowed-sinc sample rate converter
+ * Used once at load time to bring assets to the device's native output rate,
+ * so streams can run without the system resampler in the path.
+ *
+ * The rate ratio is reduced to L/M; when L is small enough every output
+ * phase gets its own exact filter, otherwise phases are quantized to a
+ * fixed table (error below 1/2048 of an input sample).
+ */
+class Resampler {
+public:
+    Resampler(int inputRate, int outputRate);
+
+    bool isPassthrough() const { return m_upFactor == m_downFactor; }
+    size_t outputFrameCount(size_t inputFrames) const;
+
+    // Interleaved in, interleaved out; channel count is preserved
+    void process(const float* input, size_t inputFrames, int channelCount,
+                 std::vector<float>& output) const;
+
+    // Convenience: convert a decoded buffer in place to targetRate
+    static void convert(PcmBuffer& buffer, int targetRate);
+
+private:
+    size_t m_upFactor;      // L
+    size_t m_downFactor;    // M
+    size_t m_phaseCount;
+    int m_tapCount;
+    std::vector<float> m_coefficients;  // m_phaseCount rows of m_tapCount taps
+
+    size_t phaseForOutput(size_t remainder) const;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_RESAMPLER_H
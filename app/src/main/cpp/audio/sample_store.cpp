@@ -0,0 +1,225 @@
+#include "sample_store.h"
+#include "wav_decoder.h"
+#include "mix_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace TrashPiles {
+
+namespace {
+
+const int8_t kAdpcmIndexTable[16] = {
+    -1, -1, -1, -1, 2, 4, 6, 8,
+    -1, -1, -1, -1, 2, 4, 6, 8
+};
+
+const int16_t kAdpcmStepTable[89] = {
+    7, 8, 9, 10, 11, 12, 13, 14, 16, 17, 19, 21, 23, 25, 28, 31,
+    34, 37, 41, 45, 50, 55, 60, 66, 73, 80, 88, 97, 107, 118, 130, 143,
+    157, 173, 190, 209, 230, 253, 279, 307, 337, 371, 408, 449, 494, 544, 598, 658,
+    724, 796, 876, 963, 1060, 1166, 1282, 1411, 1552, 1707, 1878, 2066, 2272, 2499, 2749, 3024,
+    3327, 3660, 4026, 4428, 4871, 5358, 5894, 6484, 7132, 7845, 8630, 9493, 10442, 11487, 12635, 13899,
+    15289, 16818, 18500, 20350, 22385, 24623, 27086, 29794, 32767
+};
+
+// Per-channel block header: int16 predictor, uint8 step index, one pad byte
+constexpr size_t kAdpcmHeaderBytes = 4;
+
+inline int16_t toInt16(float sample) {
+    float scaled = std::nearbyint(sample * 32768.0f);
+    return static_cast<int16_t>(std::max(-32768.0f, std::min(32767.0f, scaled)));
+}
+
+inline void adpcmStep(uint8_t nibble, int16_t& predictor, uint8_t& stepIndex) {
+    int step = kAdpcmStepTable[stepIndex];
+    int diff = step >> 3;
+    if (nibble & 1) diff += step >> 2;
+    if (nibble & 2) diff += step >> 1;
+    if (nibble & 4) diff += step;
+    int value = (nibble & 8) ? predictor - diff : predictor + diff;
+    predictor = static_cast<int16_t>(std::max(-32768, std::min(32767, value)));
+    stepIndex = static_cast<uint8_t>(std::max(0, std::min(88, stepIndex + kAdpcmIndexTable[nibble])));
+}
+
+inline uint8_t adpcmEncode(int16_t sample, int16_t& predictor, uint8_t& stepIndex) {
+    int step = kAdpcmStepTable[stepIndex];
+    int diff = sample - predictor;
+    uint8_t nibble = 0;
+    if (diff < 0) {
+        nibble = 8;
+        diff = -diff;
+    }
+    if (diff >= step) { nibble |= 4; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 2; diff -= step; }
+    step >>= 1;
+    if (diff >= step) { nibble |= 1; }
+
+    // Track exactly what the decoder will reconstruct
+    adpcmStep(nibble, predictor, stepIndex);
+    return nibble;
+}
+
+} // namespace
+
+const char* sampleEncodingText(SampleEncoding encoding) {
+    switch (encoding) {
+        case SampleEncoding::Float32: return "float32";
+        case SampleEncoding::Int16: return "int16";
+        case SampleEncoding::ImaAdpcm: return "ima-adpcm";
+    }
+    return "unknown";
+}
+
+SampleStore SampleStore::fromPcm(const PcmBuffer& pcm, SampleEncoding encoding) {
+    SampleStore store;
+    store.m_encoding = encoding;
+    store.m_channelCount = pcm.channelCount;
+    store.m_frameCount = static_cast<int>(pcm.frameCount());
+
+    size_t sampleCount = static_cast<size_t>(store.m_frameCount) * store.m_channelCount;
+    store.m_owned.assign(encodedSize(encoding, store.m_channelCount, store.m_frameCount), 0);
+
+    switch (encoding) {
+        case SampleEncoding::Float32:
+            std::memcpy(store.m_owned.data(), pcm.samples.data(), sampleCount * sizeof(float));
+            break;
+
+        case SampleEncoding::Int16: {
+            int16_t* dst = reinterpret_cast<int16_t*>(store.m_owned.data());
+            for (size_t i = 0; i < sampleCount; ++i) {
+                dst[i] = toInt16(pcm.samples[i]);
+            }
+            break;
+        }
+
+        case SampleEncoding::ImaAdpcm: {
+            int channels = store.m_channelCount;
+            size_t blockBytes = adpcmBlockBytes(channels);
+            size_t blockCount = (store.m_frameCount + kAdpcmBlockFrames - 1) / kAdpcmBlockFrames;
+
+            int16_t predictor[2] = {0, 0};
+            uint8_t stepIndex[2] = {0, 0};
+            for (size_t block = 0; block < blockCount; ++block) {
+                uint8_t* header = &store.m_owned[block * blockBytes];
+                uint8_t* nibbles = header + kAdpcmHeaderBytes * channels;
+                for (int ch = 0; ch < channels; ++ch) {
+                    uint16_t bits = static_cast<uint16_t>(predictor[ch]);
+                    header[ch * kAdpcmHeaderBytes] = static_cast<uint8_t>(bits & 0xFF);
+                    header[ch * kAdpcmHeaderBytes + 1] = static_cast<uint8_t>(bits >> 8);
+                    header[ch * kAdpcmHeaderBytes + 2] = stepIndex[ch];
+                }
+
+                int firstFrame = static_cast<int>(block) * kAdpcmBlockFrames;
+                int frames = std::min(kAdpcmBlockFrames, store.m_frameCount - firstFrame);
+                for (int f = 0; f < frames; ++f) {
+                    for (int ch = 0; ch < channels; ++ch) {
+                        int16_t sample = toInt16(pcm.samples[(firstFrame + f) * channels + ch]);
+                        uint8_t nibble = adpcmEncode(sample, predictor[ch], stepIndex[ch]);
+                        int slot = f * channels + ch;
+                        nibbles[slot >> 1] |= (slot & 1) ? (nibble << 4) : nibble;
+                    }
+                }
+            }
+            break;
+        }
+    }
+
+    return store;
+}
+
+SampleStore SampleStore::wrap(SampleEncoding encoding, int channelCount, int frameCount,
+                              const uint8_t* data, size_t size) {
+    SampleStore store;
+    store.m_encoding = encoding;
+    store.m_channelCount = channelCount;
+    store.m_frameCount = frameCount;
+    store.m_borrowed = data;
+    store.m_borrowedSize = size;
+    return store;
+}
+
+size_t SampleStore::encodedSize(SampleEncoding encoding, int channelCount, int frameCount) {
+    size_t sampleCount = static_cast<size_t>(frameCount) * channelCount;
+    switch (encoding) {
+        case SampleEncoding::Float32: return sampleCount * sizeof(float);
+        case SampleEncoding::Int16: return sampleCount * sizeof(int16_t);
+        case SampleEncoding::ImaAdpcm: {
+            size_t blockCount = (static_cast<size_t>(frameCount) + kAdpcmBlockFrames - 1) / kAdpcmBlockFrames;
+            return blockCount * adpcmBlockBytes(channelCount);
+        }
+    }
+    return 0;
+}
+
+size_t SampleStore::adpcmBlockBytes(int channelCount) {
+    return kAdpcmHeaderBytes * channelCount + (kAdpcmBlockFrames * channelCount) / 2;
+}
+
+void SampleStore::decode(DecodeCursor& cursor, int frameCount, float* out) const {
+    size_t offset = static_cast<size_t>(cursor.frame) * m_channelCount;
+    size_t count = static_cast<size_t>(frameCount) * m_channelCount;
+
+    switch (m_encoding) {
+        case SampleEncoding::Float32:
+            std::memcpy(out, reinterpret_cast<const float*>(data()) + offset, count * sizeof(float));
+            cursor.frame += frameCount;
+            break;
+        case SampleEncoding::Int16:
+            MixKernels::int16ToFloat(reinterpret_cast<const int16_t*>(data()) + offset, out, count);
+            cursor.frame += frameCount;
+            break;
+        case SampleEncoding::ImaAdpcm:
+            decodeAdpcm(cursor, frameCount, out);
+            break;
+    }
+}
+
+void SampleStore::decodeAdpcm(DecodeCursor& cursor, int frameCount, float* out) const {
+    constexpr float kScale = 1.0f / 32768.0f;
+    int channels = m_channelCount;
+    size_t blockBytes = adpcmBlockBytes(channels);
+    const uint8_t* payload = data();
+
+    // After a seek, rewind to the block start and run forward to the target frame
+    int skip = 0;
+    if (!cursor.stateValid) {
+        skip = cursor.frame % kAdpcmBlockFrames;
+        cursor.frame -= skip;
+        frameCount += skip;
+    }
+
+    for (int i = 0; i < frameCount; ++i) {
+        int inBlock = cursor.frame % kAdpcmBlockFrames;
+        const uint8_t* block = payload + (cursor.frame / kAdpcmBlockFrames) * blockBytes;
+        if (inBlock == 0) {
+            for (int ch = 0; ch < channels; ++ch) {
+                const uint8_t* header = block + ch * kAdpcmHeaderBytes;
+                cursor.predictor[ch] = static_cast<int16_t>(header[0] | (header[1] << 8));
+                cursor.stepIndex[ch] = header[2];
+            }
+            cursor.stateValid = true;
+        }
+        const uint8_t* nibbles = block + kAdpcmHeaderBytes * channels;
+
+        for (int ch = 0; ch < channels; ++ch) {
+            int slot = inBlock * channels + ch;
+            uint8_t nibble = (slot & 1) ? (nibbles[slot >> 1] >> 4) : (nibbles[slot >> 1] & 0x0F);
+            adpcmStep(nibble, cursor.predictor[ch], cursor.stepIndex[ch]);
+            if (i >= skip) {
+                out[(i - skip) * channels + ch] = cursor.predictor[ch] * kScale;
+            }
+        }
+        cursor.frame++;
+    }
+}
+
+void SampleStore::decodeAll(PcmBuffer& out) const {
+    out.channelCount = m_channelCount;
+    out.samples.resize(static_cast<size_t>(m_frameCount) * m_channelCount);
+    DecodeCursor cursor;
+    decode(cursor, m_frameCount, out.samples.data());
+}
+
+} // namespace TrashPiles
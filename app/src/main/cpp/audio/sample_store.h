@@ -0,0 +1,101 @@
+#ifndef TRASHPILES_SAMPLE_STORE_H
+#define TRASHPILES_SAMPLE_STORE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+struct PcmBuffer;
+
+enum class SampleEncoding : uint8_t {
+    Float32,    // 4 bytes/sample, lossless
+    Int16,      // 2 bytes/sample, lossless for 16-bit sources
+    ImaAdpcm    // ~0.5 bytes/sample, 4:1 against Int16
+};
+
+const char* sampleEncodingText(SampleEncoding encoding);
+
+/**
+ * Decoder position inside a SampleStore
+ * ADPCM is a running predictor, so the cursor carries decoder state and
+ * sequential decodes never re-read a block header mid-block.
+ */
+struct DecodeCursor {
+    int frame = 0;
+    int16_t predictor[2] = {0, 0};
+    uint8_t stepIndex[2] = {0, 0};
+    bool stateValid = false;
+
+    void seek(int targetFrame) {
+        frame = targetFrame;
+        stateValid = false;
+    }
+};
+
+/**
+ * Compact immutable sample storage
+ * Assets are kept in their storage encoding and widened to float only in
+ * small blocks inside the audio callback, which halves (Int16) or eighths
+ * (ADPCM) resident memory versus pre-converted float.
+ *
+ * Int16 widens through the vector kernel in mix_kernels.h. ADPCM decodes
+ * with a scalar loop on purpose: each sample's predictor and step index
+ * depend on the previous sample, so a channel has no independent lanes to
+ * vectorize. The cursor keeps the decoder state between callbacks, so each
+ * sample is decoded once.
+ */
+class SampleStore {
+public:
+    // IMA-ADPCM frames per independently decodable block
+    static constexpr int kAdpcmBlockFrames = 256;
+
+    SampleStore() = default;
+
+    // Encodes interleaved float PCM; the buffer's rate is not stored
+    static SampleStore fromPcm(const PcmBuffer& pcm, SampleEncoding encoding);
+
+    // Borrows already-encoded bytes (e.g. a mapped sound bank) without copying.
+    // The memory must outlive the store and be aligned for the encoding.
+    static SampleStore wrap(SampleEncoding encoding, int channelCount, int frameCount,
+                            const uint8_t* data, size_t size);
+
+    // Bytes a payload of this shape occupies in the given encoding
+    static size_t encodedSize(SampleEncoding encoding, int channelCount, int frameCount);
+
+    SampleEncoding encoding() const { return m_encoding; }
+    int channelCount() const { return m_channelCount; }
+    int frameCount() const { return m_frameCount; }
+    bool empty() const { return m_frameCount == 0; }
+
+    // Encoded payload, owned or borrowed
+    const uint8_t* data() const { return m_borrowed ? m_borrowed : m_owned.data(); }
+    bool isBorrowed() const { return m_borrowed != nullptr; }
+
+    // Payload bytes, whether on the heap or in a file-backed mapping
+    size_t memoryBytes() const { return m_borrowed ? m_borrowedSize : m_owned.size(); }
+
+    // Decodes frameCount interleaved frames from cursor.frame into out and
+    // advances the cursor. The caller keeps the range within frameCount().
+    void decode(DecodeCursor& cursor, int frameCount, float* out) const;
+
+    // Decodes the whole payload, e.g. to resample a bank built at another rate
+    void decodeAll(PcmBuffer& out) const;
+
+private:
+    SampleEncoding m_encoding = SampleEncoding::Int16;
+    int m_channelCount = 1;
+    int m_frameCount = 0;
+
+    std::vector<uint8_t> m_owned;
+    const uint8_t* m_borrowed = nullptr;
+    size_t m_borrowedSize = 0;
+
+    static size_t adpcmBlockBytes(int channelCount);
+    void decodeAdpcm(DecodeCursor& cursor, int frameCount, float* out) const;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_SAMPLE_STORE_H
@@ -0,0 +1,123 @@
+#include "sound_bank.h"
+#include <cstring>
+
+namespace TrashPiles {
+
+using namespace SoundBankFormat;
+
+namespace {
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+bool isKnownEncoding(uint8_t encoding) {
+    return encoding <= static_cast<uint8_t>(SampleEncoding::ImaAdpcm);
+}
+
+} // namespace
+
+bool SoundBankView::open(const uint8_t* data, size_t size) {
+    m_data = nullptr;
+    m_entryCount = 0;
+
+    Header header;
+    if (!data || size < sizeof(header)) return false;
+    std::memcpy(&header, data, sizeof(header));
+
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return false;
+    if (header.version != kVersion) return false;
+    if (header.indexOffset > size ||
+        header.entryCount > (size - header.indexOffset) / sizeof(Entry)) {
+        return false;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_indexOffset = header.indexOffset;
+    m_entryCount = header.entryCount;
+    m_sampleRate = static_cast<int>(header.sampleRate);
+
+    // Reject the whole bank if any entry points outside the image
+    for (size_t i = 0; i < m_entryCount; ++i) {
+        Entry entry = readEntry(i);
+        bool valid = isKnownEncoding(entry.encoding) &&
+                     (entry.channelCount == 1 || entry.channelCount == 2) &&
+                     entry.name[kNameCapacity - 1] == '\0' &&
+                     entry.dataOffset % kDataAlignment == 0 &&
+                     entry.dataOffset <= size &&
+                     entry.dataSize <= size - entry.dataOffset &&
+                     entry.dataSize >= SampleStore::encodedSize(
+                         static_cast<SampleEncoding>(entry.encoding),
+                         entry.channelCount, entry.frameCount);
+        if (!valid) {
+            m_data = nullptr;
+            m_entryCount = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+Entry SoundBankView::readEntry(size_t index) const {
+    Entry entry;
+    std::memcpy(&entry, m_data + m_indexOffset + index * sizeof(Entry), sizeof(entry));
+    return entry;
+}
+
+const char* SoundBankView::entryName(size_t index) const {
+    return reinterpret_cast<const char*>(m_data + m_indexOffset + index * sizeof(Entry) +
+                                         offsetof(Entry, name));
+}
+
+SampleStore SoundBankView::entryStore(size_t index) const {
+    Entry entry = readEntry(index);
+    return SampleStore::wrap(static_cast<SampleEncoding>(entry.encoding),
+                             entry.channelCount, static_cast<int>(entry.frameCount),
+                             m_data + entry.dataOffset, entry.dataSize);
+}
+
+bool SoundBankWriter::add(const std::string& name, SampleStore store) {
+    if (name.empty() || name.size() >= kNameCapacity) return false;
+    m_entries.emplace_back(name, std::move(store));
+    return true;
+}
+
+std::vector<uint8_t> SoundBankWriter::build() const {
+    size_t indexOffset = sizeof(Header);
+    size_t dataOffset = alignUp(indexOffset + m_entries.size() * sizeof(Entry), kDataAlignment);
+
+    std::vector<Entry> entries(m_entries.size());
+    for (size_t i = 0; i < m_entries.size(); ++i) {
+        const SampleStore& store = m_entries[i].second;
+        Entry& entry = entries[i];
+        std::memset(&entry, 0, sizeof(entry));
+        std::strncpy(entry.name, m_entries[i].first.c_str(), kNameCapacity - 1);
+        entry.encoding = static_cast<uint8_t>(store.encoding());
+        entry.channelCount = static_cast<uint8_t>(store.channelCount());
+        entry.frameCount = static_cast<uint32_t>(store.frameCount());
+        entry.dataOffset = static_cast<uint32_t>(dataOffset);
+        entry.dataSize = static_cast<uint32_t>(store.memoryBytes());
+        dataOffset = alignUp(dataOffset + entry.dataSize, kDataAlignment);
+    }
+
+    std::vector<uint8_t> image(dataOffset, 0);
+
+    Header header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entryCount = static_cast<uint32_t>(entries.size());
+    header.sampleRate = static_cast<uint32_t>(m_sampleRate);
+    header.indexOffset = static_cast<uint32_t>(indexOffset);
+    std::memcpy(image.data(), &header, sizeof(header));
+
+    for (size_t i = 0; i < entries.size(); ++i) {
+        std::memcpy(&image[indexOffset + i * sizeof(Entry)], &entries[i], sizeof(Entry));
+        const SampleStore& store = m_entries[i].second;
+        std::memcpy(&image[entries[i].dataOffset], store.data(), store.memoryBytes());
+    }
+    return image;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,95 @@
+#ifndef TRASHPILES_SOUND_BANK_H
+#define TRASHPILES_SOUND_BANK_H
+
+#include "sample_store.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Packed sound bank (.tpbank)
+ *
+ * Layout: header, entry index, then sample blobs already in SampleStore
+ * encoding and aligned so a mapped file can be wrapped without copying.
+ * Banks are built offline by tools/soundbank_packer from a folder of WAVs.
+ * All fields are little-endian.
+ */
+namespace SoundBankFormat {
+
+constexpr char kMagic[4] = {'T', 'P', 'S', 'B'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kNameCapacity = 40;
+constexpr size_t kDataAlignment = 16;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t entryCount;
+    uint32_t sampleRate;
+    uint32_t indexOffset;
+    uint32_t reserved[3];
+};
+
+struct Entry {
+    char name[kNameCapacity];   // NUL-terminated asset name without extension
+    uint8_t encoding;           // SampleEncoding
+    uint8_t channelCount;
+    uint16_t reserved;
+    uint32_t frameCount;
+    uint32_t dataOffset;        // From start of file, kDataAlignment-aligned
+    uint32_t dataSize;
+    uint32_t reserved2[2];
+};
+
+static_assert(sizeof(Header) == 32, "Header layout is part of the file format");
+static_assert(sizeof(Entry) == 64, "Entry layout is part of the file format");
+
+} // namespace SoundBankFormat
+
+/**
+ * Read-only view over a bank image in memory (typically an mmapped asset)
+ */
+class SoundBankView {
+public:
+    // Validates header, index and blob bounds; the view borrows data
+    bool open(const uint8_t* data, size_t size);
+
+    int sampleRate() const { return m_sampleRate; }
+    size_t entryCount() const { return m_entryCount; }
+
+    const char* entryName(size_t index) const;
+
+    // Wraps entry payload in place (no copy)
+    SampleStore entryStore(size_t index) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    size_t m_entryCount = 0;
+    size_t m_indexOffset = 0;
+    int m_sampleRate = 0;
+
+    SoundBankFormat::Entry readEntry(size_t index) const;
+};
+
+/**
+ * Serializes encoded stores into a bank image (host tool side)
+ */
+class SoundBankWriter {
+public:
+    explicit SoundBankWriter(int sampleRate) : m_sampleRate(sampleRate) {}
+
+    bool add(const std::string& name, SampleStore store);
+    std::vector<uint8_t> build() const;
+
+private:
+    int m_sampleRate;
+    std::vector<std::pair<std::string, SampleStore>> m_entries;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_SOUND_BANK_H
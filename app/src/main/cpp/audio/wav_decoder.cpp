@@ -0,0 +1,196 @@
+#include "wav_decoder.h"
+#include <algorithm>
+#include <cstring>
+
+namespace TrashPiles {
+
+namespace {
+
+constexpr uint16_t kFormatPcm = 0x0001;
+constexpr uint16_t kFormatFloat = 0x0003;
+constexpr uint16_t kFormatExtensible = 0xFFFE;
+
+// Asset buffers are not guaranteed to be aligned, so fields are assembled byte-wise
+uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) |
+           (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) |
+           (static_cast<uint32_t>(p[3]) << 24);
+}
+
+bool tagEquals(const uint8_t* p, const char* tag) {
+    return std::memcmp(p, tag, 4) == 0;
+}
+
+void writeU16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+    out.push_back(static_cast<uint8_t>(value >> 8));
+}
+
+void writeU32(std::vector<uint8_t>& out, uint32_t value) {
+    for (int shift = 0; shift < 32; shift += 8) {
+        out.push_back(static_cast<uint8_t>((value >> shift) & 0xFF));
+    }
+}
+
+void writeTag(std::vector<uint8_t>& out, const char* tag) {
+    for (int i = 0; i < 4; ++i) {
+        out.push_back(static_cast<uint8_t>(tag[i]));
+    }
+}
+
+bool fail(WavError* error, WavError value) {
+    if (error) *error = value;
+    return false;
+}
+
+} // namespace
+
+const char* wavErrorText(WavError error) {
+    switch (error) {
+        case WavError::None: return "ok";
+        case WavError::NotRiff: return "missing RIFF header";
+        case WavError::NotWave: return "RIFF form is not WAVE";
+        case WavError::MissingFormat: return "missing fmt chunk";
+        case WavError::MissingData: return "missing data chunk";
+        case WavError::UnsupportedEncoding: return "unsupported sample encoding";
+        case WavError::UnsupportedChannels: return "unsupported channel count";
+        case WavError::Truncated: return "truncated chunk";
+    }
+    return "unknown";
+}
+
+bool decodeWav(const uint8_t* data, size_t size, PcmBuffer& out, WavError* error) {
+    if (!data || size < 12 || !tagEquals(data, "RIFF")) {
+        return fail(error, WavError::NotRiff);
+    }
+    if (!tagEquals(data + 8, "WAVE")) {
+        return fail(error, WavError::NotWave);
+    }
+
+    // Some encoders write a bogus RIFF size, so bound the walk by the real buffer
+    size_t riffEnd = std::min(size, static_cast<size_t>(readU32(data + 4)) + 8);
+
+    uint16_t formatTag = 0;
+    uint16_t channels = 0;
+    uint32_t sampleRate = 0;
+    uint16_t bitsPerSample = 0;
+    uint16_t blockAlign = 0;
+    bool haveFormat = false;
+
+    const uint8_t* payload = nullptr;
+    size_t payloadSize = 0;
+
+    size_t offset = 12;
+    while (offset + 8 <= riffEnd) {
+        const uint8_t* chunk = data + offset;
+        size_t chunkSize = readU32(chunk + 4);
+        size_t bodyOffset = offset + 8;
+
+        if (tagEquals(chunk, "fmt ")) {
+            if (chunkSize < 16 || bodyOffset + chunkSize > riffEnd) {
+                return fail(error, WavError::Truncated);
+            }
+            const uint8_t* body = data + bodyOffset;
+            formatTag = readU16(body);
+            channels = readU16(body + 2);
+            sampleRate = readU32(body + 4);
+            blockAlign = readU16(body + 12);
+            bitsPerSample = readU16(body + 14);
+
+            // WAVE_FORMAT_EXTENSIBLE carries the real encoding in the sub-format GUID
+            if (formatTag == kFormatExtensible) {
+                if (chunkSize < 40) return fail(error, WavError::Truncated);
+                formatTag = readU16(body + 24);
+            }
+            haveFormat = true;
+        } else if (tagEquals(chunk, "data")) {
+            // Streaming writers may leave the data size unpatched; clamp to the file
+            payload = data + bodyOffset;
+            payloadSize = std::min(chunkSize, riffEnd - bodyOffset);
+        }
+
+        if (chunkSize >= riffEnd - bodyOffset) break;
+
+        // Chunks are word-aligned; odd sizes carry one pad byte
+        offset = bodyOffset + chunkSize + (chunkSize & 1);
+    }
+
+    if (!haveFormat) return fail(error, WavError::MissingFormat);
+    if (!payload) return fail(error, WavError::MissingData);
+    if (channels != 1 && channels != 2) return fail(error, WavError::UnsupportedChannels);
+
+    bool isPcm16 = formatTag == kFormatPcm && bitsPerSample == 16;
+    bool isPcm24 = formatTag == kFormatPcm && bitsPerSample == 24;
+    bool isFloat32 = formatTag == kFormatFloat && bitsPerSample == 32;
+    if (!isPcm16 && !isPcm24 && !isFloat32) {
+        return fail(error, WavError::UnsupportedEncoding);
+    }
+
+    size_t bytesPerSample = bitsPerSample / 8;
+    if (blockAlign != bytesPerSample * channels || sampleRate == 0) {
+        return fail(error, WavError::UnsupportedEncoding);
+    }
+
+    size_t sampleCount = (payloadSize / blockAlign) * channels;
+    out.channelCount = channels;
+    out.sampleRate = static_cast<int>(sampleRate);
+    out.samples.resize(sampleCount);
+
+    float* dst = out.samples.data();
+    const uint8_t* src = payload;
+    if (isPcm16) {
+        for (size_t i = 0; i < sampleCount; ++i, src += 2) {
+            dst[i] = static_cast<float>(static_cast<int16_t>(readU16(src))) * (1.0f / 32768.0f);
+        }
+    } else if (isPcm24) {
+        for (size_t i = 0; i < sampleCount; ++i, src += 3) {
+            // Place the 24-bit value in the top of an int32 to sign-extend it
+            int32_t value = static_cast<int32_t>(
+                (static_cast<uint32_t>(src[0]) << 8) |
+                (static_cast<uint32_t>(src[1]) << 16) |
+                (static_cast<uint32_t>(src[2]) << 24)) >> 8;
+            dst[i] = static_cast<float>(value) * (1.0f / 8388608.0f);
+        }
+    } else {
+        std::memcpy(dst, src, sampleCount * sizeof(float));
+    }
+
+    if (error) *error = WavError::None;
+    return true;
+}
+
+std::vector<uint8_t> encodeWav(const PcmBuffer& pcm) {
+    uint32_t dataBytes = static_cast<uint32_t>(pcm.samples.size() * sizeof(float));
+    uint16_t blockAlign = static_cast<uint16_t>(pcm.channelCount * sizeof(float));
+
+    std::vector<uint8_t> out;
+    out.reserve(44 + dataBytes);
+    writeTag(out, "RIFF");
+    writeU32(out, 36 + dataBytes);
+    writeTag(out, "WAVE");
+
+    writeTag(out, "fmt ");
+    writeU32(out, 16);
+    writeU16(out, kFormatFloat);
+    writeU16(out, static_cast<uint16_t>(pcm.channelCount));
+    writeU32(out, static_cast<uint32_t>(pcm.sampleRate));
+    writeU32(out, static_cast<uint32_t>(pcm.sampleRate) * blockAlign);
+    writeU16(out, blockAlign);
+    writeU16(out, 32);
+
+    writeTag(out, "data");
+    writeU32(out, dataBytes);
+    for (float sample : pcm.samples) {
+        uint32_t bits;
+        std::memcpy(&bits, &sample, sizeof(bits));
+        writeU32(out, bits);
+    }
+    return out;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,53 @@
+#ifndef TRASHPILES_WAV_DECODER_H
+#define TRASHPILES_WAV_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Decoded PCM audio - interleaved float samples in [-1, 1]
+ */
+struct PcmBuffer {
+    std::vector<float> samples;
+    int channelCount = 0;
+    int sampleRate = 0;
+
+    size_t frameCount() const {
+        return channelCount > 0 ? samples.size() / channelCount : 0;
+    }
+};
+
+enum class WavError {
+    None,
+    NotRiff,
+    NotWave,
+    MissingFormat,
+    MissingData,
+    UnsupportedEncoding,
+    UnsupportedChannels,
+    Truncated
+};
+
+const char* wavErrorText(WavError error);
+
+/**
+ * RIFF/WAVE parser
+ * Walks the chunk list instead of assuming a 44-byte header, so files with
+ * LIST/fact/cue chunks (or data placed before fmt) load correctly.
+ * Supports PCM16, PCM24 and IEEE float32, mono or stereo, including
+ * WAVE_FORMAT_EXTENSIBLE wrappers of those encodings.
+ */
+bool decodeWav(const uint8_t* data, size_t size, PcmBuffer& out, WavError* error = nullptr);
+
+/**
+ * Serializes a buffer as an IEEE float32 WAV, so decodeWav reads it back
+ * bit-exactly (used for offline renders)
+ */
+std::vector<uint8_t> encodeWav(const PcmBuffer& pcm);
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_WAV_DECODER_H
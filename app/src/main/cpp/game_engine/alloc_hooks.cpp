@@ -0,0 +1,71 @@
+// Global operator new/delete replacements that feed AllocTracker
+// Linked only into builds that measure allocations
+// (TRASHPILES_ALLOC_TRACKING); a program gets at most one copy.
+
+#include "alloc_tracker.h"
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+struct HookRegistration {
+    HookRegistration() { TrashPiles::AllocTracker::markHooked(); }
+} g_hookRegistration;
+
+void* allocate(size_t size) {
+    TrashPiles::AllocTracker::recordAllocation(size);
+    return std::malloc(size ? size : 1);
+}
+
+void* allocateAligned(size_t size, std::align_val_t alignment) {
+    TrashPiles::AllocTracker::recordAllocation(size);
+    size_t align = static_cast<size_t>(alignment);
+    if (align < sizeof(void*)) align = sizeof(void*);
+    void* pointer = nullptr;
+    return posix_memalign(&pointer, align, size ? size : 1) == 0 ? pointer : nullptr;
+}
+
+// Built without exceptions on Android, so running out of memory aborts
+void* allocateOrAbort(void* pointer) {
+    if (!pointer) std::abort();
+    return pointer;
+}
+
+void release(void* pointer) {
+    if (!pointer) return;
+    TrashPiles::AllocTracker::recordFree();
+    std::free(pointer);
+}
+
+} // namespace
+
+void* operator new(size_t size) { return allocateOrAbort(allocate(size)); }
+void* operator new[](size_t size) { return allocateOrAbort(allocate(size)); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return allocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    return allocateOrAbort(allocateAligned(size, alignment));
+}
+void* operator new[](size_t size, std::align_val_t alignment) {
+    return allocateOrAbort(allocateAligned(size, alignment));
+}
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return allocateAligned(size, alignment);
+}
+
+void operator delete(void* pointer) noexcept { release(pointer); }
+void operator delete[](void* pointer) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t) noexcept { release(pointer); }
+void operator delete(void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete[](void* pointer, size_t, std::align_val_t) noexcept { release(pointer); }
+void operator delete(void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer); }
+void operator delete[](void* pointer, std::align_val_t, const std::nothrow_t&) noexcept { release(pointer); }
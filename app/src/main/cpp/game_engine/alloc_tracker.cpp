@@ -0,0 +1,154 @@
+#include "alloc_tracker.h"
+#include <atomic>
+#include <mutex>
+
+namespace TrashPiles {
+
+namespace {
+
+struct SubsystemCounters {
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+};
+
+SubsystemCounters g_subsystems[AllocTracker::kSubsystemCount];
+std::atomic<uint64_t> g_sizeBuckets[AllocTracker::kSizeBuckets];
+std::atomic<uint64_t> g_frees{0};
+std::atomic<bool> g_hooked{false};
+
+thread_local AllocSubsystem t_subsystem = AllocSubsystem::Other;
+
+// Frame history; written by markFrame(), read by frameStats()
+std::mutex g_frameLock;
+AllocTracker::FrameStats g_frameStats;
+AllocTracker::Counts g_frameStart[AllocTracker::kSubsystemCount];
+
+int frameBucket(uint64_t allocations) {
+    int bucket = 0;
+    while (allocations > 0 && bucket < AllocTracker::kFrameBuckets - 1) {
+        allocations >>= 1;
+        ++bucket;
+    }
+    return bucket;
+}
+
+} // namespace
+
+const char* allocSubsystemName(AllocSubsystem subsystem) {
+    switch (subsystem) {
+        case AllocSubsystem::Other: return "other";
+        case AllocSubsystem::Renderer: return "renderer";
+        case AllocSubsystem::Audio: return "audio";
+        case AllocSubsystem::Game: return "game";
+        case AllocSubsystem::Jni: return "jni";
+        case AllocSubsystem::Jobs: return "jobs";
+        case AllocSubsystem::Count: break;
+    }
+    return "unknown";
+}
+
+void AllocTracker::recordAllocation(size_t size) {
+    SubsystemCounters& counters = g_subsystems[static_cast<int>(t_subsystem)];
+    counters.allocations.fetch_add(1, std::memory_order_relaxed);
+    counters.bytes.fetch_add(size, std::memory_order_relaxed);
+    g_sizeBuckets[sizeBucket(size)].fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocTracker::recordFree() {
+    g_frees.fetch_add(1, std::memory_order_relaxed);
+}
+
+void AllocTracker::markHooked() {
+    g_hooked.store(true, std::memory_order_relaxed);
+}
+
+bool AllocTracker::isHooked() {
+    return g_hooked.load(std::memory_order_relaxed);
+}
+
+AllocSubsystem AllocTracker::currentSubsystem() {
+    return t_subsystem;
+}
+
+void AllocTracker::setCurrentSubsystem(AllocSubsystem subsystem) {
+    t_subsystem = subsystem < AllocSubsystem::Count ? subsystem : AllocSubsystem::Other;
+}
+
+int AllocTracker::sizeBucket(size_t size) {
+    int bucket = 0;
+    for (size_t limit = 16; size > limit && bucket < kSizeBuckets - 1; limit <<= 1) {
+        ++bucket;
+    }
+    return bucket;
+}
+
+void AllocTracker::markFrame() {
+    std::lock_guard<std::mutex> lock(g_frameLock);
+
+    Counts frame;
+    for (int s = 0; s < kSubsystemCount; ++s) {
+        Counts now = total(static_cast<AllocSubsystem>(s));
+        Counts& delta = g_frameStats.lastFrameBySubsystem[s];
+        delta.allocations = now.allocations - g_frameStart[s].allocations;
+        delta.bytes = now.bytes - g_frameStart[s].bytes;
+        frame.allocations += delta.allocations;
+        frame.bytes += delta.bytes;
+        g_frameStart[s] = now;
+    }
+
+    ++g_frameStats.frames;
+    if (frame.allocations == 0) ++g_frameStats.allocationFreeFrames;
+    if (frame.allocations > g_frameStats.maxFrameAllocations) {
+        g_frameStats.maxFrameAllocations = frame.allocations;
+    }
+    ++g_frameStats.frameHistogram[frameBucket(frame.allocations)];
+    g_frameStats.lastFrame = frame;
+}
+
+AllocTracker::Counts AllocTracker::total(AllocSubsystem subsystem) {
+    const SubsystemCounters& counters = g_subsystems[static_cast<int>(subsystem)];
+    Counts counts;
+    counts.allocations = counters.allocations.load(std::memory_order_relaxed);
+    counts.bytes = counters.bytes.load(std::memory_order_relaxed);
+    return counts;
+}
+
+AllocTracker::Counts AllocTracker::total() {
+    Counts sum;
+    for (int s = 0; s < kSubsystemCount; ++s) {
+        Counts counts = total(static_cast<AllocSubsystem>(s));
+        sum.allocations += counts.allocations;
+        sum.bytes += counts.bytes;
+    }
+    return sum;
+}
+
+uint64_t AllocTracker::frees() {
+    return g_frees.load(std::memory_order_relaxed);
+}
+
+uint64_t AllocTracker::sizeBucketCount(int bucket) {
+    if (bucket < 0 || bucket >= kSizeBuckets) return 0;
+    return g_sizeBuckets[bucket].load(std::memory_order_relaxed);
+}
+
+AllocTracker::FrameStats AllocTracker::frameStats() {
+    std::lock_guard<std::mutex> lock(g_frameLock);
+    return g_frameStats;
+}
+
+void AllocTracker::reset() {
+    std::lock_guard<std::mutex> lock(g_frameLock);
+    for (int s = 0; s < kSubsystemCount; ++s) {
+        g_subsystems[s].allocations.store(0, std::memory_order_relaxed);
+        g_subsystems[s].bytes.store(0, std::memory_order_relaxed);
+        g_frameStart[s] = Counts();
+    }
+    for (auto& bucket : g_sizeBuckets) {
+        bucket.store(0, std::memory_order_relaxed);
+    }
+    g_frees.store(0, std::memory_order_relaxed);
+    g_frameStats = FrameStats();
+}
+
+} // namespace TrashPiles
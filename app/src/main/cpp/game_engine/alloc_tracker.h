@@ -0,0 +1,101 @@
+#ifndef TRASHPILES_ALLOC_TRACKER_H
+#define TRASHPILES_ALLOC_TRACKER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace TrashPiles {
+
+// Who a heap allocation is charged to: the innermost AllocScope on the
+// allocating thread, Other outside any scope
+enum class AllocSubsystem : uint8_t {
+    Other = 0,
+    Renderer,
+    Audio,
+    Game,
+    Jni,
+    Jobs,
+    Count
+};
+
+const char* allocSubsystemName(AllocSubsystem subsystem);
+
+/**
+ * Heap allocation accounting
+ * Counts come from the global operator new replacements in alloc_hooks.cpp,
+ * which are only linked into builds with TRASHPILES_ALLOC_TRACKING; without
+ * them every count stays zero and isHooked() is false. Totals are kept per
+ * subsystem and per size bucket. markFrame() closes a frame, so frame
+ * stats cover every thread's allocations between two marks.
+ */
+class AllocTracker {
+public:
+    static constexpr int kSubsystemCount = static_cast<int>(AllocSubsystem::Count);
+
+    // Allocation sizes: up to 16 bytes, then powers of two up to 32 KB, then larger
+    static constexpr int kSizeBuckets = 13;
+
+    // Allocations per frame: 0, 1, up to 3, up to 7 ... up to 63, more
+    static constexpr int kFrameBuckets = 8;
+
+    struct Counts {
+        uint64_t allocations = 0;
+        uint64_t bytes = 0;
+    };
+
+    struct FrameStats {
+        uint64_t frames = 0;
+        uint64_t allocationFreeFrames = 0;
+        uint64_t maxFrameAllocations = 0;
+        Counts lastFrame;
+        Counts lastFrameBySubsystem[kSubsystemCount];
+        uint64_t frameHistogram[kFrameBuckets] = {};
+    };
+
+    // From the operator new/delete hooks; must not allocate
+    static void recordAllocation(size_t size);
+    static void recordFree();
+    static void markHooked();
+    static bool isHooked();
+
+    static AllocSubsystem currentSubsystem();
+    static void setCurrentSubsystem(AllocSubsystem subsystem);
+
+    // Ends the current frame; call once per frame from one thread
+    static void markFrame();
+
+    static Counts total(AllocSubsystem subsystem);
+    static Counts total();
+    static uint64_t frees();
+    static uint64_t sizeBucketCount(int bucket);
+    static int sizeBucket(size_t size);
+    static FrameStats frameStats();
+
+    // Zero every counter and the frame history
+    static void reset();
+};
+
+/**
+ * Charges heap allocations on this thread to a subsystem until it leaves
+ * scope; nests
+ */
+class AllocScope {
+public:
+    explicit AllocScope(AllocSubsystem subsystem) : m_previous(AllocTracker::currentSubsystem()) {
+        AllocTracker::setCurrentSubsystem(subsystem);
+    }
+
+    ~AllocScope() {
+        AllocTracker::setCurrentSubsystem(m_previous);
+    }
+
+    AllocScope(const AllocScope&) = delete;
+    AllocScope& operator=(const AllocScope&) = delete;
+
+private:
+    AllocSubsystem m_previous;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_ALLOC_TRACKER_H
@@ -0,0 +1,211 @@
+#include "engine_context.h"
+#include "../renderer/renderer_wrapper.h"
+#include "../audio/audio_wrapper.h"
+#include "game_engine_wrapper.h"
+#include <android/log.h>
+
+// The wrapper headers each define LOG_TAG for their own sources, so this
+// file logs through its own macros rather than redefining theirs
+#define ENGINE_LOG_TAG "TrashPiles-Engine"
+#define ENGINE_LOGI(...) __android_log_print(ANDROID_LOG_INFO, ENGINE_LOG_TAG, __VA_ARGS__)
+#define ENGINE_LOGE(...) __android_log_print(ANDROID_LOG_ERROR, ENGINE_LOG_TAG, __VA_ARGS__)
+
+namespace TrashPiles {
+
+// Three stages can overlap at the start: streams, surface and game engine
+static constexpr int kStartupWorkers = 3;
+
+static int64_t nanosBetween(EngineContext::Clock::time_point from, EngineContext::Clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count();
+}
+
+EngineContext& EngineContext::instance() {
+    // Constructed by JNI_OnLoad, which makes it the time origin
+    static EngineContext context;
+    return context;
+}
+
+EngineContext::EngineContext()
+    : m_loadTime(Clock::now()) {
+}
+
+RendererWrapper* EngineContext::renderer() {
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    if (!m_renderer) {
+        m_renderer.reset(new RendererWrapper());
+        m_renderer->attachEventBus(&m_events);
+    }
+    return m_renderer.get();
+}
+
+AudioWrapper* EngineContext::audio() {
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    if (!m_audio) {
+        m_audio.reset(new AudioWrapper());
+        m_audio->attachEventBus(&m_events);
+    }
+    return m_audio.get();
+}
+
+GameEngineWrapper* EngineContext::gameEngine() {
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    if (!m_gameEngine) {
+        m_gameEngine.reset(new GameEngineWrapper());
+        m_gameEngine->attachEventBus(&m_events);
+    }
+    return m_gameEngine.get();
+}
+
+void EngineContext::releaseRenderer() {
+    awaitStartup();
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    m_renderer.reset();
+}
+
+void EngineContext::releaseAudio() {
+    awaitStartup();
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    m_audio.reset();
+}
+
+void EngineContext::releaseGameEngine() {
+    awaitStartup();
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    m_gameEngine.reset();
+}
+
+bool EngineContext::start(int surfaceWidth, int surfaceHeight) {
+    std::lock_guard<std::mutex> lock(m_graphLock);
+    if (m_graph) {
+        ENGINE_LOGE("Engine startup already running");
+        return false;
+    }
+
+    // Subsystems are constructed inside their stages, on the worker threads
+    std::unique_ptr<StartupGraph> graph(new StartupGraph());
+    graph->addStage(kStageGameEngine, [this]() {
+        return gameEngine()->initialize();
+    });
+    graph->addStage(kStageRendererSurface, [this, surfaceWidth, surfaceHeight]() {
+        return renderer()->initialize(surfaceWidth, surfaceHeight);
+    });
+    auto streams = graph->addStage(kStageAudioStreams, [this]() {
+        return audio()->openStreams();
+    });
+
+    // Banks are decoded at the stream rate, so they wait for the streams
+    graph->addStage(kStageSoundBank, [this]() {
+        return audio()->loadSoundBank();
+    }, {streams});
+    graph->addStage(kStageMusicBank, [this]() {
+        return audio()->loadMusicBank();
+    }, {streams});
+
+    m_graph = std::move(graph);
+    ENGINE_LOGI("Engine startup launched %.2f ms after load",
+         nanosBetween(m_loadTime, Clock::now()) / 1e6);
+    return m_graph->start(kStartupWorkers);
+}
+
+bool EngineContext::isStarted() const {
+    std::lock_guard<std::mutex> lock(m_graphLock);
+    return m_graph != nullptr;
+}
+
+std::shared_future<bool> EngineContext::stageFuture(const char* stage) const {
+    std::lock_guard<std::mutex> lock(m_graphLock);
+    if (!m_graph) return std::shared_future<bool>();
+    return m_graph->ready(m_graph->find(stage));
+}
+
+bool EngineContext::isStageReady(const char* stage) const {
+    std::lock_guard<std::mutex> lock(m_graphLock);
+    return m_graph && m_graph->isReady(m_graph->find(stage));
+}
+
+bool EngineContext::awaitStage(const char* stage, int64_t timeoutMillis) const {
+    std::shared_future<bool> ready = stageFuture(stage);
+    if (!ready.valid()) return false;
+
+    if (timeoutMillis >= 0 &&
+        ready.wait_for(std::chrono::milliseconds(timeoutMillis)) != std::future_status::ready) {
+        return false;
+    }
+    return ready.get();
+}
+
+bool EngineContext::awaitStartup() {
+    // Waits on copies of the stage futures rather than join(), so status
+    // queries are not locked out for the whole startup
+    std::vector<std::shared_future<bool>> stages;
+    {
+        std::lock_guard<std::mutex> lock(m_graphLock);
+        if (!m_graph || !m_graph->isStarted()) return false;
+        for (StartupGraph::StageId id = 0; id < m_graph->stageCount(); ++id) {
+            stages.push_back(m_graph->ready(id));
+        }
+    }
+
+    bool succeeded = true;
+    for (const auto& stage : stages) {
+        succeeded = stage.get() && succeeded;
+    }
+    return succeeded;
+}
+
+void EngineContext::markFirstFrame() {
+    int64_t expected = -1;
+    if (m_firstFrameNanos.compare_exchange_strong(expected, nanosBetween(m_loadTime, Clock::now()),
+                                                  std::memory_order_acq_rel)) {
+        logStartup();
+    }
+}
+
+std::vector<StartupGraph::StageTiming> EngineContext::startupTimings() const {
+    std::lock_guard<std::mutex> lock(m_graphLock);
+    if (!m_graph) return {};
+
+    // Rebase from graph start onto library load
+    int64_t offset = nanosBetween(m_loadTime, m_graph->startTime());
+    std::vector<StartupGraph::StageTiming> timings = m_graph->timings();
+    for (auto& timing : timings) {
+        if (timing.startNanos >= 0) timing.startNanos += offset;
+        if (timing.endNanos >= 0) timing.endNanos += offset;
+    }
+    return timings;
+}
+
+void EngineContext::logStartup() const {
+    ENGINE_LOGI("First frame %.2f ms after load", firstFrameNanos() / 1e6);
+    for (const auto& timing : startupTimings()) {
+        if (timing.endNanos < 0) {
+            ENGINE_LOGI("  %-18s pending", timing.name.c_str());
+        } else if (timing.startNanos < 0) {
+            ENGINE_LOGI("  %-18s skipped", timing.name.c_str());
+        } else {
+            ENGINE_LOGI("  %-18s %s at %.2f ms, took %.2f ms", timing.name.c_str(),
+                 timing.state == StartupGraph::State::Succeeded ? "ready" : "FAILED",
+                 timing.startNanos / 1e6, (timing.endNanos - timing.startNanos) / 1e6);
+        }
+    }
+}
+
+void EngineContext::shutdown() {
+    awaitStartup();
+
+    // The graph joins its workers on destruction, which happens outside the lock
+    std::unique_ptr<StartupGraph> graph;
+    {
+        std::lock_guard<std::mutex> lock(m_graphLock);
+        graph = std::move(m_graph);
+    }
+    graph.reset();
+
+    std::lock_guard<std::mutex> lock(m_subsystemLock);
+    m_renderer.reset();
+    m_audio.reset();
+    m_gameEngine.reset();
+    m_firstFrameNanos.store(-1, std::memory_order_release);
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,105 @@
+#ifndef TRASHPILES_ENGINE_CONTEXT_H
+#define TRASHPILES_ENGINE_CONTEXT_H
+
+#include "startup_graph.h"
+#include "../gcms/event_bus.h"
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace TrashPiles {
+
+class RendererWrapper;
+class AudioWrapper;
+class GameEngineWrapper;
+
+// Startup stage names, as reported in timings and accepted by awaitStage()
+constexpr const char* kStageGameEngine = "game.engine";
+constexpr const char* kStageRendererSurface = "renderer.surface";
+constexpr const char* kStageAudioStreams = "audio.streams";
+constexpr const char* kStageSoundBank = "audio.sound_bank";
+constexpr const char* kStageMusicBank = "audio.music_bank";
+
+/**
+ * Engine Context - the one owner of the native subsystems
+ * Subsystems are constructed on first use rather than at library load.
+ * start() launches the startup graph: stream open, surface creation and
+ * the game engine run side by side on worker threads, and the two bank
+ * loads follow the streams. Every stage has a readiness future and its
+ * timing, measured from library load, as is the first presented frame.
+ */
+class EngineContext {
+public:
+    using Clock = StartupGraph::Clock;
+
+    static EngineContext& instance();
+
+    // Lazily constructed; never null
+    RendererWrapper* renderer();
+    AudioWrapper* audio();
+    GameEngineWrapper* gameEngine();
+
+    // Game events; the game engine publishes its core's results here and the
+    // renderer and audio subscribe as they are constructed
+    EventBus& events() { return m_events; }
+
+    // Destroys a subsystem once startup no longer uses it; the next accessor
+    // call constructs a fresh one. The pointer an accessor returned dangles
+    // from here on: the Kotlin side must stop calling into the subsystem's
+    // bridge, and native code must drop any pointer it kept, before the
+    // release. The JNI bridges look the subsystem up on every call for this
+    // reason.
+    void releaseRenderer();
+    void releaseAudio();
+    void releaseGameEngine();
+
+    // Launches the startup graph; false if it is already running
+    bool start(int surfaceWidth, int surfaceHeight);
+    bool isStarted() const;
+
+    // Readiness: awaitStage returns false on failure, skip or timeout
+    bool isStageReady(const char* stage) const;
+    bool awaitStage(const char* stage, int64_t timeoutMillis) const;
+    bool awaitStartup();
+
+    // Called after each presented frame; only the first one is recorded
+    void markFirstFrame();
+
+    // Stage timings relative to library load
+    std::vector<StartupGraph::StageTiming> startupTimings() const;
+    int64_t firstFrameNanos() const { return m_firstFrameNanos.load(std::memory_order_acquire); }
+
+    // Waits for startup, then destroys every subsystem
+    void shutdown();
+
+private:
+    EngineContext();
+    ~EngineContext() = default;
+
+    EngineContext(const EngineContext&) = delete;
+    EngineContext& operator=(const EngineContext&) = delete;
+
+    Clock::time_point m_loadTime;
+    std::atomic<int64_t> m_firstFrameNanos{-1};
+
+    // Declared before the subsystems so it outlives their subscriptions
+    EventBus m_events;
+
+    // Guards the subsystem pointers, not the subsystems themselves
+    std::mutex m_subsystemLock;
+    std::unique_ptr<RendererWrapper> m_renderer;
+    std::unique_ptr<AudioWrapper> m_audio;
+    std::unique_ptr<GameEngineWrapper> m_gameEngine;
+
+    mutable std::mutex m_graphLock;
+    std::unique_ptr<StartupGraph> m_graph;
+
+    std::shared_future<bool> stageFuture(const char* stage) const;
+    void logStartup() const;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_ENGINE_CONTEXT_H
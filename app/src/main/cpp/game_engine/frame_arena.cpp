@@ -0,0 +1,42 @@
+#include "frame_arena.h"
+#include <algorithm>
+#include <cstring>
+
+namespace TrashPiles {
+
+FrameArena::FrameArena(size_t capacity)
+    : m_block(new unsigned char[capacity]),
+      m_capacity(capacity),
+      m_used(0),
+      m_highWater(0),
+      m_overflows(0) {
+}
+
+void* FrameArena::allocate(size_t size, size_t alignment) {
+    uintptr_t base = reinterpret_cast<uintptr_t>(m_block.get());
+    uintptr_t start = (base + m_used + alignment - 1) & ~(static_cast<uintptr_t>(alignment) - 1);
+    size_t offset = static_cast<size_t>(start - base);
+    if (offset > m_capacity || size > m_capacity - offset) {
+        ++m_overflows;
+        return nullptr;
+    }
+
+    m_used = offset + size;
+    m_highWater = std::max(m_highWater, m_used);
+    return m_block.get() + offset;
+}
+
+char* FrameArena::copyString(const char* text, size_t length) {
+    char* copy = static_cast<char*>(allocate(length + 1, 1));
+    if (!copy) return nullptr;
+
+    std::memcpy(copy, text, length);
+    copy[length] = '\0';
+    return copy;
+}
+
+void FrameArena::reset() {
+    m_used = 0;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,62 @@
+#ifndef TRASHPILES_FRAME_ARENA_H
+#define TRASHPILES_FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+
+namespace TrashPiles {
+
+/**
+ * Bump allocator for data that lives for one frame
+ * One block is allocated up front; allocate() hands out aligned pieces of
+ * it and reset() takes them all back at once, so per-frame scratch costs
+ * no heap traffic. Nothing is destructed: only trivially destructible
+ * types go in. Allocation fails (null) rather than growing, so callers
+ * keep a fallback and overflows() shows the block is too small.
+ * Single-threaded: owned and used by one thread.
+ */
+class FrameArena {
+public:
+    static constexpr size_t kDefaultCapacity = 64 * 1024;
+
+    explicit FrameArena(size_t capacity = kDefaultCapacity);
+
+    FrameArena(const FrameArena&) = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // alignment must be a power of two
+    void* allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template <typename T>
+    T* allocateArray(size_t count) {
+        static_assert(std::is_trivially_destructible<T>::value, "Arena memory is never destructed");
+        if (count > (capacity() - used()) / sizeof(T)) {
+            ++m_overflows;
+            return nullptr;
+        }
+        return static_cast<T*>(allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // NUL-terminated copy of length bytes of text
+    char* copyString(const char* text, size_t length);
+
+    void reset();
+
+    size_t capacity() const { return m_capacity; }
+    size_t used() const { return m_used; }
+    size_t highWater() const { return m_highWater; }    // Most used in any frame
+    uint64_t overflows() const { return m_overflows; }  // Failed allocations
+
+private:
+    std::unique_ptr<unsigned char[]> m_block;
+    size_t m_capacity;
+    size_t m_used;
+    size_t m_highWater;
+    uint64_t m_overflows;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_FRAME_ARENA_H
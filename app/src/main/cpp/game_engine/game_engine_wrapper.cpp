@@ -1,14 +1,20 @@
 #include "game_engine_wrapper.h"
+#include "alloc_tracker.h"
 
 namespace TrashPiles {
 
 GameEngineWrapper::GameEngineWrapper() 
-    : m_initialized(false), m_deltaTime(0.0f), m_fps(60) {
+    : m_core(m_stateBlock, nullptr),
+      m_hints(m_hintTable),
+      m_eventBus(nullptr),
+      m_uiSubscriber(nullptr),
+      m_initialized(false), m_deltaTime(0.0f), m_fps(60) {
     LOGI("GameEngineWrapper created");
 }
 
 GameEngineWrapper::~GameEngineWrapper() {
     cleanup();
+    attachEventBus(nullptr);
     LOGI("GameEngineWrapper destroyed");
 }
 
@@ -27,24 +33,96 @@ void GameEngineWrapper::cleanup() {
     
     LOGI("Cleaning up game engine wrapper");
     
+    m_jobs.reset();
     m_initialized = false;
 }
 
 void GameEngineWrapper::update(float deltaTime) {
+    TRACE_THREAD_NAME("game");
+    TRACE_SCOPE("game.update");
+    AllocScope allocScope(AllocSubsystem::Game);
     m_deltaTime = deltaTime;
     
-    // Native game loop update if needed
-    // Most game logic will be in Kotlin GCMS
+    // Everything submitted since the last tick, in one batch
+    m_core.tick();
+    
+    if (m_frameTasks.empty()) return;
+    
+    // Owned by the game thread, which joins in as worker 0 while it waits
+    if (!m_jobs) {
+        m_jobs.reset(new JobSystem());
+        LOGI("Job system started with %d workers", m_jobs->workerCount());
+    }
+    
+    JobCounter frame;
+    for (size_t i = 0; i < m_frameTasks.size(); ++i) {
+        int index = static_cast<int>(i);
+        Job* job = m_jobs->create(&GameEngineWrapper::runFrameTask, this, index, index + 1, &frame);
+        if (job) {
+            m_jobs->run(job);
+        } else {
+            // Ticked from a thread other than the one that started the jobs
+            runFrameTask(this, index, index + 1);
+        }
+    }
+    m_jobs->wait(frame);
+}
+
+void GameEngineWrapper::addFrameTask(const char* name, FrameTask task) {
+    if (!task) return;
+    
+    FrameTaskEntry entry;
+    entry.name = name ? name : "";
+    entry.traceName = Tracer::intern(entry.name.c_str());
+    entry.run = std::move(task);
+    m_frameTasks.push_back(std::move(entry));
+    LOGI("Frame task added: %s", m_frameTasks.back().name.c_str());
+}
+
+void GameEngineWrapper::runFrameTask(void* context, int begin, int end) {
+    GameEngineWrapper* self = static_cast<GameEngineWrapper*>(context);
+    for (int i = begin; i < end; ++i) {
+        FrameTaskEntry& task = self->m_frameTasks[i];
+        TRACE_SCOPE(task.traceName ? task.traceName : "frame.task");
+        task.run(*self->m_jobs, self->m_deltaTime);
+    }
+}
+
+void GameEngineWrapper::attachEventBus(EventBus* bus) {
+    if (m_eventBus) {
+        m_eventBus->unsubscribe(m_uiSubscriber);
+        m_uiSubscriber = nullptr;
+    }
+    
+    m_eventBus = bus;
+    m_core.setEventBus(bus);
+}
+
+int GameEngineWrapper::pollEvents(GameEvent* out, int maxCount) {
+    if (!m_eventBus) return 0;
+    if (!m_uiSubscriber) {
+        m_uiSubscriber = m_eventBus->subscribe("ui");
+        if (!m_uiSubscriber) {
+            LOGE("No free event bus subscriber slot for ui");
+            return 0;
+        }
+    }
+    
+    int count = 0;
+    while (count < maxCount && m_eventBus->poll(m_uiSubscriber, out[count])) {
+        ++count;
+    }
+    return count;
 }
 
 void GameEngineWrapper::handleTouchDown(float x, float y) {
-    LOGI("Touch down at: (%.2f, %.2f)", x, y);
+    TRACE_INSTANT("input.touchDown");
     
     // Handle touch input if needed from native side
 }
 
 void GameEngineWrapper::handleTouchUp(float x, float y) {
-    LOGI("Touch up at: (%.2f, %.2f)", x, y);
+    TRACE_INSTANT("input.touchUp");
     
     // Handle touch input if needed from native side
 }
@@ -2,6 +2,16 @@
 #define TRASHPILES_GAME_ENGINE_WRAPPER_H
 
 #include <android/log.h>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../gcms/state_block.h"
+#include "../gcms/game_core.h"
+#include "../gcms/hint_advisor.h"
+#include "../gcms/transposition_table.h"
+#include "../trace/trace.h"
+#include "job_system.h"
 
 #define LOG_TAG "TrashPiles-GameEngine"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -22,10 +32,22 @@ public:
     // Initialization
     bool initialize();
     void cleanup();
+    bool isInitialized() const { return m_initialized; }
     
     // Game loop support (if needed from native side)
     void update(float deltaTime);
     
+    // Per-frame subsystem work (animation advance, AI rollouts, asset
+    // decode). update() runs every task as its own job after the core tick
+    // and returns once all are done; a task may split itself further with
+    // parallelFor. Register from the game thread.
+    using FrameTask = std::function<void(JobSystem& jobs, float deltaTime)>;
+    void addFrameTask(const char* name, FrameTask task);
+    int getFrameTaskCount() const { return static_cast<int>(m_frameTasks.size()); }
+    
+    // Created by the first update(), on the game thread; null before that
+    JobSystem* jobs() { return m_jobs.get(); }
+    
     // Input handling support
     void handleTouchDown(float x, float y);
     void handleTouchUp(float x, float y);
@@ -35,7 +57,39 @@ public:
     float getDeltaTime() const;
     int getFPS() const;
     
+    // Game state mirror shared with the Kotlin UI
+    StateBlock& stateBlock() { return m_stateBlock; }
+    
+    // Native rules core; update() drains its command queue once per tick
+    GameCore& gameCore() { return m_core; }
+    void attachEventBus(EventBus* bus);
+    
+    // AI hints for the core's position, cached by position hash; the table
+    // may also be handed to AI search jobs
+    HintAdvisor& hintAdvisor() { return m_hints; }
+    TranspositionTable& hintTable() { return m_hintTable; }
+    
+    // Core events for the Kotlin side, which polls once per frame from one
+    // thread; subscribes on the first call
+    int pollEvents(GameEvent* out, int maxCount);
+    
 private:
+    struct FrameTaskEntry {
+        std::string name;
+        const char* traceName = nullptr;    // Interned copy of name
+        FrameTask run;
+    };
+    
+    static void runFrameTask(void* context, int begin, int end);
+    
+    StateBlock m_stateBlock;
+    GameCore m_core;
+    TranspositionTable m_hintTable;
+    HintAdvisor m_hints;
+    EventBus* m_eventBus;
+    EventBus::Subscriber* m_uiSubscriber;
+    std::unique_ptr<JobSystem> m_jobs;
+    std::vector<FrameTaskEntry> m_frameTasks;
     bool m_initialized;
     float m_deltaTime;
     int m_fps;
@@ -0,0 +1,348 @@
+#include "job_system.h"
+#include "alloc_tracker.h"
+#include "../trace/trace.h"
+#include <cstdio>
+
+namespace TrashPiles {
+
+static_assert((WorkStealingDeque::kCapacity & (WorkStealingDeque::kCapacity - 1)) == 0,
+              "Deque capacity must be a power of two");
+static_assert((JobSystem::kMaxJobsPerWorker & (JobSystem::kMaxJobsPerWorker - 1)) == 0,
+              "Job ring size must be a power of two");
+
+// Marks a counter whose continuations have already been released
+static Job* const kContinuationsFired = reinterpret_cast<Job*>(uintptr_t(1));
+
+// Spins before an idle worker goes to sleep
+static constexpr int kIdleSpins = 64;
+
+// Which job system and worker the calling thread belongs to
+struct WorkerIdentity {
+    const JobSystem* system = nullptr;
+    int index = -1;
+};
+static thread_local WorkerIdentity t_worker;
+
+void JobCounter::reset() {
+    m_pending.store(0, std::memory_order_relaxed);
+    m_continuations.store(nullptr, std::memory_order_release);
+}
+
+// ============================================================================
+// DEQUE
+// ============================================================================
+
+WorkStealingDeque::WorkStealingDeque() : m_jobs(new std::atomic<Job*>[kCapacity]) {
+    for (int64_t i = 0; i < kCapacity; ++i) {
+        m_jobs[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+bool WorkStealingDeque::push(Job* job) {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+    int64_t top = m_top.load(std::memory_order_acquire);
+    if (bottom - top >= kCapacity) return false;
+
+    // Release on the slot as well as bottom, so a thief that reads the slot
+    // also sees the job it points at
+    m_jobs[bottom & (kCapacity - 1)].store(job, std::memory_order_release);
+    m_bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+Job* WorkStealingDeque::pop() {
+    int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+    m_bottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = m_top.load(std::memory_order_relaxed);
+
+    if (top > bottom) {
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Job* job = m_jobs[bottom & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom) {
+        // Last job: race the thieves for it
+        if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+            job = nullptr;
+        }
+        m_bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return job;
+}
+
+Job* WorkStealingDeque::steal() {
+    int64_t top = m_top.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = m_bottom.load(std::memory_order_acquire);
+    if (top >= bottom) return nullptr;
+
+    Job* job = m_jobs[top & (kCapacity - 1)].load(std::memory_order_acquire);
+    if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                                       std::memory_order_relaxed)) {
+        return nullptr;
+    }
+    return job;
+}
+
+int64_t WorkStealingDeque::size() const {
+    int64_t size = m_bottom.load(std::memory_order_relaxed) - m_top.load(std::memory_order_relaxed);
+    return size > 0 ? size : 0;
+}
+
+// ============================================================================
+// WORKER COUNT
+// ============================================================================
+
+int JobSystem::selectWorkerCount(const std::vector<int64_t>& coreMaxFrequencies) {
+    int cores = static_cast<int>(coreMaxFrequencies.size());
+    if (cores <= 0) return 1;
+
+    int64_t slowest = 0;
+    int64_t fastest = 0;
+    for (int64_t frequency : coreMaxFrequencies) {
+        if (frequency <= 0) continue;
+        slowest = slowest == 0 ? frequency : std::min(slowest, frequency);
+        fastest = std::max(fastest, frequency);
+    }
+
+    // Homogeneous or unknown: every core. Otherwise leave the LITTLE cluster
+    // to the audio callback, the UI thread and the OS; a job split across
+    // mixed cores finishes at the pace of its slowest chunk.
+    int count = cores;
+    if (slowest > 0 && slowest < fastest) {
+        count = static_cast<int>(std::count_if(coreMaxFrequencies.begin(), coreMaxFrequencies.end(),
+                                               [slowest](int64_t frequency) { return frequency > slowest; }));
+    }
+    return std::min(std::max(count, 1), kMaxWorkers);
+}
+
+int JobSystem::recommendedWorkerCount() {
+    int cores = static_cast<int>(std::thread::hardware_concurrency());
+    if (cores <= 0) return 1;
+
+    std::vector<int64_t> frequencies(cores, 0);
+    for (int core = 0; core < cores; ++core) {
+        char path[96];
+        std::snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", core);
+        if (FILE* file = std::fopen(path, "r")) {
+            long long frequency = 0;
+            if (std::fscanf(file, "%lld", &frequency) == 1) frequencies[core] = frequency;
+            std::fclose(file);
+        }
+    }
+    return selectWorkerCount(frequencies);
+}
+
+// ============================================================================
+// JOB SYSTEM
+// ============================================================================
+
+JobSystem::JobSystem(int workerCount)
+    : m_workerCount(std::min(std::max(workerCount, 1), kMaxWorkers)),
+      m_workers(new Worker[m_workerCount]) {
+    for (int i = 0; i < m_workerCount; ++i) {
+        m_workers[i].jobs.reset(new Job[kMaxJobsPerWorker]);
+        m_workers[i].random = 0x9E3779B9u * static_cast<uint32_t>(i + 1);
+    }
+
+    t_worker.system = this;
+    t_worker.index = 0;
+    for (int i = 1; i < m_workerCount; ++i) {
+        m_threads.emplace_back(&JobSystem::workerLoop, this, i);
+    }
+}
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(m_sleepLock);
+        m_running.store(false, std::memory_order_release);
+    }
+    m_wake.notify_all();
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+    if (t_worker.system == this) t_worker = WorkerIdentity();
+}
+
+int JobSystem::currentWorker() const {
+    return t_worker.system == this ? t_worker.index : -1;
+}
+
+Job* JobSystem::create(JobFunction function, void* context, int begin, int end, JobCounter* counter) {
+    int worker = currentWorker();
+    if (worker < 0) return nullptr;
+
+    Worker& self = m_workers[worker];
+    Job* job = &self.jobs[self.nextJob++ & (kMaxJobsPerWorker - 1)];
+    job->function = function;
+    job->context = context;
+    job->begin = begin;
+    job->end = end;
+    job->counter = counter;
+    job->next = nullptr;
+    return job;
+}
+
+void JobSystem::run(Job* job) {
+    if (!job) return;
+    if (job->counter) job->counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+    schedule(job);
+}
+
+void JobSystem::runAfter(JobCounter& dependency, Job* job) {
+    if (!job) return;
+    if (job->counter) job->counter->m_pending.fetch_add(1, std::memory_order_relaxed);
+
+    if (dependency.isDone()) {
+        schedule(job);
+        return;
+    }
+
+    Job* head = dependency.m_continuations.load(std::memory_order_acquire);
+    for (;;) {
+        if (head == kContinuationsFired) {
+            schedule(job);
+            return;
+        }
+        job->next = head;
+        if (dependency.m_continuations.compare_exchange_weak(head, job, std::memory_order_acq_rel,
+                                                             std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+void JobSystem::wait(const JobCounter& counter) {
+    int worker = currentWorker();
+    while (!counter.isDone()) {
+        Job* job = worker >= 0 ? take(worker) : nullptr;
+        if (job) {
+            execute(worker, job);
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+JobSystem::Stats JobSystem::stats() const {
+    Stats total;
+    for (int i = 0; i < m_workerCount; ++i) {
+        total.executed += m_workers[i].executed.load(std::memory_order_relaxed);
+        total.stolen += m_workers[i].stolen.load(std::memory_order_relaxed);
+        total.inlined += m_workers[i].inlined.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+void JobSystem::schedule(Job* job) {
+    int worker = currentWorker();
+    if (worker < 0) {
+        // Continuations released by a foreign thread have no deque to go to
+        job->function(job->context, job->begin, job->end);
+        finish(job);
+        return;
+    }
+
+    if (!m_workers[worker].deque.push(job)) {
+        m_workers[worker].inlined.fetch_add(1, std::memory_order_relaxed);
+        execute(worker, job);
+        return;
+    }
+
+    // Wake a sleeper; the counters are seq_cst so either it sees the job or
+    // we see it asleep
+    m_queued.fetch_add(1, std::memory_order_seq_cst);
+    if (m_sleeping.load(std::memory_order_seq_cst) > 0) {
+        { std::lock_guard<std::mutex> lock(m_sleepLock); }
+        m_wake.notify_one();
+    }
+}
+
+Job* JobSystem::take(int worker) {
+    Worker& self = m_workers[worker];
+    Job* job = self.deque.pop();
+    if (!job && m_workerCount > 1) {
+        // Random victims so thieves do not all pile onto the same deque
+        for (int attempt = 0; attempt < m_workerCount && !job; ++attempt) {
+            self.random ^= self.random << 13;
+            self.random ^= self.random >> 17;
+            self.random ^= self.random << 5;
+            int victim = static_cast<int>(self.random % static_cast<uint32_t>(m_workerCount));
+            if (victim == worker) continue;
+            job = m_workers[victim].deque.steal();
+            if (job) self.stolen.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    if (job) m_queued.fetch_sub(1, std::memory_order_relaxed);
+    return job;
+}
+
+void JobSystem::execute(int worker, Job* job) {
+    TRACE_SCOPE("job");
+    job->function(job->context, job->begin, job->end);
+    m_workers[worker].executed.fetch_add(1, std::memory_order_relaxed);
+    finish(job);
+}
+
+void JobSystem::finish(Job* job) {
+    JobCounter* counter = job->counter;
+    if (!counter) return;
+
+    int pending = counter->m_pending.load(std::memory_order_acquire);
+    while (pending > 1) {
+        if (counter->m_pending.compare_exchange_weak(pending, pending - 1, std::memory_order_acq_rel,
+                                                     std::memory_order_acquire)) {
+            return;
+        }
+    }
+
+    // Last job of the group: take whatever was waiting on it before the
+    // count drops, since a waiter may free the counter once it reads zero
+    Job* continuation = counter->m_continuations.exchange(kContinuationsFired, std::memory_order_acq_rel);
+    counter->m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    while (continuation && continuation != kContinuationsFired) {
+        Job* next = continuation->next;
+        schedule(continuation);
+        continuation = next;
+    }
+}
+
+void JobSystem::workerLoop(int worker) {
+    t_worker.system = this;
+    t_worker.index = worker;
+    AllocTracker::setCurrentSubsystem(AllocSubsystem::Jobs);
+
+#ifdef TRASHPILES_TRACING
+    char name[24];
+    std::snprintf(name, sizeof(name), "job.worker.%d", worker);
+    Tracer::setThreadName(name);
+#endif
+
+    int idle = 0;
+    while (m_running.load(std::memory_order_acquire)) {
+        if (Job* job = take(worker)) {
+            execute(worker, job);
+            idle = 0;
+            continue;
+        }
+
+        if (++idle < kIdleSpins) {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_sleepLock);
+        m_sleeping.fetch_add(1, std::memory_order_seq_cst);
+        m_wake.wait(lock, [this]() {
+            return m_queued.load(std::memory_order_seq_cst) > 0 || !m_running.load(std::memory_order_acquire);
+        });
+        m_sleeping.fetch_sub(1, std::memory_order_seq_cst);
+        idle = 0;
+    }
+    t_worker = WorkerIdentity();
+}
+
+} // namespace TrashPiles
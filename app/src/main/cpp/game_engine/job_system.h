@@ -0,0 +1,192 @@
+#ifndef TRASHPILES_JOB_SYSTEM_H
+#define TRASHPILES_JOB_SYSTEM_H
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace TrashPiles {
+
+class JobSystem;
+struct Job;
+
+/**
+ * Completion counter for a group of jobs
+ * Every job run against a counter holds it up until it finishes. Jobs
+ * attached with JobSystem::runAfter() start once it drops to zero. Add
+ * the jobs a counter tracks before attaching continuations to it, and
+ * reset() it before reusing it for a new group.
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    int pending() const { return m_pending.load(std::memory_order_acquire); }
+    bool isDone() const { return pending() == 0; }
+    void reset();
+
+private:
+    friend class JobSystem;
+
+    std::atomic<int> m_pending{0};
+    std::atomic<Job*> m_continuations{nullptr};
+};
+
+using JobFunction = void (*)(void* context, int begin, int end);
+
+struct Job {
+    JobFunction function = nullptr;
+    void* context = nullptr;
+    int begin = 0;
+    int end = 0;
+    JobCounter* counter = nullptr;
+    Job* next = nullptr;        // Continuation list link
+};
+
+/**
+ * Chase-Lev work-stealing deque of jobs
+ * The owning worker pushes and pops at the bottom, LIFO, so it stays on
+ * its freshest (cache-warm) work; any other thread steals the oldest job
+ * from the top. Fixed capacity: push fails when full.
+ */
+class WorkStealingDeque {
+public:
+    static constexpr int64_t kCapacity = 4096;     // Power of two
+
+    WorkStealingDeque();
+
+    bool push(Job* job);    // Owner only
+    Job* pop();             // Owner only
+    Job* steal();           // Any thread
+
+    int64_t size() const;
+
+private:
+    alignas(64) std::atomic<int64_t> m_top{0};
+    alignas(64) std::atomic<int64_t> m_bottom{0};
+    std::unique_ptr<std::atomic<Job*>[]> m_jobs;
+};
+
+/**
+ * Work-stealing job system
+ * The thread that constructs it is worker 0 and takes part whenever it
+ * waits; workerCount - 1 more threads are started. Each worker has its
+ * own deque and a ring of job storage, so jobs are created and run from
+ * worker threads only, without locks or allocation. Idle workers steal
+ * from random victims, then sleep until more work is scheduled.
+ *
+ * Job storage is recycled in submission order: at most kMaxJobsPerWorker
+ * jobs created by one worker may be in flight at a time.
+ */
+class JobSystem {
+public:
+    static constexpr int kMaxWorkers = 16;
+    static constexpr int kMaxJobsPerWorker = 4096;
+
+    struct Stats {
+        uint64_t executed = 0;
+        uint64_t stolen = 0;
+        uint64_t inlined = 0;       // Run in place because a deque was full
+    };
+
+    // Threads to use on this device, counting the caller: the cores outside
+    // the slowest cluster on a big.LITTLE part, every core otherwise
+    static int recommendedWorkerCount();
+
+    // Pure form of the above; one entry per core, its max frequency in kHz
+    // (0 if unknown)
+    static int selectWorkerCount(const std::vector<int64_t>& coreMaxFrequencies);
+
+    explicit JobSystem(int workerCount = recommendedWorkerCount());
+    ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    int workerCount() const { return m_workerCount; }
+
+    // Worker threads only. Null when called from any other thread.
+    Job* create(JobFunction function, void* context, int begin = 0, int end = 0,
+                JobCounter* counter = nullptr);
+
+    // Schedule a created job now, or once dependency reaches zero
+    void run(Job* job);
+    void runAfter(JobCounter& dependency, Job* job);
+
+    // Runs other jobs until the counter reaches zero
+    void wait(const JobCounter& counter);
+
+    // Calls body(begin, end) over [0, count) in chunks of at least grain
+    // items across the workers and returns when all are done
+    template <typename Body>
+    void parallelFor(int count, int grain, Body&& body);
+
+    Stats stats() const;
+
+private:
+    struct alignas(64) Worker {
+        WorkStealingDeque deque;
+        std::unique_ptr<Job[]> jobs;
+        uint32_t nextJob = 0;
+        uint32_t random = 0;
+        std::atomic<uint64_t> executed{0};
+        std::atomic<uint64_t> stolen{0};
+        std::atomic<uint64_t> inlined{0};
+    };
+
+    int m_workerCount;
+    std::unique_ptr<Worker[]> m_workers;
+    std::vector<std::thread> m_threads;
+    std::atomic<bool> m_running{true};
+
+    // Sleep/wake for idle workers
+    std::mutex m_sleepLock;
+    std::condition_variable m_wake;
+    std::atomic<int> m_queued{0};
+    std::atomic<int> m_sleeping{0};
+
+    int currentWorker() const;
+    void schedule(Job* job);
+    Job* take(int worker);
+    void execute(int worker, Job* job);
+    void finish(Job* job);
+    void workerLoop(int worker);
+
+    template <typename Body>
+    static void invokeRange(void* context, int begin, int end) {
+        (*static_cast<typename std::remove_reference<Body>::type*>(context))(begin, end);
+    }
+};
+
+template <typename Body>
+void JobSystem::parallelFor(int count, int grain, Body&& body) {
+    if (count <= 0) return;
+
+    // A few chunks per worker leaves room to balance uneven items
+    int chunk = std::max(std::max(grain, 1), (count + m_workerCount * 4 - 1) / (m_workerCount * 4));
+    if (chunk >= count || currentWorker() < 0) {
+        body(0, count);
+        return;
+    }
+
+    JobCounter counter;
+    for (int begin = 0; begin < count; begin += chunk) {
+        Job* job = create(&invokeRange<Body>, const_cast<void*>(static_cast<const void*>(&body)),
+                          begin, std::min(begin + chunk, count), &counter);
+        run(job);
+    }
+    wait(counter);
+}
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_JOB_SYSTEM_H
@@ -0,0 +1,83 @@
+#ifndef TRASHPILES_MAPPED_ASSET_H
+#define TRASHPILES_MAPPED_ASSET_H
+
+#include <android/asset_manager.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <cstddef>
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Read-only mapping of an APK asset
+ * Uncompressed assets are mmapped straight from the APK file descriptor;
+ * compressed ones fall back to the asset manager's buffer, kept open for
+ * the mapping's lifetime.
+ */
+class MappedAsset {
+public:
+    MappedAsset() = default;
+    MappedAsset(const MappedAsset&) = delete;
+    MappedAsset& operator=(const MappedAsset&) = delete;
+    
+    ~MappedAsset() {
+        if (m_mapping) munmap(m_mapping, m_mappingSize);
+        if (m_asset) AAsset_close(m_asset);
+    }
+    
+    bool open(AAssetManager* manager, const char* path) {
+        AAsset* asset = AAssetManager_open(manager, path, AASSET_MODE_STREAMING);
+        if (!asset) return false;
+        
+        off64_t start = 0;
+        off64_t length = 0;
+        int fd = AAsset_openFileDescriptor64(asset, &start, &length);
+        AAsset_close(asset);
+        
+        if (fd >= 0) {
+            // mmap offsets must be page aligned; the asset may start mid-page
+            off64_t pageSize = sysconf(_SC_PAGESIZE);
+            off64_t pageOffset = start % pageSize;
+            m_mappingSize = static_cast<size_t>(length + pageOffset);
+            void* mapping = mmap(nullptr, m_mappingSize, PROT_READ, MAP_PRIVATE, fd, start - pageOffset);
+            close(fd);
+            if (mapping != MAP_FAILED) {
+                m_mapping = mapping;
+                m_data = static_cast<const uint8_t*>(mapping) + pageOffset;
+                m_size = static_cast<size_t>(length);
+                madvise(m_mapping, m_mappingSize, MADV_WILLNEED);
+                return true;
+            }
+        }
+        
+        m_asset = AAssetManager_open(manager, path, AASSET_MODE_BUFFER);
+        if (!m_asset) return false;
+        m_data = static_cast<const uint8_t*>(AAsset_getBuffer(m_asset));
+        m_size = static_cast<size_t>(AAsset_getLength(m_asset));
+        return m_data != nullptr;
+    }
+    
+    // Fault every page in now so first reads (e.g. the first play of a sound) don't
+    void prefault() const {
+        volatile uint8_t sink = 0;
+        for (size_t offset = 0; offset < m_size; offset += 4096) {
+            sink ^= m_data[offset];
+        }
+        (void)sink;
+    }
+    
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+    
+private:
+    void* m_mapping = nullptr;
+    size_t m_mappingSize = 0;
+    AAsset* m_asset = nullptr;
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_MAPPED_ASSET_H
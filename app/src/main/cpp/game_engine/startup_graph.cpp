@@ -0,0 +1,158 @@
+#include "startup_graph.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+StartupGraph::~StartupGraph() {
+    join();
+}
+
+StartupGraph::StageId StartupGraph::addStage(const char* name, Task task,
+                                             std::initializer_list<StageId> dependencies) {
+    if (m_started) return -1;
+    for (StageId dependency : dependencies) {
+        if (dependency < 0 || dependency >= stageCount()) return -1;
+    }
+
+    StageId id = stageCount();
+    std::unique_ptr<Stage> stage(new Stage());
+    stage->name = name ? name : "";
+    stage->task = std::move(task);
+    stage->future = stage->promise.get_future().share();
+    for (StageId dependency : dependencies) {
+        m_stages[dependency]->dependents.push_back(id);
+        ++stage->pendingDependencies;
+    }
+    m_stages.push_back(std::move(stage));
+    return id;
+}
+
+StartupGraph::StageId StartupGraph::find(const char* name) const {
+    if (!name) return -1;
+    for (StageId id = 0; id < stageCount(); ++id) {
+        if (m_stages[id]->name == name) return id;
+    }
+    return -1;
+}
+
+bool StartupGraph::start(int workerCount) {
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (m_started) return false;
+
+    m_started = true;
+    m_startTime = Clock::now();
+    m_remaining = stageCount();
+    for (StageId id = 0; id < stageCount(); ++id) {
+        if (m_stages[id]->pendingDependencies == 0) {
+            m_runnable.push_back(id);
+        }
+    }
+
+    // More workers than stages would only ever sleep
+    int threads = std::max(1, std::min(workerCount, stageCount()));
+    for (int i = 0; i < threads && m_remaining > 0; ++i) {
+        m_workers.emplace_back(&StartupGraph::workerLoop, this);
+    }
+    return true;
+}
+
+void StartupGraph::workerLoop() {
+    std::unique_lock<std::mutex> lock(m_lock);
+    for (;;) {
+        m_wake.wait(lock, [this]() { return !m_runnable.empty() || m_remaining == 0; });
+        if (m_runnable.empty()) return;
+
+        StageId id = m_runnable.front();
+        m_runnable.pop_front();
+        Stage& stage = *m_stages[id];
+        stage.state = State::Running;
+        stage.startNanos = nanosSinceStart();
+
+        // Stage bodies run unlocked; only the bookkeeping is serialized
+        lock.unlock();
+        bool succeeded = stage.task ? stage.task() : true;
+        lock.lock();
+
+        complete(id, succeeded ? State::Succeeded : State::Failed);
+    }
+}
+
+void StartupGraph::complete(StageId id, State state) {
+    // Skips cascade through dependents without running them
+    std::vector<std::pair<StageId, State>> completions{{id, state}};
+    while (!completions.empty()) {
+        auto completion = completions.back();
+        completions.pop_back();
+
+        Stage& stage = *m_stages[completion.first];
+        stage.state = completion.second;
+        stage.endNanos = nanosSinceStart();
+        --m_remaining;
+
+        bool succeeded = completion.second == State::Succeeded;
+        for (StageId dependentId : stage.dependents) {
+            Stage& dependent = *m_stages[dependentId];
+            if (!succeeded) dependent.dependencyFailed = true;
+            if (--dependent.pendingDependencies > 0) continue;
+
+            if (dependent.dependencyFailed) {
+                completions.emplace_back(dependentId, State::Skipped);
+            } else {
+                m_runnable.push_back(dependentId);
+            }
+        }
+        stage.promise.set_value(succeeded);
+    }
+
+    m_wake.notify_all();
+}
+
+std::shared_future<bool> StartupGraph::ready(StageId id) const {
+    if (id < 0 || id >= stageCount()) return std::shared_future<bool>();
+    return m_stages[id]->future;
+}
+
+bool StartupGraph::isReady(StageId id) const {
+    return state(id) == State::Succeeded;
+}
+
+StartupGraph::State StartupGraph::state(StageId id) const {
+    if (id < 0 || id >= stageCount()) return State::Pending;
+    std::lock_guard<std::mutex> lock(m_lock);
+    return m_stages[id]->state;
+}
+
+bool StartupGraph::join() {
+    for (auto& worker : m_workers) {
+        if (worker.joinable()) worker.join();
+    }
+    m_workers.clear();
+
+    std::lock_guard<std::mutex> lock(m_lock);
+    if (!m_started) return false;
+    for (const auto& stage : m_stages) {
+        if (stage->state != State::Succeeded) return false;
+    }
+    return true;
+}
+
+std::vector<StartupGraph::StageTiming> StartupGraph::timings() const {
+    std::lock_guard<std::mutex> lock(m_lock);
+    std::vector<StageTiming> result;
+    result.reserve(m_stages.size());
+    for (const auto& stage : m_stages) {
+        StageTiming timing;
+        timing.name = stage->name;
+        timing.state = stage->state;
+        timing.startNanos = stage->startNanos;
+        timing.endNanos = stage->endNanos;
+        result.push_back(timing);
+    }
+    return result;
+}
+
+int64_t StartupGraph::nanosSinceStart() const {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - m_startTime).count();
+}
+
+} // namespace TrashPiles
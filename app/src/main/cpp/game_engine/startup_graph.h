@@ -0,0 +1,108 @@
+#ifndef TRASHPILES_STARTUP_GRAPH_H
+#define TRASHPILES_STARTUP_GRAPH_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Dependency graph of initialization stages
+ * Stages are added up front, then start() runs them on a small pool of
+ * worker threads: a stage becomes runnable once all of its dependencies
+ * succeeded, so independent stages overlap. A stage whose dependency failed
+ * is skipped rather than run. Each stage has a readiness future that
+ * resolves true on success and false on failure or skip.
+ */
+class StartupGraph {
+public:
+    using StageId = int;
+    using Task = std::function<bool()>;
+    using Clock = std::chrono::steady_clock;
+
+    enum class State : uint8_t {
+        Pending,
+        Running,
+        Succeeded,
+        Failed,
+        Skipped
+    };
+
+    struct StageTiming {
+        std::string name;
+        State state = State::Pending;
+        int64_t startNanos = -1;    // Since start(); -1 until the stage runs
+        int64_t endNanos = -1;      // Since start(); -1 until the stage completes
+    };
+
+    StartupGraph() = default;
+    ~StartupGraph();
+
+    StartupGraph(const StartupGraph&) = delete;
+    StartupGraph& operator=(const StartupGraph&) = delete;
+
+    // Before start() only; dependencies must already be in the graph.
+    // Returns -1 for an unknown dependency.
+    StageId addStage(const char* name, Task task, std::initializer_list<StageId> dependencies = {});
+    StageId find(const char* name) const;
+    int stageCount() const { return static_cast<int>(m_stages.size()); }
+
+    // Launches up to workerCount threads and returns immediately
+    bool start(int workerCount);
+    bool isStarted() const { return m_started; }
+
+    // Readiness
+    std::shared_future<bool> ready(StageId id) const;
+    bool isReady(StageId id) const;
+    State state(StageId id) const;
+
+    // Blocks until every stage has completed and the workers have exited;
+    // true if all of them succeeded
+    bool join();
+
+    Clock::time_point startTime() const { return m_startTime; }
+    std::vector<StageTiming> timings() const;
+
+private:
+    struct Stage {
+        std::string name;
+        Task task;
+        std::vector<StageId> dependents;
+        int pendingDependencies = 0;
+        bool dependencyFailed = false;
+        State state = State::Pending;
+        int64_t startNanos = -1;
+        int64_t endNanos = -1;
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+    };
+
+    std::vector<std::unique_ptr<Stage>> m_stages;
+    mutable std::mutex m_lock;
+    std::condition_variable m_wake;
+    std::deque<StageId> m_runnable;
+    int m_remaining = 0;
+    bool m_started = false;
+    Clock::time_point m_startTime;
+    std::vector<std::thread> m_workers;
+
+    void workerLoop();
+    int64_t nanosSinceStart() const;
+
+    // Called with m_lock held
+    void complete(StageId id, State state);
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_STARTUP_GRAPH_H
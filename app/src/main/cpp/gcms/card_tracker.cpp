@@ -0,0 +1,129 @@
+#include "card_tracker.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+static bool validCard(int card) {
+    return card >= 0 && (card & (kCardFaceUp - 1)) < CardTracker::kCardCount;
+}
+
+void CardTracker::reset() {
+    m_public = 0;
+    std::fill(m_private, m_private + kMaxObservers, uint64_t(0));
+    m_discardCount = 0;
+    m_discardCards = 0;
+    m_deckCount = kCardCount;
+}
+
+void CardTracker::observe(const GameEvent& event) {
+    switch (event.type) {
+        case GameEventType::GameStarted:
+            reset();
+            break;
+        case GameEventType::CardDealt:
+            dealt();
+            break;
+        case GameEventType::CardDrawn:
+            drawn(event.playerId, event.card, event.value != 0);
+            break;
+        case GameEventType::CardPlaced:
+            revealed(event.card);
+            break;
+        case GameEventType::CardFlipped:
+            if (event.value != 0) revealed(event.card);
+            break;
+        case GameEventType::CardDiscarded:
+            discarded(event.card);
+            break;
+        case GameEventType::DeckReshuffled:
+            reshuffled();
+            break;
+        default:
+            break;
+    }
+}
+
+void CardTracker::dealt() {
+    if (m_deckCount > 0) --m_deckCount;
+}
+
+void CardTracker::drawn(int player, int card, bool fromDiscard) {
+    if (fromDiscard) {
+        // Public already; only the pile changes
+        if (m_discardCount == 0) return;
+        m_discardCards &= ~cardBit(m_discard[--m_discardCount]);
+        return;
+    }
+
+    if (m_deckCount > 0) --m_deckCount;
+    if (validCard(card) && player >= 0 && player < kMaxObservers) m_private[player] |= cardBit(card);
+}
+
+void CardTracker::revealed(int card) {
+    if (validCard(card)) m_public |= cardBit(card);
+}
+
+void CardTracker::discarded(int card) {
+    if (!validCard(card) || m_discardCount == kCardCount) return;
+    m_public |= cardBit(card);
+    m_discard[m_discardCount++] = static_cast<int8_t>(card & (kCardFaceUp - 1));
+    m_discardCards |= cardBit(card);
+}
+
+void CardTracker::reshuffled() {
+    if (m_discardCount <= 1) return;
+
+    int8_t top = m_discard[m_discardCount - 1];
+    uint64_t returned = m_discardCards & ~cardBit(top);
+    m_public &= ~returned;
+    for (uint64_t& known : m_private) known &= ~returned;
+
+    m_deckCount += m_discardCount - 1;
+    m_discard[0] = top;
+    m_discardCount = 1;
+    m_discardCards = cardBit(top);
+}
+
+uint64_t CardTracker::seen(int observer) const {
+    uint64_t known = m_public;
+    if (observer >= 0 && observer < kMaxObservers) known |= m_private[observer];
+    return known & kAllCards;
+}
+
+int CardTracker::unseenCount(int observer) const {
+    return kCardCount - __builtin_popcountll(seen(observer));
+}
+
+int CardTracker::unseenOfRank(int observer, int rank) const {
+    if (rank < 0 || rank >= kRankCount) return 0;
+    return __builtin_popcountll(~seen(observer) & rankCards(rank));
+}
+
+float CardTracker::rankOdds(int observer, int rank) const {
+    int unseen = unseenCount(observer);
+    return unseen > 0 ? static_cast<float>(unseenOfRank(observer, rank)) / unseen : 0.0f;
+}
+
+void CardTracker::rankOdds(int observer, float* out) const {
+    uint64_t unseenCards = ~seen(observer) & kAllCards;
+    int unseen = __builtin_popcountll(unseenCards);
+    float scale = unseen > 0 ? 1.0f / unseen : 0.0f;
+    for (int rank = 0; rank < kRankCount; ++rank) {
+        out[rank] = static_cast<float>(__builtin_popcountll(unseenCards & rankCards(rank))) * scale;
+    }
+}
+
+float CardTracker::fitOdds(int observer, uint16_t emptySlots) const {
+    emptySlots &= (1u << kStateMaxHandSlots) - 1;
+    if (emptySlots == 0) return 0.0f;
+
+    uint64_t fits = kWildCards;
+    for (uint32_t slots = emptySlots; slots; slots &= slots - 1) {
+        fits |= rankCards(__builtin_ctz(slots));
+    }
+    uint64_t unseenCards = ~seen(observer) & kAllCards;
+    int unseen = __builtin_popcountll(unseenCards);
+    return unseen > 0 ? static_cast<float>(__builtin_popcountll(unseenCards & fits)) / unseen : 0.0f;
+}
+
+} // namespace TrashPiles
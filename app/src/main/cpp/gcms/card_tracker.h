@@ -0,0 +1,85 @@
+#ifndef TRASHPILES_CARD_TRACKER_H
+#define TRASHPILES_CARD_TRACKER_H
+
+#include "event_bus.h"
+#include "state_block.h"
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Card tracker - what each player can know about the unseen cards
+ * Follows the game's events and keeps, per observer, a 52-bit mask of the
+ * cards whose place they know (bit = rank * 4 + suit, the state block card
+ * code). Face-up cards are public knowledge; a card drawn from the deck is
+ * known to its drawer until it is played or discarded, when everyone sees
+ * it. A reshuffle returns the discard pile below its top card to the deck,
+ * so those cards are unseen again.
+ *
+ * Every unseen card is equally likely to be the next one off the deck (the
+ * face-down hand cards were dealt from the same shuffle), so the odds of a
+ * rank are its unseen cards over all unseen cards. Ranks are four
+ * consecutive bits of the mask, which makes each count a popcount: events
+ * and queries are O(1) whatever the size of the piles.
+ *
+ * Single-threaded: GameCore owns one fed from its own events, and the
+ * Kotlin rules feed another through NativeCardTracker.kt.
+ */
+class CardTracker {
+public:
+    static constexpr int kMaxObservers = kStateMaxPlayers;
+    static constexpr int kCardCount = 52;
+    static constexpr int kRankCount = 13;
+    static constexpr uint64_t kAllCards = (uint64_t(1) << kCardCount) - 1;
+    // Jack, queen and king: ranks 10..12
+    static constexpr uint64_t kWildCards = uint64_t(0xFFF) << 40;
+
+    CardTracker() { reset(); }
+
+    // A fresh shuffled deck: nothing seen, everything in the deck
+    void reset();
+
+    // GameCore events; observers not mentioned are ignored, as are events
+    // with no bearing on the cards
+    void observe(const GameEvent& event);
+
+    // The same transitions, for callers without events
+    void dealt();
+    void drawn(int player, int card, bool fromDiscard);
+    void revealed(int card);        // Placed or flipped face up
+    void discarded(int card);       // Face up onto the discard pile
+    void reshuffled();              // Discard pile below its top card back into the deck
+
+    // Cards observer knows the place of; any other observer (e.g. -1 for a
+    // spectator or hint) gets the public cards only
+    uint64_t seen(int observer) const;
+    int unseenCount(int observer) const;
+    int unseenOfRank(int observer, int rank) const;
+
+    // Chance the next card off the deck has this rank, 0 if nothing is unseen
+    float rankOdds(int observer, int rank) const;
+    // All kRankCount ranks at once
+    void rankOdds(int observer, float* out) const;
+    // Chance the next card off the deck can go in one of these face-down
+    // slots (HandBits bit order): its own rank, or a wild for any of them
+    float fitOdds(int observer, uint16_t emptySlots) const;
+
+    int deckCount() const { return m_deckCount; }
+    int discardCount() const { return m_discardCount; }
+    int discardTop() const { return m_discardCount > 0 ? m_discard[m_discardCount - 1] : kNoCard; }
+
+    static constexpr uint64_t cardBit(int card) { return uint64_t(1) << (card & (kCardFaceUp - 1)); }
+    static constexpr uint64_t rankCards(int rank) { return uint64_t(0xF) << (rank * 4); }
+
+private:
+    uint64_t m_public;                      // Face up somewhere: hands and discard pile
+    uint64_t m_private[kMaxObservers];      // Drawn from the deck, seen by the drawer only
+    int8_t m_discard[kCardCount];           // Top at m_discardCount - 1
+    int m_discardCount;
+    uint64_t m_discardCards;
+    int m_deckCount;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_CARD_TRACKER_H
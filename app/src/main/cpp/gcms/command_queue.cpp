@@ -0,0 +1,50 @@
+#include "command_queue.h"
+
+namespace TrashPiles {
+
+static_assert((CommandQueue::kCapacity & (CommandQueue::kCapacity - 1)) == 0, "Capacity must be a power of two");
+
+CommandQueue::CommandQueue() {
+    for (uint32_t i = 0; i < kCapacity; ++i) {
+        m_slots[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool CommandQueue::push(const GameCommand& command) {
+    uint64_t position = m_tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_slots[position & (kCapacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        int64_t difference = static_cast<int64_t>(sequence - position);
+
+        if (difference == 0) {
+            if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                slot.command = command;
+                slot.sequence.store(position + 1, std::memory_order_release);
+                m_pushed.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        } else if (difference < 0) {
+            // The consumer has not freed this slot from the previous lap
+            m_rejected.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            position = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+int CommandQueue::drain(GameCommand* out, int maxCount) {
+    int count = 0;
+    while (count < maxCount) {
+        Slot& slot = m_slots[m_head & (kCapacity - 1)];
+        if (slot.sequence.load(std::memory_order_acquire) != m_head + 1) break;
+
+        out[count++] = slot.command;
+        slot.sequence.store(m_head + kCapacity, std::memory_order_release);
+        ++m_head;
+    }
+    return count;
+}
+
+} // namespace TrashPiles
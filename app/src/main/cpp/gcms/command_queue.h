@@ -0,0 +1,77 @@
+#ifndef TRASHPILES_COMMAND_QUEUE_H
+#define TRASHPILES_COMMAND_QUEUE_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace TrashPiles {
+
+// Values are shared with NativeCommandPipeline.kt
+enum class GameCommandType : uint8_t {
+    InitializeGame = 0, // value = player count, flags = AI player bits, slot = RulesVariant (-1 classic)
+    StartGame,
+    DrawCard,           // playerId, value = 1 from the discard pile
+    PlaceCard,          // playerId, slot, card = held card code or -1
+    DiscardCard,        // playerId
+    FlipCard,           // playerId, slot
+    EndTurn,            // playerId
+    SkipTurn,           // playerId
+    PauseGame,
+    ResumeGame,
+    EndGame,
+    ResetGame,
+    Count
+};
+
+struct GameCommand {
+    GameCommandType type = GameCommandType::StartGame;
+    int32_t playerId = -1;
+    int32_t card = -1;          // State block card code
+    int32_t slot = -1;
+    int32_t value = 0;
+    uint32_t flags = 0;
+    int64_t timeMillis = 0;     // Wall clock at submission, for lastActionTime
+};
+
+/**
+ * Bounded multi-producer, single-consumer command queue
+ * Producers (UI thread, AI, input) claim a slot with one CAS and never
+ * block each other for longer than that; the consumer drains whatever is
+ * complete in one batch per tick. A full queue rejects the push instead of
+ * growing or waiting.
+ */
+class CommandQueue {
+public:
+    static constexpr uint32_t kCapacity = 256;     // Power of two
+
+    CommandQueue();
+
+    CommandQueue(const CommandQueue&) = delete;
+    CommandQueue& operator=(const CommandQueue&) = delete;
+
+    // Any thread. False if the queue is full.
+    bool push(const GameCommand& command);
+
+    // Consumer thread only. Copies up to maxCount commands in push order.
+    int drain(GameCommand* out, int maxCount);
+
+    // Counters
+    uint64_t pushed() const { return m_pushed.load(std::memory_order_relaxed); }
+    uint64_t rejected() const { return m_rejected.load(std::memory_order_relaxed); }
+
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};      // Position when free, position + 1 when written
+        GameCommand command;
+    };
+
+    Slot m_slots[kCapacity];
+    alignas(64) std::atomic<uint64_t> m_tail{0};
+    alignas(64) uint64_t m_head = 0;            // Consumer only
+    std::atomic<uint64_t> m_pushed{0};
+    std::atomic<uint64_t> m_rejected{0};
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_COMMAND_QUEUE_H
@@ -0,0 +1,210 @@
+#include "endgame_table.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace TrashPiles {
+
+using namespace EndgameTableFormat;
+
+bool EndgamePosition::from(HandBits hand, const CardTracker& tracker, int observer, EndgamePosition* out) {
+    uint16_t open = HandKernels::emptySlots(hand);
+    int count = __builtin_popcount(open);
+    if (count < 1 || count > kMaxOpenSlots) return false;
+
+    uint64_t unseenCards = ~tracker.seen(observer) & CardTracker::kAllCards;
+    EndgamePosition position;
+    for (uint32_t slots = open; slots; slots &= slots - 1) {
+        int slot = __builtin_ctz(slots);
+        position.slots[position.openSlots] = static_cast<int8_t>(slot);
+        position.naturals[position.openSlots] =
+            static_cast<uint8_t>(__builtin_popcountll(unseenCards & CardTracker::rankCards(slot)));
+        ++position.openSlots;
+    }
+    position.wilds = __builtin_popcountll(unseenCards & CardTracker::kWildCards);
+    position.unseen = __builtin_popcountll(unseenCards);
+    *out = position;
+    return true;
+}
+
+EndgameTableView::OpenResult EndgameTableView::open(const uint8_t* data, size_t size) {
+    m_entries = nullptr;
+    if (!data || size < sizeof(Header)) return OpenResult::TooSmall;
+    if (reinterpret_cast<uintptr_t>(data) % alignof(Header) != 0) return OpenResult::Misaligned;
+
+    const Header& header = *reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return OpenResult::BadMagic;
+    if (header.version != kVersion) return OpenResult::BadVersion;
+    if (header.totalSize != size) return OpenResult::BadSize;
+    if (header.maxOpenSlots != kMaxOpenSlots || header.maxNaturals != kMaxNaturals ||
+        header.maxWilds != kMaxWilds || header.maxUnseen != kMaxUnseen || header.entryCount != kEntryCount) {
+        return OpenResult::BadShape;
+    }
+    if (header.entriesOffset % alignof(Entry) != 0 || header.entriesOffset < sizeof(Header) ||
+        header.entriesOffset > size || header.entryCount > (size - header.entriesOffset) / sizeof(Entry)) {
+        return OpenResult::BadSection;
+    }
+
+    m_entries = reinterpret_cast<const Entry*>(data + header.entriesOffset);
+    return OpenResult::Ok;
+}
+
+const EndgameTableView::Entry* EndgameTableView::find(const EndgamePosition& position) const {
+    if (!m_entries || position.openSlots < 1 || position.openSlots > kMaxOpenSlots) return nullptr;
+    for (int i = 0; i < position.openSlots; ++i) {
+        if (position.naturals[i] > kMaxNaturals) return nullptr;
+    }
+    if (position.wilds < 0 || position.wilds > kMaxWilds || position.unseen < 0 || position.unseen > kMaxUnseen) {
+        return nullptr;
+    }
+    return &m_entries[entryIndex(position.openSlots, position.naturals, position.wilds, position.unseen)];
+}
+
+bool EndgameTableView::advise(const EndgamePosition& position, int discardTop, EndgameAdvice* out) const {
+    const Entry* entry = find(position);
+    if (!entry || entry->turns == kUnsolvable) return false;
+
+    EndgameAdvice advice;
+    advice.expectedTurns = static_cast<float>(entry->turns) / kTurnScale;
+    if (entry->wildSlot < position.openSlots) advice.wildSlot = position.slots[entry->wildSlot];
+
+    if (discardTop >= 0) {
+        int rank = (discardTop & (kCardFaceUp - 1)) / 4;
+        if (rank >= HandKernels::kWildRankStart) {
+            advice.takeDiscard = (entry->take & kTakeWild) != 0;
+            advice.discardSlot = advice.takeDiscard ? advice.wildSlot : -1;
+        } else {
+            for (int i = 0; i < position.openSlots; ++i) {
+                if (position.slots[i] == rank && (entry->take & (1u << i))) {
+                    advice.takeDiscard = true;
+                    advice.discardSlot = rank;
+                }
+            }
+        }
+    }
+    *out = advice;
+    return true;
+}
+
+EndgameSolver::EndgameSolver()
+    : m_turns(kEntryCount, std::numeric_limits<double>::infinity()),
+      m_entries(kEntryCount, Entry{kUnsolvable, 0, 0}) {
+    // Filling a slot leads to a position with one fewer, so solve upwards
+    for (int openSlots = 1; openSlots <= kMaxOpenSlots; ++openSlots) {
+        for (uint32_t code = 0; code < naturalCodes(openSlots); ++code) {
+            uint8_t naturals[kMaxOpenSlots];
+            for (int i = openSlots - 1, rest = static_cast<int>(code); i >= 0; --i, rest /= kNaturalStates) {
+                naturals[i] = static_cast<uint8_t>(rest % kNaturalStates);
+            }
+            for (int wilds = 0; wilds <= kMaxWilds; ++wilds) {
+                for (int unseen = 0; unseen <= kMaxUnseen; ++unseen) {
+                    solve(openSlots, naturals, wilds, unseen);
+                }
+            }
+        }
+    }
+}
+
+void EndgameSolver::solve(int openSlots, const uint8_t* naturals, int wilds, int unseen) {
+    int fitting = wilds;
+    for (int i = 0; i < openSlots; ++i) fitting += naturals[i];
+    if (unseen == 0 || fitting == 0 || fitting > unseen) return;
+
+    // Turns left after filling slot skip, with wildsLeft still unseen
+    auto after = [&](int skip, int wildsLeft) {
+        if (openSlots == 1) return 0.0;
+        uint8_t rest[kMaxOpenSlots];
+        int count = 0;
+        for (int i = 0; i < openSlots; ++i) {
+            if (i != skip) rest[count++] = naturals[i];
+        }
+        return m_turns[entryIndex(openSlots - 1, rest, wildsLeft, unseen - 1)];
+    };
+
+    double cards = unseen;
+    double natural[kMaxOpenSlots] = {};
+    double odds[kMaxOpenSlots] = {};
+    for (int i = 0; i < openSlots; ++i) {
+        odds[i] = naturals[i] / cards;
+        if (naturals[i] > 0) natural[i] = after(i, wilds);
+    }
+
+    double wild = std::numeric_limits<double>::infinity();
+    int wildSlot = 0;
+    double wildOdds = wilds / cards;
+    if (wilds > 0) {
+        for (int j = 0; j < openSlots; ++j) {
+            double turns = after(j, wilds - 1);
+            if (turns < wild) {
+                wild = turns;
+                wildSlot = j;
+            }
+        }
+    }
+
+    // A draw from the deck: turns still to go when it fits, a turn lost when not
+    double progress = wilds > 0 ? wildOdds * wild : 0.0;
+    for (int i = 0; i < openSlots; ++i) {
+        if (naturals[i] > 0) progress += odds[i] * natural[i];
+    }
+    double miss = 1.0 - fitting / cards;
+
+    // For each choice of which fitting discards to take, solve
+    //   E = 1 + taken + declined * (progress + miss * E)
+    // and keep the best; ties go to taking more
+    uint32_t allowed = wilds > 0 ? kTakeWild : 0;
+    for (int i = 0; i < openSlots; ++i) {
+        if (naturals[i] > 0) allowed |= 1u << i;
+    }
+    double best = std::numeric_limits<double>::infinity();
+    uint32_t bestTake = 0;
+    for (uint32_t take = allowed;; take = (take - 1) & allowed) {
+        double taken = 0.0;
+        double declined = 1.0;
+        for (int i = 0; i < openSlots; ++i) {
+            if (take & (1u << i)) {
+                taken += odds[i] * natural[i];
+                declined -= odds[i];
+            }
+        }
+        if (take & kTakeWild) {
+            taken += wildOdds * wild;
+            declined -= wildOdds;
+        }
+        double turns = (1.0 + taken + declined * progress) / (1.0 - declined * miss);
+        if (turns < best) {
+            best = turns;
+            bestTake = take;
+        }
+        if (take == 0) break;
+    }
+
+    uint32_t index = entryIndex(openSlots, naturals, wilds, unseen);
+    m_turns[index] = best;
+    if (std::isinf(best)) return;
+
+    double scaled = std::round(best * kTurnScale);
+    Entry& entry = m_entries[index];
+    entry.turns = scaled >= kMaxTurns ? kMaxTurns : static_cast<uint16_t>(scaled);
+    entry.take = static_cast<uint8_t>(bestTake);
+    entry.wildSlot = static_cast<uint8_t>(wildSlot);
+}
+
+void EndgameSolver::build(std::vector<uint8_t>& image) const {
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.entriesOffset = sizeof(Header);
+    header.entryCount = kEntryCount;
+    header.maxOpenSlots = kMaxOpenSlots;
+    header.maxNaturals = kMaxNaturals;
+    header.maxWilds = kMaxWilds;
+    header.maxUnseen = kMaxUnseen;
+    header.totalSize = static_cast<uint32_t>(sizeof(Header) + m_entries.size() * sizeof(Entry));
+
+    image.assign(header.totalSize, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    std::memcpy(image.data() + header.entriesOffset, m_entries.data(), m_entries.size() * sizeof(Entry));
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,181 @@
+#ifndef TRASHPILES_ENDGAME_TABLE_H
+#define TRASHPILES_ENDGAME_TABLE_H
+
+#include "card_tracker.h"
+#include "hand_kernels.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Endgame tablebase (.tpend)
+ *
+ * Exact late-round decisions for a hand with one to three face-down slots,
+ * solved offline by tools/endgame_solver and mapped read-only from the
+ * APK. A position is the open slots' unseen naturals (0..4 each, in slot
+ * order), the unseen wilds and the unseen card count, as a CardTracker
+ * reports them for the player; the discard top is whatever card is
+ * showing when the entry is read.
+ *
+ * The model is the player's own turns, as GameCore plays them: the discard
+ * top and a deck draw are each an unseen card at random, a placed card
+ * leaves the unseen cards for good, and cards that do not fit come back
+ * through reshuffles. Each entry holds the expected turns to finish under
+ * optimal play, whether to take a fitting discard, and the slot a wild
+ * should fill.
+ *
+ * Layout: header, then one Entry per position at entryIndex(). All fields
+ * are little-endian; entries are read in place from the mapped file.
+ */
+namespace EndgameTableFormat {
+
+constexpr char kMagic[4] = {'T', 'P', 'E', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr int kMaxOpenSlots = 3;
+constexpr int kMaxNaturals = 4;
+constexpr int kMaxWilds = 12;
+constexpr int kMaxUnseen = CardTracker::kCardCount;
+// Expected turns in fixed point
+constexpr int kTurnScale = 256;
+constexpr uint16_t kMaxTurns = 0xFFFE;
+// Not reachable, or the hand can never finish
+constexpr uint16_t kUnsolvable = 0xFFFF;
+// Entry::take bit for a wild on the discard pile; bit i is a natural for open slot i
+constexpr uint8_t kTakeWild = 1u << kMaxOpenSlots;
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t entriesOffset;
+    uint32_t entryCount;
+    uint8_t maxOpenSlots;
+    uint8_t maxNaturals;
+    uint8_t maxWilds;
+    uint8_t maxUnseen;
+    uint32_t reserved[2];
+};
+
+struct Entry {
+    uint16_t turns;         // Expected turns to finish * kTurnScale, or kUnsolvable
+    uint8_t take;           // Which fitting discards to take instead of drawing
+    uint8_t wildSlot;       // Open slot ordinal a wild should fill
+};
+
+static_assert(sizeof(Header) == 32, "Header layout is part of the file format");
+static_assert(sizeof(Entry) == 4, "Entry layout is part of the file format");
+static_assert(std::is_trivially_copyable<Entry>::value, "entries are read in place");
+
+constexpr int kNaturalStates = kMaxNaturals + 1;
+constexpr int kWildStates = kMaxWilds + 1;
+constexpr int kUnseenStates = kMaxUnseen + 1;
+
+// Distinct natural counts over openSlots slots
+constexpr uint32_t naturalCodes(int openSlots) {
+    return openSlots <= 0 ? 1 : kNaturalStates * naturalCodes(openSlots - 1);
+}
+
+// First entry of the positions with openSlots face-down slots
+constexpr uint32_t blockStart(int openSlots) {
+    return openSlots <= 1 ? 0
+                          : blockStart(openSlots - 1) + naturalCodes(openSlots - 1) * kWildStates * kUnseenStates;
+}
+
+constexpr uint32_t kEntryCount = blockStart(kMaxOpenSlots + 1);
+
+// Caller keeps every count in range
+inline uint32_t entryIndex(int openSlots, const uint8_t* naturals, int wilds, int unseen) {
+    uint32_t code = 0;
+    for (int i = 0; i < openSlots; ++i) code = code * kNaturalStates + naturals[i];
+    return blockStart(openSlots) + (code * kWildStates + static_cast<uint32_t>(wilds)) * kUnseenStates +
+           static_cast<uint32_t>(unseen);
+}
+
+} // namespace EndgameTableFormat
+
+/**
+ * An endgame position as the table keys it
+ */
+struct EndgamePosition {
+    int openSlots = 0;
+    int8_t slots[EndgameTableFormat::kMaxOpenSlots] = {};      // Face-down slots, ascending
+    uint8_t naturals[EndgameTableFormat::kMaxOpenSlots] = {};  // Unseen cards of each slot's rank
+    int wilds = 0;
+    int unseen = 0;
+
+    // The position of observer's hand as the tracker sees it; false unless
+    // one to three slots are face down
+    static bool from(HandBits hand, const CardTracker& tracker, int observer, EndgamePosition* out);
+};
+
+struct EndgameAdvice {
+    float expectedTurns = 0.0f;
+    bool takeDiscard = false;       // Take the discard top rather than draw
+    int discardSlot = -1;           // Where a taken discard goes
+    int wildSlot = -1;              // Where a wild from the deck goes
+};
+
+/**
+ * Read-only view over a tablebase image in memory (typically an mmapped asset)
+ * open() checks the header and the entry bounds once; lookups afterwards
+ * are an index computation and one read.
+ */
+class EndgameTableView {
+public:
+    using Entry = EndgameTableFormat::Entry;
+
+    enum class OpenResult {
+        Ok = 0,
+        TooSmall,
+        Misaligned,             // Entries cannot be read in place
+        BadMagic,
+        BadVersion,
+        BadSize,
+        BadShape,               // Solved for other limits than this build's
+        BadSection
+    };
+
+    // The view borrows data
+    OpenResult open(const uint8_t* data, size_t size);
+    bool isOpen() const { return m_entries != nullptr; }
+
+    // nullptr if the position is outside the table
+    const Entry* find(const EndgamePosition& position) const;
+
+    // The table's play for this position with discardTop showing (kNoCard
+    // if the pile is empty); false if the position is outside the table or
+    // cannot finish
+    bool advise(const EndgamePosition& position, int discardTop, EndgameAdvice* out) const;
+
+private:
+    const Entry* m_entries = nullptr;
+};
+
+/**
+ * Solves every position and builds the tablebase image (host tool side)
+ */
+class EndgameSolver {
+public:
+    EndgameSolver();
+
+    // Expected turns to finish, infinity where the hand cannot; entries
+    // with counts that do not fit together (more naturals and wilds than
+    // unseen cards) are infinite too
+    double expectedTurns(uint32_t index) const { return m_turns[index]; }
+    const EndgameTableFormat::Entry& entry(uint32_t index) const { return m_entries[index]; }
+
+    void build(std::vector<uint8_t>& image) const;
+
+private:
+    std::vector<double> m_turns;
+    std::vector<EndgameTableFormat::Entry> m_entries;
+
+    void solve(int openSlots, const uint8_t* naturals, int wilds, int unseen);
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_ENDGAME_TABLE_H
@@ -0,0 +1,120 @@
+#include "event_bus.h"
+#include <cstring>
+
+namespace TrashPiles {
+
+static_assert((EventBus::kCapacity & (EventBus::kCapacity - 1)) == 0, "Capacity must be a power of two");
+static_assert(static_cast<int>(GameEventType::Count) <= 32, "Event types must fit the subscriber mask");
+
+EventBus::Subscriber* EventBus::subscribe(const char* name, uint32_t typeMask) {
+    for (auto& subscriber : m_subscribers) {
+        bool expected = false;
+        if (!subscriber.active.compare_exchange_strong(expected, true, std::memory_order_acq_rel)) {
+            continue;
+        }
+
+        std::memset(subscriber.name, 0, sizeof(subscriber.name));
+        if (name) std::strncpy(subscriber.name, name, kMaxNameLength);
+        subscriber.typeMask = typeMask;
+        subscriber.cursor.store(m_head.load(std::memory_order_acquire), std::memory_order_relaxed);
+        subscriber.delivered.store(0, std::memory_order_relaxed);
+        subscriber.dropped.store(0, std::memory_order_relaxed);
+        return &subscriber;
+    }
+    return nullptr;
+}
+
+void EventBus::unsubscribe(Subscriber* subscriber) {
+    if (subscriber) subscriber->active.store(false, std::memory_order_release);
+}
+
+bool EventBus::publish(const GameEvent& event) {
+    uint64_t ticket = m_head.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = m_slots[ticket & (kCapacity - 1)];
+
+    // Claim the slot; a writer from the previous lap may still be copying
+    uint64_t seen = slot.sequence.load(std::memory_order_relaxed);
+    for (;;) {
+        if (seen == kWriting) {
+            seen = slot.sequence.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (seen > ticket) {
+            m_publishDropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (slot.sequence.compare_exchange_weak(seen, kWriting, std::memory_order_acq_rel,
+                                                std::memory_order_relaxed)) {
+            break;
+        }
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.event = event;
+    slot.sequence.store(ticket + 1, std::memory_order_release);
+    m_published.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool EventBus::poll(Subscriber* subscriber, GameEvent& out) {
+    if (!subscriber) return false;
+
+    for (;;) {
+        uint64_t cursor = subscriber->cursor.load(std::memory_order_relaxed);
+        Slot& slot = m_slots[cursor & (kCapacity - 1)];
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+
+        if (sequence == cursor + 1) {
+            GameEvent event = slot.event;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) != sequence) {
+                continue;   // Overwritten while copying; re-examine the slot
+            }
+
+            subscriber->cursor.store(cursor + 1, std::memory_order_relaxed);
+            if (!(subscriber->typeMask & gameEventBit(event.type))) continue;
+
+            out = event;
+            subscriber->delivered.store(subscriber->delivered.load(std::memory_order_relaxed) + 1,
+                                        std::memory_order_relaxed);
+            return true;
+        }
+
+        // Not published yet
+        if (sequence != kWriting && sequence < cursor + 1) return false;
+
+        // Mid-write: ours if nothing has been claimed a full lap ahead
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        if (sequence == kWriting && head - cursor <= kCapacity) return false;
+
+        // Lapped: resume at the oldest event that can still be intact
+        uint64_t oldest = head - kCapacity;
+        if (oldest <= cursor) oldest = cursor + 1;
+        subscriber->dropped.store(subscriber->dropped.load(std::memory_order_relaxed) + (oldest - cursor),
+                                  std::memory_order_relaxed);
+        subscriber->cursor.store(oldest, std::memory_order_relaxed);
+    }
+}
+
+uint64_t EventBus::lag(const Subscriber* subscriber) const {
+    if (!subscriber) return 0;
+    uint64_t head = m_head.load(std::memory_order_acquire);
+    uint64_t cursor = subscriber->cursor.load(std::memory_order_relaxed);
+    return head > cursor ? head - cursor : 0;
+}
+
+int EventBus::subscriberCount() const {
+    int count = 0;
+    for (const auto& subscriber : m_subscribers) {
+        if (subscriber.active.load(std::memory_order_acquire)) ++count;
+    }
+    return count;
+}
+
+const EventBus::Subscriber* EventBus::subscriberAt(int index) const {
+    if (index < 0 || index >= kMaxSubscribers) return nullptr;
+    const Subscriber& subscriber = m_subscribers[index];
+    return subscriber.active.load(std::memory_order_acquire) ? &subscriber : nullptr;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,106 @@
+#ifndef TRASHPILES_EVENT_BUS_H
+#define TRASHPILES_EVENT_BUS_H
+
+#include <atomic>
+#include <cstdint>
+
+namespace TrashPiles {
+
+// Values are shared with NativeEventBus.kt
+enum class GameEventType : uint8_t {
+    GameStarted = 0,
+    GameEnded,          // playerId = winner
+    TurnStarted,        // playerId
+    TurnEnded,          // playerId
+    CardDealt,          // card, playerId, slot
+    CardDrawn,          // card, playerId, value = 1 from the discard pile
+    CardPlaced,         // card, playerId, slot
+    CardFlipped,        // card, value = 1 face up
+    CardDiscarded,      // card, playerId
+    RoundWon,           // playerId
+    InvalidMove,        // playerId
+    DeckReshuffled,     // card = top card kept on the discard pile, value = cards returned
+    Count
+};
+
+constexpr uint32_t kAllGameEvents = ~0u;
+
+inline uint32_t gameEventBit(GameEventType type) {
+    return 1u << static_cast<uint32_t>(type);
+}
+
+struct GameEvent {
+    GameEventType type = GameEventType::GameStarted;
+    int32_t playerId = -1;
+    int32_t card = -1;          // State block card code, kNoCard when not a card event
+    int32_t slot = -1;
+    int32_t value = 0;
+    float volume = 1.0f;
+    int64_t timeNanos = 0;      // Publisher's steady clock
+};
+
+/**
+ * Lock-free broadcast ring for game events
+ * Any thread may publish; each subscriber has its own cursor and sees every
+ * event in its type mask, in publish order. Producers never wait for
+ * consumers: a subscriber that falls a full ring behind skips ahead and
+ * counts what it lost. poll() is wait-free apart from a retry when a slot
+ * is overwritten mid-read, so it is safe on the audio callback thread.
+ */
+class EventBus {
+public:
+    static constexpr uint32_t kCapacity = 1024;    // Power of two
+    static constexpr int kMaxSubscribers = 8;
+    static constexpr int kMaxNameLength = 23;
+
+    struct Subscriber {
+        char name[kMaxNameLength + 1] = {};
+        uint32_t typeMask = kAllGameEvents;
+        std::atomic<uint64_t> cursor{0};        // Advanced by the consuming thread only
+        std::atomic<uint64_t> delivered{0};
+        std::atomic<uint64_t> dropped{0};       // Overwritten before they were read, or lost by their publisher
+        std::atomic<bool> active{false};
+    };
+
+    EventBus() = default;
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    // Control threads. The cursor starts at the next published event.
+    // Null when every subscriber slot is taken.
+    Subscriber* subscribe(const char* name, uint32_t typeMask = kAllGameEvents);
+    void unsubscribe(Subscriber* subscriber);
+
+    // Any thread. False if the slot was already reused by a later event,
+    // which only happens when producers stall for a full lap.
+    bool publish(const GameEvent& event);
+
+    // The subscriber's consuming thread only
+    bool poll(Subscriber* subscriber, GameEvent& out);
+
+    // Counters
+    uint64_t published() const { return m_published.load(std::memory_order_relaxed); }
+    uint64_t publishDropped() const { return m_publishDropped.load(std::memory_order_relaxed); }
+    uint64_t lag(const Subscriber* subscriber) const;
+    int subscriberCount() const;
+    const Subscriber* subscriberAt(int index) const;   // Null for free slots
+
+private:
+    static constexpr uint64_t kWriting = ~0ull;
+
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> sequence{0};      // Ticket + 1 once written, kWriting mid-write
+        GameEvent event;
+    };
+
+    Slot m_slots[kCapacity];
+    alignas(64) std::atomic<uint64_t> m_head{0};
+    std::atomic<uint64_t> m_published{0};
+    std::atomic<uint64_t> m_publishDropped{0};
+    Subscriber m_subscribers[kMaxSubscribers];
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_EVENT_BUS_H
@@ -0,0 +1,487 @@
+#include "game_core.h"
+#include "../trace/trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace TrashPiles {
+
+static_assert(GameCore::kWildRankStart == HandKernels::kWildRankStart, "wild ranks must agree");
+
+static int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* commandResultText(CommandResult result) {
+    switch (result) {
+        case CommandResult::Ok: return "Ok";
+        case CommandResult::InputLocked: return "Input is locked";
+        case CommandResult::WrongPhase: return "Not allowed in this phase";
+        case CommandResult::NotYourTurn: return "Not your turn";
+        case CommandResult::NoSuchPlayer: return "Player not found";
+        case CommandResult::InvalidPlayerCount: return "Invalid player count";
+        case CommandResult::PileEmpty: return "Pile is empty";
+        case CommandResult::InvalidSlot: return "Invalid slot index";
+        case CommandResult::SlotFilled: return "Slot already filled";
+        case CommandResult::CardMismatch: return "Card does not match slot";
+        case CommandResult::NoHeldCard: return "No card drawn";
+        case CommandResult::AlreadyHolding: return "Card already drawn";
+        case CommandResult::UnknownCommand: return "Unknown command";
+        case CommandResult::UnknownRules: return "Unknown rules variant";
+    }
+    return "Unknown";
+}
+
+GameCore::GameCore(StateBlock& stateBlock, EventBus* events, uint32_t seed)
+    : m_stateBlock(stateBlock), m_events(events), m_random(seed) {
+    reset();
+}
+
+bool GameCore::submit(const GameCommand& command) {
+    return m_queue.push(command);
+}
+
+int GameCore::tick() {
+    GameCommand batch[kMaxBatch];
+    int count = m_queue.drain(batch, kMaxBatch);
+    if (count == 0) return 0;
+
+    TRACE_SCOPE("game.tick");
+    TRACE_COUNTER("game.batch", count);
+    bool changed = false;
+    for (int i = 0; i < count; ++i) {
+        changed |= apply(batch[i]) == CommandResult::Ok;
+    }
+
+    // One state publish per batch, however many commands it held
+    if (changed) publishState();
+
+    ++m_stats.ticks;
+    m_stats.maxBatch = std::max(m_stats.maxBatch, count);
+    return count;
+}
+
+CommandResult GameCore::apply(const GameCommand& command) {
+    CommandResult result = validate(command);
+    if (result != CommandResult::Ok) {
+        ++m_stats.rejected;
+        emit(GameEventType::InvalidMove, command.playerId, kNoCard,
+             static_cast<int>(command.type), static_cast<int>(result));
+        return result;
+    }
+
+    execute(command);
+    if (command.timeMillis) m_lastActionMillis = command.timeMillis;
+    ++m_stats.executed;
+    return result;
+}
+
+void GameCore::reset() {
+    m_phase = GamePhase::Setup;
+    m_playerCount = 0;
+    m_variant = RulesVariant::Classic;
+    m_rules = selectRules(m_variant, kStateMaxPlayers);
+    m_aiMask = 0;
+    m_currentPlayer = 0;
+    m_round = 1;
+    m_winner = -1;
+    m_inputLocked = false;
+    m_heldCard = kNoCard;
+    m_lastActionMillis = 0;
+    m_deckCount = 0;
+    m_discardCount = 0;
+    std::memset(m_hands, kNoCard, sizeof(m_hands));
+    std::memset(m_handCount, 0, sizeof(m_handCount));
+    std::fill(m_handBits, m_handBits + kStateMaxPlayers, HandBits());
+    m_tracker.reset();
+    m_hash = computePositionHash();
+}
+
+CommandResult GameCore::validate(const GameCommand& command) const {
+    using Type = GameCommandType;
+    Type type = command.type;
+    if (static_cast<int>(type) >= static_cast<int>(Type::Count)) return CommandResult::UnknownCommand;
+
+    // GCMSValidator.isAllowedWhenLocked
+    if (m_inputLocked && type != Type::PauseGame && type != Type::ResumeGame && type != Type::EndGame) {
+        return CommandResult::InputLocked;
+    }
+
+    // GCMSValidator.isValidForPhase
+    bool phaseOk = false;
+    switch (m_phase) {
+        case GamePhase::Setup:
+            phaseOk = type == Type::InitializeGame || type == Type::StartGame;
+            break;
+        case GamePhase::Dealing:
+            phaseOk = false;
+            break;
+        case GamePhase::Playing:
+            phaseOk = type == Type::DrawCard || type == Type::PlaceCard || type == Type::DiscardCard ||
+                      type == Type::FlipCard || type == Type::EndTurn || type == Type::SkipTurn ||
+                      type == Type::PauseGame || type == Type::ResumeGame;
+            break;
+        case GamePhase::RoundEnd:
+            phaseOk = type == Type::StartGame || type == Type::EndGame;
+            break;
+        case GamePhase::GameOver:
+            phaseOk = type == Type::ResetGame;
+            break;
+    }
+    if (!phaseOk) return CommandResult::WrongPhase;
+
+    switch (type) {
+        case Type::InitializeGame:
+            if (command.value < 2 || command.value > kStateMaxPlayers) return CommandResult::InvalidPlayerCount;
+            if (command.slot >= static_cast<int>(RulesVariant::Count)) return CommandResult::UnknownRules;
+            return CommandResult::Ok;
+
+        case Type::StartGame:
+            if (m_playerCount == 0) return CommandResult::InvalidPlayerCount;
+            return CommandResult::Ok;
+
+        case Type::DrawCard:
+        case Type::PlaceCard:
+        case Type::DiscardCard:
+        case Type::FlipCard:
+        case Type::EndTurn:
+        case Type::SkipTurn:
+            return (this->*m_rules->validatePlay)(command);
+
+        default:
+            return CommandResult::Ok;
+    }
+}
+
+template <class Policy>
+CommandResult GameCore::validatePlay(const GameCommand& command) const {
+    using Type = GameCommandType;
+    Type type = command.type;
+
+    // Player actions
+    bool needsTurn = type == Type::DrawCard || type == Type::PlaceCard || type == Type::DiscardCard ||
+                     type == Type::EndTurn || type == Type::SkipTurn;
+    bool needsPlayer = needsTurn || type == Type::FlipCard;
+    if (needsPlayer && (command.playerId < 0 || command.playerId >= Policy::kPlayers)) {
+        return CommandResult::NoSuchPlayer;
+    }
+    if (needsTurn && command.playerId != m_currentPlayer) return CommandResult::NotYourTurn;
+
+    switch (type) {
+        case Type::DrawCard:
+            if (m_heldCard != kNoCard) return CommandResult::AlreadyHolding;
+            if (command.value != 0) {
+                if (m_discardCount == 0) return CommandResult::PileEmpty;
+            } else if (m_deckCount == 0 && m_discardCount <= 1) {
+                return CommandResult::PileEmpty;
+            }
+            return CommandResult::Ok;
+
+        case Type::PlaceCard: {
+            if (m_heldCard == kNoCard) return CommandResult::NoHeldCard;
+            if (command.card >= 0 && (command.card & (kCardFaceUp - 1)) != m_heldCard) {
+                return CommandResult::CardMismatch;
+            }
+            if (command.slot < 0 || command.slot >= m_handCount[command.playerId]) return CommandResult::InvalidSlot;
+            if (m_hands[command.playerId][command.slot] & kCardFaceUp) return CommandResult::SlotFilled;
+            if (!Policy::fitsSlot(m_heldCard, command.slot)) return CommandResult::CardMismatch;
+            return CommandResult::Ok;
+        }
+
+        case Type::DiscardCard:
+            if (m_heldCard == kNoCard) return CommandResult::NoHeldCard;
+            return CommandResult::Ok;
+
+        case Type::FlipCard:
+            if (command.slot < 0 || command.slot >= m_handCount[command.playerId]) return CommandResult::InvalidSlot;
+            return CommandResult::Ok;
+
+        default:
+            return CommandResult::Ok;
+    }
+}
+
+void GameCore::execute(const GameCommand& command) {
+    using Type = GameCommandType;
+    switch (command.type) {
+        case Type::InitializeGame:
+            reset();
+            m_playerCount = command.value;
+            m_variant = command.slot > 0 ? static_cast<RulesVariant>(command.slot) : RulesVariant::Classic;
+            m_rules = selectRules(m_variant, m_playerCount);
+            m_aiMask = command.flags;
+            break;
+
+        case Type::StartGame:
+            if (m_phase == GamePhase::RoundEnd) ++m_round;
+            (this->*m_rules->startRound)();
+            break;
+
+        case Type::PauseGame:
+            m_inputLocked = true;
+            break;
+
+        case Type::ResumeGame:
+            m_inputLocked = false;
+            break;
+
+        case Type::EndGame:
+            m_phase = GamePhase::GameOver;
+            emit(GameEventType::GameEnded, m_winner);
+            break;
+
+        case Type::ResetGame:
+            reset();
+            break;
+
+        default:
+            (this->*m_rules->executePlay)(command);
+            break;
+    }
+}
+
+template <class Policy>
+void GameCore::executePlay(const GameCommand& command) {
+    using Type = GameCommandType;
+    switch (command.type) {
+        case Type::DrawCard: {
+            bool fromDiscard = command.value != 0;
+            m_hash ^= pileHash();
+            if (!fromDiscard && m_deckCount == 0) reshuffleDiscard();
+            m_heldCard = fromDiscard ? m_discard[--m_discardCount] : m_deck[--m_deckCount];
+            m_heldCard &= kCardFaceUp - 1;
+            m_hash ^= pileHash();
+            emit(GameEventType::CardDrawn, command.playerId, m_heldCard, -1, fromDiscard ? 1 : 0);
+            break;
+        }
+
+        case Type::PlaceCard: {
+            int8_t& slot = m_hands[command.playerId][command.slot];
+            int uncovered = slot & (kCardFaceUp - 1);
+            m_hash ^= slotHash(command.playerId, command.slot) ^ pileHash();
+            slot = static_cast<int8_t>(m_heldCard | kCardFaceUp);
+            HandBits& bits = m_handBits[command.playerId];
+            uint16_t bit = static_cast<uint16_t>(1u << command.slot);
+            bits.faceUp |= bit;
+            bits.correct = static_cast<uint16_t>(Policy::rankOf(m_heldCard) == command.slot ? bits.correct | bit
+                                                                                            : bits.correct & ~bit);
+            emit(GameEventType::CardPlaced, command.playerId, slot, command.slot);
+            m_heldCard = kNoCard;
+
+            m_discard[m_discardCount++] = static_cast<int8_t>(uncovered | kCardFaceUp);
+            m_hash ^= slotHash(command.playerId, command.slot) ^ pileHash();
+            emit(GameEventType::CardDiscarded, command.playerId, uncovered | kCardFaceUp);
+
+            if (hasWon(command.playerId)) {
+                m_winner = command.playerId;
+                m_phase = GamePhase::RoundEnd;
+                emit(GameEventType::RoundWon, command.playerId);
+            }
+            break;
+        }
+
+        case Type::DiscardCard:
+            discardHeld(command.playerId);
+            break;
+
+        case Type::FlipCard: {
+            int8_t& slot = m_hands[command.playerId][command.slot];
+            m_hash ^= slotHash(command.playerId, command.slot);
+            slot = static_cast<int8_t>(slot | kCardFaceUp);
+            m_hash ^= slotHash(command.playerId, command.slot);
+            m_handBits[command.playerId].faceUp |= static_cast<uint16_t>(1u << command.slot);
+            emit(GameEventType::CardFlipped, command.playerId, slot, command.slot, 1);
+            break;
+        }
+
+        case Type::EndTurn:
+            discardHeld(command.playerId);
+            emit(GameEventType::TurnEnded, command.playerId);
+            advanceTurn<Policy>();
+            break;
+
+        case Type::SkipTurn:
+            discardHeld(command.playerId);
+            advanceTurn<Policy>();
+            break;
+
+        default:
+            break;
+    }
+}
+
+template <class Policy>
+void GameCore::startRound() {
+    m_phase = GamePhase::Dealing;
+    ++m_dealCount;
+    m_winner = -1;
+    m_heldCard = kNoCard;
+    emit(GameEventType::GameStarted);
+
+    // Fresh shuffled deck, in DeckBuilder card code order
+    for (int i = 0; i < Policy::kDeckSize; ++i) {
+        m_deck[i] = static_cast<int8_t>(i % Policy::kCardsPerDeck);
+    }
+    std::shuffle(m_deck, m_deck + Policy::kDeckSize, m_random);
+    m_deckCount = Policy::kDeckSize;
+    m_discardCount = 0;
+
+    int cards = Policy::cardsForRound(m_round);
+    std::memset(m_hands, kNoCard, sizeof(m_hands));
+    std::fill(m_handBits, m_handBits + kStateMaxPlayers, HandBits());
+    for (int player = 0; player < Policy::kPlayers; ++player) {
+        m_handCount[player] = cards;
+        for (int slot = 0; slot < cards; ++slot) {
+            m_hands[player][slot] = m_deck[--m_deckCount];
+            emit(GameEventType::CardDealt, player, m_hands[player][slot], slot);
+        }
+        m_handBits[player] = HandKernels::fromCards(m_hands[player], cards);
+    }
+
+    m_phase = GamePhase::Playing;
+    m_currentPlayer = 0;
+    m_hash = computePositionHash();
+    emit(GameEventType::TurnStarted, m_currentPlayer);
+}
+
+template <class Policy>
+void GameCore::advanceTurn() {
+    const ZobristKeys& keys = zobristKeys();
+    m_hash ^= keys.toMove[m_currentPlayer];
+    m_currentPlayer = (m_currentPlayer + 1) % Policy::kPlayers;
+    m_hash ^= keys.toMove[m_currentPlayer];
+    emit(GameEventType::TurnStarted, m_currentPlayer);
+}
+
+void GameCore::discardHeld(int playerId) {
+    if (m_heldCard == kNoCard) return;
+
+    int card = m_heldCard | kCardFaceUp;
+    m_hash ^= pileHash();
+    m_discard[m_discardCount++] = static_cast<int8_t>(card);
+    m_heldCard = kNoCard;
+    m_hash ^= pileHash();
+    emit(GameEventType::CardDiscarded, playerId, card);
+}
+
+void GameCore::reshuffleDiscard() {
+    // GameRules.reshuffleDiscardIntoDeck: everything but the top card, face down
+    int8_t top = m_discard[m_discardCount - 1];
+    for (int i = 0; i < m_discardCount - 1; ++i) {
+        m_deck[m_deckCount++] = static_cast<int8_t>(m_discard[i] & (kCardFaceUp - 1));
+    }
+    std::shuffle(m_deck, m_deck + m_deckCount, m_random);
+    int returned = m_discardCount - 1;
+    m_discard[0] = top;
+    m_discardCount = 1;
+    emit(GameEventType::DeckReshuffled, -1, top, -1, returned);
+}
+
+template <class Policy>
+uint32_t GameCore::placeableSlotsFor(int player, int card) const {
+    return Policy::placeableSlots(m_handBits[player], Policy::rankOf(card));
+}
+
+template <class Policy>
+const GameCore::Rules* GameCore::rulesFor() {
+    // The state block, tracker and position hash are sized for these
+    static_assert(Policy::kPlayers <= kStateMaxPlayers, "more players than the state block holds");
+    static_assert(Policy::kSlots <= kStateMaxHandSlots, "more slots than the state block holds");
+    static_assert(Policy::kDeckSize <= kDeckSize, "card tracking assumes one deck");
+    static const Rules rules = {
+        Policy::kSlots,
+        &GameCore::validatePlay<Policy>,
+        &GameCore::executePlay<Policy>,
+        &GameCore::startRound<Policy>,
+        &GameCore::placeableSlotsFor<Policy>,
+    };
+    return &rules;
+}
+
+const GameCore::Rules* GameCore::selectRules(RulesVariant variant, int players) {
+    // Indexed by player count - 2
+    static const Rules* const classic[] = {
+        rulesFor<ClassicRules<2>>(), rulesFor<ClassicRules<3>>(), rulesFor<ClassicRules<4>>(),
+    };
+    static const Rules* const quick[] = {
+        rulesFor<QuickRules<2>>(), rulesFor<QuickRules<3>>(), rulesFor<QuickRules<4>>(),
+    };
+    static_assert(sizeof(classic) / sizeof(classic[0]) == kStateMaxPlayers - 1, "one entry per player count");
+
+    int index = std::min(std::max(players, 2), kStateMaxPlayers) - 2;
+    return variant == RulesVariant::Quick ? quick[index] : classic[index];
+}
+
+int GameCore::penaltyScore(int player) const {
+    return HandKernels::penalty(m_handBits[player]);
+}
+
+bool GameCore::hasWon(int player) const {
+    return HandKernels::isComplete(m_handBits[player]);
+}
+
+uint64_t GameCore::slotHash(int player, int slot) const {
+    int card = m_hands[player][slot];
+    if (card == kNoCard) return 0;
+    const ZobristKeys& keys = zobristKeys();
+    uint64_t hash = keys.handCard[player][slot][card & (kCardFaceUp - 1)];
+    return (card & kCardFaceUp) ? hash ^ keys.faceUp[player][slot] : hash;
+}
+
+uint64_t GameCore::pileHash() const {
+    const ZobristKeys& keys = zobristKeys();
+    uint64_t hash = keys.deckCount[m_deckCount];
+    if (m_discardCount > 0) hash ^= keys.discardTop[m_discard[m_discardCount - 1] & (kCardFaceUp - 1)];
+    if (m_heldCard != kNoCard) hash ^= keys.held[m_heldCard];
+    return hash;
+}
+
+uint64_t GameCore::computePositionHash() const {
+    uint64_t hash = pileHash() ^ zobristKeys().toMove[m_currentPlayer];
+    for (int player = 0; player < m_playerCount; ++player) {
+        for (int slot = 0; slot < m_handCount[player]; ++slot) hash ^= slotHash(player, slot);
+    }
+    return hash;
+}
+
+void GameCore::emit(GameEventType type, int playerId, int card, int slot, int value) {
+    GameEvent event;
+    event.type = type;
+    event.playerId = playerId;
+    event.card = card;
+    event.slot = slot;
+    event.value = value;
+    m_tracker.observe(event);
+    if (!m_events) return;
+
+    event.timeNanos = nowNanos();
+    m_events->publish(event);
+}
+
+void GameCore::publishState() {
+    GameStateFields fields;
+    fields.match.phase = static_cast<int32_t>(m_phase);
+    fields.match.currentPlayerIndex = m_currentPlayer;
+    fields.match.currentRound = m_round;
+    fields.match.winnerId = m_winner;
+    fields.match.inputLocked = m_inputLocked ? 1 : 0;
+    fields.match.playerCount = m_playerCount;
+    fields.match.lastActionTimeMillis = m_lastActionMillis;
+
+    fields.piles.deckCount = m_deckCount;
+    fields.piles.discardCount = m_discardCount;
+    fields.piles.discardTop = m_discardCount > 0 ? m_discard[m_discardCount - 1] : kNoCard;
+
+    for (int player = 0; player < m_playerCount; ++player) {
+        fields.players[player].id = player;
+        fields.players[player].flags = (m_aiMask & (1u << player)) ? kPlayerIsAI : 0;
+        if (player == m_winner) fields.players[player].flags |= kPlayerFinished;
+        fields.players[player].handCount = m_handCount[player];
+    }
+    std::memcpy(fields.hands, m_hands, sizeof(fields.hands));
+
+    m_stateBlock.publish(fields);
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,201 @@
+#ifndef TRASHPILES_GAME_CORE_H
+#define TRASHPILES_GAME_CORE_H
+
+#include "card_tracker.h"
+#include "command_queue.h"
+#include "event_bus.h"
+#include "hand_kernels.h"
+#include "rules_policy.h"
+#include "state_block.h"
+#include "zobrist.h"
+#include <cstdint>
+#include <random>
+
+namespace TrashPiles {
+
+// GamePhase ordinals in GCMSState.kt
+enum class GamePhase : int32_t {
+    Setup = 0,
+    Dealing,
+    Playing,
+    RoundEnd,
+    GameOver
+};
+
+// Why a command was rejected; carried as the value of InvalidMove events
+// and shared with NativeCommandPipeline.kt
+enum class CommandResult : int32_t {
+    Ok = 0,
+    InputLocked,
+    WrongPhase,
+    NotYourTurn,
+    NoSuchPlayer,
+    InvalidPlayerCount,
+    PileEmpty,
+    InvalidSlot,
+    SlotFilled,
+    CardMismatch,
+    NoHeldCard,
+    AlreadyHolding,
+    UnknownCommand,
+    UnknownRules
+};
+
+const char* commandResultText(CommandResult result);
+
+/**
+ * Native game core - the Trash rules over flat state
+ * Commands arrive through an MPSC queue from any thread; tick() drains
+ * them in one batch on the game thread, validates and executes each
+ * against the native state, publishes the outcome as events on the bus,
+ * and writes the state block once for the whole batch.
+ *
+ * Rules follow GCMSValidator/GameRules: cards go in the slot matching
+ * their value (ace in slot 0), jacks, queens and kings are wild, and the
+ * round is won when every slot is face up. A drawn card is held until it
+ * is placed or discarded; the card a placement uncovers goes to the
+ * discard pile.
+ *
+ * The play rules are compiled once per variant and player count
+ * (rules_policy.h); InitializeGame picks the instantiation for the match
+ * and play commands go straight to it.
+ */
+class GameCore {
+public:
+    static constexpr int kDeckSize = 52;
+    static constexpr int kMaxBatch = 64;
+    static constexpr int kWildRankStart = 10;   // Jack
+
+    struct Stats {
+        uint64_t ticks = 0;
+        uint64_t executed = 0;
+        uint64_t rejected = 0;
+        int maxBatch = 0;
+    };
+
+    GameCore(StateBlock& stateBlock, EventBus* events, uint32_t seed = std::random_device{}());
+
+    GameCore(const GameCore&) = delete;
+    GameCore& operator=(const GameCore&) = delete;
+
+    // Any thread. False if the queue is full.
+    bool submit(const GameCommand& command);
+
+    // Game thread. Returns the number of commands drained.
+    int tick();
+
+    // Game thread; validates and executes without the queue
+    CommandResult apply(const GameCommand& command);
+
+    void setEventBus(EventBus* events) { m_events = events; }
+    void setSeed(uint32_t seed) { m_random.seed(seed); }
+
+    // Game thread state
+    GamePhase phase() const { return m_phase; }
+    int currentPlayer() const { return m_currentPlayer; }
+    int playerCount() const { return m_playerCount; }
+    RulesVariant rulesVariant() const { return m_variant; }
+    // Hand slots of the match's variant; the first round deals this many
+    int slotCount() const { return m_rules->slots; }
+    int round() const { return m_round; }
+    // Rounds dealt since construction, across matches; a new deal changes it
+    uint32_t dealCount() const { return m_dealCount; }
+    int winner() const { return m_winner; }
+    int heldCard() const { return m_heldCard; }
+    int deckCount() const { return m_deckCount; }
+    int discardCount() const { return m_discardCount; }
+    int discardTop() const { return m_discardCount > 0 ? m_discard[m_discardCount - 1] : kNoCard; }
+    int handCount(int player) const { return m_handCount[player]; }
+    int8_t handCard(int player, int slot) const { return m_hands[player][slot]; }
+    HandBits handBits(int player) const { return m_handBits[player]; }
+    // What each seat can know of the unseen cards, kept from the core's own events
+    const CardTracker& tracker() const { return m_tracker; }
+
+    // Zobrist hash of the position (hands, discard top, held card, deck
+    // size, player to move), kept in step per command; equal positions hash
+    // equal however they were reached
+    uint64_t positionHash() const { return m_hash; }
+    // The same from scratch
+    uint64_t computePositionHash() const;
+
+    // Rules queries for AI and hints; game thread
+    // Bit s set when card may be placed in the player's slot s
+    uint32_t placeableSlots(int player, int card) const { return (this->*m_rules->placeableSlots)(player, card); }
+    bool hasWon(int player) const;
+    // GameRules.calculateScore before skill effects: one point per face-down card
+    int penaltyScore(int player) const;
+
+    const Stats& stats() const { return m_stats; }
+    const CommandQueue& queue() const { return m_queue; }
+
+    // Card code helpers, for the classic wild ranks
+    static int rankOf(int code) { return (code & (kCardFaceUp - 1)) / 4; }
+    static bool isWild(int code) { return rankOf(code) >= kWildRankStart; }
+    static bool fitsSlot(int code, int slot) { return isWild(code) || rankOf(code) == slot; }
+
+private:
+    // One instantiation of the play rules, chosen at InitializeGame
+    struct Rules {
+        int slots;
+        CommandResult (GameCore::*validatePlay)(const GameCommand& command) const;
+        void (GameCore::*executePlay)(const GameCommand& command);
+        void (GameCore::*startRound)();
+        uint32_t (GameCore::*placeableSlots)(int player, int card) const;
+    };
+
+    CommandQueue m_queue;
+    StateBlock& m_stateBlock;
+    EventBus* m_events;
+    std::mt19937 m_random;
+    Stats m_stats;
+
+    GamePhase m_phase;
+    int m_playerCount;
+    RulesVariant m_variant;
+    const Rules* m_rules;
+    uint32_t m_aiMask;
+    int m_currentPlayer;
+    int m_round;
+    uint32_t m_dealCount = 0;
+    int m_winner;
+    bool m_inputLocked;
+    int m_heldCard;                 // Drawn by the current player, kNoCard if none
+    int64_t m_lastActionMillis;
+
+    int8_t m_deck[kDeckSize];       // Top at m_deckCount - 1
+    int m_deckCount;
+    int8_t m_discard[kDeckSize];    // Top at m_discardCount - 1
+    int m_discardCount;
+    int8_t m_hands[kStateMaxPlayers][kStateMaxHandSlots];
+    int m_handCount[kStateMaxPlayers];
+    HandBits m_handBits[kStateMaxPlayers];     // Kept in step with m_hands for the rules queries
+    CardTracker m_tracker;
+    uint64_t m_hash;
+
+    void reset();
+    CommandResult validate(const GameCommand& command) const;
+    void execute(const GameCommand& command);
+
+    void discardHeld(int playerId);
+    void reshuffleDiscard();
+
+    // Per variant (RulesPolicy); defined and instantiated in game_core.cpp
+    template <class Policy> static const Rules* rulesFor();
+    static const Rules* selectRules(RulesVariant variant, int players);
+    template <class Policy> CommandResult validatePlay(const GameCommand& command) const;
+    template <class Policy> void executePlay(const GameCommand& command);
+    template <class Policy> void startRound();
+    template <class Policy> void advanceTurn();
+    template <class Policy> uint32_t placeableSlotsFor(int player, int card) const;
+
+    // Hash terms of one hand slot, and of the piles and held card
+    uint64_t slotHash(int player, int slot) const;
+    uint64_t pileHash() const;
+
+    void emit(GameEventType type, int playerId = -1, int card = kNoCard, int slot = -1, int value = 0);
+    void publishState();
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_GAME_CORE_H
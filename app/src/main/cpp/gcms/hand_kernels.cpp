@@ -0,0 +1,77 @@
+#include "hand_kernels.h"
+
+#if defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+namespace TrashPiles {
+namespace HandKernels {
+
+HandBits fromCards(const int8_t* cards, int count) {
+    HandBits hand;
+    for (int slot = 0; slot < count && slot < kStateMaxHandSlots; ++slot) {
+        int8_t code = cards[slot];
+        if (code == kNoCard) continue;
+        uint16_t bit = static_cast<uint16_t>(1u << slot);
+        hand.slots |= bit;
+        if (code & kCardFaceUp) hand.faceUp |= bit;
+        if ((code & (kCardFaceUp - 1)) / 4 == slot) hand.correct |= bit;
+    }
+    return hand;
+}
+
+void penalties(const uint16_t* __restrict slots, const uint16_t* __restrict faceUp,
+               uint8_t* __restrict out, size_t count) {
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t empty = vbicq_u16(vld1q_u16(slots + i), vld1q_u16(faceUp + i));
+        uint16x8_t bits = vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u16(empty)));
+        vst1_u8(out + i, vmovn_u16(bits));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = static_cast<uint8_t>(__builtin_popcount(slots[i] & ~faceUp[i] & 0xFFFFu));
+    }
+}
+
+size_t completeHands(const uint16_t* __restrict slots, const uint16_t* __restrict faceUp,
+                     uint8_t* __restrict out, size_t count) {
+    size_t i = 0;
+    size_t complete = 0;
+#if defined(__ARM_NEON)
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t dealt = vld1q_u16(slots + i);
+        uint16x8_t empty = vbicq_u16(dealt, vld1q_u16(faceUp + i));
+        uint16x8_t done = vandq_u16(vceqq_u16(empty, vdupq_n_u16(0)), vtstq_u16(dealt, dealt));
+        uint8x8_t flags = vand_u8(vmovn_u16(done), vdup_n_u8(1));
+        vst1_u8(out + i, flags);
+        complete += vget_lane_u64(vpaddl_u32(vpaddl_u16(vpaddl_u8(flags))), 0);
+    }
+#endif
+    for (; i < count; ++i) {
+        uint8_t done = slots[i] != 0 && (slots[i] & ~faceUp[i] & 0xFFFFu) == 0;
+        out[i] = done;
+        complete += done;
+    }
+    return complete;
+}
+
+void placeableSlots(const uint16_t* __restrict slots, const uint16_t* __restrict faceUp, int rank,
+                    uint16_t* __restrict out, size_t count) {
+    uint16_t target = rank >= kWildRankStart ? kFullHand : static_cast<uint16_t>(1u << rank);
+    size_t i = 0;
+#if defined(__ARM_NEON)
+    uint16x8_t targets = vdupq_n_u16(target);
+    for (; i + 8 <= count; i += 8) {
+        uint16x8_t empty = vbicq_u16(vld1q_u16(slots + i), vld1q_u16(faceUp + i));
+        vst1q_u16(out + i, vandq_u16(empty, targets));
+    }
+#endif
+    for (; i < count; ++i) {
+        out[i] = static_cast<uint16_t>(slots[i] & ~faceUp[i] & target);
+    }
+}
+
+} // namespace HandKernels
+} // namespace TrashPiles
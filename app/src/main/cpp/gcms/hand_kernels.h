@@ -0,0 +1,77 @@
+#ifndef TRASHPILES_HAND_KERNELS_H
+#define TRASHPILES_HAND_KERNELS_H
+
+#include "state_block.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * One hand as bitboards, bit s for slot s
+ * slots marks the dealt slots, faceUp the revealed ones, and correct the
+ * slots holding their own card (rank == slot, ace in slot 0). The rules
+ * queries below are each an AND and a popcount instead of a walk over the
+ * cards.
+ */
+struct HandBits {
+    uint16_t slots = 0;
+    uint16_t faceUp = 0;
+    uint16_t correct = 0;
+};
+
+namespace HandKernels {
+
+// Slot mask of a full ten-card hand
+constexpr uint16_t kFullHand = (1u << kStateMaxHandSlots) - 1;
+// Jack and above go in any slot
+constexpr int kWildRankStart = 10;
+
+// From card codes as the state block stores them (kNoCard past the hand)
+HandBits fromCards(const int8_t* cards, int count);
+
+// GameRules.getValidSlotsForWild: the face-down slots
+inline uint16_t emptySlots(HandBits hand) {
+    return static_cast<uint16_t>(hand.slots & ~hand.faceUp);
+}
+
+// GameRules.calculateScore before skill effects: one per face-down card
+inline int penalty(HandBits hand) {
+    return __builtin_popcount(emptySlots(hand));
+}
+
+// GameCore::hasWon: something dealt and all of it face up
+inline bool isComplete(HandBits hand) {
+    return hand.slots != 0 && emptySlots(hand) == 0;
+}
+
+// GameRules.hasPlayerWon: ten cards, all face up in their own slots
+inline bool isOrderedWin(HandBits hand) {
+    return hand.slots == kFullHand && (hand.faceUp & hand.correct) == kFullHand;
+}
+
+// Slots a card of this rank may go in: its own if still face down, or any
+// face-down slot for a wild
+inline uint16_t placeableSlots(HandBits hand, int rank) {
+    uint16_t target = rank >= kWildRankStart ? kFullHand : static_cast<uint16_t>(1u << rank);
+    return static_cast<uint16_t>(emptySlots(hand) & target);
+}
+
+// Batch forms over count hands stored as parallel mask arrays, for
+// simulations and AI rollouts. NEON on ARM, plain loops elsewhere (written
+// so the compiler can vectorize them).
+
+// out[i] = penalty of hand i
+void penalties(const uint16_t* slots, const uint16_t* faceUp, uint8_t* out, size_t count);
+
+// out[i] = 1 if hand i is complete, else 0; returns how many are
+size_t completeHands(const uint16_t* slots, const uint16_t* faceUp, uint8_t* out, size_t count);
+
+// out[i] = slots of hand i a card of this rank may go in
+void placeableSlots(const uint16_t* slots, const uint16_t* faceUp, int rank, uint16_t* out, size_t count);
+
+} // namespace HandKernels
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_HAND_KERNELS_H
@@ -0,0 +1,91 @@
+#include "hint_advisor.h"
+
+namespace TrashPiles {
+
+namespace {
+
+// TranspositionEntry::move: slot in the low byte (0xFF for none), bit 8 for a discard take
+constexpr uint16_t kMoveNoSlot = 0xFF;
+constexpr uint16_t kMoveFromDiscard = 0x100;
+
+uint16_t packMove(const HintMove& move) {
+    uint16_t packed = move.slot >= 0 ? static_cast<uint16_t>(move.slot) : kMoveNoSlot;
+    return move.fromDiscard ? static_cast<uint16_t>(packed | kMoveFromDiscard) : packed;
+}
+
+HintMove unpackMove(const TranspositionEntry& entry) {
+    HintMove move;
+    move.fromDiscard = (entry.move & kMoveFromDiscard) != 0;
+    int slot = entry.move & 0xFF;
+    move.slot = slot == kMoveNoSlot ? -1 : slot;
+    move.confidence = entry.value;
+    return move;
+}
+
+} // namespace
+
+uint64_t HintAdvisor::key(uint64_t positionHash, uint64_t seen, int player) {
+    // splitmix64 finalizer: nearby seen sets land far apart
+    uint64_t z = seen + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    uint64_t observer = player >= 0 && player < kStateMaxPlayers ? zobristKeys().observer[player] : 0;
+    return positionHash ^ observer ^ z;
+}
+
+HintMove HintAdvisor::hint(const GameCore& core, int player) {
+    uint32_t deal = core.dealCount();
+    if (m_dealCount.exchange(deal, std::memory_order_relaxed) != deal) m_table.newGeneration();
+
+    uint64_t positionKey = key(core, player);
+    TranspositionEntry entry;
+    if (m_table.probe(positionKey, &entry)) return unpackMove(entry);
+
+    HintMove move = evaluate(core, player);
+    entry.value = move.confidence;
+    entry.move = packMove(move);
+    entry.depth = 1;
+    m_table.store(positionKey, entry);
+    return move;
+}
+
+HintMove HintAdvisor::evaluate(const GameCore& core, int player) {
+    HintMove move;
+    if (player < 0 || player >= core.playerCount()) {
+        move.confidence = 0.5f;
+        return move;
+    }
+
+    HandBits hand = core.handBits(player);
+    uint16_t emptySlots = HandKernels::emptySlots(hand);
+    const CardTracker& tracker = core.tracker();
+
+    int top = core.discardTop();
+    if (top != kNoCard) {
+        uint32_t slots = core.placeableSlots(player, top);
+        if (slots) {
+            move.fromDiscard = true;
+            move.confidence = 0.9f;
+            move.slot = __builtin_ctz(slots);
+            if (GameCore::isWild(top)) {
+                // The slot least likely to get its own card
+                int fewest = tracker.unseenOfRank(player, move.slot);
+                for (slots &= slots - 1; slots; slots &= slots - 1) {
+                    int slot = __builtin_ctz(slots);
+                    int unseen = tracker.unseenOfRank(player, slot);
+                    if (unseen < fewest) {
+                        fewest = unseen;
+                        move.slot = slot;
+                    }
+                }
+            }
+            return move;
+        }
+    }
+
+    move.confidence = tracker.fitOdds(player, emptySlots);
+    return move;
+}
+
+} // namespace TrashPiles
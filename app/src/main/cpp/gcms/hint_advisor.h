@@ -0,0 +1,56 @@
+#ifndef TRASHPILES_HINT_ADVISOR_H
+#define TRASHPILES_HINT_ADVISOR_H
+
+#include "game_core.h"
+#include "transposition_table.h"
+#include <atomic>
+
+namespace TrashPiles {
+
+// The draw a hint suggests, as GameRules.computeAIHint describes it
+struct HintMove {
+    bool fromDiscard = false;
+    int slot = -1;                  // Where a taken discard goes
+    float confidence = 0.0f;
+};
+
+/**
+ * Native AI hints, cached by position
+ * Evaluates the GameRules.computeAIHint play against GameCore: take the
+ * discard top when it fits a face-down slot (a wild goes to the slot with
+ * the fewest of its own rank still unseen), otherwise draw from the deck,
+ * with the tracker's odds of a fitting card as the confidence.
+ *
+ * Results go in a transposition table under the position hash mixed with
+ * the asking player and the cards that player has seen, so a repeated
+ * request for an unchanged position (UI re-requests, pause and resume, a
+ * position reached again with the same discard history) is one probe.
+ * The position hash alone misses the discard pile below its top, which
+ * the odds depend on.
+ * Each new deal (a match start or a new round) starts a table generation,
+ * so hints from earlier rounds are the first to be replaced. The table may
+ * be shared with other searchers; hint() is safe from any thread that may
+ * read the core.
+ */
+class HintAdvisor {
+public:
+    explicit HintAdvisor(TranspositionTable& table) : m_table(table) {}
+
+    HintMove hint(const GameCore& core, int player);
+
+    // The hint from scratch, without the table
+    static HintMove evaluate(const GameCore& core, int player);
+
+    static uint64_t key(uint64_t positionHash, uint64_t seen, int player);
+    static uint64_t key(const GameCore& core, int player) {
+        return key(core.positionHash(), core.tracker().seen(player), player);
+    }
+
+private:
+    TranspositionTable& m_table;
+    std::atomic<uint32_t> m_dealCount{0};   // Core deal the current generation belongs to
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_HINT_ADVISOR_H
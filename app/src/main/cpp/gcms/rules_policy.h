@@ -0,0 +1,69 @@
+#ifndef TRASHPILES_RULES_POLICY_H
+#define TRASHPILES_RULES_POLICY_H
+
+#include "hand_kernels.h"
+#include "state_block.h"
+#include <cstdint>
+
+namespace TrashPiles {
+
+// Rule variants a match can be initialized with; InitializeGame carries the
+// value in its slot field (NativeCommandPipeline.RULES_*)
+enum class RulesVariant : int32_t {
+    Classic = 0,        // Ten slots, jacks to kings wild
+    Quick,              // Five slots (ace to five), jacks to kings wild
+    Count
+};
+
+/**
+ * Compile-time rules of one variant
+ * GameCore's play rules are templates over a policy, so each variant is
+ * compiled with its player count, hand size, deck size and wild ranks as
+ * constants: loops over players and slots have fixed trip counts, turn
+ * order is a modulo by a constant, and nothing checks a rules setting at
+ * run time. GameCore picks the instantiation once, when the match is
+ * initialized.
+ *
+ * Card codes stay rank * 4 + suit; with more than one deck, each code is
+ * in the deck that many times.
+ */
+template <int PlayersN, int SlotsN, int DecksN = 1, int WildRankStartN = HandKernels::kWildRankStart>
+struct RulesPolicy {
+    static constexpr int kPlayers = PlayersN;
+    static constexpr int kSlots = SlotsN;
+    static constexpr int kDecks = DecksN;
+    static constexpr int kWildRankStart = WildRankStartN;
+    static constexpr int kCardsPerDeck = 52;
+    static constexpr int kDeckSize = kCardsPerDeck * kDecks;
+    static constexpr uint16_t kFullHand = static_cast<uint16_t>((1u << kSlots) - 1);
+
+    static_assert(kPlayers >= 2, "a match needs two players");
+    static_assert(kSlots >= 1 && kSlots <= 16, "HandBits holds at most 16 slots");
+    static_assert(kSlots <= kWildRankStart, "a slot's own rank must not be wild");
+    static_assert(kPlayers * kSlots < kDeckSize, "the deal must leave a deck");
+
+    // GameRules.initializeRound: a full hand in the first round, one fewer each round
+    static constexpr int cardsForRound(int round) {
+        return round >= kSlots ? 1 : (round < 1 ? kSlots : kSlots + 1 - round);
+    }
+
+    static constexpr int rankOf(int code) { return (code & (kCardFaceUp - 1)) / 4; }
+    static constexpr bool isWild(int code) { return rankOf(code) >= kWildRankStart; }
+    static constexpr bool fitsSlot(int code, int slot) { return isWild(code) || rankOf(code) == slot; }
+
+    // Face-down slots a card of this rank may go in; ranks past the hand fit nowhere
+    static constexpr uint16_t placeableSlots(HandBits hand, int rank) {
+        return static_cast<uint16_t>(HandKernels::emptySlots(hand) &
+                                     (rank >= kWildRankStart ? kFullHand
+                                      : rank < kSlots        ? 1u << rank
+                                                             : 0u));
+    }
+};
+
+// The shipped variants, one instantiation per player count
+template <int Players> using ClassicRules = RulesPolicy<Players, 10>;
+template <int Players> using QuickRules = RulesPolicy<Players, 5>;
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_RULES_POLICY_H
@@ -0,0 +1,191 @@
+#include "skill_effect_table.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace TrashPiles {
+
+namespace {
+
+constexpr uint32_t kScoreTypes = (1u << static_cast<int>(SkillEffectKind::ScoreMultiplier)) |
+                                 (1u << static_cast<int>(SkillEffectKind::Shield)) |
+                                 (1u << static_cast<int>(SkillEffectKind::DoublePoints));
+
+bool affectsScore(int type) {
+    return (kScoreTypes >> type) & 1u;
+}
+
+// Kotlin's Float.toInt(): truncates, saturates, NaN is 0
+int32_t kotlinToInt(float value) {
+    if (std::isnan(value)) return 0;
+    if (value >= static_cast<float>(std::numeric_limits<int32_t>::max())) return std::numeric_limits<int32_t>::max();
+    if (value <= static_cast<float>(std::numeric_limits<int32_t>::min())) return std::numeric_limits<int32_t>::min();
+    return static_cast<int32_t>(value);
+}
+
+} // namespace
+
+SkillEffectTable::SkillEffectTable() {
+    clear();
+}
+
+void SkillEffectTable::clear() {
+    std::fill(m_remaining, m_remaining + kMaxEffects, 0);
+    std::fill(m_duration, m_duration + kMaxEffects, 0);
+    std::fill(m_value, m_value + kMaxEffects, 0.0f);
+    std::fill(m_sequence, m_sequence + kMaxEffects, 0u);
+    std::fill(m_player, m_player + kMaxEffects, uint8_t(0));
+    std::fill(m_type, m_type + kMaxEffects, uint8_t(0));
+    m_live = 0;
+    m_nextSequence = 0;
+    for (int player = 0; player < kMaxPlayers; ++player) {
+        std::fill(m_slots[player], m_slots[player] + kTypeCount, 0ull);
+        compileScores(player);
+    }
+}
+
+bool SkillEffectTable::add(int player, SkillEffectKind type, float value, int32_t duration) {
+    int typeIndex = static_cast<int>(type);
+    if (player < 0 || player >= kMaxPlayers || typeIndex < 0 || typeIndex >= kTypeCount) return false;
+
+    uint64_t spent = 0;
+    for (uint64_t slots = m_slots[player][typeIndex]; slots; slots &= slots - 1) {
+        int slot = __builtin_ctzll(slots);
+        if (m_remaining[slot] <= 0) spent |= 1ull << slot;
+    }
+    release(spent);
+
+    uint64_t vacant = ~m_live;
+    if (vacant == 0) {
+        if (spent && affectsScore(typeIndex)) compileScores(player);
+        return false;
+    }
+
+    int slot = __builtin_ctzll(vacant);
+    m_remaining[slot] = duration;
+    m_duration[slot] = duration;
+    m_value[slot] = value;
+    m_sequence[slot] = m_nextSequence++;
+    m_player[slot] = static_cast<uint8_t>(player);
+    m_type[slot] = static_cast<uint8_t>(typeIndex);
+    m_live |= 1ull << slot;
+    m_slots[player][typeIndex] |= 1ull << slot;
+
+    if (affectsScore(typeIndex)) compileScores(player);
+    return true;
+}
+
+void SkillEffectTable::advanceTurn() {
+    // Timed effects tick down; permanent and free slots have duration <= 0
+    for (int slot = 0; slot < kMaxEffects; ++slot) {
+        m_remaining[slot] -= m_duration[slot] > 0 ? 1 : 0;
+    }
+
+    uint64_t expired = 0;
+    for (int slot = 0; slot < kMaxEffects; ++slot) {
+        bool keep = m_remaining[slot] > 0 || m_duration[slot] == kPermanent;
+        expired |= static_cast<uint64_t>(!keep) << slot;
+    }
+    expired &= m_live;
+    if (!expired) return;
+
+    bool recompile[kMaxPlayers] = {};
+    for (uint64_t slots = expired; slots; slots &= slots - 1) {
+        int slot = __builtin_ctzll(slots);
+        if (affectsScore(m_type[slot])) recompile[m_player[slot]] = true;
+    }
+    release(expired);
+    for (int player = 0; player < kMaxPlayers; ++player) {
+        if (recompile[player]) compileScores(player);
+    }
+}
+
+void SkillEffectTable::release(uint64_t slots) {
+    m_live &= ~slots;
+    for (; slots; slots &= slots - 1) {
+        int slot = __builtin_ctzll(slots);
+        m_slots[m_player[slot]][m_type[slot]] &= ~(1ull << slot);
+        m_remaining[slot] = 0;
+        m_duration[slot] = 0;
+    }
+}
+
+bool SkillEffectTable::has(int player, SkillEffectKind type) const {
+    int typeIndex = static_cast<int>(type);
+    if (player < 0 || player >= kMaxPlayers || typeIndex < 0 || typeIndex >= kTypeCount) return false;
+    for (uint64_t slots = m_slots[player][typeIndex]; slots; slots &= slots - 1) {
+        if (counts(__builtin_ctzll(slots))) return true;
+    }
+    return false;
+}
+
+float SkillEffectTable::value(int player, SkillEffectKind type) const {
+    int typeIndex = static_cast<int>(type);
+    if (player < 0 || player >= kMaxPlayers || typeIndex < 0 || typeIndex >= kTypeCount) return 1.0f;
+
+    // First in list order: the oldest one still counting
+    int first = -1;
+    for (uint64_t slots = m_slots[player][typeIndex]; slots; slots &= slots - 1) {
+        int slot = __builtin_ctzll(slots);
+        if (counts(slot) && (first < 0 || m_sequence[slot] < m_sequence[first])) first = slot;
+    }
+    return first < 0 ? 1.0f : m_value[first];
+}
+
+int32_t SkillEffectTable::score(int player, int32_t baseScore) const {
+    if (player < 0 || player >= kMaxPlayers) return baseScore;
+    if (baseScore >= 0 && baseScore <= kMaxBaseScore) return m_scoreTable[player][baseScore];
+    return applyScoreEffects(player, baseScore);
+}
+
+void SkillEffectTable::scores(const int32_t* baseScores, int32_t* out, int count) const {
+    count = std::min(count, kMaxPlayers);
+    for (int player = 0; player < count; ++player) {
+        out[player] = score(player, baseScores[player]);
+    }
+}
+
+int SkillEffectTable::activeCount() const {
+    return __builtin_popcountll(m_live);
+}
+
+void SkillEffectTable::compileScores(int player) {
+    for (int32_t base = 0; base <= kMaxBaseScore; ++base) {
+        m_scoreTable[player][base] = applyScoreEffects(player, base);
+    }
+}
+
+// calculateScore's loop: every listed score effect, in list order, whether
+// or not it has turns left
+int32_t SkillEffectTable::applyScoreEffects(int player, int32_t baseScore) const {
+    int ordered[kMaxEffects];
+    int count = 0;
+    for (int type = 0; type < kTypeCount; ++type) {
+        if (!affectsScore(type)) continue;
+        for (uint64_t slots = m_slots[player][type]; slots; slots &= slots - 1) {
+            ordered[count++] = __builtin_ctzll(slots);
+        }
+    }
+    std::sort(ordered, ordered + count, [this](int a, int b) { return m_sequence[a] < m_sequence[b]; });
+
+    int32_t score = baseScore;
+    for (int i = 0; i < count; ++i) {
+        int slot = ordered[i];
+        switch (static_cast<SkillEffectKind>(m_type[slot])) {
+            case SkillEffectKind::ScoreMultiplier:
+                score = kotlinToInt(static_cast<float>(score) * m_value[slot]);
+                break;
+            case SkillEffectKind::DoublePoints:
+                score = static_cast<int32_t>(static_cast<uint32_t>(score) * 2u);
+                break;
+            case SkillEffectKind::Shield:
+                score = std::max(0, static_cast<int32_t>(static_cast<uint32_t>(score) - 1u));
+                break;
+            default:
+                break;
+        }
+    }
+    return score;
+}
+
+} // namespace TrashPiles
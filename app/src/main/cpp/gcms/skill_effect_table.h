@@ -0,0 +1,94 @@
+#ifndef TRASHPILES_SKILL_EFFECT_TABLE_H
+#define TRASHPILES_SKILL_EFFECT_TABLE_H
+
+#include "state_block.h"
+#include <cstdint>
+
+namespace TrashPiles {
+
+// SkillEffectType ordinals in GCMSState.kt
+enum class SkillEffectKind : uint8_t {
+    ScoreMultiplier = 0,
+    DrawBonus,
+    DiscountCost,
+    WildCardBonus,
+    LuckyDraw,
+    Shield,
+    DoublePoints,
+    InstantPlace,
+    Count
+};
+
+/**
+ * Active skill effects for one match, indexed by player and effect type
+ * Mirrors GCMSState.activeSkillEffects with the list semantics of
+ * addSkillEffect, updateSkillEffects, hasSkillEffect, getSkillEffectValue
+ * and GameRules.calculateScore. Effects live in fixed structure-of-arrays
+ * slots, so the start-of-turn decrement is one branch-free pass over every
+ * slot; each (player, type) pair keeps a bitmask of its slots.
+ *
+ * The score effects (multiplier, double points, shield) only change when
+ * effects are added or expire, so each player's effects are compiled then
+ * into a table of final scores for every base score a hand can produce;
+ * scoring a round is a lookup per player however many effects are active.
+ * Single-threaded: owned by the game thread.
+ */
+class SkillEffectTable {
+public:
+    static constexpr int kMaxPlayers = kStateMaxPlayers;
+    static constexpr int kMaxEffects = 64;
+    static constexpr int kTypeCount = static_cast<int>(SkillEffectKind::Count);
+    // Base scores are face-down cards, so at most one per hand slot
+    static constexpr int kMaxBaseScore = kStateMaxHandSlots;
+    static constexpr int32_t kPermanent = -1;
+
+    SkillEffectTable();
+
+    // addSkillEffect: drops the player's effects of this type with no turns
+    // left (permanent ones included, as in Kotlin), then appends. False if
+    // the player is out of range or every slot is taken.
+    bool add(int player, SkillEffectKind type, float value, int32_t duration);
+
+    // updateSkillEffects: timed effects lose a turn, and anything neither
+    // permanent nor with turns left is removed
+    void advanceTurn();
+
+    void clear();
+
+    // hasSkillEffect / getSkillEffectValue (1.0 when absent)
+    bool has(int player, SkillEffectKind type) const;
+    float value(int player, SkillEffectKind type) const;
+
+    // calculateScore for one player from the face-down card count
+    int32_t score(int player, int32_t baseScore) const;
+    // The same for players 0..count-1 at once
+    void scores(const int32_t* baseScores, int32_t* out, int count) const;
+
+    int activeCount() const;
+    int32_t remainingTurns(int slot) const { return m_remaining[slot]; }
+
+private:
+    // Slot arrays, in one layout the decrement pass can vectorize over;
+    // free slots hold duration 0 so the pass leaves them alone
+    alignas(64) int32_t m_remaining[kMaxEffects];
+    alignas(64) int32_t m_duration[kMaxEffects];
+    float m_value[kMaxEffects];
+    uint32_t m_sequence[kMaxEffects];
+    uint8_t m_player[kMaxEffects];
+    uint8_t m_type[kMaxEffects];
+
+    uint64_t m_live = 0;
+    uint64_t m_slots[kMaxPlayers][kTypeCount];
+    uint32_t m_nextSequence = 0;
+
+    int32_t m_scoreTable[kMaxPlayers][kMaxBaseScore + 1];
+
+    bool counts(int slot) const { return m_remaining[slot] > 0 || m_duration[slot] == kPermanent; }
+    void release(uint64_t slots);
+    void compileScores(int player);
+    int32_t applyScoreEffects(int player, int32_t baseScore) const;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_SKILL_EFFECT_TABLE_H
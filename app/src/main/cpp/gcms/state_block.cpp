@@ -0,0 +1,81 @@
+#include "state_block.h"
+#include <cstring>
+
+namespace TrashPiles {
+
+// The Kotlin mirror reads these offsets directly
+static_assert(offsetof(StateBlockData, sequence) == 8, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, sectionVersion) == 12, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, fields) == 32, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, fields.match.lastActionTimeMillis) == 56, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, fields.piles) == 64, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, fields.players) == 80, "StateBlock layout changed");
+static_assert(offsetof(StateBlockData, fields.hands) == 144, "StateBlock layout changed");
+static_assert(sizeof(StateBlockData) == 184, "StateBlock layout changed");
+
+GameStateFields::GameStateFields() {
+    std::memset(hands, kNoCard, sizeof(hands));
+}
+
+StateBlock::StateBlock()
+    : m_data() {}
+
+bool StateBlock::publish(const GameStateFields& next) {
+    GameStateFields& current = m_data.fields;
+
+    // The writer is the only one that modifies the block, so it can compare
+    // against it without the seqlock
+    bool changed[kSectionCount] = {
+        std::memcmp(&current.match, &next.match, sizeof(next.match)) != 0,
+        std::memcmp(&current.piles, &next.piles, sizeof(next.piles)) != 0,
+        std::memcmp(current.players, next.players, sizeof(next.players)) != 0,
+        std::memcmp(current.hands, next.hands, sizeof(next.hands)) != 0,
+    };
+    if (!changed[kSectionMatch] && !changed[kSectionPiles] &&
+        !changed[kSectionPlayers] && !changed[kSectionHands]) {
+        return false;
+    }
+
+    uint32_t sequence = __atomic_load_n(&m_data.sequence, __ATOMIC_RELAXED);
+    __atomic_store_n(&m_data.sequence, sequence + 1, __ATOMIC_RELAXED);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    if (changed[kSectionMatch]) current.match = next.match;
+    if (changed[kSectionPiles]) current.piles = next.piles;
+    if (changed[kSectionPlayers]) std::memcpy(current.players, next.players, sizeof(next.players));
+    if (changed[kSectionHands]) std::memcpy(current.hands, next.hands, sizeof(next.hands));
+    for (int section = 0; section < kSectionCount; ++section) {
+        if (changed[section]) {
+            __atomic_store_n(&m_data.sectionVersion[section], sequence + 2, __ATOMIC_RELAXED);
+        }
+    }
+
+    __atomic_store_n(&m_data.sequence, sequence + 2, __ATOMIC_RELEASE);
+    return true;
+}
+
+bool StateBlock::read(GameStateFields& out, uint32_t* sectionVersions, int maxAttempts) const {
+    for (int attempt = 0; attempt < maxAttempts; ++attempt) {
+        uint32_t before = __atomic_load_n(&m_data.sequence, __ATOMIC_ACQUIRE);
+        if (before & 1) continue;
+
+        std::memcpy(&out, &m_data.fields, sizeof(out));
+        if (sectionVersions) {
+            std::memcpy(sectionVersions, m_data.sectionVersion, sizeof(m_data.sectionVersion));
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (__atomic_load_n(&m_data.sequence, __ATOMIC_RELAXED) == before) return true;
+    }
+    return false;
+}
+
+uint32_t StateBlock::sequence() const {
+    return __atomic_load_n(&m_data.sequence, __ATOMIC_ACQUIRE);
+}
+
+uint32_t StateBlock::sectionVersion(StateSection section) const {
+    return __atomic_load_n(&m_data.sectionVersion[section], __ATOMIC_ACQUIRE);
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,122 @@
+#ifndef TRASHPILES_STATE_BLOCK_H
+#define TRASHPILES_STATE_BLOCK_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace TrashPiles {
+
+constexpr uint32_t kStateBlockMagic = 0x42535054;   // "TPSB"
+constexpr uint32_t kStateBlockLayoutVersion = 1;
+constexpr int kStateMaxPlayers = 4;
+constexpr int kStateMaxHandSlots = 10;
+
+// Card codes: rank * 4 + suit, ranks ace..king, suits spades, hearts, clubs,
+// diamonds; kCardFaceUp is or'ed in for a face-up card
+constexpr int8_t kNoCard = -1;
+constexpr int8_t kCardFaceUp = 0x40;
+
+inline int8_t makeCardCode(int rank, int suit, bool faceUp) {
+    return static_cast<int8_t>(rank * 4 + suit + (faceUp ? kCardFaceUp : 0));
+}
+
+// Sections version independently so readers can skip what did not change
+enum StateSection : int {
+    kSectionMatch = 0,
+    kSectionPiles,
+    kSectionPlayers,
+    kSectionHands,
+    kSectionCount
+};
+
+constexpr int32_t kPlayerIsAI = 1 << 0;
+constexpr int32_t kPlayerFinished = 1 << 1;
+
+/**
+ * Game state in flat, fixed-offset form
+ * Mirrors the fields of GCMSState the UI draws. Plain data so it can be
+ * compared and copied per section.
+ */
+struct GameStateFields {
+    // Match section
+    struct Match {
+        int32_t phase = 0;              // GamePhase ordinal
+        int32_t currentPlayerIndex = 0;
+        int32_t currentRound = 1;
+        int32_t winnerId = -1;          // -1 while undecided
+        int32_t inputLocked = 0;
+        int32_t playerCount = 0;
+        int64_t lastActionTimeMillis = 0;
+    } match;
+
+    // Piles section
+    struct Piles {
+        int32_t deckCount = 0;
+        int32_t discardCount = 0;
+        int32_t discardTop = kNoCard;
+        int32_t reserved = 0;
+    } piles;
+
+    // Players section
+    struct Player {
+        int32_t id = 0;
+        int32_t score = 0;
+        int32_t flags = 0;              // kPlayerIsAI | kPlayerFinished
+        int32_t handCount = 0;
+    } players[kStateMaxPlayers];
+
+    // Hands section, kNoCard for empty slots
+    int8_t hands[kStateMaxPlayers][kStateMaxHandSlots];
+
+    GameStateFields();
+};
+
+/**
+ * Memory image shared with Kotlin through a direct ByteBuffer
+ * Offsets are part of the contract with GameStateMirror.kt; the
+ * static_asserts in state_block.cpp pin them.
+ */
+struct StateBlockData {
+    uint32_t magic = kStateBlockMagic;
+    uint32_t layoutVersion = kStateBlockLayoutVersion;
+    uint32_t sequence = 0;                       // Seqlock: odd while a write is in progress
+    uint32_t sectionVersion[kSectionCount] = {}; // Sequence at which each section last changed
+    uint32_t reserved = 0;
+    GameStateFields fields;
+};
+
+/**
+ * Versioned, seqlock-protected game state block
+ * One writer publishes whole snapshots; only sections that differ from the
+ * current contents are written and have their version bumped. Readers, in
+ * native code or Kotlin over the same memory, retry until they see the same
+ * even sequence before and after reading.
+ */
+class StateBlock {
+public:
+    StateBlock();
+
+    StateBlock(const StateBlock&) = delete;
+    StateBlock& operator=(const StateBlock&) = delete;
+
+    // Writer side, single thread. Returns false if nothing changed.
+    bool publish(const GameStateFields& next);
+
+    // Consistent copy; false if a writer kept the block busy for every attempt
+    bool read(GameStateFields& out, uint32_t* sectionVersions = nullptr, int maxAttempts = 64) const;
+
+    uint32_t sequence() const;
+    uint32_t sectionVersion(StateSection section) const;
+
+    // For the direct ByteBuffer
+    void* data() { return &m_data; }
+    size_t size() const { return sizeof(m_data); }
+
+private:
+    alignas(64) StateBlockData m_data;
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_STATE_BLOCK_H
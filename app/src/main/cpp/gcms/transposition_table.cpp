@@ -0,0 +1,117 @@
+#include "transposition_table.h"
+#include <cstring>
+
+namespace TrashPiles {
+
+namespace {
+
+// data word: value bits 0..31, move 32..47, depth 48..55, generation 56..63.
+// Generations run 1..255, so a stored entry is never 0.
+uint64_t pack(const TranspositionEntry& entry, uint32_t generation) {
+    uint32_t value;
+    std::memcpy(&value, &entry.value, sizeof(value));
+    return uint64_t(value) | (uint64_t(entry.move) << 32) | (uint64_t(entry.depth) << 48) |
+           (uint64_t(generation) << 56);
+}
+
+TranspositionEntry unpack(uint64_t data) {
+    TranspositionEntry entry;
+    uint32_t value = static_cast<uint32_t>(data);
+    std::memcpy(&entry.value, &value, sizeof(value));
+    entry.move = static_cast<uint16_t>(data >> 32);
+    entry.depth = static_cast<uint8_t>(data >> 48);
+    return entry;
+}
+
+uint32_t generationOf(uint64_t data) {
+    return static_cast<uint32_t>(data >> 56);
+}
+
+} // namespace
+
+TranspositionTable::TranspositionTable(int log2Buckets)
+    : m_buckets(new Bucket[size_t(1) << log2Buckets]),
+      m_mask((uint64_t(1) << log2Buckets) - 1),
+      m_generation(1) {}
+
+bool TranspositionTable::probe(uint64_t key, TranspositionEntry* out) {
+    m_probes.fetch_add(1, std::memory_order_relaxed);
+    const Bucket& bucket = m_buckets[key & m_mask];
+    for (const Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data != 0 && (check ^ data) == key) {
+            *out = unpack(data);
+            m_hits.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TranspositionTable::store(uint64_t key, const TranspositionEntry& entry) {
+    uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    Bucket& bucket = m_buckets[key & m_mask];
+
+    Slot* victim = nullptr;
+    bool evicts = true;
+    int worst = 0;
+    for (Slot& slot : bucket.slots) {
+        uint64_t data = slot.data.load(std::memory_order_relaxed);
+        uint64_t check = slot.check.load(std::memory_order_relaxed);
+        if (data == 0) {
+            victim = &slot;
+            evicts = false;
+            break;
+        }
+        if ((check ^ data) == key) {
+            // Keep a deeper result from this search
+            if (generationOf(data) == generation && unpack(data).depth > entry.depth) return;
+            victim = &slot;
+            evicts = false;
+            break;
+        }
+        // Older generations first, then shallower results
+        int age = static_cast<int>((generation - generationOf(data) + 255) % 255);
+        int score = unpack(data).depth - 256 * age;
+        if (!victim || score < worst) {
+            victim = &slot;
+            worst = score;
+        }
+    }
+
+    uint64_t data = pack(entry, generation);
+    victim->data.store(data, std::memory_order_relaxed);
+    victim->check.store(key ^ data, std::memory_order_relaxed);
+    m_stores.fetch_add(1, std::memory_order_relaxed);
+    if (evicts) m_replaced.fetch_add(1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::newGeneration() {
+    uint32_t generation = m_generation.load(std::memory_order_relaxed);
+    m_generation.store(generation % 255 + 1, std::memory_order_relaxed);
+}
+
+void TranspositionTable::clear() {
+    for (uint64_t i = 0; i <= m_mask; ++i) {
+        for (Slot& slot : m_buckets[i].slots) {
+            slot.data.store(0, std::memory_order_relaxed);
+            slot.check.store(0, std::memory_order_relaxed);
+        }
+    }
+    m_probes.store(0, std::memory_order_relaxed);
+    m_hits.store(0, std::memory_order_relaxed);
+    m_stores.store(0, std::memory_order_relaxed);
+    m_replaced.store(0, std::memory_order_relaxed);
+}
+
+TranspositionTable::Stats TranspositionTable::stats() const {
+    Stats stats;
+    stats.probes = m_probes.load(std::memory_order_relaxed);
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.stores = m_stores.load(std::memory_order_relaxed);
+    stats.replaced = m_replaced.load(std::memory_order_relaxed);
+    return stats;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,83 @@
+#ifndef TRASHPILES_TRANSPOSITION_TABLE_H
+#define TRASHPILES_TRANSPOSITION_TABLE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace TrashPiles {
+
+// What a search or hint concluded about a position
+struct TranspositionEntry {
+    float value = 0.0f;
+    uint16_t move = 0;          // Best action, packed by the caller
+    uint8_t depth = 0;          // How deep the result was searched; deeper results are kept first
+};
+
+/**
+ * Bounded transposition table shared by AI threads without locks
+ * Keyed by position hash (GameCore::positionHash, optionally mixed with the
+ * asking player). Four entries share a 64-byte bucket. Each entry is two
+ * atomic words, the packed data and the key XORed with it, so a probe that
+ * races a store sees a key mismatch (a miss) rather than a torn result.
+ * When a bucket is full, a store replaces the entry from the oldest search
+ * generation, then the shallowest.
+ *
+ * Hit, miss and store counts are relaxed atomics, for the hit-rate stats.
+ */
+class TranspositionTable {
+public:
+    static constexpr int kBucketEntries = 4;
+
+    struct Stats {
+        uint64_t probes = 0;
+        uint64_t hits = 0;
+        uint64_t stores = 0;
+        uint64_t replaced = 0;      // Stores that evicted another position
+        double hitRate() const { return probes ? static_cast<double>(hits) / probes : 0.0; }
+    };
+
+    // 2^log2Buckets buckets of kBucketEntries entries
+    explicit TranspositionTable(int log2Buckets = 10);
+
+    TranspositionTable(const TranspositionTable&) = delete;
+    TranspositionTable& operator=(const TranspositionTable&) = delete;
+
+    // Any thread
+    bool probe(uint64_t key, TranspositionEntry* out);
+    void store(uint64_t key, const TranspositionEntry& entry);
+
+    // Start of a new search (a new match or position); older entries go first
+    void newGeneration();
+    uint32_t generation() const { return m_generation.load(std::memory_order_relaxed); }
+
+    // Not concurrently with probes or stores
+    void clear();
+
+    Stats stats() const;
+    size_t capacity() const { return (m_mask + 1) * kBucketEntries; }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> check{0};     // key ^ data
+        std::atomic<uint64_t> data{0};      // 0 when empty
+    };
+
+    struct alignas(64) Bucket {
+        Slot slots[kBucketEntries];
+    };
+
+    std::unique_ptr<Bucket[]> m_buckets;
+    uint64_t m_mask;
+    std::atomic<uint32_t> m_generation;
+
+    alignas(64) std::atomic<uint64_t> m_probes{0};
+    std::atomic<uint64_t> m_hits{0};
+    alignas(64) std::atomic<uint64_t> m_stores{0};
+    std::atomic<uint64_t> m_replaced{0};
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_TRANSPOSITION_TABLE_H
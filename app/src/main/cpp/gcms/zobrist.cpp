@@ -0,0 +1,45 @@
+#include "zobrist.h"
+
+namespace TrashPiles {
+
+namespace {
+
+// splitmix64: well mixed keys from a counter
+uint64_t nextKey(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+template <size_t N>
+void fill(uint64_t (&keys)[N], uint64_t& state) {
+    for (uint64_t& key : keys) key = nextKey(state);
+}
+
+template <size_t N, size_t M>
+void fill(uint64_t (&keys)[N][M], uint64_t& state) {
+    for (auto& row : keys) fill(row, state);
+}
+
+ZobristKeys makeKeys() {
+    ZobristKeys keys;
+    uint64_t state = 0x5452415348504C53ull;     // "TRASHPLS"
+    for (auto& player : keys.handCard) fill(player, state);
+    fill(keys.faceUp, state);
+    fill(keys.discardTop, state);
+    fill(keys.held, state);
+    fill(keys.deckCount, state);
+    fill(keys.toMove, state);
+    fill(keys.observer, state);
+    return keys;
+}
+
+} // namespace
+
+const ZobristKeys& zobristKeys() {
+    static const ZobristKeys keys = makeKeys();
+    return keys;
+}
+
+} // namespace TrashPiles
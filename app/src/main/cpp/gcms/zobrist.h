@@ -0,0 +1,35 @@
+#ifndef TRASHPILES_ZOBRIST_H
+#define TRASHPILES_ZOBRIST_H
+
+#include "state_block.h"
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Zobrist keys for game positions
+ * A position hash is the XOR of one key per fact about it: each dealt
+ * hand card in its slot, each face-up slot, the discard top, the held
+ * card, the deck size and the player to move. A move XORs out the keys of
+ * what it changes and XORs in the new ones, so GameCore keeps the hash in
+ * step in O(1) per command. Keys are fixed (seeded), so hashes agree across
+ * runs and threads.
+ */
+struct ZobristKeys {
+    static constexpr int kCards = 52;
+
+    uint64_t handCard[kStateMaxPlayers][kStateMaxHandSlots][kCards];
+    uint64_t faceUp[kStateMaxPlayers][kStateMaxHandSlots];
+    uint64_t discardTop[kCards];
+    uint64_t held[kCards];
+    uint64_t deckCount[kCards + 1];
+    uint64_t toMove[kStateMaxPlayers];
+    // Mixed into cache keys for queries asked on a player's behalf
+    uint64_t observer[kStateMaxPlayers];
+};
+
+const ZobristKeys& zobristKeys();
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_ZOBRIST_H
@@ -3,43 +3,24 @@
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include "audio/audio_wrapper.h"
+#include "game_engine/engine_context.h"
+#include "trace/trace.h"
+#include "game_engine/alloc_tracker.h"
 
 #define LOG_TAG "TrashPiles-AudioJNI"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-extern "C" {
-
-// Global audio instance
-static TrashPiles::AudioWrapper* g_audio = nullptr;
-
-JNIEXPORT jlong JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeCreateAudioEngine(JNIEnv* env, jobject thiz) {
-    if (g_audio) {
-        LOGE("Audio engine already created");
-        return 0;
-    }
-    
-    g_audio = new TrashPiles::AudioWrapper();
-    LOGI("Audio engine created");
-    return reinterpret_cast<jlong>(g_audio);
+// Owned by the engine context; constructed on first use
+static TrashPiles::AudioWrapper* audioEngine() {
+    return TrashPiles::EngineContext::instance().audio();
 }
 
-JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeDestroyAudioEngine(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
-    if (audio) {
-        delete audio;
-        if (audio == g_audio) {
-            g_audio = nullptr;
-        }
-        LOGI("Audio engine destroyed");
-    }
-}
+extern "C" {
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeSetAssetManager(JNIEnv* env, jobject thiz, jlong audio_ptr, jobject asset_manager) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_setAssetManager(JNIEnv* env, jobject thiz, jobject asset_manager) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (!audio) return;
     
     AAssetManager* assetManager = AAssetManager_fromJava(env, asset_manager);
@@ -48,63 +29,86 @@ Java_com_trashpiles_AudioEngineBridge_nativeSetAssetManager(JNIEnv* env, jobject
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeInitialize(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_initAudioEngine(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (!audio) {
         LOGE("Cannot initialize audio - engine is null");
         return JNI_FALSE;
     }
     
-    bool result = audio->initialize();
+    // Once the startup graph runs, it opens the streams and loads the banks
+    TrashPiles::EngineContext& context = TrashPiles::EngineContext::instance();
+    bool result = context.isStarted()
+        ? context.awaitStage(TrashPiles::kStageAudioStreams, -1)
+        : audio->initialize();
     LOGI("Audio engine initialization: %s", result ? "SUCCESS" : "FAILED");
     return result ? JNI_TRUE : JNI_FALSE;
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeCleanup(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_cleanup(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->cleanup();
         LOGI("Audio engine cleanup completed");
     }
 }
 
-JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativePlaySound(JNIEnv* env, jobject thiz, jlong audio_ptr, jstring sound_name) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
-    if (!audio) return;
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_registerSound(JNIEnv* env, jobject thiz, jstring sound_name) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (!audio) return -1;
     
+    // The only call that marshals a name; everything after uses the id
     const char* soundNameStr = env->GetStringUTFChars(sound_name, nullptr);
-    if (soundNameStr) {
-        audio->playSound(soundNameStr);
-        env->ReleaseStringUTFChars(sound_name, soundNameStr);
+    if (!soundNameStr) return -1;
+    
+    jint soundId = audio->registerSound(soundNameStr);
+    env->ReleaseStringUTFChars(sound_name, soundNameStr);
+    return soundId;
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_playSound(JNIEnv* env, jobject thiz, jint sound_id, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    TRACE_SCOPE("jni.playSound");
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Audio);
+    if (audio) {
+        audio->playSound(sound_id, volume);
     }
 }
 
+// Plays sound_id on the audio thread whenever the event type is published;
+// -1 unbinds
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeStopSound(JNIEnv* env, jobject thiz, jlong audio_ptr, jstring sound_name) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
-    if (!audio) return;
-    
-    const char* soundNameStr = env->GetStringUTFChars(sound_name, nullptr);
-    if (soundNameStr) {
-        audio->stopSound(soundNameStr);
-        env->ReleaseStringUTFChars(sound_name, soundNameStr);
+Java_com_trashpiles_native_AudioEngineBridge_bindEventSound(JNIEnv* env, jobject thiz, jint event_type, jint sound_id, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio && event_type >= 0 && event_type < static_cast<jint>(TrashPiles::GameEventType::Count)) {
+        audio->bindEventSound(static_cast<TrashPiles::GameEventType>(event_type), sound_id, volume);
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeStopAllSounds(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_stopSound(JNIEnv* env, jobject thiz, jint sound_id) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        audio->stopSound(sound_id);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_stopAllSounds(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->stopAllSounds();
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativePlayMusic(JNIEnv* env, jobject thiz, jlong audio_ptr, jstring music_name, jboolean loop) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_playMusic(JNIEnv* env, jobject thiz, jstring music_name, jboolean loop) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (!audio) return;
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Audio);
     
     const char* musicNameStr = env->GetStringUTFChars(music_name, nullptr);
     if (musicNameStr) {
@@ -114,56 +118,116 @@ Java_com_trashpiles_AudioEngineBridge_nativePlayMusic(JNIEnv* env, jobject thiz,
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeStopMusic(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_stopMusic(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->stopMusic();
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativePauseMusic(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_pauseMusic(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->pauseMusic();
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeResumeMusic(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_resumeMusic(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->resumeMusic();
     }
 }
 
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_getFramePosition(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    return audio ? static_cast<jlong>(audio->getFramePosition()) : 0;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_getOutputSampleRate(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    return audio ? audio->getOutputSampleRate() : 0;
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_playSoundAt(JNIEnv* env, jobject thiz, jint sound_id, jlong frame, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        audio->playSoundAt(sound_id, frame, volume);
+    }
+}
+
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeSetSoundVolume(JNIEnv* env, jobject thiz, jlong audio_ptr, jfloat volume) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_stopSoundAt(JNIEnv* env, jobject thiz, jint sound_id, jlong frame) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        audio->stopSoundAt(sound_id, frame);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_playMusicAt(JNIEnv* env, jobject thiz, jstring music_name, jlong frame, jboolean loop) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (!audio) return;
+    
+    const char* musicNameStr = env->GetStringUTFChars(music_name, nullptr);
+    if (musicNameStr) {
+        audio->playMusicAt(musicNameStr, frame, loop);
+        env->ReleaseStringUTFChars(music_name, musicNameStr);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_crossfadeMusic(JNIEnv* env, jobject thiz, jstring music_name, jlong frame, jint fade_frames, jboolean loop) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (!audio) return;
+    
+    const char* musicNameStr = env->GetStringUTFChars(music_name, nullptr);
+    if (musicNameStr) {
+        audio->crossfadeMusic(musicNameStr, frame, fade_frames, loop);
+        env->ReleaseStringUTFChars(music_name, musicNameStr);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_stopMusicAt(JNIEnv* env, jobject thiz, jlong frame, jint fade_frames) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        audio->stopMusicAt(frame, fade_frames);
+    }
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_setSoundVolume(JNIEnv* env, jobject thiz, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->setSoundVolume(volume);
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeSetMusicVolume(JNIEnv* env, jobject thiz, jlong audio_ptr, jfloat volume) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_setMusicVolume(JNIEnv* env, jobject thiz, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->setMusicVolume(volume);
     }
 }
 
 JNIEXPORT void JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeSetMasterVolume(JNIEnv* env, jobject thiz, jlong audio_ptr, jfloat volume) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_setMasterVolume(JNIEnv* env, jobject thiz, jfloat volume) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         audio->setMasterVolume(volume);
     }
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeIsMusicPlaying(JNIEnv* env, jobject thiz, jlong audio_ptr) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
+Java_com_trashpiles_native_AudioEngineBridge_isMusicPlaying(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     if (audio) {
         return audio->isMusicPlaying() ? JNI_TRUE : JNI_FALSE;
     }
@@ -171,18 +235,82 @@ Java_com_trashpiles_AudioEngineBridge_nativeIsMusicPlaying(JNIEnv* env, jobject
 }
 
 JNIEXPORT jboolean JNICALL
-Java_com_trashpiles_AudioEngineBridge_nativeIsSoundPlaying(JNIEnv* env, jobject thiz, jlong audio_ptr, jstring sound_name) {
-    TrashPiles::AudioWrapper* audio = reinterpret_cast<TrashPiles::AudioWrapper*>(audio_ptr);
-    if (!audio) return JNI_FALSE;
+Java_com_trashpiles_native_AudioEngineBridge_isSoundPlaying(JNIEnv* env, jobject thiz, jint sound_id) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        return audio->isSoundPlaying(sound_id) ? JNI_TRUE : JNI_FALSE;
+    }
+    return JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_isSoundBankReady(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    if (audio) {
+        return audio->isSoundBankReady() ? JNI_TRUE : JNI_FALSE;
+    }
+    return JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_getMemoryStats(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
     
-    const char* soundNameStr = env->GetStringUTFChars(sound_name, nullptr);
-    if (soundNameStr) {
-        bool result = audio->isSoundPlaying(soundNameStr);
-        env->ReleaseStringUTFChars(sound_name, soundNameStr);
-        return result ? JNI_TRUE : JNI_FALSE;
+    // Layout: [soundCount, soundBytes, musicCount, musicBytes]
+    jlong values[4] = {0, 0, 0, 0};
+    if (audio) {
+        TrashPiles::AudioMemoryStats stats = audio->getMemoryStats();
+        values[0] = stats.soundCount;
+        values[1] = static_cast<jlong>(stats.soundBytes);
+        values[2] = stats.musicCount;
+        values[3] = static_cast<jlong>(stats.musicBytes);
     }
     
-    return JNI_FALSE;
+    jlongArray result = env->NewLongArray(4);
+    if (result) {
+        env->SetLongArrayRegion(result, 0, 4, values);
+    }
+    return result;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_AudioEngineBridge_getPerformanceStats(JNIEnv* env, jobject thiz) {
+    TrashPiles::AudioWrapper* audio = audioEngine();
+    
+    // Layout, sound stream then music stream, kStreamFields each:
+    // [callbackCount, xrunCount, bufferSizeFrames, framesPerBurst, bufferCapacityFrames,
+    //  lowestStableFrames, latencyMicros, callbackMeanMicros, callbackMaxMicros,
+    //  histogram bucket 0..15 (log2 microseconds)]
+    constexpr int kBuckets = TrashPiles::CallbackHistogram::kBucketCount;
+    constexpr int kStreamFields = 9 + kBuckets;
+    jlong values[kStreamFields * 2] = {};
+    
+    if (audio) {
+        TrashPiles::AudioPerformanceStats stats = audio->getPerformanceStats();
+        const TrashPiles::AudioStreamStats* streams[2] = {&stats.sound, &stats.music};
+        for (int s = 0; s < 2; ++s) {
+            const TrashPiles::AudioStreamStats& stream = *streams[s];
+            jlong* out = values + s * kStreamFields;
+            out[0] = static_cast<jlong>(stream.callbackCount);
+            out[1] = stream.xrunCount;
+            out[2] = stream.bufferSizeFrames;
+            out[3] = stream.framesPerBurst;
+            out[4] = stream.bufferCapacityFrames;
+            out[5] = stream.lowestStableFrames;
+            out[6] = stream.latencyMillis < 0.0 ? -1 : static_cast<jlong>(stream.latencyMillis * 1000.0);
+            out[7] = stream.callbackMeanNanos / 1000;
+            out[8] = stream.callbackMaxNanos / 1000;
+            for (int b = 0; b < kBuckets; ++b) {
+                out[9 + b] = static_cast<jlong>(stream.callbackHistogram[b]);
+            }
+        }
+    }
+    
+    jlongArray result = env->NewLongArray(kStreamFields * 2);
+    if (result) {
+        env->SetLongArrayRegion(result, 0, kStreamFields * 2, values);
+    }
+    return result;
 }
 
 } // extern "C"
\ No newline at end of file
@@ -1,12 +1,20 @@
 #include <jni.h>
 #include <android/log.h>
 #include "../game_engine/game_engine_wrapper.h"
+#include "../game_engine/engine_context.h"
+#include "../game_engine/alloc_tracker.h"
+#include "../trace/trace.h"
+#include <algorithm>
+#include <chrono>
 
 #define LOG_TAG "TrashPiles-GameEngine-JNI"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-extern TrashPiles::GameEngineWrapper* g_gameEngine;
+// Owned by the engine context; constructed on first use
+static TrashPiles::GameEngineWrapper* gameEngine() {
+    return TrashPiles::EngineContext::instance().gameEngine();
+}
 
 extern "C" {
 
@@ -19,12 +27,11 @@ Java_com_trashpiles_native_GameEngineBridge_initGameEngine(
     
     LOGI("JNI: initGameEngine called");
     
-    if (!g_gameEngine) {
-        LOGE("Game engine instance is null!");
-        return JNI_FALSE;
-    }
-    
-    bool success = g_gameEngine->initialize();
+    // Once the startup graph runs, it initializes the engine
+    TrashPiles::EngineContext& context = TrashPiles::EngineContext::instance();
+    bool success = context.isStarted()
+        ? context.awaitStage(TrashPiles::kStageGameEngine, -1)
+        : gameEngine()->initialize();
     return success ? JNI_TRUE : JNI_FALSE;
 }
 
@@ -35,9 +42,8 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_native_GameEngineBridge_update(
     JNIEnv* env, jobject obj, jfloat deltaTime) {
     
-    if (g_gameEngine) {
-        g_gameEngine->update(deltaTime);
-    }
+    TRACE_SCOPE("jni.update");
+    gameEngine()->update(deltaTime);
 }
 
 /**
@@ -47,9 +53,8 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_native_GameEngineBridge_handleTouchDown(
     JNIEnv* env, jobject obj, jfloat x, jfloat y) {
     
-    if (g_gameEngine) {
-        g_gameEngine->handleTouchDown(x, y);
-    }
+    TRACE_SCOPE("jni.touchDown");
+    gameEngine()->handleTouchDown(x, y);
 }
 
 /**
@@ -59,9 +64,8 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_native_GameEngineBridge_handleTouchUp(
     JNIEnv* env, jobject obj, jfloat x, jfloat y) {
     
-    if (g_gameEngine) {
-        g_gameEngine->handleTouchUp(x, y);
-    }
+    TRACE_SCOPE("jni.touchUp");
+    gameEngine()->handleTouchUp(x, y);
 }
 
 /**
@@ -71,9 +75,7 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_native_GameEngineBridge_handleTouchMove(
     JNIEnv* env, jobject obj, jfloat x, jfloat y) {
     
-    if (g_gameEngine) {
-        g_gameEngine->handleTouchMove(x, y);
-    }
+    gameEngine()->handleTouchMove(x, y);
 }
 
 /**
@@ -83,9 +85,7 @@ JNIEXPORT jfloat JNICALL
 Java_com_trashpiles_native_GameEngineBridge_getDeltaTime(
     JNIEnv* env, jobject obj) {
     
-    if (!g_gameEngine) return 0.0f;
-    
-    return g_gameEngine->getDeltaTime();
+    return gameEngine()->getDeltaTime();
 }
 
 /**
@@ -95,9 +95,7 @@ JNIEXPORT jint JNICALL
 Java_com_trashpiles_native_GameEngineBridge_getFPS(
     JNIEnv* env, jobject obj) {
     
-    if (!g_gameEngine) return 0;
-    
-    return g_gameEngine->getFPS();
+    return gameEngine()->getFPS();
 }
 
 /**
@@ -109,9 +107,271 @@ Java_com_trashpiles_native_GameEngineBridge_cleanup(
     
     LOGI("JNI: cleanup called");
     
-    if (g_gameEngine) {
-        g_gameEngine->cleanup();
+    gameEngine()->cleanup();
+}
+
+/**
+ * Direct buffer over the game state block, read by GameStateMirror
+ */
+JNIEXPORT jobject JNICALL
+Java_com_trashpiles_native_GameEngineBridge_getStateBuffer(
+    JNIEnv* env, jobject obj) {
+    
+    TrashPiles::StateBlock& block = gameEngine()->stateBlock();
+    return env->NewDirectByteBuffer(block.data(), static_cast<jlong>(block.size()));
+}
+
+/**
+ * Publish a state snapshot into the block
+ * fields: phase, current player, round, winner, input locked, player count,
+ * deck count, discard count, discard top, then id, score, flags, hand count
+ * per player. hands: kStateMaxHandSlots card codes per player.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_GameEngineBridge_publishState(
+    JNIEnv* env, jobject obj, jintArray fields, jbyteArray hands, jlong lastActionTime) {
+    
+    constexpr jsize kMatchFields = 9;
+    constexpr jsize kPlayerFields = 4;
+    constexpr jsize kFieldCount = kMatchFields + kPlayerFields * TrashPiles::kStateMaxPlayers;
+    constexpr jsize kHandBytes = TrashPiles::kStateMaxPlayers * TrashPiles::kStateMaxHandSlots;
+    
+    if (env->GetArrayLength(fields) != kFieldCount || env->GetArrayLength(hands) != kHandBytes) {
+        LOGE("publishState: unexpected array sizes");
+        return JNI_FALSE;
+    }
+    
+    jint values[kFieldCount];
+    env->GetIntArrayRegion(fields, 0, kFieldCount, values);
+    
+    TrashPiles::GameStateFields next;
+    next.match.phase = values[0];
+    next.match.currentPlayerIndex = values[1];
+    next.match.currentRound = values[2];
+    next.match.winnerId = values[3];
+    next.match.inputLocked = values[4];
+    next.match.playerCount = values[5];
+    next.match.lastActionTimeMillis = lastActionTime;
+    next.piles.deckCount = values[6];
+    next.piles.discardCount = values[7];
+    next.piles.discardTop = values[8];
+    for (int i = 0; i < TrashPiles::kStateMaxPlayers; ++i) {
+        const jint* player = values + kMatchFields + i * kPlayerFields;
+        next.players[i].id = player[0];
+        next.players[i].score = player[1];
+        next.players[i].flags = player[2];
+        next.players[i].handCount = player[3];
+    }
+    env->GetByteArrayRegion(hands, 0, kHandBytes, reinterpret_cast<jbyte*>(&next.hands[0][0]));
+    
+    return gameEngine()->stateBlock().publish(next) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Publish a game event to the native bus
+ * Subscribers (audio, renderer) consume it on their own threads; nothing
+ * travels back through JNI. card is a state block card code or -1.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_GameEngineBridge_publishEvent(
+    JNIEnv* env, jobject obj, jint type, jint playerId, jint card, jint slot, jint value, jfloat volume) {
+    
+    if (type < 0 || type >= static_cast<jint>(TrashPiles::GameEventType::Count)) {
+        LOGE("publishEvent: unknown event type %d", type);
+        return JNI_FALSE;
+    }
+    
+    TrashPiles::GameEvent event;
+    event.type = static_cast<TrashPiles::GameEventType>(type);
+    event.playerId = playerId;
+    event.card = card;
+    event.slot = slot;
+    event.value = value;
+    event.volume = volume;
+    event.timeNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    
+    return TrashPiles::EngineContext::instance().events().publish(event) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Queue a command on the native game core
+ * Any thread; returns false if the queue is full. Executed on the next
+ * update(), results arrive as events.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_GameEngineBridge_submitCommand(
+    JNIEnv* env, jobject obj, jint type, jint playerId, jint card, jint slot, jint value, jint flags) {
+    
+    TRACE_SCOPE("jni.submitCommand");
+    if (type < 0 || type >= static_cast<jint>(TrashPiles::GameCommandType::Count)) {
+        LOGE("submitCommand: unknown command type %d", type);
+        return JNI_FALSE;
     }
+    
+    TrashPiles::GameCommand command;
+    command.type = static_cast<TrashPiles::GameCommandType>(type);
+    command.playerId = playerId;
+    command.card = card;
+    command.slot = slot;
+    command.value = value;
+    command.flags = static_cast<uint32_t>(flags);
+    command.timeMillis = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    
+    return gameEngine()->gameCore().submit(command) ? JNI_TRUE : JNI_FALSE;
+}
+
+/**
+ * Copy pending core events, kEventFields ints each:
+ * type, player, card, slot, value. Returns the number of events copied.
+ */
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_GameEngineBridge_pollEvents(
+    JNIEnv* env, jobject obj, jintArray out) {
+    
+    TRACE_SCOPE("jni.pollEvents");
+    constexpr int kEventFields = 5;
+    constexpr int kMaxEvents = 128;
+    
+    int capacity = std::min(env->GetArrayLength(out) / kEventFields, kMaxEvents);
+    TrashPiles::GameEvent events[kMaxEvents];
+    int count = gameEngine()->pollEvents(events, capacity);
+    
+    jint values[kMaxEvents * kEventFields];
+    for (int i = 0; i < count; ++i) {
+        jint* fields = values + i * kEventFields;
+        fields[0] = static_cast<jint>(events[i].type);
+        fields[1] = events[i].playerId;
+        fields[2] = events[i].card;
+        fields[3] = events[i].slot;
+        fields[4] = events[i].value;
+    }
+    env->SetIntArrayRegion(out, 0, count * kEventFields, values);
+    return count;
+}
+
+/**
+ * Command pipeline counters:
+ * [queued, rejected by a full queue, ticks, executed, rejected by rules, largest batch]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_GameEngineBridge_getCommandStats(
+    JNIEnv* env, jobject obj) {
+    
+    TrashPiles::GameCore& core = gameEngine()->gameCore();
+    const TrashPiles::GameCore::Stats& stats = core.stats();
+    jlong values[] = {
+        static_cast<jlong>(core.queue().pushed()),
+        static_cast<jlong>(core.queue().rejected()),
+        static_cast<jlong>(stats.ticks),
+        static_cast<jlong>(stats.executed),
+        static_cast<jlong>(stats.rejected),
+        static_cast<jlong>(stats.maxBatch),
+    };
+    
+    jlongArray result = env->NewLongArray(6);
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, 6, values);
+    return result;
+}
+
+/**
+ * AI hint for the player in the core's current position:
+ * out = [1 to take the discard top else 0, target slot or -1, confidence].
+ * Repeat requests for an unchanged position come from the hint cache.
+ * Game thread. False if the player is not in the match.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_GameEngineBridge_requestHint(
+    JNIEnv* env, jobject obj, jint playerId, jfloatArray out) {
+    
+    TRACE_SCOPE("jni.requestHint");
+    TrashPiles::GameEngineWrapper* engine = gameEngine();
+    const TrashPiles::GameCore& core = engine->gameCore();
+    if (playerId < 0 || playerId >= core.playerCount() || env->GetArrayLength(out) < 3) return JNI_FALSE;
+    
+    TrashPiles::HintMove move = engine->hintAdvisor().hint(core, playerId);
+    jfloat values[] = {
+        move.fromDiscard ? 1.0f : 0.0f,
+        static_cast<jfloat>(move.slot),
+        move.confidence,
+    };
+    env->SetFloatArrayRegion(out, 0, 3, values);
+    return JNI_TRUE;
+}
+
+/**
+ * Hint cache counters: [probes, hits, stores, stores that evicted another position, capacity]
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_GameEngineBridge_getHintCacheStats(
+    JNIEnv* env, jobject obj) {
+    
+    TrashPiles::TranspositionTable& table = gameEngine()->hintTable();
+    TrashPiles::TranspositionTable::Stats stats = table.stats();
+    jlong values[] = {
+        static_cast<jlong>(stats.probes),
+        static_cast<jlong>(stats.hits),
+        static_cast<jlong>(stats.stores),
+        static_cast<jlong>(stats.replaced),
+        static_cast<jlong>(table.capacity()),
+    };
+    
+    jlongArray result = env->NewLongArray(5);
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_GameEngineBridge_getJobStats(
+    JNIEnv* env, jobject obj) {
+    
+    TrashPiles::JobSystem* jobs = gameEngine()->jobs();
+    TrashPiles::JobSystem::Stats stats = jobs ? jobs->stats() : TrashPiles::JobSystem::Stats();
+    jlong values[] = {
+        static_cast<jlong>(jobs ? jobs->workerCount() : 0),
+        static_cast<jlong>(gameEngine()->getFrameTaskCount()),
+        static_cast<jlong>(stats.executed),
+        static_cast<jlong>(stats.stolen),
+        static_cast<jlong>(stats.inlined),
+    };
+    
+    jlongArray result = env->NewLongArray(5);
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, 5, values);
+    return result;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_GameEngineBridge_getAllocStats(
+    JNIEnv* env, jobject obj) {
+    
+    using TrashPiles::AllocTracker;
+    constexpr int kHeader = 6;
+    constexpr int kCount = kHeader + AllocTracker::kSubsystemCount + AllocTracker::kFrameBuckets;
+    
+    AllocTracker::FrameStats stats = AllocTracker::frameStats();
+    jlong values[kCount] = {
+        AllocTracker::isHooked() ? 1 : 0,
+        static_cast<jlong>(stats.frames),
+        static_cast<jlong>(stats.allocationFreeFrames),
+        static_cast<jlong>(stats.maxFrameAllocations),
+        static_cast<jlong>(stats.lastFrame.allocations),
+        static_cast<jlong>(stats.lastFrame.bytes),
+    };
+    for (int s = 0; s < AllocTracker::kSubsystemCount; ++s) {
+        values[kHeader + s] = static_cast<jlong>(stats.lastFrameBySubsystem[s].allocations);
+    }
+    for (int b = 0; b < AllocTracker::kFrameBuckets; ++b) {
+        values[kHeader + AllocTracker::kSubsystemCount + b] = static_cast<jlong>(stats.frameHistogram[b]);
+    }
+    
+    jlongArray result = env->NewLongArray(kCount);
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, kCount, values);
+    return result;
 }
 
 } // extern "C"
\ No newline at end of file
@@ -0,0 +1,249 @@
+#include <jni.h>
+#include <android/log.h>
+#include <android/asset_manager_jni.h>
+#include "../game_engine/mapped_asset.h"
+#include "../gcms/card_tracker.h"
+#include "../gcms/endgame_table.h"
+#include "../gcms/skill_effect_table.h"
+#include <algorithm>
+
+#define LOG_TAG "TrashPiles-GcmsJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using TrashPiles::CardTracker;
+using TrashPiles::EndgameAdvice;
+using TrashPiles::EndgamePosition;
+using TrashPiles::EndgameTableView;
+using TrashPiles::GameEvent;
+using TrashPiles::GameEventType;
+using TrashPiles::SkillEffectKind;
+using TrashPiles::SkillEffectTable;
+
+static SkillEffectTable* skillEffects(jlong handle) {
+    return reinterpret_cast<SkillEffectTable*>(handle);
+}
+
+static bool validType(jint type) {
+    return type >= 0 && type < SkillEffectTable::kTypeCount;
+}
+
+static CardTracker* cardTracker(jlong handle) {
+    return reinterpret_cast<CardTracker*>(handle);
+}
+
+// The solved tablebase and the mapping its entries are read from
+struct EndgameTable {
+    TrashPiles::MappedAsset asset;
+    EndgameTableView view;
+};
+
+static EndgameTable* endgameTable(jlong handle) {
+    return reinterpret_cast<EndgameTable*>(handle);
+}
+
+extern "C" {
+
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeCreate(JNIEnv* env, jobject obj) {
+    return reinterpret_cast<jlong>(new SkillEffectTable());
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeDestroy(JNIEnv* env, jobject obj, jlong handle) {
+    delete skillEffects(handle);
+}
+
+// player is a seat index; type a SkillEffectType ordinal
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeAdd(
+    JNIEnv* env, jobject obj, jlong handle, jint player, jint type, jfloat value, jint duration) {
+
+    SkillEffectTable* table = skillEffects(handle);
+    if (!table || !validType(type)) return JNI_FALSE;
+    return table->add(player, static_cast<SkillEffectKind>(type), value, duration) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeAdvanceTurn(JNIEnv* env, jobject obj, jlong handle) {
+    SkillEffectTable* table = skillEffects(handle);
+    if (table) table->advanceTurn();
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeClear(JNIEnv* env, jobject obj, jlong handle) {
+    SkillEffectTable* table = skillEffects(handle);
+    if (table) table->clear();
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeHas(
+    JNIEnv* env, jobject obj, jlong handle, jint player, jint type) {
+
+    SkillEffectTable* table = skillEffects(handle);
+    if (!table || !validType(type)) return JNI_FALSE;
+    return table->has(player, static_cast<SkillEffectKind>(type)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeValue(
+    JNIEnv* env, jobject obj, jlong handle, jint player, jint type) {
+
+    SkillEffectTable* table = skillEffects(handle);
+    if (!table || !validType(type)) return 1.0f;
+    return table->value(player, static_cast<SkillEffectKind>(type));
+}
+
+/**
+ * Final scores for every seat at once: scores[i] from baseScores[i] (the
+ * face-down card count), for as many seats as both arrays hold
+ */
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeSkillEffects_nativeScores(
+    JNIEnv* env, jobject obj, jlong handle, jintArray baseScores, jintArray scores) {
+
+    SkillEffectTable* table = skillEffects(handle);
+    if (!table) return;
+
+    jsize count = std::min({env->GetArrayLength(baseScores), env->GetArrayLength(scores),
+                            static_cast<jsize>(SkillEffectTable::kMaxPlayers)});
+    jint base[SkillEffectTable::kMaxPlayers] = {};
+    jint out[SkillEffectTable::kMaxPlayers] = {};
+    env->GetIntArrayRegion(baseScores, 0, count, base);
+    table->scores(base, out, count);
+    env->SetIntArrayRegion(scores, 0, count, out);
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeCreate(JNIEnv* env, jobject obj) {
+    return reinterpret_cast<jlong>(new CardTracker());
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeDestroy(JNIEnv* env, jobject obj, jlong handle) {
+    delete cardTracker(handle);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeReset(JNIEnv* env, jobject obj, jlong handle) {
+    CardTracker* tracker = cardTracker(handle);
+    if (tracker) tracker->reset();
+}
+
+// One game event, with the fields NativeEventBus sends
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeObserve(
+    JNIEnv* env, jobject obj, jlong handle, jint type, jint player, jint card, jint slot, jint value) {
+
+    CardTracker* tracker = cardTracker(handle);
+    if (!tracker || type < 0 || type >= static_cast<jint>(GameEventType::Count)) return;
+
+    GameEvent event;
+    event.type = static_cast<GameEventType>(type);
+    event.playerId = player;
+    event.card = card;
+    event.slot = slot;
+    event.value = value;
+    tracker->observe(event);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeUnseenCount(JNIEnv* env, jobject obj, jlong handle, jint observer) {
+    CardTracker* tracker = cardTracker(handle);
+    return tracker ? tracker->unseenCount(observer) : CardTracker::kCardCount;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeSeen(JNIEnv* env, jobject obj, jlong handle, jint observer) {
+    CardTracker* tracker = cardTracker(handle);
+    return tracker ? static_cast<jlong>(tracker->seen(observer)) : 0;
+}
+
+// odds[r] = chance the next deck card has rank r, for the ranks odds holds
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeRankOdds(
+    JNIEnv* env, jobject obj, jlong handle, jint observer, jfloatArray odds) {
+
+    CardTracker* tracker = cardTracker(handle);
+    if (!tracker) return;
+
+    jsize count = std::min(env->GetArrayLength(odds), static_cast<jsize>(CardTracker::kRankCount));
+    jfloat out[CardTracker::kRankCount];
+    tracker->rankOdds(observer, out);
+    env->SetFloatArrayRegion(odds, 0, count, out);
+}
+
+JNIEXPORT jfloat JNICALL
+Java_com_trashpiles_native_NativeCardTracker_nativeFitOdds(
+    JNIEnv* env, jobject obj, jlong handle, jint observer, jint emptySlots) {
+
+    CardTracker* tracker = cardTracker(handle);
+    return tracker ? tracker->fitOdds(observer, static_cast<uint16_t>(emptySlots)) : 0.0f;
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeEndgameTable_nativeOpen(
+    JNIEnv* env, jobject obj, jobject assetManager, jstring path) {
+
+    AAssetManager* manager = AAssetManager_fromJava(env, assetManager);
+    const char* assetPath = env->GetStringUTFChars(path, nullptr);
+    if (!manager || !assetPath) {
+        if (assetPath) env->ReleaseStringUTFChars(path, assetPath);
+        return 0;
+    }
+
+    EndgameTable* table = new EndgameTable();
+    bool mapped = table->asset.open(manager, assetPath);
+    EndgameTableView::OpenResult result =
+        mapped ? table->view.open(table->asset.data(), table->asset.size()) : EndgameTableView::OpenResult::TooSmall;
+    if (result != EndgameTableView::OpenResult::Ok) {
+        if (mapped) LOGE("Endgame table %s rejected: %d", assetPath, static_cast<int>(result));
+        env->ReleaseStringUTFChars(path, assetPath);
+        delete table;
+        return 0;
+    }
+
+    LOGI("Mapped %s: %zu bytes", assetPath, table->asset.size());
+    env->ReleaseStringUTFChars(path, assetPath);
+    return reinterpret_cast<jlong>(table);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeEndgameTable_nativeClose(JNIEnv* env, jobject obj, jlong handle) {
+    delete endgameTable(handle);
+}
+
+/**
+ * The table's play for observer's face-down slots as tracker sees them:
+ * out = {expected turns * kTurnScale, take the discard (0/1), slot for the
+ * discard, slot for a wild from the deck}. False outside the table.
+ */
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeEndgameTable_nativeAdvise(
+    JNIEnv* env, jobject obj, jlong handle, jlong trackerHandle, jint observer, jint emptySlots,
+    jint discardTop, jintArray out) {
+
+    EndgameTable* table = endgameTable(handle);
+    CardTracker* tracker = cardTracker(trackerHandle);
+    if (!table || !tracker || env->GetArrayLength(out) < 4) return JNI_FALSE;
+
+    TrashPiles::HandBits hand;
+    hand.slots = static_cast<uint16_t>(emptySlots & TrashPiles::HandKernels::kFullHand);
+    EndgamePosition position;
+    EndgameAdvice advice;
+    if (!EndgamePosition::from(hand, *tracker, observer, &position) ||
+        !table->view.advise(position, discardTop, &advice)) {
+        return JNI_FALSE;
+    }
+
+    jint fields[4] = {
+        static_cast<jint>(advice.expectedTurns * TrashPiles::EndgameTableFormat::kTurnScale),
+        advice.takeDiscard ? 1 : 0,
+        advice.discardSlot,
+        advice.wildSlot
+    };
+    env->SetIntArrayRegion(out, 0, 4, fields);
+    return JNI_TRUE;
+}
+
+} // extern "C"
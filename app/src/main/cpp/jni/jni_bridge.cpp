@@ -1,17 +1,20 @@
 #include <jni.h>
 #include <android/log.h>
-#include "../renderer/renderer_wrapper.h"
-#include "../audio/audio_wrapper.h"
-#include "../game_engine/game_engine_wrapper.h"
+#include "../game_engine/engine_context.h"
+#include <vector>
 
 #define LOG_TAG "TrashPiles-JNI"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-// Global engine instances
-static TrashPiles::RendererWrapper* g_renderer = nullptr;
-static TrashPiles::AudioWrapper* g_audio = nullptr;
-static TrashPiles::GameEngineWrapper* g_gameEngine = nullptr;
+// Subsystems live in the engine context and are created on first use
+using TrashPiles::EngineContext;
+
+// Per-stage fields in the startup timing array
+static constexpr int kStageTimingFields = 3;
+
+// Per-subscriber fields in the event bus stats array
+static constexpr int kSubscriberStatFields = 3;
 
 extern "C" {
 
@@ -24,12 +27,9 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
     LOGI("Version: 1.0.0");
     LOGI("=================================================");
     
-    // Create engine instances
-    g_renderer = new TrashPiles::RendererWrapper();
-    g_audio = new TrashPiles::AudioWrapper();
-    g_gameEngine = new TrashPiles::GameEngineWrapper();
+    // Nothing is constructed here; this only fixes the startup time origin
+    EngineContext::instance();
     
-    LOGI("Engine instances created successfully");
     LOGI("Native library loaded successfully");
     
     return JNI_VERSION_1_6;
@@ -39,23 +39,113 @@ JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void* reserved) {
 JNIEXPORT void JNI_OnUnload(JavaVM* vm, void* reserved) {
     LOGI("Unloading native library...");
     
-    // Cleanup engine instances
-    if (g_renderer) {
-        delete g_renderer;
-        g_renderer = nullptr;
+    EngineContext::instance().shutdown();
+    
+    LOGI("Native library unloaded");
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_startEngine(JNIEnv* env, jobject thiz, jint width, jint height) {
+    return EngineContext::instance().start(width, height) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_isStageReady(JNIEnv* env, jobject thiz, jstring stage) {
+    const char* stageStr = env->GetStringUTFChars(stage, nullptr);
+    bool ready = EngineContext::instance().isStageReady(stageStr);
+    env->ReleaseStringUTFChars(stage, stageStr);
+    return ready ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_awaitStage(JNIEnv* env, jobject thiz, jstring stage, jlong timeout_ms) {
+    const char* stageStr = env->GetStringUTFChars(stage, nullptr);
+    bool ready = EngineContext::instance().awaitStage(stageStr, timeout_ms);
+    env->ReleaseStringUTFChars(stage, stageStr);
+    return ready ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jobjectArray JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_getStartupStageNames(JNIEnv* env, jobject thiz) {
+    auto timings = EngineContext::instance().startupTimings();
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(timings.size()), stringClass, nullptr);
+    if (!result) return nullptr;
+    
+    for (size_t i = 0; i < timings.size(); ++i) {
+        jstring name = env->NewStringUTF(timings[i].name.c_str());
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), name);
+        env->DeleteLocalRef(name);
     }
+    return result;
+}
+
+// Layout: [first frame ns, then per stage in getStartupStageNames order:
+// state, start ns, end ns]. Times are from library load, -1 if not reached;
+// state is 0 pending, 1 running, 2 succeeded, 3 failed, 4 skipped.
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_getStartupTimings(JNIEnv* env, jobject thiz) {
+    EngineContext& context = EngineContext::instance();
+    auto timings = context.startupTimings();
     
-    if (g_audio) {
-        delete g_audio;
-        g_audio = nullptr;
+    std::vector<jlong> values;
+    values.reserve(1 + timings.size() * kStageTimingFields);
+    values.push_back(context.firstFrameNanos());
+    for (const auto& timing : timings) {
+        values.push_back(static_cast<jlong>(timing.state));
+        values.push_back(timing.startNanos);
+        values.push_back(timing.endNanos);
     }
     
-    if (g_gameEngine) {
-        delete g_gameEngine;
-        g_gameEngine = nullptr;
+    jlongArray result = env->NewLongArray(static_cast<jsize>(values.size()));
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    return result;
+}
+
+// Active event bus subscribers, in getEventBusStats order
+JNIEXPORT jobjectArray JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_getEventSubscriberNames(JNIEnv* env, jobject thiz) {
+    const TrashPiles::EventBus& bus = EngineContext::instance().events();
+    std::vector<const char*> names;
+    for (int i = 0; i < TrashPiles::EventBus::kMaxSubscribers; ++i) {
+        if (const auto* subscriber = bus.subscriberAt(i)) names.push_back(subscriber->name);
     }
     
-    LOGI("Native library unloaded");
+    jclass stringClass = env->FindClass("java/lang/String");
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(names.size()), stringClass, nullptr);
+    if (!result) return nullptr;
+    
+    for (size_t i = 0; i < names.size(); ++i) {
+        jstring name = env->NewStringUTF(names[i]);
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), name);
+        env->DeleteLocalRef(name);
+    }
+    return result;
+}
+
+// Layout: [published, dropped by publishers, then per subscriber in
+// getEventSubscriberNames order: delivered, dropped, lag]
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeEngineWrapper_getEventBusStats(JNIEnv* env, jobject thiz) {
+    const TrashPiles::EventBus& bus = EngineContext::instance().events();
+    
+    std::vector<jlong> values;
+    values.reserve(2 + TrashPiles::EventBus::kMaxSubscribers * kSubscriberStatFields);
+    values.push_back(static_cast<jlong>(bus.published()));
+    values.push_back(static_cast<jlong>(bus.publishDropped()));
+    for (int i = 0; i < TrashPiles::EventBus::kMaxSubscribers; ++i) {
+        const auto* subscriber = bus.subscriberAt(i);
+        if (!subscriber) continue;
+        values.push_back(static_cast<jlong>(subscriber->delivered.load(std::memory_order_relaxed)));
+        values.push_back(static_cast<jlong>(subscriber->dropped.load(std::memory_order_relaxed)));
+        values.push_back(static_cast<jlong>(bus.lag(subscriber)));
+    }
+    
+    jlongArray result = env->NewLongArray(static_cast<jsize>(values.size()));
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    return result;
 }
 
-} // extern "C"
\ No newline at end of file
+} // extern "C"
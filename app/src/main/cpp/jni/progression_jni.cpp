@@ -0,0 +1,615 @@
+#include <jni.h>
+#include <android/log.h>
+#include <android/asset_manager_jni.h>
+#include "../game_engine/mapped_asset.h"
+#include "../progression/challenge_aggregator.h"
+#include "../progression/progression_blob.h"
+#include "../progression/skill_tree_index.h"
+#include "../progression/trophy_rules.h"
+#include <algorithm>
+#include <vector>
+
+#define LOG_TAG "TrashPiles-ProgressionJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using TrashPiles::ChallengeAggregator;
+using TrashPiles::ProgressionBlobView;
+using TrashPiles::SkillTreeIndex;
+using TrashPiles::TrophyRules;
+using TrashPiles::TrophyTracker;
+using NodeSet = SkillTreeIndex::NodeSet;
+
+static SkillTreeIndex* skillTree(jlong handle) {
+    return reinterpret_cast<SkillTreeIndex*>(handle);
+}
+
+static ChallengeAggregator* challengeAggregator(jlong handle) {
+    return reinterpret_cast<ChallengeAggregator*>(handle);
+}
+
+static TrophyRules* trophyRules(jlong handle) {
+    return reinterpret_cast<TrophyRules*>(handle);
+}
+
+static TrophyTracker* trophyTracker(jlong handle) {
+    return reinterpret_cast<TrophyTracker*>(handle);
+}
+
+// The packed catalog and the mapping its records are read from
+struct ProgressionCatalog {
+    TrashPiles::MappedAsset asset;
+    ProgressionBlobView view;
+};
+
+static ProgressionCatalog* progressionCatalog(jlong handle) {
+    return reinterpret_cast<ProgressionCatalog*>(handle);
+}
+
+// Node, trophy and requirement sets cross JNI as LongArrays of kWords words
+template <typename Set>
+static Set toBitSet(JNIEnv* env, jlongArray words) {
+    Set set;
+    if (!words) return set;
+
+    jlong values[Set::kWords] = {};
+    jsize count = std::min<jsize>(env->GetArrayLength(words), Set::kWords);
+    env->GetLongArrayRegion(words, 0, count, values);
+    for (int w = 0; w < count; ++w) {
+        set.setWord(w, static_cast<uint64_t>(values[w]));
+    }
+    return set;
+}
+
+template <typename Set>
+static jlongArray toLongArray(JNIEnv* env, const Set& set) {
+    jlong values[Set::kWords];
+    for (int w = 0; w < Set::kWords; ++w) {
+        values[w] = static_cast<jlong>(set.word(w));
+    }
+
+    jlongArray result = env->NewLongArray(Set::kWords);
+    if (!result) return nullptr;
+    env->SetLongArrayRegion(result, 0, Set::kWords, values);
+    return result;
+}
+
+static jintArray toIntArray(JNIEnv* env, const SkillTreeIndex::NodeRange& range) {
+    std::vector<jint> ids(range.ids, range.ids + range.count);
+    jintArray result = env->NewIntArray(range.count);
+    if (!result) return nullptr;
+    env->SetIntArrayRegion(result, 0, range.count, ids.data());
+    return result;
+}
+
+extern "C" {
+
+/**
+ * Build the index from parallel arrays, one entry per node id; node id's
+ * prerequisites are prereqIds[prereqOffsets[id] until prereqOffsets[id + 1]].
+ * Returns a handle, 0 if the tree is rejected.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeCreate(
+    JNIEnv* env, jobject obj, jintArray levels, jintArray costs, jintArray tiers,
+    jintArray pointTypes, jintArray prereqOffsets, jintArray prereqIds) {
+
+    jsize count = env->GetArrayLength(levels);
+    if (env->GetArrayLength(costs) != count || env->GetArrayLength(tiers) != count ||
+        env->GetArrayLength(pointTypes) != count || env->GetArrayLength(prereqOffsets) != count + 1) {
+        LOGE("Skill tree arrays disagree on the node count");
+        return 0;
+    }
+
+    std::vector<jint> levelValues(count), costValues(count), tierValues(count), typeValues(count);
+    std::vector<jint> offsets(count + 1);
+    env->GetIntArrayRegion(levels, 0, count, levelValues.data());
+    env->GetIntArrayRegion(costs, 0, count, costValues.data());
+    env->GetIntArrayRegion(tiers, 0, count, tierValues.data());
+    env->GetIntArrayRegion(pointTypes, 0, count, typeValues.data());
+    env->GetIntArrayRegion(prereqOffsets, 0, count + 1, offsets.data());
+
+    jsize prereqCount = env->GetArrayLength(prereqIds);
+    std::vector<jint> prereqs(prereqCount);
+    env->GetIntArrayRegion(prereqIds, 0, prereqCount, prereqs.data());
+    for (jsize id = 0; id <= count; ++id) {
+        if (offsets[id] < 0 || offsets[id] > prereqCount || (id > 0 && offsets[id] < offsets[id - 1])) {
+            LOGE("Skill tree prerequisite offsets out of range");
+            return 0;
+        }
+    }
+
+    std::vector<TrashPiles::SkillNodeSpec> nodes(count);
+    for (jsize id = 0; id < count; ++id) {
+        if (tierValues[id] < 0 || tierValues[id] >= SkillTreeIndex::kTierCount ||
+            typeValues[id] < 0 || typeValues[id] >= SkillTreeIndex::kPointKinds) {
+            LOGE("Skill tree node %d has an unknown tier or point type", static_cast<int>(id));
+            return 0;
+        }
+        nodes[id].level = levelValues[id];
+        nodes[id].cost = costValues[id];
+        nodes[id].tier = static_cast<uint8_t>(tierValues[id]);
+        nodes[id].pointKind = static_cast<TrashPiles::PointKind>(typeValues[id]);
+    }
+
+    SkillTreeIndex* index = new SkillTreeIndex();
+    SkillTreeIndex::BuildResult result = index->build(nodes.data(), count, offsets.data(), prereqs.data());
+    if (result != SkillTreeIndex::BuildResult::Ok) {
+        LOGE("Skill tree rejected: %d", static_cast<int>(result));
+        delete index;
+        return 0;
+    }
+
+    LOGI("Skill tree index built: %d nodes", index->nodeCount());
+    return reinterpret_cast<jlong>(index);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeDestroy(JNIEnv* env, jobject obj, jlong handle) {
+    delete skillTree(handle);
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeEligible(
+    JNIEnv* env, jobject obj, jlong handle, jint level, jint skillPoints, jint abilityPoints, jlongArray unlocked) {
+
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index) return nullptr;
+    return toLongArray(env, index->eligible(level, skillPoints, abilityPoints, toBitSet<NodeSet>(env, unlocked)));
+}
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeCanUnlock(
+    JNIEnv* env, jobject obj, jlong handle, jint node, jint level, jint skillPoints, jint abilityPoints,
+    jlongArray unlocked) {
+
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index) return JNI_FALSE;
+    return index->canUnlock(node, level, skillPoints, abilityPoints, toBitSet<NodeSet>(env, unlocked)) ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativePrerequisitesMet(
+    JNIEnv* env, jobject obj, jlong handle, jlongArray unlocked) {
+
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index) return nullptr;
+    return toLongArray(env, index->prerequisitesMet(toBitSet<NodeSet>(env, unlocked)));
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeMissingFor(
+    JNIEnv* env, jobject obj, jlong handle, jint node, jlongArray unlocked) {
+
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index || node < 0 || node >= index->nodeCount()) return nullptr;
+    return toLongArray(env, index->missingFor(node, toBitSet<NodeSet>(env, unlocked)));
+}
+
+JNIEXPORT jintArray JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeNodesAtLevel(JNIEnv* env, jobject obj, jlong handle, jint level) {
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index) return nullptr;
+    return toIntArray(env, index->nodesAtLevel(level));
+}
+
+JNIEXPORT jintArray JNICALL
+Java_com_trashpiles_native_NativeSkillTree_nativeNodesInTier(JNIEnv* env, jobject obj, jlong handle, jint tier) {
+    SkillTreeIndex* index = skillTree(handle);
+    if (!index) return nullptr;
+    return toIntArray(env, index->nodesInTier(tier));
+}
+
+/**
+ * Compile trophy prerequisites: thresholds holds TrophyRules::kFieldCount
+ * minimums per trophy (Int.MIN_VALUE where the prerequisite has none);
+ * trophy id's required keys are reqKeys[reqOffsets[id] until reqOffsets[id + 1]].
+ * Returns a handle, 0 if the catalog is rejected.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeCreate(
+    JNIEnv* env, jobject obj, jintArray thresholds, jintArray reqOffsets, jintArray reqKeys) {
+
+    jsize count = env->GetArrayLength(reqOffsets) - 1;
+    if (count < 0 || env->GetArrayLength(thresholds) != count * TrophyRules::kFieldCount) {
+        LOGE("Trophy rule arrays disagree on the trophy count");
+        return 0;
+    }
+
+    std::vector<jint> minimums(count * TrophyRules::kFieldCount);
+    std::vector<jint> offsets(count + 1);
+    env->GetIntArrayRegion(thresholds, 0, count * TrophyRules::kFieldCount, minimums.data());
+    env->GetIntArrayRegion(reqOffsets, 0, count + 1, offsets.data());
+
+    jsize keyCount = env->GetArrayLength(reqKeys);
+    std::vector<jint> keys(keyCount);
+    env->GetIntArrayRegion(reqKeys, 0, keyCount, keys.data());
+    for (jsize id = 0; id <= count; ++id) {
+        if (offsets[id] < 0 || offsets[id] > keyCount || (id > 0 && offsets[id] < offsets[id - 1])) {
+            LOGE("Trophy requirement offsets out of range");
+            return 0;
+        }
+    }
+
+    TrophyRules* rules = new TrophyRules();
+    TrophyRules::BuildResult result = rules->build(count, minimums.data(), offsets.data(), keys.data());
+    if (result != TrophyRules::BuildResult::Ok) {
+        LOGE("Trophy rules rejected: %d", static_cast<int>(result));
+        delete rules;
+        return 0;
+    }
+
+    LOGI("Trophy rules compiled: %d trophies", rules->trophyCount());
+    return reinterpret_cast<jlong>(rules);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeDestroy(JNIEnv* env, jobject obj, jlong handle) {
+    delete trophyRules(handle);
+}
+
+// Trackers borrow the rules; destroy them first
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeCreateTracker(JNIEnv* env, jobject obj, jlong handle) {
+    TrophyRules* rules = trophyRules(handle);
+    if (!rules) return 0;
+    return reinterpret_cast<jlong>(new TrophyTracker(*rules));
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeDestroyTracker(JNIEnv* env, jobject obj, jlong tracker) {
+    delete trophyTracker(tracker);
+}
+
+/**
+ * Feed a player's progress (kFieldCount values in ProgressField order plus
+ * the unlocked requirement keys) and get back the newly satisfied trophies
+ */
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeUpdate(
+    JNIEnv* env, jobject obj, jlong tracker, jintArray fields, jlongArray unlocked) {
+
+    TrophyTracker* player = trophyTracker(tracker);
+    if (!player || env->GetArrayLength(fields) != TrophyRules::kFieldCount) return nullptr;
+
+    jint values[TrophyRules::kFieldCount];
+    env->GetIntArrayRegion(fields, 0, TrophyRules::kFieldCount, values);
+    TrophyRules::TrophySet newlySatisfied =
+        player->update(values, toBitSet<TrophyRules::RequirementSet>(env, unlocked));
+    return toLongArray(env, newlySatisfied);
+}
+
+JNIEXPORT jlongArray JNICALL
+Java_com_trashpiles_native_NativeTrophyRules_nativeSatisfied(JNIEnv* env, jobject obj, jlong tracker) {
+    TrophyTracker* player = trophyTracker(tracker);
+    if (!player) return nullptr;
+    return toLongArray(env, player->satisfied());
+}
+
+// Fields per goal in the packed goal array
+static constexpr int kGoalStride = 5;
+
+/**
+ * Build an aggregator for one challenge set. goals packs kGoalStride ints
+ * per goal: challenge, ChallengeEvent ordinal, key (-1 if unkeyed), target,
+ * atMost (0 or 1). Returns a handle, 0 if a goal is rejected.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeChallengeAggregator_nativeCreate(
+    JNIEnv* env, jobject obj, jint challengeCount, jintArray goals) {
+
+    jsize length = env->GetArrayLength(goals);
+    if (length % kGoalStride != 0) {
+        LOGE("Challenge goal array is not a whole number of goals");
+        return 0;
+    }
+
+    std::vector<jint> packed(length);
+    env->GetIntArrayRegion(goals, 0, length, packed.data());
+
+    std::vector<TrashPiles::ChallengeGoal> specs(length / kGoalStride);
+    for (size_t g = 0; g < specs.size(); ++g) {
+        const jint* fields = packed.data() + g * kGoalStride;
+        if (fields[1] < 0 || fields[1] >= ChallengeAggregator::kEventCount) {
+            LOGE("Challenge goal %d has an unknown event", static_cast<int>(g));
+            return 0;
+        }
+        specs[g].challenge = fields[0];
+        specs[g].event = static_cast<TrashPiles::ChallengeEvent>(fields[1]);
+        specs[g].key = fields[2];
+        specs[g].target = fields[3];
+        specs[g].atMost = fields[4] != 0;
+    }
+
+    ChallengeAggregator* aggregator = new ChallengeAggregator();
+    ChallengeAggregator::BuildResult result =
+        aggregator->build(challengeCount, specs.data(), static_cast<int>(specs.size()));
+    if (result != ChallengeAggregator::BuildResult::Ok) {
+        LOGE("Challenge goals rejected: %d", static_cast<int>(result));
+        delete aggregator;
+        return 0;
+    }
+    return reinterpret_cast<jlong>(aggregator);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeChallengeAggregator_nativeDestroy(JNIEnv* env, jobject obj, jlong handle) {
+    delete challengeAggregator(handle);
+}
+
+// Challenge sets fit one word: bit n for challenge n
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeChallengeAggregator_nativeDispatch(
+    JNIEnv* env, jobject obj, jlong handle, jint event, jint key, jint amount) {
+
+    ChallengeAggregator* aggregator = challengeAggregator(handle);
+    if (!aggregator || event < 0 || event >= ChallengeAggregator::kEventCount) return 0;
+    return static_cast<jlong>(
+        aggregator->dispatch(static_cast<TrashPiles::ChallengeEvent>(event), key, amount).word(0));
+}
+
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeChallengeAggregator_nativeCompleted(JNIEnv* env, jobject obj, jlong handle) {
+    ChallengeAggregator* aggregator = challengeAggregator(handle);
+    if (!aggregator) return 0;
+    return static_cast<jlong>(aggregator->completed().word(0));
+}
+
+// Record fields cross JNI one record at a time: every numeric field in one
+// IntArray, strings and id lists by field number, in record order.
+namespace CatalogField {
+    // Strings
+    constexpr int kId = 0, kName = 1, kDescription = 2;
+    constexpr int kNodeEffect = 3, kNodeTrophyId = 4;
+    constexpr int kTrophyIcon = 3;
+    constexpr int kChallengeAchievement = 3, kChallengeSpecialReward = 4;
+    // Lists
+    constexpr int kNodePrerequisites = 0;
+    constexpr int kTrophySkills = 0, kTrophyAbilities = 1;
+    constexpr int kChallengeAbilityGoals = 0, kChallengeSkills = 1;
+}
+
+static bool inSection(ProgressionCatalog* catalog, jint section, jint index) {
+    if (!catalog) return false;
+    switch (section) {
+        case TrashPiles::ProgressionBlobFormat::Nodes: return index >= 0 && index < catalog->view.nodeCount();
+        case TrashPiles::ProgressionBlobFormat::Trophies: return index >= 0 && index < catalog->view.trophyCount();
+        case TrashPiles::ProgressionBlobFormat::ChallengeSets:
+            return index >= 0 && index < catalog->view.challengeSetCount();
+        case TrashPiles::ProgressionBlobFormat::Challenges:
+            return index >= 0 && index < catalog->view.challengeCount();
+        default: return false;
+    }
+}
+
+static jintArray toIntArray(JNIEnv* env, const std::vector<jint>& values) {
+    jintArray result = env->NewIntArray(static_cast<jsize>(values.size()));
+    if (!result) return nullptr;
+    env->SetIntArrayRegion(result, 0, static_cast<jsize>(values.size()), values.data());
+    return result;
+}
+
+static jobjectArray toStringArray(JNIEnv* env, const std::vector<const char*>& values) {
+    jclass stringClass = env->FindClass("java/lang/String");
+    if (!stringClass) return nullptr;
+    jobjectArray result = env->NewObjectArray(static_cast<jsize>(values.size()), stringClass, nullptr);
+    env->DeleteLocalRef(stringClass);
+    if (!result) return nullptr;
+    for (size_t i = 0; i < values.size(); ++i) {
+        jstring value = env->NewStringUTF(values[i]);
+        if (!value) return nullptr;
+        env->SetObjectArrayElement(result, static_cast<jsize>(i), value);
+        env->DeleteLocalRef(value);
+    }
+    return result;
+}
+
+/**
+ * Map the packed catalog (tools/progression_packer) from the APK and check
+ * it. Returns a handle, 0 if the asset is missing or does not open; callers
+ * then build the catalogs in Kotlin as before.
+ */
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeOpen(
+    JNIEnv* env, jobject obj, jobject assetManager, jstring path) {
+
+    AAssetManager* manager = AAssetManager_fromJava(env, assetManager);
+    const char* assetPath = env->GetStringUTFChars(path, nullptr);
+    if (!manager || !assetPath) {
+        if (assetPath) env->ReleaseStringUTFChars(path, assetPath);
+        return 0;
+    }
+
+    ProgressionCatalog* catalog = new ProgressionCatalog();
+    bool mapped = catalog->asset.open(manager, assetPath);
+    ProgressionBlobView::OpenResult result =
+        mapped ? catalog->view.open(catalog->asset.data(), catalog->asset.size()) : ProgressionBlobView::OpenResult::TooSmall;
+    if (result != ProgressionBlobView::OpenResult::Ok) {
+        if (mapped) LOGE("Progression catalog %s rejected: %d", assetPath, static_cast<int>(result));
+        env->ReleaseStringUTFChars(path, assetPath);
+        delete catalog;
+        return 0;
+    }
+
+    LOGI("Mapped %s: %d nodes, %d trophies, %d challenge sets", assetPath, catalog->view.nodeCount(),
+         catalog->view.trophyCount(), catalog->view.challengeSetCount());
+    env->ReleaseStringUTFChars(path, assetPath);
+    return reinterpret_cast<jlong>(catalog);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeClose(JNIEnv* env, jobject obj, jlong handle) {
+    delete progressionCatalog(handle);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeCount(JNIEnv* env, jobject obj, jlong handle, jint section) {
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    if (!catalog) return 0;
+    switch (section) {
+        case TrashPiles::ProgressionBlobFormat::Nodes: return catalog->view.nodeCount();
+        case TrashPiles::ProgressionBlobFormat::Trophies: return catalog->view.trophyCount();
+        case TrashPiles::ProgressionBlobFormat::ChallengeSets: return catalog->view.challengeSetCount();
+        case TrashPiles::ProgressionBlobFormat::Challenges: return catalog->view.challengeCount();
+        default: return 0;
+    }
+}
+
+/**
+ * Every numeric field of one record:
+ *   node          cost level xp pointType tier category usesPerMatch usesPerRound
+ *   trophy        rarity tier pointType(-1 if split) xp points, then the six
+ *                 TrophyThreshold values (kNoValue if unset)
+ *   challenge set level requiredToComplete challengeStart challengeCount
+ *   challenge     type targetLevel score points combo streak cards maxTime
+ *                 perfect pointsBonus xpBonus, then uses per ability goal
+ */
+JNIEXPORT jintArray JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeInts(
+    JNIEnv* env, jobject obj, jlong handle, jint section, jint index) {
+
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    if (!inSection(catalog, section, index)) return nullptr;
+    const ProgressionBlobView& view = catalog->view;
+
+    std::vector<jint> values;
+    switch (section) {
+        case TrashPiles::ProgressionBlobFormat::Nodes: {
+            const ProgressionBlobView::NodeRecord& node = view.node(index);
+            values = {node.cost, node.levelRequired, node.xpReward, node.pointType, node.tier, node.category,
+                      node.usesPerMatch, node.usesPerRound};
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::Trophies: {
+            const ProgressionBlobView::TrophyRecord& trophy = view.trophy(index);
+            jint pointType = trophy.pointType == TrashPiles::ProgressionBlobFormat::kNoEnum ? -1 : trophy.pointType;
+            values = {trophy.rarity, trophy.tier, pointType, trophy.xpReward, trophy.pointReward};
+            values.insert(values.end(), trophy.thresholds,
+                          trophy.thresholds + TrashPiles::ProgressionBlobFormat::ThresholdCount);
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::ChallengeSets: {
+            const ProgressionBlobView::ChallengeSetRecord& set = view.challengeSet(index);
+            values = {set.level, set.requiredToComplete, set.challengeStart, set.challengeCount};
+            break;
+        }
+        default: {
+            const ProgressionBlobView::ChallengeRecord& challenge = view.challenge(index);
+            values = {challenge.type, challenge.targetLevel, challenge.score, challenge.pointsEarned,
+                      challenge.comboCount, challenge.winStreak, challenge.cardsPlaced, challenge.maxTimeSeconds,
+                      challenge.perfectRounds, challenge.pointsBonus, challenge.xpBonus};
+            for (int g = 0; g < challenge.abilityGoalCount; ++g) {
+                values.push_back(view.abilityGoal(challenge.abilityGoalStart + g).uses);
+            }
+            break;
+        }
+    }
+    return toIntArray(env, values);
+}
+
+// One string field (CatalogField), null where the catalog has none
+JNIEXPORT jstring JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeString(
+    JNIEnv* env, jobject obj, jlong handle, jint section, jint index, jint field) {
+
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    if (!inSection(catalog, section, index) || field < 0) return nullptr;
+    const ProgressionBlobView& view = catalog->view;
+
+    uint32_t offset = TrashPiles::ProgressionBlobFormat::kNoString;
+    switch (section) {
+        case TrashPiles::ProgressionBlobFormat::Nodes: {
+            const ProgressionBlobView::NodeRecord& node = view.node(index);
+            const uint32_t fields[] = {node.id, node.name, node.description, node.effect, node.trophyId};
+            if (field <= CatalogField::kNodeTrophyId) offset = fields[field];
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::Trophies: {
+            const ProgressionBlobView::TrophyRecord& trophy = view.trophy(index);
+            const uint32_t fields[] = {trophy.id, trophy.name, trophy.description, trophy.icon};
+            if (field <= CatalogField::kTrophyIcon) offset = fields[field];
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::Challenges: {
+            const ProgressionBlobView::ChallengeRecord& challenge = view.challenge(index);
+            const uint32_t fields[] = {challenge.id, challenge.name, challenge.description, challenge.achievement,
+                                       challenge.specialReward};
+            if (field <= CatalogField::kChallengeSpecialReward) offset = fields[field];
+            break;
+        }
+        default:
+            break;
+    }
+
+    const char* text = view.string(offset);
+    return text ? env->NewStringUTF(text) : nullptr;
+}
+
+// One id list (CatalogField); unknown prerequisites come back as ""
+JNIEXPORT jobjectArray JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeStrings(
+    JNIEnv* env, jobject obj, jlong handle, jint section, jint index, jint field) {
+
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    if (!inSection(catalog, section, index)) return nullptr;
+    const ProgressionBlobView& view = catalog->view;
+
+    std::vector<const char*> ids;
+    switch (section) {
+        case TrashPiles::ProgressionBlobFormat::Nodes: {
+            const ProgressionBlobView::NodeRecord& node = view.node(index);
+            if (field != CatalogField::kNodePrerequisites) break;
+            for (int p = 0; p < node.prerequisiteCount; ++p) {
+                uint16_t required = view.prerequisite(node.prerequisiteStart + p);
+                ids.push_back(required == TrashPiles::ProgressionBlobFormat::kMissingNode
+                                  ? "" : view.string(view.node(required).id));
+            }
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::Trophies: {
+            const ProgressionBlobView::TrophyRecord& trophy = view.trophy(index);
+            if (field == CatalogField::kTrophySkills) {
+                for (int r = 0; r < trophy.skillCount; ++r) ids.push_back(view.requirement(trophy.skillStart + r));
+            } else if (field == CatalogField::kTrophyAbilities) {
+                for (int r = 0; r < trophy.abilityCount; ++r) ids.push_back(view.requirement(trophy.abilityStart + r));
+            }
+            break;
+        }
+        case TrashPiles::ProgressionBlobFormat::Challenges: {
+            const ProgressionBlobView::ChallengeRecord& challenge = view.challenge(index);
+            if (field == CatalogField::kChallengeAbilityGoals) {
+                for (int g = 0; g < challenge.abilityGoalCount; ++g) {
+                    ids.push_back(view.string(view.abilityGoal(challenge.abilityGoalStart + g).abilityId));
+                }
+            } else if (field == CatalogField::kChallengeSkills) {
+                for (int r = 0; r < challenge.skillCount; ++r) ids.push_back(view.requirement(challenge.skillStart + r));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return toStringArray(env, ids);
+}
+
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeFindNode(
+    JNIEnv* env, jobject obj, jlong handle, jstring id) {
+
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    const char* nodeId = catalog ? env->GetStringUTFChars(id, nullptr) : nullptr;
+    if (!nodeId) return -1;
+    int index = catalog->view.findNode(nodeId);
+    env->ReleaseStringUTFChars(id, nodeId);
+    return index;
+}
+
+JNIEXPORT jint JNICALL
+Java_com_trashpiles_native_NativeProgressionCatalog_nativeFindChallengeSet(
+    JNIEnv* env, jobject obj, jlong handle, jint level) {
+
+    ProgressionCatalog* catalog = progressionCatalog(handle);
+    return catalog ? catalog->view.findChallengeSet(level) : -1;
+}
+
+} // extern "C"
@@ -3,36 +3,44 @@
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
 #include "renderer/renderer_wrapper.h"
+#include "game_engine/engine_context.h"
+#include "trace/trace.h"
+#include "game_engine/alloc_tracker.h"
 
 #define LOG_TAG "TrashPiles-RendererJNI"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-extern "C" {
+namespace {
 
-// Global renderer instance
-static TrashPiles::RendererWrapper* g_renderer = nullptr;
+// Copies a Java string into the renderer's frame arena, avoiding a JVM
+// allocation per draw call; null when the arena is full
+const char* copyToFrameArena(JNIEnv* env, TrashPiles::RendererWrapper* renderer, jstring text) {
+    if (!text) return nullptr;
+    
+    jsize utfLength = env->GetStringUTFLength(text);
+    char* copy = static_cast<char*>(renderer->frameArena().allocate(static_cast<size_t>(utfLength) + 1, 1));
+    if (!copy) return nullptr;
+    
+    env->GetStringUTFRegion(text, 0, env->GetStringLength(text), copy);
+    copy[utfLength] = '\0';
+    return copy;
+}
+
+} // namespace
+
+extern "C" {
 
+// The renderer is owned by the engine context; the handle is its pointer
 JNIEXPORT jlong JNICALL
 Java_com_trashpiles_RendererBridge_nativeCreateRenderer(JNIEnv* env, jobject thiz) {
-    if (g_renderer) {
-        LOGE("Renderer already created");
-        return 0;
-    }
-    
-    g_renderer = new TrashPiles::RendererWrapper();
-    LOGI("Renderer created");
-    return reinterpret_cast<jlong>(g_renderer);
+    return reinterpret_cast<jlong>(TrashPiles::EngineContext::instance().renderer());
 }
 
 JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeDestroyRenderer(JNIEnv* env, jobject thiz, jlong renderer_ptr) {
-    TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
-    if (renderer) {
-        delete renderer;
-        if (renderer == g_renderer) {
-            g_renderer = nullptr;
-        }
+    if (renderer_ptr) {
+        TrashPiles::EngineContext::instance().releaseRenderer();
         LOGI("Renderer destroyed");
     }
 }
@@ -55,6 +63,12 @@ Java_com_trashpiles_RendererBridge_nativeInitialize(JNIEnv* env, jobject thiz, j
         return JNI_FALSE;
     }
     
+    // The startup graph may already have created this surface
+    TrashPiles::EngineContext::instance().awaitStage(TrashPiles::kStageRendererSurface, -1);
+    if (renderer->isInitialized() && renderer->getWidth() == width && renderer->getHeight() == height) {
+        return JNI_TRUE;
+    }
+    
     bool result = renderer->initialize(width, height);
     LOGI("Renderer initialization: %s", result ? "SUCCESS" : "FAILED");
     return result ? JNI_TRUE : JNI_FALSE;
@@ -72,6 +86,8 @@ Java_com_trashpiles_RendererBridge_nativeCleanup(JNIEnv* env, jobject thiz, jlon
 JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeBeginFrame(JNIEnv* env, jobject thiz, jlong renderer_ptr) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
+    TRACE_SCOPE("jni.beginFrame");
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Renderer);
     if (renderer) {
         renderer->beginFrame();
     }
@@ -80,8 +96,11 @@ Java_com_trashpiles_RendererBridge_nativeBeginFrame(JNIEnv* env, jobject thiz, j
 JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeEndFrame(JNIEnv* env, jobject thiz, jlong renderer_ptr) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
+    TRACE_SCOPE("jni.endFrame");
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Renderer);
     if (renderer) {
         renderer->endFrame();
+        TrashPiles::EngineContext::instance().markFirstFrame();
     }
 }
 
@@ -96,6 +115,8 @@ Java_com_trashpiles_RendererBridge_nativeClear(JNIEnv* env, jobject thiz, jlong
 JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeRenderCard(JNIEnv* env, jobject thiz, jlong renderer_ptr, jint card_id, jfloat x, jfloat y, jfloat width, jfloat height, jboolean face_up) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
+    TRACE_SCOPE("jni.renderCard");
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Renderer);
     if (renderer) {
         renderer->renderCard(card_id, x, y, width, height, face_up);
     }
@@ -113,8 +134,15 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeRenderButton(JNIEnv* env, jobject thiz, jlong renderer_ptr, jstring button_id, jfloat x, jfloat y, jfloat width, jfloat height) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
     if (!renderer) return;
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Renderer);
     
-    const char* buttonIdStr = env->GetStringUTFChars(button_id, nullptr);
+    const char* buttonIdStr = copyToFrameArena(env, renderer, button_id);
+    if (buttonIdStr) {
+        renderer->renderButton(buttonIdStr, x, y, width, height);
+        return;
+    }
+    
+    buttonIdStr = button_id ? env->GetStringUTFChars(button_id, nullptr) : nullptr;
     if (buttonIdStr) {
         renderer->renderButton(buttonIdStr, x, y, width, height);
         env->ReleaseStringUTFChars(button_id, buttonIdStr);
@@ -125,14 +153,29 @@ JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeRenderText(JNIEnv* env, jobject thiz, jlong renderer_ptr, jstring text, jfloat x, jfloat y, jfloat size) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
     if (!renderer) return;
+    TrashPiles::AllocScope allocScope(TrashPiles::AllocSubsystem::Renderer);
+    
+    const char* textStr = copyToFrameArena(env, renderer, text);
+    if (textStr) {
+        renderer->renderText(textStr, x, y, size);
+        return;
+    }
     
-    const char* textStr = env->GetStringUTFChars(text, nullptr);
+    textStr = text ? env->GetStringUTFChars(text, nullptr) : nullptr;
     if (textStr) {
         renderer->renderText(textStr, x, y, size);
         env->ReleaseStringUTFChars(text, textStr);
     }
 }
 
+JNIEXPORT void JNICALL
+Java_com_trashpiles_RendererBridge_nativeRenderTurnIndicator(JNIEnv* env, jobject thiz, jlong renderer_ptr, jint player_id, jfloat x, jfloat y, jfloat width, jfloat height) {
+    TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
+    if (renderer) {
+        renderer->renderTurnIndicator(player_id, x, y, width, height);
+    }
+}
+
 JNIEXPORT void JNICALL
 Java_com_trashpiles_RendererBridge_nativeSetCardRotation(JNIEnv* env, jobject thiz, jlong renderer_ptr, jint card_id, jfloat angle) {
     TrashPiles::RendererWrapper* renderer = reinterpret_cast<TrashPiles::RendererWrapper*>(renderer_ptr);
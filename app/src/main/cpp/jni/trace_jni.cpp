@@ -0,0 +1,101 @@
+#include <jni.h>
+#include <android/log.h>
+#include "../trace/trace.h"
+#include <cstdint>
+
+#define LOG_TAG "TrashPiles-TraceJNI"
+#define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
+#define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
+
+using TrashPiles::TracePhase;
+using TrashPiles::Tracer;
+
+// Kotlin names are interned once and passed back as handles, so sections
+// from the UI and AI code record without crossing strings every call
+static const char* traceName(jlong handle) {
+    return reinterpret_cast<const char*>(static_cast<intptr_t>(handle));
+}
+
+#ifdef TRASHPILES_TRACING
+static void recordFromKotlin(TracePhase phase, jlong handle, int64_t value) {
+    if (handle && Tracer::isEnabled()) {
+        Tracer::record(phase, traceName(handle), value);
+    }
+}
+#else
+static void recordFromKotlin(TracePhase, jlong, int64_t) {}
+#endif
+
+extern "C" {
+
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeTrace_isCompiledIn(JNIEnv* env, jobject thiz) {
+#ifdef TRASHPILES_TRACING
+    return JNI_TRUE;
+#else
+    return JNI_FALSE;
+#endif
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_setEnabled(JNIEnv* env, jobject thiz, jboolean enabled) {
+    Tracer::setEnabled(enabled == JNI_TRUE);
+    LOGI("Native tracing %s", enabled == JNI_TRUE ? "enabled" : "disabled");
+}
+
+// Returns 0 once the name table is full
+JNIEXPORT jlong JNICALL
+Java_com_trashpiles_native_NativeTrace_registerName(JNIEnv* env, jobject thiz, jstring name) {
+    const char* nameStr = env->GetStringUTFChars(name, nullptr);
+    const char* interned = Tracer::intern(nameStr);
+    env->ReleaseStringUTFChars(name, nameStr);
+    
+    if (!interned) {
+        LOGE("Trace name table full");
+        return 0;
+    }
+    return static_cast<jlong>(reinterpret_cast<intptr_t>(interned));
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_beginSection(JNIEnv* env, jobject thiz, jlong handle) {
+    recordFromKotlin(TracePhase::Begin, handle, 0);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_endSection(JNIEnv* env, jobject thiz, jlong handle) {
+    recordFromKotlin(TracePhase::End, handle, 0);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_counter(JNIEnv* env, jobject thiz, jlong handle, jlong value) {
+    recordFromKotlin(TracePhase::Counter, handle, value);
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_setThreadName(JNIEnv* env, jobject thiz, jstring name) {
+    const char* nameStr = env->GetStringUTFChars(name, nullptr);
+    Tracer::setThreadName(nameStr);
+    env->ReleaseStringUTFChars(name, nameStr);
+}
+
+// Writes Chrome trace-event JSON, loadable in Perfetto UI
+JNIEXPORT jboolean JNICALL
+Java_com_trashpiles_native_NativeTrace_exportTrace(JNIEnv* env, jobject thiz, jstring path) {
+    const char* pathStr = env->GetStringUTFChars(path, nullptr);
+    bool written = Tracer::writeChromeJson(pathStr);
+    if (written) {
+        LOGI("Trace written to %s (%d threads)", pathStr, Tracer::threadCount());
+    } else {
+        LOGE("Failed to write trace to %s", pathStr);
+    }
+    env->ReleaseStringUTFChars(path, pathStr);
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT void JNICALL
+Java_com_trashpiles_native_NativeTrace_clear(JNIEnv* env, jobject thiz) {
+    Tracer::clear();
+}
+
+} // extern "C"
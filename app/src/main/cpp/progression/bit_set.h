@@ -0,0 +1,116 @@
+#ifndef TRASHPILES_BIT_SET_H
+#define TRASHPILES_BIT_SET_H
+
+#include <cstdint>
+
+namespace TrashPiles {
+
+/**
+ * Fixed-size set of small dense ids, one bit each
+ * Set algebra runs a word at a time, so questions over a whole catalog
+ * (which nodes are unlocked, affordable, eligible) cost a few ANDs rather
+ * than a walk over every entry. Words are little-endian in id order, the
+ * layout Kotlin sees as a LongArray.
+ */
+template <int Bits>
+class BitSet {
+public:
+    static constexpr int kBits = Bits;
+    static constexpr int kWords = (Bits + 63) / 64;
+
+    constexpr BitSet() : m_words() {}
+
+    void set(int id) { m_words[id >> 6] |= uint64_t(1) << (id & 63); }
+    void reset(int id) { m_words[id >> 6] &= ~(uint64_t(1) << (id & 63)); }
+    bool test(int id) const { return (m_words[id >> 6] >> (id & 63)) & 1; }
+
+    void clear() {
+        for (int w = 0; w < kWords; ++w) m_words[w] = 0;
+    }
+
+    bool any() const {
+        uint64_t bits = 0;
+        for (int w = 0; w < kWords; ++w) bits |= m_words[w];
+        return bits != 0;
+    }
+
+    bool none() const { return !any(); }
+
+    int count() const {
+        int total = 0;
+        for (int w = 0; w < kWords; ++w) total += __builtin_popcountll(m_words[w]);
+        return total;
+    }
+
+    // Every id in this set is also in other
+    bool isSubsetOf(const BitSet& other) const {
+        uint64_t outside = 0;
+        for (int w = 0; w < kWords; ++w) outside |= m_words[w] & ~other.m_words[w];
+        return outside == 0;
+    }
+
+    bool intersects(const BitSet& other) const {
+        uint64_t shared = 0;
+        for (int w = 0; w < kWords; ++w) shared |= m_words[w] & other.m_words[w];
+        return shared != 0;
+    }
+
+    BitSet& operator&=(const BitSet& other) {
+        for (int w = 0; w < kWords; ++w) m_words[w] &= other.m_words[w];
+        return *this;
+    }
+
+    BitSet& operator|=(const BitSet& other) {
+        for (int w = 0; w < kWords; ++w) m_words[w] |= other.m_words[w];
+        return *this;
+    }
+
+    BitSet& operator^=(const BitSet& other) {
+        for (int w = 0; w < kWords; ++w) m_words[w] ^= other.m_words[w];
+        return *this;
+    }
+
+    // Removes every id in other
+    BitSet& subtract(const BitSet& other) {
+        for (int w = 0; w < kWords; ++w) m_words[w] &= ~other.m_words[w];
+        return *this;
+    }
+
+    friend BitSet operator&(BitSet a, const BitSet& b) { return a &= b; }
+    friend BitSet operator|(BitSet a, const BitSet& b) { return a |= b; }
+    friend BitSet operator^(BitSet a, const BitSet& b) { return a ^= b; }
+
+    friend bool operator==(const BitSet& a, const BitSet& b) {
+        for (int w = 0; w < kWords; ++w) {
+            if (a.m_words[w] != b.m_words[w]) return false;
+        }
+        return true;
+    }
+    friend bool operator!=(const BitSet& a, const BitSet& b) { return !(a == b); }
+
+    // Calls visit(id) for each member in ascending order
+    template <typename Visit>
+    void forEach(Visit&& visit) const {
+        for (int w = 0; w < kWords; ++w) {
+            uint64_t bits = m_words[w];
+            while (bits) {
+                visit(w * 64 + __builtin_ctzll(bits));
+                bits &= bits - 1;
+            }
+        }
+    }
+
+    uint64_t word(int w) const { return m_words[w]; }
+    // Bits past kBits in the last word are dropped
+    void setWord(int w, uint64_t bits) {
+        if (w == kWords - 1 && Bits % 64) bits &= (uint64_t(1) << (Bits % 64)) - 1;
+        m_words[w] = bits;
+    }
+
+private:
+    uint64_t m_words[kWords];
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_BIT_SET_H
@@ -0,0 +1,128 @@
+#include "challenge_aggregator.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+namespace {
+
+// How each event folds into its counters (updateProgressForEvent)
+enum class Fold : uint8_t {
+    Add,        // += amount
+    Count,      // += 1
+    Max,        // best amount seen
+    Assign,     // latest amount
+    Mark        // 1 once seen
+};
+
+constexpr Fold kFolds[] = {
+    Fold::Add,      // ScoreEarned
+    Fold::Count,    // AbilityUsed
+    Fold::Mark,     // SkillUnlocked
+    Fold::Add,      // PointsEarned
+    Fold::Max,      // ComboAchieved
+    Fold::Max,      // GameWon
+    Fold::Count,    // CardPlaced
+    Fold::Assign,   // TimeElapsed
+    Fold::Count     // PerfectRound
+};
+static_assert(sizeof(kFolds) / sizeof(kFolds[0]) == ChallengeAggregator::kEventCount,
+              "one fold per challenge event");
+
+int32_t fold(Fold rule, int32_t value, int32_t amount) {
+    switch (rule) {
+        case Fold::Add: return value + amount;
+        case Fold::Count: return value + 1;
+        case Fold::Max: return std::max(value, amount);
+        case Fold::Assign: return amount;
+        case Fold::Mark: return 1;
+    }
+    return value;
+}
+
+} // namespace
+
+ChallengeAggregator::BuildResult ChallengeAggregator::build(int challengeCount, const ChallengeGoal* goals,
+                                                            int goalCount) {
+    *this = ChallengeAggregator();
+    if (challengeCount < 0 || challengeCount > kMaxChallenges || goalCount < 0 || goalCount > UINT16_MAX) {
+        return BuildResult::TooManyChallenges;
+    }
+
+    m_unmet.assign(challengeCount, 0);
+    for (int id = 0; id < goalCount; ++id) {
+        const ChallengeGoal& goal = goals[id];
+        if (goal.challenge < 0 || goal.challenge >= challengeCount || goal.event >= ChallengeEvent::Count ||
+            (isKeyed(goal.event) && goal.key < 0)) {
+            *this = ChallengeAggregator();
+            return BuildResult::BadGoal;
+        }
+        m_goals.push_back(goal);
+        if (!isKeyed(goal.event)) m_goals.back().key = -1;
+
+        // Counters start at 0; a goal already met there never holds a challenge back
+        if (!isMet(goal, 0)) ++m_unmet[goal.challenge];
+    }
+    m_challengeCount = challengeCount;
+    m_counters.assign(goalCount, 0);
+
+    for (int id = 0; id < goalCount; ++id) {
+        m_subscriptions.push_back({m_goals[id].key, static_cast<uint16_t>(id)});
+    }
+    std::stable_sort(m_subscriptions.begin(), m_subscriptions.end(),
+                     [this](const Subscription& a, const Subscription& b) {
+        ChallengeEvent eventA = m_goals[a.goal].event;
+        ChallengeEvent eventB = m_goals[b.goal].event;
+        return eventA != eventB ? eventA < eventB : a.key < b.key;
+    });
+    for (int event = 0, position = 0; event <= kEventCount; ++event) {
+        while (position < goalCount && static_cast<int>(m_goals[m_subscriptions[position].goal].event) < event) {
+            ++position;
+        }
+        m_eventStart[event] = position;
+    }
+
+    for (int challenge = 0; challenge < challengeCount; ++challenge) {
+        if (m_unmet[challenge] == 0) m_pending.set(challenge);
+    }
+    return BuildResult::Ok;
+}
+
+ChallengeAggregator::ChallengeSet ChallengeAggregator::dispatch(ChallengeEvent event, int32_t key, int32_t amount) {
+    ChallengeSet newlyCompleted = m_pending;
+    m_completed |= m_pending;
+    m_pending.clear();
+    m_lastVisited = 0;
+    if (event >= ChallengeEvent::Count) return newlyCompleted;
+
+    const Subscription* begin = m_subscriptions.data() + m_eventStart[static_cast<int>(event)];
+    const Subscription* end = m_subscriptions.data() + m_eventStart[static_cast<int>(event) + 1];
+    if (isKeyed(event)) {
+        auto keyBefore = [](const Subscription& subscription, int32_t value) { return subscription.key < value; };
+        auto keyAfter = [](int32_t value, const Subscription& subscription) { return value < subscription.key; };
+        begin = std::lower_bound(begin, end, key, keyBefore);
+        end = std::upper_bound(begin, end, key, keyAfter);
+    }
+
+    Fold rule = kFolds[static_cast<int>(event)];
+    for (const Subscription* subscription = begin; subscription != end; ++subscription) {
+        const ChallengeGoal& goal = m_goals[subscription->goal];
+        if (m_completed.test(goal.challenge)) continue;
+        ++m_lastVisited;
+
+        int32_t& counter = m_counters[subscription->goal];
+        bool wasMet = isMet(goal, counter);
+        counter = fold(rule, counter, amount);
+        bool nowMet = isMet(goal, counter);
+        if (wasMet == nowMet) continue;
+
+        if (nowMet && --m_unmet[goal.challenge] == 0) {
+            m_completed.set(goal.challenge);
+            newlyCompleted.set(goal.challenge);
+        } else if (!nowMet) {
+            ++m_unmet[goal.challenge];
+        }
+    }
+    return newlyCompleted;
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,106 @@
+#ifndef TRASHPILES_CHALLENGE_AGGREGATOR_H
+#define TRASHPILES_CHALLENGE_AGGREGATOR_H
+
+#include "bit_set.h"
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+// Event types ChallengeSystem.updateProgressForEvent understands, in order
+enum class ChallengeEvent : uint8_t {
+    ScoreEarned = 0,    // amount: score
+    AbilityUsed,        // key: ability
+    SkillUnlocked,      // key: skill
+    PointsEarned,       // amount: points
+    ComboAchieved,      // amount: combo length
+    GameWon,            // amount: current streak
+    CardPlaced,
+    TimeElapsed,        // amount: seconds so far
+    PerfectRound,
+    Count
+};
+
+// One requirement of one challenge: a counter fed by one event type (and
+// one key, for abilities and skills) that must reach target, or for time
+// limits stay at or under it
+struct ChallengeGoal {
+    int32_t challenge = 0;
+    ChallengeEvent event = ChallengeEvent::ScoreEarned;
+    int32_t key = -1;
+    int32_t target = 0;
+    bool atMost = false;
+};
+
+/**
+ * Challenge progress for one player's current challenge set
+ * Every goal owns a slot in a flat counter array, and goals are indexed by
+ * event type and key, so an event only visits the counters subscribed to
+ * it; nothing is copied and untouched challenges are never re-checked. Each
+ * challenge keeps a count of unmet goals, and a goal crossing its target
+ * moves that count, so completion is known the moment the last one crosses.
+ * Completion latches, as Challenge.isCompleted does. Not thread-safe.
+ */
+class ChallengeAggregator {
+public:
+    static constexpr int kMaxChallenges = 64;
+    static constexpr int kEventCount = static_cast<int>(ChallengeEvent::Count);
+
+    using ChallengeSet = BitSet<kMaxChallenges>;
+
+    enum class BuildResult {
+        Ok = 0,
+        TooManyChallenges,
+        BadGoal                 // Challenge or event out of range, or a keyed event without a key
+    };
+
+    // Challenges are ids 0 .. challengeCount - 1; all counters start at 0.
+    // A challenge with no unmet goal completes on the first event, as the
+    // Kotlin check would.
+    BuildResult build(int challengeCount, const ChallengeGoal* goals, int goalCount);
+
+    // Feed one event; returns the challenges it completed. The key is only
+    // read for AbilityUsed and SkillUnlocked, the amount only where noted
+    // on ChallengeEvent.
+    ChallengeSet dispatch(ChallengeEvent event, int32_t key, int32_t amount);
+
+    int challengeCount() const { return m_challengeCount; }
+    int goalCount() const { return static_cast<int>(m_goals.size()); }
+    const ChallengeGoal& goal(int id) const { return m_goals[id]; }
+    int32_t counter(int goal) const { return m_counters[goal]; }
+    int unmetGoals(int challenge) const { return m_unmet[challenge]; }
+    const ChallengeSet& completed() const { return m_completed; }
+
+    // Goals the last dispatch visited
+    int lastVisited() const { return m_lastVisited; }
+
+    static bool isKeyed(ChallengeEvent event) {
+        return event == ChallengeEvent::AbilityUsed || event == ChallengeEvent::SkillUnlocked;
+    }
+
+private:
+    struct Subscription {
+        int32_t key;
+        uint16_t goal;
+    };
+
+    int m_challengeCount = 0;
+    std::vector<ChallengeGoal> m_goals;
+    std::vector<int32_t> m_counters;
+    std::vector<uint16_t> m_unmet;
+    // Grouped by event, then sorted by key; event e owns
+    // m_subscriptions[m_eventStart[e] .. m_eventStart[e + 1])
+    std::vector<Subscription> m_subscriptions;
+    int m_eventStart[kEventCount + 1] = {};
+    ChallengeSet m_completed;
+    ChallengeSet m_pending;         // Complete from the start, not yet reported
+    int m_lastVisited = 0;
+
+    bool isMet(const ChallengeGoal& goal, int32_t value) const {
+        return goal.atMost ? value <= goal.target : value >= goal.target;
+    }
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_CHALLENGE_AGGREGATOR_H
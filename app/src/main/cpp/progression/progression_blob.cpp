@@ -0,0 +1,505 @@
+#include "progression_blob.h"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <utility>
+
+namespace TrashPiles {
+
+using namespace ProgressionBlobFormat;
+
+namespace {
+
+constexpr size_t kRecordSizes[SectionCount] = {
+    sizeof(NodeRecord),
+    sizeof(uint16_t),
+    sizeof(TrophyRecord),
+    sizeof(uint32_t),
+    sizeof(ChallengeSetRecord),
+    sizeof(ChallengeRecord),
+    sizeof(AbilityGoalRecord)
+};
+
+size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+// Interned, NUL-terminated strings; equal strings share one offset
+class StringTable {
+public:
+    uint32_t add(const std::string& text) {
+        auto found = m_offsets.find(text);
+        if (found != m_offsets.end()) return found->second;
+
+        uint32_t offset = static_cast<uint32_t>(m_bytes.size());
+        m_bytes.insert(m_bytes.end(), text.begin(), text.end());
+        m_bytes.push_back('\0');
+        m_offsets.emplace(text, offset);
+        return offset;
+    }
+
+    uint32_t addOptional(const std::string& text, bool present) { return present ? add(text) : kNoString; }
+
+    const std::vector<char>& bytes() const { return m_bytes; }
+
+private:
+    std::vector<char> m_bytes;
+    std::map<std::string, uint32_t> m_offsets;
+};
+
+std::string unescape(const std::string& field) {
+    std::string text;
+    text.reserve(field.size());
+    for (size_t i = 0; i < field.size(); ++i) {
+        if (field[i] != '\\' || i + 1 == field.size()) {
+            text.push_back(field[i]);
+            continue;
+        }
+        char next = field[++i];
+        text.push_back(next == 't' ? '\t' : next == 'n' ? '\n' : next);
+    }
+    return text;
+}
+
+std::vector<std::string> split(const std::string& text, char separator) {
+    std::vector<std::string> parts;
+    size_t start = 0;
+    while (true) {
+        size_t end = text.find(separator, start);
+        parts.push_back(text.substr(start, end == std::string::npos ? std::string::npos : end - start));
+        if (end == std::string::npos) return parts;
+        start = end + 1;
+    }
+}
+
+std::vector<std::string> splitList(const std::string& field) {
+    if (field.empty() || field == "-") return {};
+    return split(field, ',');
+}
+
+bool parseInt(const std::string& field, int32_t& value) {
+    if (field == "-") {
+        value = kNoValue;
+        return true;
+    }
+    if (field.empty()) return false;
+    char* end = nullptr;
+    long long parsed = std::strtoll(field.c_str(), &end, 10);
+    if (*end != '\0' || parsed < INT32_MIN || parsed > INT32_MAX) return false;
+    value = static_cast<int32_t>(parsed);
+    return true;
+}
+
+bool parseEnum(const std::string& field, uint8_t& value) {
+    int32_t parsed = 0;
+    if (!parseInt(field, parsed)) return false;
+    if (parsed == kNoValue) {
+        value = kNoEnum;
+        return true;
+    }
+    if (parsed < 0 || parsed >= kNoEnum) return false;
+    value = static_cast<uint8_t>(parsed);
+    return true;
+}
+
+bool fail(std::string* error, std::string message) {
+    *error = std::move(message);
+    return false;
+}
+
+// Text field; "-" is null
+bool optionalText(const std::string& field, std::string& text) {
+    if (field == "-") return false;
+    text = unescape(field);
+    return true;
+}
+
+} // namespace
+
+bool ProgressionBlobWriter::addCatalogText(const std::string& text, std::string* error) {
+    std::vector<std::string> lines = split(text, '\n');
+    for (size_t number = 0; number < lines.size(); ++number) {
+        std::string& line = lines[number];
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty() || line[0] == '#') continue;
+
+        if (!addLine(split(line, '\t'), error)) {
+            if (error) *error = "line " + std::to_string(number + 1) + ": " + *error;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProgressionBlobWriter::addLine(const std::vector<std::string>& fields, std::string* error) {
+    std::string scratch;
+    if (!error) error = &scratch;
+    const std::string& kind = fields[0];
+
+    if (kind == "node") {
+        if (fields.size() != 15) return fail(error, "node needs 14 fields");
+        Node node;
+        int32_t usesPerMatch = 0, usesPerRound = 0;
+        node.id = unescape(fields[1]);
+        node.name = unescape(fields[2]);
+        node.description = unescape(fields[3]);
+        node.effect = unescape(fields[4]);
+        node.hasTrophy = optionalText(fields[5], node.trophyId);
+        if (!parseInt(fields[6], node.cost) || !parseInt(fields[7], node.level) || !parseInt(fields[8], node.xp) ||
+            !parseEnum(fields[9], node.pointType) || !parseEnum(fields[10], node.tier) ||
+            !parseEnum(fields[11], node.category) || !parseInt(fields[12], usesPerMatch) ||
+            !parseInt(fields[13], usesPerRound)) {
+            return fail(error, "bad number in node " + node.id);
+        }
+        node.usesPerMatch = static_cast<int16_t>(usesPerMatch == kNoValue ? -1 : usesPerMatch);
+        node.usesPerRound = static_cast<int16_t>(usesPerRound == kNoValue ? -1 : usesPerRound);
+        for (const std::string& prerequisite : splitList(fields[14])) node.prerequisites.push_back(unescape(prerequisite));
+        m_nodes.push_back(std::move(node));
+        return true;
+    }
+
+    if (kind == "trophy") {
+        if (fields.size() != 18) return fail(error, "trophy needs 17 fields");
+        Trophy trophy;
+        trophy.id = unescape(fields[1]);
+        trophy.name = unescape(fields[2]);
+        trophy.description = unescape(fields[3]);
+        trophy.hasIcon = optionalText(fields[4], trophy.icon);
+        if (!parseEnum(fields[5], trophy.rarity) || !parseEnum(fields[6], trophy.tier) ||
+            !parseEnum(fields[7], trophy.pointType) || !parseInt(fields[8], trophy.xp) ||
+            !parseInt(fields[9], trophy.points)) {
+            return fail(error, "bad number in trophy " + trophy.id);
+        }
+        for (int t = 0; t < ThresholdCount; ++t) {
+            if (!parseInt(fields[10 + t], trophy.thresholds[t])) return fail(error, "bad threshold in trophy " + trophy.id);
+        }
+        for (const std::string& skill : splitList(fields[16])) trophy.skills.push_back(unescape(skill));
+        for (const std::string& ability : splitList(fields[17])) trophy.abilities.push_back(unescape(ability));
+        m_trophies.push_back(std::move(trophy));
+        return true;
+    }
+
+    if (kind == "set") {
+        if (fields.size() != 3) return fail(error, "set needs 2 fields");
+        ChallengeSet set;
+        if (!parseInt(fields[1], set.level) || !parseInt(fields[2], set.requiredToComplete)) {
+            return fail(error, "bad number in set");
+        }
+        m_sets.push_back(std::move(set));
+        return true;
+    }
+
+    if (kind == "challenge") {
+        if (m_sets.empty()) return fail(error, "challenge before any set");
+        if (fields.size() != 19) return fail(error, "challenge needs 18 fields");
+        Challenge challenge;
+        challenge.id = unescape(fields[1]);
+        challenge.name = unescape(fields[2]);
+        challenge.description = unescape(fields[3]);
+        challenge.achievement = unescape(fields[4]);
+        challenge.hasSpecialReward = optionalText(fields[5], challenge.specialReward);
+        int32_t* numbers[] = {&challenge.targetLevel, &challenge.score, &challenge.points, &challenge.combo,
+                              &challenge.streak, &challenge.cards, &challenge.maxTime, &challenge.perfect,
+                              &challenge.pointsBonus, &challenge.xpBonus};
+        if (!parseEnum(fields[6], challenge.type)) return fail(error, "bad type in challenge " + challenge.id);
+        for (size_t n = 0; n < sizeof(numbers) / sizeof(numbers[0]); ++n) {
+            if (!parseInt(fields[7 + n], *numbers[n])) return fail(error, "bad number in challenge " + challenge.id);
+        }
+        for (const std::string& goal : splitList(fields[17])) {
+            size_t equals = goal.rfind('=');
+            int32_t uses = 0;
+            if (equals == std::string::npos || !parseInt(goal.substr(equals + 1), uses)) {
+                return fail(error, "bad ability goal in challenge " + challenge.id);
+            }
+            challenge.abilityGoals.emplace_back(unescape(goal.substr(0, equals)), uses);
+        }
+        for (const std::string& skill : splitList(fields[18])) challenge.skills.push_back(unescape(skill));
+        m_sets.back().challenges.push_back(std::move(challenge));
+        return true;
+    }
+
+    return fail(error, "unknown record '" + kind + "'");
+}
+
+bool ProgressionBlobWriter::build(std::vector<uint8_t>& image, std::string* error) const {
+    std::string scratch;
+    if (!error) error = &scratch;
+
+    // Nodes by id; sets by level
+    std::vector<const Node*> nodes;
+    for (const Node& node : m_nodes) nodes.push_back(&node);
+    std::stable_sort(nodes.begin(), nodes.end(), [](const Node* a, const Node* b) { return a->id < b->id; });
+    std::map<std::string, uint16_t> nodeIndex;
+    for (size_t i = 0; i < nodes.size(); ++i) nodeIndex.emplace(nodes[i]->id, static_cast<uint16_t>(i));
+
+    std::vector<const ChallengeSet*> sets;
+    for (const ChallengeSet& set : m_sets) sets.push_back(&set);
+    std::stable_sort(sets.begin(), sets.end(), [](const ChallengeSet* a, const ChallengeSet* b) {
+        return a->level < b->level;
+    });
+
+    StringTable strings;
+    std::vector<NodeRecord> nodeRecords;
+    std::vector<uint16_t> prerequisites;
+    std::vector<TrophyRecord> trophyRecords;
+    std::vector<uint32_t> requirements;
+    std::vector<ChallengeSetRecord> setRecords;
+    std::vector<ChallengeRecord> challengeRecords;
+    std::vector<AbilityGoalRecord> abilityGoals;
+
+    auto fits = [](size_t value) { return value < kMissingNode; };
+
+    for (const Node* node : nodes) {
+        NodeRecord record = {};
+        record.id = strings.add(node->id);
+        record.name = strings.add(node->name);
+        record.description = strings.add(node->description);
+        record.effect = strings.add(node->effect);
+        record.trophyId = strings.addOptional(node->trophyId, node->hasTrophy);
+        record.cost = node->cost;
+        record.levelRequired = node->level;
+        record.xpReward = node->xp;
+        record.pointType = node->pointType;
+        record.tier = node->tier;
+        record.category = node->category;
+        record.prerequisiteStart = static_cast<uint16_t>(prerequisites.size());
+        record.prerequisiteCount = static_cast<uint16_t>(node->prerequisites.size());
+        record.usesPerMatch = node->usesPerMatch;
+        record.usesPerRound = node->usesPerRound;
+        for (const std::string& prerequisite : node->prerequisites) {
+            auto found = nodeIndex.find(prerequisite);
+            prerequisites.push_back(found == nodeIndex.end() ? kMissingNode : found->second);
+        }
+        if (!fits(prerequisites.size())) return fail(error, "too many prerequisites");
+        nodeRecords.push_back(record);
+    }
+
+    auto addRequirements = [&](const std::vector<std::string>& ids, uint16_t& start, uint16_t& count) {
+        start = static_cast<uint16_t>(requirements.size());
+        count = static_cast<uint16_t>(ids.size());
+        for (const std::string& id : ids) requirements.push_back(strings.add(id));
+        return fits(requirements.size());
+    };
+
+    for (const Trophy& trophy : m_trophies) {
+        TrophyRecord record = {};
+        record.id = strings.add(trophy.id);
+        record.name = strings.add(trophy.name);
+        record.description = strings.add(trophy.description);
+        record.icon = strings.addOptional(trophy.icon, trophy.hasIcon);
+        record.rarity = trophy.rarity;
+        record.tier = trophy.tier;
+        record.pointType = trophy.pointType;
+        record.xpReward = trophy.xp;
+        record.pointReward = trophy.points;
+        std::copy(trophy.thresholds, trophy.thresholds + ThresholdCount, record.thresholds);
+        if (!addRequirements(trophy.skills, record.skillStart, record.skillCount) ||
+            !addRequirements(trophy.abilities, record.abilityStart, record.abilityCount)) {
+            return fail(error, "too many requirements");
+        }
+        trophyRecords.push_back(record);
+    }
+
+    for (const ChallengeSet* set : sets) {
+        ChallengeSetRecord setRecord = {};
+        setRecord.level = set->level;
+        setRecord.requiredToComplete = set->requiredToComplete;
+        setRecord.challengeStart = static_cast<uint16_t>(challengeRecords.size());
+        setRecord.challengeCount = static_cast<uint16_t>(set->challenges.size());
+
+        for (const Challenge& challenge : set->challenges) {
+            ChallengeRecord record = {};
+            record.id = strings.add(challenge.id);
+            record.name = strings.add(challenge.name);
+            record.description = strings.add(challenge.description);
+            record.achievement = strings.add(challenge.achievement);
+            record.specialReward = strings.addOptional(challenge.specialReward, challenge.hasSpecialReward);
+            record.type = challenge.type;
+            record.targetLevel = challenge.targetLevel;
+            record.score = challenge.score;
+            record.pointsEarned = challenge.points;
+            record.comboCount = challenge.combo;
+            record.winStreak = challenge.streak;
+            record.cardsPlaced = challenge.cards;
+            record.maxTimeSeconds = challenge.maxTime;
+            record.perfectRounds = challenge.perfect;
+            record.pointsBonus = challenge.pointsBonus;
+            record.xpBonus = challenge.xpBonus;
+            record.abilityGoalStart = static_cast<uint16_t>(abilityGoals.size());
+            record.abilityGoalCount = static_cast<uint16_t>(challenge.abilityGoals.size());
+            for (const auto& goal : challenge.abilityGoals) {
+                abilityGoals.push_back({strings.add(goal.first), goal.second});
+            }
+            if (!fits(abilityGoals.size()) ||
+                !addRequirements(challenge.skills, record.skillStart, record.skillCount)) {
+                return fail(error, "too many challenge goals");
+            }
+            challengeRecords.push_back(record);
+        }
+        if (!fits(challengeRecords.size())) return fail(error, "too many challenges");
+        setRecords.push_back(setRecord);
+    }
+
+    const void* sources[SectionCount] = {
+        nodeRecords.data(), prerequisites.data(), trophyRecords.data(), requirements.data(),
+        setRecords.data(), challengeRecords.data(), abilityGoals.data()
+    };
+    const size_t counts[SectionCount] = {
+        nodeRecords.size(), prerequisites.size(), trophyRecords.size(), requirements.size(),
+        setRecords.size(), challengeRecords.size(), abilityGoals.size()
+    };
+
+    Header header = {};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+
+    size_t offset = sizeof(Header);
+    for (int section = 0; section < SectionCount; ++section) {
+        offset = alignUp(offset, kSectionAlignment);
+        header.sections[section].offset = static_cast<uint32_t>(offset);
+        header.sections[section].count = static_cast<uint32_t>(counts[section]);
+        offset += counts[section] * kRecordSizes[section];
+    }
+    header.stringsOffset = static_cast<uint32_t>(offset);
+    header.stringsSize = static_cast<uint32_t>(strings.bytes().size());
+    header.totalSize = static_cast<uint32_t>(offset + strings.bytes().size());
+
+    image.assign(header.totalSize, 0);
+    std::memcpy(image.data(), &header, sizeof(header));
+    for (int section = 0; section < SectionCount; ++section) {
+        if (counts[section] == 0) continue;
+        std::memcpy(image.data() + header.sections[section].offset, sources[section],
+                    counts[section] * kRecordSizes[section]);
+    }
+    if (!strings.bytes().empty()) {
+        std::memcpy(image.data() + header.stringsOffset, strings.bytes().data(), strings.bytes().size());
+    }
+    return true;
+}
+
+ProgressionBlobView::OpenResult ProgressionBlobView::open(const uint8_t* data, size_t size) {
+    *this = ProgressionBlobView();
+    if (!data || size < sizeof(Header)) return OpenResult::TooSmall;
+    if (reinterpret_cast<uintptr_t>(data) % kRecordAlignment != 0) return OpenResult::Misaligned;
+
+    const Header& header = *reinterpret_cast<const Header*>(data);
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) return OpenResult::BadMagic;
+    if (header.version != kVersion) return OpenResult::BadVersion;
+    if (header.totalSize != size) return OpenResult::BadSize;
+
+    for (int section = 0; section < SectionCount; ++section) {
+        const SectionEntry& entry = header.sections[section];
+        if (entry.offset % kSectionAlignment != 0 || entry.offset < sizeof(Header) || entry.offset > size ||
+            entry.count > (size - entry.offset) / kRecordSizes[section]) {
+            return OpenResult::BadSection;
+        }
+    }
+    if (header.stringsOffset > size || header.stringsSize > size - header.stringsOffset ||
+        (header.stringsSize > 0 && data[header.stringsOffset + header.stringsSize - 1] != '\0')) {
+        return OpenResult::BadString;
+    }
+
+    m_data = data;
+    m_size = size;
+    m_strings = reinterpret_cast<const char*>(data + header.stringsOffset);
+    m_stringsSize = header.stringsSize;
+    std::copy(header.sections, header.sections + SectionCount, m_sections);
+
+    if (!validateReferences()) {
+        *this = ProgressionBlobView();
+        return OpenResult::BadReference;
+    }
+    return OpenResult::Ok;
+}
+
+bool ProgressionBlobView::validString(uint32_t offset, bool optional) const {
+    if (offset == kNoString) return optional;
+    return offset < m_stringsSize;
+}
+
+bool ProgressionBlobView::validateReferences() const {
+    auto inRange = [this](Section section, uint32_t start, uint32_t count) {
+        return start <= m_sections[section].count && count <= m_sections[section].count - start;
+    };
+
+    for (int i = 0; i < nodeCount(); ++i) {
+        const NodeRecord& record = node(i);
+        if (!validString(record.id, false) || !validString(record.name, false) ||
+            !validString(record.description, false) || !validString(record.effect, false) ||
+            !validString(record.trophyId, true) ||
+            !inRange(Prerequisites, record.prerequisiteStart, record.prerequisiteCount)) {
+            return false;
+        }
+        for (int p = 0; p < record.prerequisiteCount; ++p) {
+            uint16_t required = prerequisite(record.prerequisiteStart + p);
+            if (required != kMissingNode && required >= nodeCount()) return false;
+        }
+        // Lookups binary search the ids
+        if (i > 0 && std::strcmp(string(node(i - 1).id), string(record.id)) > 0) return false;
+    }
+
+    for (int r = 0; r < count(Requirements); ++r) {
+        if (!validString(records<uint32_t>(Requirements)[r], false)) return false;
+    }
+    for (int g = 0; g < count(AbilityGoals); ++g) {
+        if (!validString(abilityGoal(g).abilityId, false)) return false;
+    }
+
+    for (int i = 0; i < trophyCount(); ++i) {
+        const TrophyRecord& record = trophy(i);
+        if (!validString(record.id, false) || !validString(record.name, false) ||
+            !validString(record.description, false) || !validString(record.icon, true) ||
+            !inRange(Requirements, record.skillStart, record.skillCount) ||
+            !inRange(Requirements, record.abilityStart, record.abilityCount)) {
+            return false;
+        }
+    }
+
+    for (int i = 0; i < challengeSetCount(); ++i) {
+        const ChallengeSetRecord& record = challengeSet(i);
+        if (!inRange(Challenges, record.challengeStart, record.challengeCount)) return false;
+        if (i > 0 && challengeSet(i - 1).level > record.level) return false;
+    }
+
+    for (int i = 0; i < challengeCount(); ++i) {
+        const ChallengeRecord& record = challenge(i);
+        if (!validString(record.id, false) || !validString(record.name, false) ||
+            !validString(record.description, false) || !validString(record.achievement, false) ||
+            !validString(record.specialReward, true) ||
+            !inRange(AbilityGoals, record.abilityGoalStart, record.abilityGoalCount) ||
+            !inRange(Requirements, record.skillStart, record.skillCount)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+const char* ProgressionBlobView::string(uint32_t offset) const {
+    if (offset == kNoString) return nullptr;
+    return m_strings + offset;
+}
+
+int ProgressionBlobView::findNode(const char* id) const {
+    int low = 0;
+    int high = nodeCount();
+    while (low < high) {
+        int middle = (low + high) / 2;
+        int order = std::strcmp(string(node(middle).id), id);
+        if (order == 0) return middle;
+        if (order < 0) low = middle + 1;
+        else high = middle;
+    }
+    return -1;
+}
+
+int ProgressionBlobView::findChallengeSet(int level) const {
+    const ChallengeSetRecord* begin = records<ChallengeSetRecord>(ChallengeSets);
+    const ChallengeSetRecord* end = begin + challengeSetCount();
+    const ChallengeSetRecord* found = std::lower_bound(begin, end, level, [](const ChallengeSetRecord& set, int value) {
+        return set.level < value;
+    });
+    return found != end && found->level == level ? static_cast<int>(found - begin) : -1;
+}
+
+} // namespace TrashPiles
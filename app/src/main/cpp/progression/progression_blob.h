@@ -0,0 +1,325 @@
+#ifndef TRASHPILES_PROGRESSION_BLOB_H
+#define TRASHPILES_PROGRESSION_BLOB_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace TrashPiles {
+
+/**
+ * Packed progression catalog (.tpprog)
+ *
+ * The skill and ability tree, the trophy definitions and the per-level
+ * challenge sets, compiled offline by tools/progression_packer so nothing
+ * is constructed at startup. Layout: header, then fixed-size record
+ * sections each aligned to kSectionAlignment, then a string table of
+ * NUL-terminated UTF-8. Records refer to strings by table offset and to
+ * each other by index. Enum fields hold Kotlin ordinals. All fields are
+ * little-endian; the records are read in place from the mapped file.
+ */
+namespace ProgressionBlobFormat {
+
+constexpr char kMagic[4] = {'T', 'P', 'P', 'G'};
+constexpr uint32_t kVersion = 1;
+constexpr size_t kSectionAlignment = 8;
+constexpr uint32_t kNoString = 0xFFFFFFFFu;
+constexpr uint8_t kNoEnum = 0xFF;
+// Prerequisite outside the catalog, which nothing can unlock
+constexpr uint16_t kMissingNode = 0xFFFF;
+// Unset numeric minimum, as TrophyRules::kNoThreshold
+constexpr int32_t kNoValue = INT32_MIN;
+
+enum Section {
+    Nodes = 0,
+    Prerequisites,          // uint16_t node indices or kMissingNode
+    Trophies,
+    Requirements,           // uint32_t string offsets: trophy and challenge skill or ability ids
+    ChallengeSets,
+    Challenges,
+    AbilityGoals,
+    SectionCount
+};
+
+struct SectionEntry {
+    uint32_t offset;        // From start of file, kSectionAlignment-aligned
+    uint32_t count;
+};
+
+struct Header {
+    char magic[4];
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t stringsOffset;
+    uint32_t stringsSize;
+    uint32_t reserved[3];
+    SectionEntry sections[SectionCount];
+};
+
+// TreeNode, sorted by id so lookups can binary search
+struct NodeRecord {
+    uint32_t id;
+    uint32_t name;
+    uint32_t description;
+    uint32_t effect;                // Effect as Kotlin prints it, e.g. "XP_BOOST(value=10)"
+    uint32_t trophyId;
+    int32_t cost;
+    int32_t levelRequired;
+    int32_t xpReward;
+    uint8_t pointType;
+    uint8_t tier;
+    uint8_t category;
+    uint8_t reserved;
+    uint16_t prerequisiteStart;     // Into Prerequisites
+    uint16_t prerequisiteCount;
+    int16_t usesPerMatch;           // -1 for skills
+    int16_t usesPerRound;
+    uint32_t reserved2;
+};
+
+// Thresholds in ProgressField order, matching TrophyRules
+enum TrophyThreshold {
+    RequiredLevel = 0,
+    MinTotalPoints,
+    MinSkillPoints,
+    MinAbilityPoints,
+    MinAbilitiesUnlocked,
+    MinSkillsUnlocked,
+    ThresholdCount
+};
+
+// TrophyDefinition, in catalog order
+struct TrophyRecord {
+    uint32_t id;
+    uint32_t name;
+    uint32_t description;
+    uint32_t icon;
+    uint8_t rarity;
+    uint8_t tier;
+    uint8_t pointType;              // kNoEnum: split between SP and AP
+    uint8_t reserved;
+    int32_t xpReward;
+    int32_t pointReward;
+    int32_t thresholds[ThresholdCount];     // kNoValue where the prerequisite is null
+    uint16_t skillStart;            // Into Requirements
+    uint16_t skillCount;
+    uint16_t abilityStart;
+    uint16_t abilityCount;
+    uint32_t reserved2;
+};
+
+struct ChallengeSetRecord {
+    int32_t level;
+    int32_t requiredToComplete;
+    uint16_t challengeStart;        // Into Challenges
+    uint16_t challengeCount;
+    uint32_t reserved;
+};
+
+struct ChallengeRecord {
+    uint32_t id;
+    uint32_t name;
+    uint32_t description;
+    uint32_t achievement;
+    uint32_t specialReward;
+    uint8_t type;                   // ChallengeType
+    uint8_t reserved[3];
+    int32_t targetLevel;
+    int32_t score;
+    int32_t pointsEarned;
+    int32_t comboCount;
+    int32_t winStreak;
+    int32_t cardsPlaced;
+    int32_t maxTimeSeconds;
+    int32_t perfectRounds;
+    int32_t pointsBonus;
+    int32_t xpBonus;
+    uint16_t abilityGoalStart;      // Into AbilityGoals
+    uint16_t abilityGoalCount;
+    uint16_t skillStart;            // Into Requirements
+    uint16_t skillCount;
+};
+
+struct AbilityGoalRecord {
+    uint32_t abilityId;
+    int32_t uses;
+};
+
+// The loader reads these in place, so their layout is the file format
+static_assert(sizeof(SectionEntry) == 8, "SectionEntry layout is part of the file format");
+static_assert(sizeof(Header) == 32 + 8 * SectionCount, "Header layout is part of the file format");
+static_assert(sizeof(NodeRecord) == 48, "NodeRecord layout is part of the file format");
+static_assert(offsetof(NodeRecord, prerequisiteStart) == 36, "NodeRecord layout is part of the file format");
+static_assert(sizeof(TrophyRecord) == 64, "TrophyRecord layout is part of the file format");
+static_assert(offsetof(TrophyRecord, thresholds) == 28, "TrophyRecord layout is part of the file format");
+static_assert(sizeof(ChallengeSetRecord) == 16, "ChallengeSetRecord layout is part of the file format");
+static_assert(sizeof(ChallengeRecord) == 72, "ChallengeRecord layout is part of the file format");
+static_assert(offsetof(ChallengeRecord, targetLevel) == 24, "ChallengeRecord layout is part of the file format");
+static_assert(sizeof(AbilityGoalRecord) == 8, "AbilityGoalRecord layout is part of the file format");
+static_assert(std::is_trivially_copyable<NodeRecord>::value && std::is_trivially_copyable<TrophyRecord>::value &&
+              std::is_trivially_copyable<ChallengeRecord>::value, "records are read in place");
+
+// Every record is 4-byte aligned within its section
+constexpr size_t kRecordAlignment = 4;
+static_assert(alignof(NodeRecord) <= kRecordAlignment && alignof(TrophyRecord) <= kRecordAlignment &&
+              alignof(ChallengeRecord) <= kRecordAlignment && alignof(Header) <= kRecordAlignment,
+              "a 4-byte aligned mapping is enough to read records in place");
+
+} // namespace ProgressionBlobFormat
+
+/**
+ * Read-only view over a catalog image in memory (typically an mmapped asset)
+ * open() checks the header, every section's bounds and every index and
+ * string reference once, so accessors afterwards are plain pointer reads.
+ */
+class ProgressionBlobView {
+public:
+    using NodeRecord = ProgressionBlobFormat::NodeRecord;
+    using TrophyRecord = ProgressionBlobFormat::TrophyRecord;
+    using ChallengeSetRecord = ProgressionBlobFormat::ChallengeSetRecord;
+    using ChallengeRecord = ProgressionBlobFormat::ChallengeRecord;
+    using AbilityGoalRecord = ProgressionBlobFormat::AbilityGoalRecord;
+
+    enum class OpenResult {
+        Ok = 0,
+        TooSmall,
+        Misaligned,             // Records cannot be read in place
+        BadMagic,
+        BadVersion,
+        BadSize,
+        BadSection,
+        BadString,
+        BadReference
+    };
+
+    // The view borrows data
+    OpenResult open(const uint8_t* data, size_t size);
+    bool isOpen() const { return m_data != nullptr; }
+
+    int nodeCount() const { return count(ProgressionBlobFormat::Nodes); }
+    int trophyCount() const { return count(ProgressionBlobFormat::Trophies); }
+    int challengeSetCount() const { return count(ProgressionBlobFormat::ChallengeSets); }
+    int challengeCount() const { return count(ProgressionBlobFormat::Challenges); }
+
+    const NodeRecord& node(int index) const { return records<NodeRecord>(ProgressionBlobFormat::Nodes)[index]; }
+    const TrophyRecord& trophy(int index) const {
+        return records<TrophyRecord>(ProgressionBlobFormat::Trophies)[index];
+    }
+    const ChallengeSetRecord& challengeSet(int index) const {
+        return records<ChallengeSetRecord>(ProgressionBlobFormat::ChallengeSets)[index];
+    }
+    const ChallengeRecord& challenge(int index) const {
+        return records<ChallengeRecord>(ProgressionBlobFormat::Challenges)[index];
+    }
+
+    uint16_t prerequisite(int index) const {
+        return records<uint16_t>(ProgressionBlobFormat::Prerequisites)[index];
+    }
+    const char* requirement(int index) const {
+        return string(records<uint32_t>(ProgressionBlobFormat::Requirements)[index]);
+    }
+    const AbilityGoalRecord& abilityGoal(int index) const {
+        return records<AbilityGoalRecord>(ProgressionBlobFormat::AbilityGoals)[index];
+    }
+
+    // nullptr for kNoString
+    const char* string(uint32_t offset) const;
+
+    // Node index by id, -1 if absent
+    int findNode(const char* id) const;
+    // Challenge set index by level, -1 if absent
+    int findChallengeSet(int level) const;
+
+private:
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+    const char* m_strings = nullptr;
+    uint32_t m_stringsSize = 0;
+    ProgressionBlobFormat::SectionEntry m_sections[ProgressionBlobFormat::SectionCount] = {};
+
+    int count(ProgressionBlobFormat::Section section) const { return static_cast<int>(m_sections[section].count); }
+
+    template <typename Record>
+    const Record* records(ProgressionBlobFormat::Section section) const {
+        return reinterpret_cast<const Record*>(m_data + m_sections[section].offset);
+    }
+
+    bool validString(uint32_t offset, bool optional) const;
+    bool validateReferences() const;
+};
+
+/**
+ * Builds a catalog image from the text catalog the Kotlin exporter writes
+ * (host tool side)
+ *
+ * One record per line, tab-separated, with \t, \n and \\ escaped and "-"
+ * for a null value; lists are comma-separated, ability goals id=uses.
+ *   node       id name description effect trophyId cost level xp pointType tier
+ *              category usesPerMatch usesPerRound prerequisites
+ *   trophy     id name description icon rarity tier pointType xp points level
+ *              totalPoints sp ap abilitiesUnlocked skillsUnlocked skills abilities
+ *   set        level requiredToComplete
+ *   challenge  id name description achievement specialReward type targetLevel
+ *              score points combo streak cards maxTime perfect pointsBonus xpBonus
+ *              abilityGoals skills
+ * Challenges belong to the set line above them. Blank lines and lines
+ * starting with # are skipped.
+ */
+class ProgressionBlobWriter {
+public:
+    // False with a message naming the line on the first malformed record
+    bool addCatalogText(const std::string& text, std::string* error);
+
+    size_t nodeCount() const { return m_nodes.size(); }
+    size_t trophyCount() const { return m_trophies.size(); }
+    size_t challengeSetCount() const { return m_sets.size(); }
+
+    // False if a section outgrows its 16-bit indices
+    bool build(std::vector<uint8_t>& image, std::string* error) const;
+
+private:
+    struct Node {
+        std::string id, name, description, effect, trophyId;
+        bool hasTrophy = false;
+        int32_t cost = 0, level = 0, xp = 0;
+        uint8_t pointType = 0, tier = 0, category = 0;
+        int16_t usesPerMatch = -1, usesPerRound = -1;
+        std::vector<std::string> prerequisites;
+    };
+
+    struct Trophy {
+        std::string id, name, description, icon;
+        bool hasIcon = false;
+        uint8_t rarity = 0, tier = 0, pointType = ProgressionBlobFormat::kNoEnum;
+        int32_t xp = 0, points = 0;
+        int32_t thresholds[ProgressionBlobFormat::ThresholdCount] = {};
+        std::vector<std::string> skills, abilities;
+    };
+
+    struct Challenge {
+        std::string id, name, description, achievement, specialReward;
+        bool hasSpecialReward = false;
+        uint8_t type = 0;
+        int32_t targetLevel = 0, score = 0, points = 0, combo = 0, streak = 0, cards = 0;
+        int32_t maxTime = 0, perfect = 0, pointsBonus = 0, xpBonus = 0;
+        std::vector<std::pair<std::string, int32_t>> abilityGoals;
+        std::vector<std::string> skills;
+    };
+
+    struct ChallengeSet {
+        int32_t level = 0, requiredToComplete = 0;
+        std::vector<Challenge> challenges;
+    };
+
+    std::vector<Node> m_nodes;
+    std::vector<Trophy> m_trophies;
+    std::vector<ChallengeSet> m_sets;
+
+    bool addLine(const std::vector<std::string>& fields, std::string* error);
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_PROGRESSION_BLOB_H
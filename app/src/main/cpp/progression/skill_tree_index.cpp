@@ -0,0 +1,202 @@
+#include "skill_tree_index.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+void SkillTreeIndex::SortedView::build(std::vector<uint16_t> order, const std::vector<int32_t>& keyOf) {
+    std::stable_sort(order.begin(), order.end(), [&keyOf](uint16_t a, uint16_t b) {
+        return keyOf[a] < keyOf[b];
+    });
+
+    ids = std::move(order);
+    keys.clear();
+    prefix.assign(1, NodeSet());
+    for (uint16_t id : ids) {
+        keys.push_back(keyOf[id]);
+        NodeSet next = prefix.back();
+        next.set(id);
+        prefix.push_back(next);
+    }
+}
+
+const SkillTreeIndex::NodeSet& SkillTreeIndex::SortedView::atMost(int32_t limit) const {
+    size_t end = std::upper_bound(keys.begin(), keys.end(), limit) - keys.begin();
+    return prefix[end];
+}
+
+SkillTreeIndex::BuildResult SkillTreeIndex::build(const SkillNodeSpec* nodes, int count,
+                                                  const int32_t* prerequisiteOffsets,
+                                                  const int32_t* prerequisiteIds) {
+    *this = SkillTreeIndex();
+    if (count < 0 || count > kMaxNodes) return BuildResult::TooManyNodes;
+
+    m_nodes.assign(nodes, nodes + count);
+    m_prerequisites.assign(count, NodeSet());
+    for (int id = 0; id < count; ++id) {
+        const SkillNodeSpec& node = m_nodes[id];
+        if (node.level < 0 || node.cost < 0 || node.tier >= kTierCount ||
+            node.pointKind >= PointKind::Count) {
+            *this = SkillTreeIndex();
+            return BuildResult::BadNode;
+        }
+
+        for (int32_t p = prerequisiteOffsets[id]; p < prerequisiteOffsets[id + 1]; ++p) {
+            int32_t prerequisite = prerequisiteIds[p];
+            if (prerequisite == -1) {
+                m_unobtainable.set(id);
+            } else if (prerequisite < 0 || prerequisite >= count || prerequisite == id) {
+                *this = SkillTreeIndex();
+                return BuildResult::BadPrerequisite;
+            } else {
+                m_prerequisites[id].set(prerequisite);
+            }
+        }
+        if (m_prerequisites[id].any()) m_withPrerequisites.set(id);
+
+        m_all.set(id);
+        m_tierSets[node.tier].set(id);
+        m_kindSets[static_cast<int>(node.pointKind)].set(id);
+    }
+    m_count = count;
+
+    if (!computeClosures()) {
+        *this = SkillTreeIndex();
+        return BuildResult::Cycle;
+    }
+
+    std::vector<uint16_t> all;
+    std::vector<uint16_t> byKind[kPointKinds];
+    std::vector<int32_t> levels(count);
+    std::vector<int32_t> costs(count);
+    for (int id = 0; id < count; ++id) {
+        all.push_back(static_cast<uint16_t>(id));
+        byKind[static_cast<int>(m_nodes[id].pointKind)].push_back(static_cast<uint16_t>(id));
+        levels[id] = m_nodes[id].level;
+        costs[id] = m_nodes[id].cost;
+    }
+    m_byLevel.build(all, levels);
+    for (int kind = 0; kind < kPointKinds; ++kind) {
+        m_byCost[kind].build(byKind[kind], costs);
+    }
+
+    // Tier order: by tier, then level, then id
+    m_byTier = m_byLevel.ids;
+    std::stable_sort(m_byTier.begin(), m_byTier.end(), [this](uint16_t a, uint16_t b) {
+        return m_nodes[a].tier < m_nodes[b].tier;
+    });
+    for (int tier = 0, position = 0; tier <= kTierCount; ++tier) {
+        while (position < count && m_nodes[m_byTier[position]].tier < tier) ++position;
+        m_tierStart[tier] = position;
+    }
+    m_tierStart[kTierCount] = count;
+
+    return BuildResult::Ok;
+}
+
+bool SkillTreeIndex::computeClosures() {
+    // Depth-first from every node; a node reached again while still on the
+    // stack closes a cycle
+    enum : uint8_t { Unvisited, Visiting, Done };
+    std::vector<uint8_t> state(m_count, Unvisited);
+    std::vector<int> stack;
+    m_closure.assign(m_count, NodeSet());
+
+    for (int root = 0; root < m_count; ++root) {
+        if (state[root] != Unvisited) continue;
+        stack.push_back(root);
+
+        while (!stack.empty()) {
+            int id = stack.back();
+            if (state[id] == Unvisited) {
+                state[id] = Visiting;
+                bool cycle = false;
+                m_prerequisites[id].forEach([&](int prerequisite) {
+                    if (state[prerequisite] == Visiting) cycle = true;
+                    else if (state[prerequisite] == Unvisited) stack.push_back(prerequisite);
+                });
+                if (cycle) return false;
+                continue;
+            }
+
+            stack.pop_back();
+            if (state[id] == Done) continue;
+
+            // Every prerequisite is done by now
+            NodeSet closure = m_prerequisites[id];
+            m_prerequisites[id].forEach([&](int prerequisite) {
+                closure |= m_closure[prerequisite];
+            });
+            m_closure[id] = closure;
+            state[id] = Done;
+        }
+    }
+    return true;
+}
+
+SkillTreeIndex::NodeSet SkillTreeIndex::missingFor(int id, const NodeSet& unlocked) const {
+    NodeSet missing = m_closure[id];
+    return missing.subtract(unlocked);
+}
+
+SkillTreeIndex::NodeRange SkillTreeIndex::nodesAtLevel(int level) const {
+    auto range = std::equal_range(m_byLevel.keys.begin(), m_byLevel.keys.end(), level);
+    NodeRange result;
+    result.ids = m_byLevel.ids.data() + (range.first - m_byLevel.keys.begin());
+    result.count = static_cast<int>(range.second - range.first);
+    return result;
+}
+
+SkillTreeIndex::NodeRange SkillTreeIndex::nodesInTier(int tier) const {
+    NodeRange result;
+    if (tier < 0 || tier >= kTierCount) return result;
+
+    result.ids = m_byTier.data() + m_tierStart[tier];
+    result.count = m_tierStart[tier + 1] - m_tierStart[tier];
+    return result;
+}
+
+SkillTreeIndex::NodeSet SkillTreeIndex::upToLevel(int level) const {
+    if (m_count == 0) return NodeSet();
+    return m_byLevel.atMost(level);
+}
+
+SkillTreeIndex::NodeSet SkillTreeIndex::affordable(int skillPoints, int abilityPoints) const {
+    if (m_count == 0) return NodeSet();
+    return m_byCost[static_cast<int>(PointKind::Skill)].atMost(skillPoints) |
+           m_byCost[static_cast<int>(PointKind::Ability)].atMost(abilityPoints);
+}
+
+SkillTreeIndex::NodeSet SkillTreeIndex::prerequisitesMet(const NodeSet& unlocked) const {
+    // Nodes without prerequisites need no checking
+    NodeSet met = m_all;
+    met.subtract(m_withPrerequisites);
+    m_withPrerequisites.forEach([&](int id) {
+        if (m_prerequisites[id].isSubsetOf(unlocked)) met.set(id);
+    });
+    return met.subtract(m_unobtainable);
+}
+
+SkillTreeIndex::NodeSet SkillTreeIndex::eligible(int level, int skillPoints, int abilityPoints,
+                                                 const NodeSet& unlocked) const {
+    NodeSet result = upToLevel(level);
+    result &= affordable(skillPoints, abilityPoints);
+    result.subtract(unlocked);
+    return result & prerequisitesMet(unlocked);
+}
+
+bool SkillTreeIndex::canUnlock(int id, int level, int skillPoints, int abilityPoints,
+                               const NodeSet& unlocked) const {
+    if (id < 0 || id >= m_count || unlocked.test(id) || m_unobtainable.test(id)) return false;
+
+    const SkillNodeSpec& node = m_nodes[id];
+    if (level < node.level) return false;
+    if (!m_prerequisites[id].isSubsetOf(unlocked)) return false;
+
+    switch (node.pointKind) {
+        case PointKind::Skill: return skillPoints >= node.cost;
+        case PointKind::Ability: return abilityPoints >= node.cost;
+        default: return false;
+    }
+}
+
+} // namespace TrashPiles
@@ -0,0 +1,123 @@
+#ifndef TRASHPILES_SKILL_TREE_INDEX_H
+#define TRASHPILES_SKILL_TREE_INDEX_H
+
+#include "bit_set.h"
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+// PointType ordinals in SkillAbilitySystemUpdated.kt
+enum class PointKind : uint8_t {
+    Skill = 0,
+    Ability,
+    Invalid,
+    Count
+};
+
+// One skill or ability as the index needs it; ids are positions in the
+// array handed to build()
+struct SkillNodeSpec {
+    int32_t level = 1;
+    int32_t cost = 0;
+    uint8_t tier = 0;                   // Tier ordinal
+    PointKind pointKind = PointKind::Skill;
+};
+
+/**
+ * Compiled skill tree
+ * Nodes have dense ids. Each node's direct prerequisites and the full
+ * closure of everything beneath it are bitsets, and nodes are presorted by
+ * level, by tier and by cost, with a running set at every position. So
+ * "up to level L", "affordable with these points" and "prerequisites met"
+ * are each a lookup plus a few word-wide ANDs, and the eligible set for a
+ * player is their intersection. Immutable after build(); any thread may
+ * query.
+ */
+class SkillTreeIndex {
+public:
+    static constexpr int kMaxNodes = 256;
+    static constexpr int kTierCount = 7;
+    static constexpr int kPointKinds = static_cast<int>(PointKind::Count);
+
+    using NodeSet = BitSet<kMaxNodes>;
+
+    enum class BuildResult {
+        Ok = 0,
+        TooManyNodes,
+        BadNode,                // Negative cost or level, or tier or point kind out of range
+        BadPrerequisite,        // Prerequisite id out of range or the node itself
+        Cycle
+    };
+
+    struct NodeRange {
+        const uint16_t* ids = nullptr;
+        int count = 0;
+    };
+
+    // Node id's prerequisites are prerequisiteIds[prerequisiteOffsets[id] ..
+    // prerequisiteOffsets[id + 1]); the offsets array has count + 1 entries.
+    // A prerequisite id of -1 names a node outside the catalog, which no
+    // unlocked set can contain.
+    BuildResult build(const SkillNodeSpec* nodes, int count,
+                      const int32_t* prerequisiteOffsets, const int32_t* prerequisiteIds);
+
+    int nodeCount() const { return m_count; }
+    const SkillNodeSpec& node(int id) const { return m_nodes[id]; }
+    const NodeSet& allNodes() const { return m_all; }
+
+    const NodeSet& prerequisites(int id) const { return m_prerequisites[id]; }
+    // Every node that must be unlocked before id, however indirectly
+    const NodeSet& requirementClosure(int id) const { return m_closure[id]; }
+    // What is still missing below id
+    NodeSet missingFor(int id, const NodeSet& unlocked) const;
+
+    // Presorted views; ranges stay valid while the index lives
+    NodeRange nodesAtLevel(int level) const;
+    NodeRange nodesInTier(int tier) const;
+    const NodeSet& tierSet(int tier) const { return m_tierSets[tier]; }
+    const NodeSet& pointKindSet(PointKind kind) const { return m_kindSets[static_cast<int>(kind)]; }
+
+    NodeSet upToLevel(int level) const;
+    // Invalid nodes are never affordable
+    NodeSet affordable(int skillPoints, int abilityPoints) const;
+    NodeSet prerequisitesMet(const NodeSet& unlocked) const;
+
+    // TreeNode.canUnlock for every node at once: not unlocked, level
+    // reached, prerequisites unlocked and enough points of the node's kind
+    NodeSet eligible(int level, int skillPoints, int abilityPoints, const NodeSet& unlocked) const;
+    bool canUnlock(int id, int level, int skillPoints, int abilityPoints, const NodeSet& unlocked) const;
+
+private:
+    // Nodes in key order with the set of the first k at position k
+    struct SortedView {
+        std::vector<uint16_t> ids;
+        std::vector<int32_t> keys;
+        std::vector<NodeSet> prefix;
+
+        void build(std::vector<uint16_t> order, const std::vector<int32_t>& keyOf);
+        // Nodes whose key is at most limit
+        const NodeSet& atMost(int32_t limit) const;
+    };
+
+    int m_count = 0;
+    std::vector<SkillNodeSpec> m_nodes;
+    std::vector<NodeSet> m_prerequisites;
+    std::vector<NodeSet> m_closure;
+    NodeSet m_all;
+    NodeSet m_withPrerequisites;
+    NodeSet m_unobtainable;         // A prerequisite outside the catalog
+
+    SortedView m_byLevel;
+    SortedView m_byCost[kPointKinds];
+    std::vector<uint16_t> m_byTier;
+    int m_tierStart[kTierCount + 1] = {};
+    NodeSet m_tierSets[kTierCount];
+    NodeSet m_kindSets[kPointKinds];
+
+    bool computeClosures();
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_SKILL_TREE_INDEX_H
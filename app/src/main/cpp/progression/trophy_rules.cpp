@@ -0,0 +1,152 @@
+#include "trophy_rules.h"
+#include <algorithm>
+
+namespace TrashPiles {
+
+TrophyRules::BuildResult TrophyRules::build(int count, const int32_t* thresholds,
+                                            const int32_t* requirementOffsets,
+                                            const int32_t* requirementKeys) {
+    *this = TrophyRules();
+    if (count < 0 || count > kMaxTrophies) return BuildResult::TooManyTrophies;
+
+    m_thresholds.assign(thresholds, thresholds + count * kFieldCount);
+    m_requirements.assign(count, RequirementSet());
+    m_predicates.assign(count, 0);
+
+    std::vector<int32_t> keyUses(kMaxRequirements, 0);
+    for (int id = 0; id < count; ++id) {
+        for (int32_t r = requirementOffsets[id]; r < requirementOffsets[id + 1]; ++r) {
+            int32_t key = requirementKeys[r];
+            if (key < 0 || key >= kMaxRequirements) {
+                *this = TrophyRules();
+                return BuildResult::BadRequirement;
+            }
+            m_requirements[id].set(key);
+        }
+
+        // Repeated keys count once
+        m_requirements[id].forEach([&keyUses](int key) { ++keyUses[key]; });
+        int predicates = m_requirements[id].count();
+        for (int field = 0; field < kFieldCount; ++field) {
+            if (m_thresholds[id * kFieldCount + field] != kNoThreshold) ++predicates;
+        }
+        m_predicates[id] = static_cast<uint16_t>(predicates);
+    }
+    m_count = count;
+
+    for (int field = 0; field < kFieldCount; ++field) {
+        std::vector<uint16_t> order;
+        for (int id = 0; id < count; ++id) {
+            if (m_thresholds[id * kFieldCount + field] != kNoThreshold) order.push_back(static_cast<uint16_t>(id));
+        }
+        std::stable_sort(order.begin(), order.end(), [this, field](uint16_t a, uint16_t b) {
+            return m_thresholds[a * kFieldCount + field] < m_thresholds[b * kFieldCount + field];
+        });
+
+        ThresholdList& list = m_byField[field];
+        list.trophies = order;
+        for (uint16_t id : order) {
+            list.thresholds.push_back(m_thresholds[id * kFieldCount + field]);
+        }
+    }
+
+    // Inverted index from key to the trophies requiring it
+    m_keyStart.assign(kMaxRequirements + 1, 0);
+    for (int key = 0; key < kMaxRequirements; ++key) {
+        m_keyStart[key + 1] = m_keyStart[key] + keyUses[key];
+    }
+    m_keyTrophies.resize(m_keyStart[kMaxRequirements]);
+    std::vector<int32_t> next(m_keyStart.begin(), m_keyStart.end() - 1);
+    for (int id = 0; id < count; ++id) {
+        m_requirements[id].forEach([&](int key) {
+            m_keyTrophies[next[key]++] = static_cast<uint16_t>(id);
+        });
+    }
+
+    return BuildResult::Ok;
+}
+
+bool TrophyRules::meets(int id, const int32_t* fields, const RequirementSet& unlocked) const {
+    for (int field = 0; field < kFieldCount; ++field) {
+        if (fields[field] < m_thresholds[id * kFieldCount + field]) return false;
+    }
+    return m_requirements[id].isSubsetOf(unlocked);
+}
+
+TrophyTracker::TrophyTracker(const TrophyRules& rules)
+    : m_rules(rules), m_unmet(rules.trophyCount(), 0) {
+}
+
+void TrophyTracker::evaluateAll(const int32_t* fields, const RequirementSet& unlocked) {
+    m_satisfied.clear();
+    for (int id = 0; id < m_rules.m_count; ++id) {
+        int unmet = 0;
+        for (int field = 0; field < TrophyRules::kFieldCount; ++field) {
+            if (fields[field] < m_rules.m_thresholds[id * TrophyRules::kFieldCount + field]) ++unmet;
+        }
+        RequirementSet missing = m_rules.m_requirements[id];
+        unmet += missing.subtract(unlocked).count();
+
+        m_unmet[id] = static_cast<uint16_t>(unmet);
+        if (unmet == 0) m_satisfied.set(id);
+    }
+    m_lastAdjusted = m_rules.m_count;
+}
+
+TrophyTracker::TrophySet TrophyTracker::update(const int32_t* fields, const RequirementSet& unlocked) {
+    TrophySet before = m_satisfied;
+    if (!m_started) {
+        m_started = true;
+        evaluateAll(fields, unlocked);
+    } else {
+        TrophySet touched;
+        m_lastAdjusted = 0;
+
+        for (int field = 0; field < TrophyRules::kFieldCount; ++field) {
+            int32_t from = m_fields[field];
+            int32_t to = fields[field];
+            if (from == to) continue;
+
+            // "value >= t" flips exactly for thresholds in (low, high]
+            const TrophyRules::ThresholdList& list = m_rules.m_byField[field];
+            int32_t low = std::min(from, to);
+            int32_t high = std::max(from, to);
+            size_t begin = std::upper_bound(list.thresholds.begin(), list.thresholds.end(), low) -
+                           list.thresholds.begin();
+            size_t end = std::upper_bound(list.thresholds.begin() + begin, list.thresholds.end(), high) -
+                         list.thresholds.begin();
+            for (size_t i = begin; i < end; ++i) {
+                uint16_t id = list.trophies[i];
+                if (to > from) --m_unmet[id];
+                else ++m_unmet[id];
+                touched.set(id);
+            }
+            m_lastAdjusted += static_cast<int>(end - begin);
+        }
+
+        RequirementSet flipped = m_unlocked ^ unlocked;
+        flipped.forEach([&](int key) {
+            bool nowUnlocked = unlocked.test(key);
+            for (int32_t i = m_rules.m_keyStart[key]; i < m_rules.m_keyStart[key + 1]; ++i) {
+                uint16_t id = m_rules.m_keyTrophies[i];
+                if (nowUnlocked) --m_unmet[id];
+                else ++m_unmet[id];
+                touched.set(id);
+                ++m_lastAdjusted;
+            }
+        });
+
+        touched.forEach([this](int id) {
+            if (m_unmet[id] == 0) m_satisfied.set(id);
+            else m_satisfied.reset(id);
+        });
+    }
+
+    std::copy(fields, fields + TrophyRules::kFieldCount, m_fields);
+    m_unlocked = unlocked;
+
+    TrophySet newlySatisfied = m_satisfied;
+    return newlySatisfied.subtract(before);
+}
+
+} // namespace TrashPiles
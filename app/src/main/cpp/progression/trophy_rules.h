@@ -0,0 +1,125 @@
+#ifndef TRASHPILES_TROPHY_RULES_H
+#define TRASHPILES_TROPHY_RULES_H
+
+#include "bit_set.h"
+#include <cstdint>
+#include <vector>
+
+namespace TrashPiles {
+
+// Numeric PlayerProgress fields a TrophyPrerequisite can put a minimum on
+enum class ProgressField : uint8_t {
+    Level = 0,
+    TotalPoints,        // SP + AP
+    SkillPoints,
+    AbilityPoints,
+    AbilitiesUnlocked,
+    SkillsUnlocked,
+    Count
+};
+
+/**
+ * Compiled trophy prerequisites
+ * Each TrophyPrerequisite becomes up to one "field >= threshold" predicate
+ * per ProgressField plus a set of required unlocks. Required skills and
+ * abilities are interned by the caller into dense requirement keys, so the
+ * unlock check is a bitset subset test. Thresholds are presorted per field
+ * and keys carry the list of trophies that need them, which is what lets
+ * TrophyTracker touch only the trophies a change can affect. Immutable
+ * after build(); any thread may share it.
+ */
+class TrophyRules {
+public:
+    static constexpr int kMaxTrophies = 256;
+    static constexpr int kMaxRequirements = 256;
+    static constexpr int kFieldCount = static_cast<int>(ProgressField::Count);
+    // Threshold for a field the prerequisite leaves out (a null in Kotlin)
+    static constexpr int32_t kNoThreshold = INT32_MIN;
+
+    using TrophySet = BitSet<kMaxTrophies>;
+    using RequirementSet = BitSet<kMaxRequirements>;
+
+    enum class BuildResult {
+        Ok = 0,
+        TooManyTrophies,
+        BadRequirement          // Key out of range
+    };
+
+    // Trophy id's thresholds are thresholds[id * kFieldCount + field]; its
+    // required keys are requirementKeys[requirementOffsets[id] ..
+    // requirementOffsets[id + 1]).
+    BuildResult build(int count, const int32_t* thresholds,
+                      const int32_t* requirementOffsets, const int32_t* requirementKeys);
+
+    int trophyCount() const { return m_count; }
+    int32_t threshold(int id, ProgressField field) const {
+        return m_thresholds[id * kFieldCount + static_cast<int>(field)];
+    }
+    const RequirementSet& requirements(int id) const { return m_requirements[id]; }
+    // Predicates trophy id has in all; it is satisfied when none are unmet
+    int predicateCount(int id) const { return m_predicates[id]; }
+
+    // TrophyPrerequisite.meetsRequirements for one trophy, from scratch
+    bool meets(int id, const int32_t* fields, const RequirementSet& unlocked) const;
+
+private:
+    friend class TrophyTracker;
+
+    // Trophies with a threshold on one field, ascending by threshold
+    struct ThresholdList {
+        std::vector<int32_t> thresholds;
+        std::vector<uint16_t> trophies;
+    };
+
+    int m_count = 0;
+    std::vector<int32_t> m_thresholds;
+    std::vector<RequirementSet> m_requirements;
+    std::vector<uint16_t> m_predicates;
+    ThresholdList m_byField[kFieldCount];
+    // Trophies needing key k are m_keyTrophies[m_keyStart[k] .. m_keyStart[k + 1])
+    std::vector<int32_t> m_keyStart;
+    std::vector<uint16_t> m_keyTrophies;
+};
+
+/**
+ * One player's standing against a TrophyRules catalog
+ * Keeps the last progress seen and, per trophy, how many predicates are
+ * still unmet. update() diffs the new progress against the last: a field
+ * that moved only visits the thresholds it crossed, and a key that flipped
+ * only visits the trophies requiring it, so the work follows what changed
+ * rather than the catalog size. The first update evaluates everything.
+ * Not thread-safe; one tracker per player.
+ */
+class TrophyTracker {
+public:
+    using TrophySet = TrophyRules::TrophySet;
+    using RequirementSet = TrophyRules::RequirementSet;
+
+    explicit TrophyTracker(const TrophyRules& rules);
+
+    // Takes the player's new progress (fields indexed by ProgressField) and
+    // returns the trophies it newly satisfies
+    TrophySet update(const int32_t* fields, const RequirementSet& unlocked);
+
+    // Every trophy the last progress satisfies
+    const TrophySet& satisfied() const { return m_satisfied; }
+    int unmetCount(int id) const { return m_unmet[id]; }
+
+    // Predicates re-checked by the last update
+    int lastAdjusted() const { return m_lastAdjusted; }
+
+private:
+    const TrophyRules& m_rules;
+    bool m_started = false;
+    int32_t m_fields[TrophyRules::kFieldCount] = {};
+    RequirementSet m_unlocked;
+    std::vector<uint16_t> m_unmet;
+    TrophySet m_satisfied;
+    int m_lastAdjusted = 0;
+
+    void evaluateAll(const int32_t* fields, const RequirementSet& unlocked);
+};
+
+} // namespace TrashPiles
+
+#endif // TRASHPILES_TROPHY_RULES_H
@@ -1,4 +1,7 @@
 #include "renderer_wrapper.h"
+#include "../gcms/state_block.h"
+#include "../trace/trace.h"
+#include "../game_engine/alloc_tracker.h"
 #include <skia/core/SkCanvas.h>
 #include <skia/core/SkPaint.h>
 #include <skia/core/SkBitmap.h>
@@ -7,35 +10,31 @@
 #include <skia/core/SkFont.h>
 #include <skia/core/SkTextBlob.h>
 #include <skia/core/SkMatrix.h>
-#include <skia/core/SkPath.h>
 #include <skia/effects/SkGradientShader.h>
 #include <android/asset_manager.h>
 #include <android/asset_manager_jni.h>
+#include <chrono>
+#include <cmath>
 #include <memory>
-#include <map>
 
 namespace TrashPiles {
 
-// Card animation state
-struct CardState {
-    float rotation = 0.0f;
-    float scaleX = 1.0f;
-    float scaleY = 1.0f;
-    float alpha = 1.0f;
-    float x = 0.0f;
-    float y = 0.0f;
-};
+// A card turns over in this long after its flip event
+static constexpr int64_t kFlipNanos = 250000000;
 
 // Static instance for asset manager access
 static AAssetManager* g_assetManager = nullptr;
 
 RendererWrapper::RendererWrapper() 
-    : m_width(0), m_height(0), m_initialized(false) {
+    : m_width(0), m_height(0), m_initialized(false),
+      m_buttonShaderHeight(0.0f),
+      m_eventBus(nullptr), m_eventSubscriber(nullptr), m_activePlayer(-1), m_frameNanos(0) {
     LOGI("RendererWrapper created");
 }
 
 RendererWrapper::~RendererWrapper() {
     cleanup();
+    attachEventBus(nullptr);
     LOGI("RendererWrapper destroyed");
 }
 
@@ -77,6 +76,25 @@ bool RendererWrapper::initialize(int width, int height) {
     m_cardBackPaint.setStyle(SkPaint::kFill_Style);
     m_cardBackPaint.setColor(SK_ColorBLUE);
     
+    // Per-draw paints are set up once here and only recolored or resized
+    // while drawing, so a steady frame makes no heap allocations of its own
+    m_buttonPaint.setAntiAlias(true);
+    m_buttonPaint.setStyle(SkPaint::kFill_Style);
+    
+    m_buttonBorderPaint.setAntiAlias(true);
+    m_buttonBorderPaint.setStyle(SkPaint::kStroke_Style);
+    m_buttonBorderPaint.setColor(SK_ColorDKGRAY);
+    m_buttonBorderPaint.setStrokeWidth(2.0f);
+    
+    m_patternPaint.setAntiAlias(true);
+    m_patternPaint.setColor(SK_ColorWHITE);
+    m_patternPaint.setStrokeWidth(1.5f);
+    
+    m_turnPaint.setAntiAlias(true);
+    m_turnPaint.setStyle(SkPaint::kStroke_Style);
+    m_turnPaint.setColor(SK_ColorYELLOW);
+    m_turnPaint.setStrokeWidth(4.0f);
+    
     m_initialized = true;
     LOGI("Renderer initialized successfully");
     return true;
@@ -88,7 +106,9 @@ void RendererWrapper::cleanup() {
     LOGI("Cleaning up renderer");
     
     m_surface.reset();
-    m_cardStates.clear();
+    m_buttonShader.reset();
+    m_buttonShaderHeight = 0.0f;
+    resetCardStates();
     
     m_initialized = false;
 }
@@ -96,6 +116,18 @@ void RendererWrapper::cleanup() {
 void RendererWrapper::beginFrame() {
     if (!m_initialized || !m_surface) return;
     
+    TRACE_THREAD_NAME("render");
+    TRACE_BEGIN("frame");
+    
+    // Closes the previous frame's allocation count and scratch memory
+    AllocTracker::markFrame();
+    m_frameArena.reset();
+    
+    AllocScope allocScope(AllocSubsystem::Renderer);
+    m_frameNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+    drainEvents();
+    
     m_canvas = m_surface->getCanvas();
     if (m_canvas) {
         m_canvas->save();
@@ -108,6 +140,7 @@ void RendererWrapper::endFrame() {
     m_canvas->restore();
     m_surface->flush();
     m_canvas = nullptr;
+    TRACE_END("frame");
 }
 
 void RendererWrapper::clear(float r, float g, float b, float a) {
@@ -127,15 +160,28 @@ void RendererWrapper::renderCard(int cardId, float x, float y, float width, floa
     if (!m_canvas) return;
     
     // Get card animation state
-    CardState& state = m_cardStates[cardId];
+    CardState& state = cardState(cardId);
     state.x = x;
     state.y = y;
     
+    // A card the bus has seen shows the bus's face; a fresh flip narrows
+    // the card to its edge on the old face and opens it on the new one
+    float flipScale = 1.0f;
+    if (state.faceKnown) {
+        faceUp = state.faceUp;
+        int64_t age = m_frameNanos - state.eventNanos;
+        if (state.flipFrom != state.faceUp && age >= 0 && age < kFlipNanos) {
+            float t = static_cast<float>(age) / kFlipNanos;
+            flipScale = std::fabs(std::cos(t * static_cast<float>(M_PI)));
+            if (t < 0.5f) faceUp = state.flipFrom;
+        }
+    }
+    
     // Apply transformations
     SkMatrix matrix;
     matrix.setTranslate(x + width/2, y + height/2);
     matrix.preRotate(state.rotation);
-    matrix.preScale(state.scaleX, state.scaleY);
+    matrix.preScale(state.scaleX * flipScale, state.scaleY);
     matrix.preTranslate(-width/2, -height/2);
     
     SkAutoCanvasRestore autoRestore(m_canvas, true);
@@ -174,67 +220,162 @@ void RendererWrapper::renderCardBack(float x, float y, float width, float height
 void RendererWrapper::renderButton(const char* buttonId, float x, float y, float width, float height) {
     if (!m_canvas) return;
     
-    SkRect rect = SkRect::MakeXYWH(x, y, width, height);
+    // Drawn at the origin so one gradient serves every button of this height
+    SkRect rect = SkRect::MakeWH(width, height);
     
     // Button gradient effect
-    SkColor colors[] = {SK_ColorLTGRAY, SK_ColorGRAY};
-    SkPoint points[] = {{0, y}, {0, y + height}};
-    auto shader = SkGradientShader::MakeLinear(points, colors, nullptr, 2, SkTileMode::kClamp);
-    
-    SkPaint buttonPaint;
-    buttonPaint.setAntiAlias(true);
-    buttonPaint.setStyle(SkPaint::kFill_Style);
-    buttonPaint.setShader(std::move(shader));
+    if (!m_buttonShader || m_buttonShaderHeight != height) {
+        SkColor colors[] = {SK_ColorLTGRAY, SK_ColorGRAY};
+        SkPoint points[] = {{0, 0}, {0, height}};
+        m_buttonShader = SkGradientShader::MakeLinear(points, colors, nullptr, 2, SkTileMode::kClamp);
+        m_buttonShaderHeight = height;
+        m_buttonPaint.setShader(m_buttonShader);
+    }
     
     // Draw button
     SkAutoCanvasRestore autoRestore(m_canvas, true);
-    m_canvas->drawRoundRect(rect, 8.0f, 8.0f, buttonPaint);
+    m_canvas->translate(x, y);
+    m_canvas->drawRoundRect(rect, 8.0f, 8.0f, m_buttonPaint);
     
     // Draw border
-    SkPaint borderPaint;
-    borderPaint.setAntiAlias(true);
-    borderPaint.setStyle(SkPaint::kStroke_Style);
-    borderPaint.setColor(SK_ColorDKGRAY);
-    borderPaint.setStrokeWidth(2.0f);
-    m_canvas->drawRoundRect(rect, 8.0f, 8.0f, borderPaint);
+    m_canvas->drawRoundRect(rect, 8.0f, 8.0f, m_buttonBorderPaint);
     
     // Draw text
     if (buttonId && strlen(buttonId) > 0) {
-        SkPaint textPaint;
-        textPaint.setAntiAlias(true);
-        textPaint.setColor(SK_ColorBLACK);
-        textPaint.setTextSize(16.0f);
-        textPaint.setTextAlign(SkTextAlign::kCenter);
+        m_textPaint.setColor(SK_ColorBLACK);
+        m_textPaint.setTextSize(16.0f);
+        m_textPaint.setTextAlign(SkTextAlign::kCenter);
         
-        SkFont font(nullptr, 16.0f);
+        m_font.setSize(16.0f);
         m_canvas->drawSimpleText(buttonId, strlen(buttonId), SkTextEncoding::kUTF8, 
-                               x + width/2, y + height/2 + 8, font, textPaint);
+                               width/2, height/2 + 8, m_font, m_textPaint);
     }
 }
 
 void RendererWrapper::renderText(const char* text, float x, float y, float size) {
     if (!m_canvas || !text) return;
     
-    SkPaint textPaint;
-    textPaint.setAntiAlias(true);
-    textPaint.setColor(SK_ColorBLACK);
-    textPaint.setTextSize(size);
+    m_textPaint.setColor(SK_ColorBLACK);
+    m_textPaint.setTextSize(size);
+    m_textPaint.setTextAlign(SkTextAlign::kLeft);
     
-    SkFont font(nullptr, size);
-    m_canvas->drawSimpleText(text, strlen(text), SkTextEncoding::kUTF8, x, y, font, textPaint);
+    m_font.setSize(size);
+    m_canvas->drawSimpleText(text, strlen(text), SkTextEncoding::kUTF8, x, y, m_font, m_textPaint);
+}
+
+void RendererWrapper::renderTurnIndicator(int playerId, float x, float y, float width, float height) {
+    if (!m_canvas || playerId < 0 || playerId != m_activePlayer) return;
+    
+    SkRect rect = SkRect::MakeXYWH(x, y, width, height);
+    m_canvas->drawRoundRect(rect, 8.0f, 8.0f, m_turnPaint);
 }
 
 void RendererWrapper::setCardRotation(int cardId, float angle) {
-    m_cardStates[cardId].rotation = angle;
+    cardState(cardId).rotation = angle;
 }
 
 void RendererWrapper::setCardScale(int cardId, float scaleX, float scaleY) {
-    m_cardStates[cardId].scaleX = scaleX;
-    m_cardStates[cardId].scaleY = scaleY;
+    CardState& state = cardState(cardId);
+    state.scaleX = scaleX;
+    state.scaleY = scaleY;
 }
 
 void RendererWrapper::setCardAlpha(int cardId, float alpha) {
-    m_cardStates[cardId].alpha = alpha;
+    cardState(cardId).alpha = alpha;
+}
+
+CardState& RendererWrapper::cardState(int cardId) {
+    if (cardId < 0 || cardId >= kCardCount) {
+        m_scratchCardState = CardState();
+        return m_scratchCardState;
+    }
+    return m_cardStates[cardId];
+}
+
+void RendererWrapper::resetCardStates() {
+    for (CardState& state : m_cardStates) {
+        state = CardState();
+    }
+}
+
+void RendererWrapper::attachEventBus(EventBus* bus) {
+    if (m_eventBus) {
+        m_eventBus->unsubscribe(m_eventSubscriber);
+        m_eventSubscriber = nullptr;
+    }
+    
+    m_eventBus = bus;
+    if (!bus) return;
+    
+    uint32_t mask = gameEventBit(GameEventType::GameStarted) |
+                    gameEventBit(GameEventType::TurnStarted) |
+                    gameEventBit(GameEventType::CardDealt) |
+                    gameEventBit(GameEventType::CardDrawn) |
+                    gameEventBit(GameEventType::CardPlaced) |
+                    gameEventBit(GameEventType::CardFlipped) |
+                    gameEventBit(GameEventType::CardDiscarded);
+    m_eventSubscriber = bus->subscribe("renderer", mask);
+    if (!m_eventSubscriber) {
+        LOGE("No free event bus subscriber slot for renderer");
+    }
+}
+
+void RendererWrapper::drainEvents() {
+    if (!m_eventSubscriber) return;
+    
+    GameEvent event;
+    while (m_eventBus->poll(m_eventSubscriber, event)) {
+        applyEvent(event);
+    }
+}
+
+// State block card code (suits spades, hearts, clubs, diamonds) to the
+// renderer's card id (suit * 13 + value, suits spades, hearts, diamonds, clubs)
+static int rendererCardId(int cardCode) {
+    static const int kSuitOrder[4] = {0, 1, 3, 2};
+    int index = cardCode & (kCardFaceUp - 1);
+    return kSuitOrder[index % 4] * 13 + index / 4;
+}
+
+void RendererWrapper::applyEvent(const GameEvent& event) {
+    switch (event.type) {
+        case GameEventType::GameStarted:
+            resetCardStates();
+            m_activePlayer = -1;
+            return;
+        case GameEventType::TurnStarted:
+            m_activePlayer = event.playerId;
+            return;
+        default:
+            break;
+    }
+    
+    if (event.card < 0) return;
+    CardState& state = cardState(rendererCardId(event.card));
+    state.eventNanos = event.timeNanos;
+    switch (event.type) {
+        case GameEventType::CardDealt:
+            // Dealt cards appear as they land, without turning over
+            state.faceUp = (event.card & kCardFaceUp) != 0;
+            state.flipFrom = state.faceUp;
+            state.faceKnown = true;
+            break;
+        case GameEventType::CardPlaced:
+        case GameEventType::CardFlipped:
+        case GameEventType::CardDiscarded: {
+            bool faceUp = event.type == GameEventType::CardFlipped   ? event.value != 0
+                          : event.type == GameEventType::CardPlaced  ? (event.card & kCardFaceUp) != 0
+                                                                     : true;
+            state.flipFrom = state.faceKnown ? state.faceUp : faceUp;
+            state.faceUp = faceUp;
+            state.faceKnown = true;
+            break;
+        }
+        default:
+            // In a hand: who may see it is the caller's call
+            state.faceKnown = false;
+            break;
+    }
 }
 
 void RendererWrapper::drawCardValue(int cardId, float x, float y, float width, float height) {
@@ -247,45 +388,35 @@ void RendererWrapper::drawCardValue(int cardId, float x, float y, float width, f
     // Set color based on suit
     SkColor textColor = (suit == 1 || suit == 2) ? SK_ColorRED : SK_ColorBLACK;
     
-    SkPaint textPaint;
-    textPaint.setAntiAlias(true);
-    textPaint.setColor(textColor);
-    textPaint.setTextSize(height * 0.3f);
-    textPaint.setTextAlign(SkTextAlign::kCenter);
+    m_textPaint.setColor(textColor);
+    m_textPaint.setTextSize(height * 0.3f);
+    m_textPaint.setTextAlign(SkTextAlign::kCenter);
     
     // Draw value
     const char* valueText = getCardValueText(value);
-    SkFont font(nullptr, height * 0.3f);
+    m_font.setSize(height * 0.3f);
     m_canvas->drawSimpleText(valueText, strlen(valueText), SkTextEncoding::kUTF8, 
-                           x + width/2, y + height * 0.35f, font, textPaint);
+                           x + width/2, y + height * 0.35f, m_font, m_textPaint);
     
     // Draw suit symbol
     const char* suitText = getSuitSymbol(suit);
     m_canvas->drawSimpleText(suitText, strlen(suitText), SkTextEncoding::kUTF8, 
-                           x + width/2, y + height * 0.65f, font, textPaint);
+                           x + width/2, y + height * 0.65f, m_font, m_textPaint);
 }
 
 void RendererWrapper::drawCardBackPattern(float x, float y, float width, float height) {
     if (!m_canvas) return;
     
-    SkPaint patternPaint;
-    patternPaint.setAntiAlias(true);
-    patternPaint.setColor(SK_ColorWHITE);
-    patternPaint.setStrokeWidth(1.5f);
-    
-    // Draw diamond pattern
+    // Draw diamond pattern: a square turned 45 degrees, which needs no path
     float centerX = x + width/2;
     float centerY = y + height/2;
     float diamondSize = width * 0.3f;
+    float side = diamondSize * static_cast<float>(M_SQRT2);
     
-    SkPath diamondPath;
-    diamondPath.moveTo(centerX, centerY - diamondSize);
-    diamondPath.lineTo(centerX + diamondSize, centerY);
-    diamondPath.lineTo(centerX, centerY + diamondSize);
-    diamondPath.lineTo(centerX - diamondSize, centerY);
-    diamondPath.close();
-    
-    m_canvas->drawPath(diamondPath, patternPaint);
+    SkAutoCanvasRestore autoRestore(m_canvas, true);
+    m_canvas->translate(centerX, centerY);
+    m_canvas->rotate(45.0f);
+    m_canvas->drawRect(SkRect::MakeXYWH(-side/2, -side/2, side, side), m_patternPaint);
 }
 
 const char* RendererWrapper::getCardValueText(int value) {
@@ -2,11 +2,14 @@
 #define TRASHPILES_RENDERER_WRAPPER_H
 
 #include <android/log.h>
+#include "../gcms/event_bus.h"
+#include "../game_engine/frame_arena.h"
 #include <skia/core/SkSurface.h>
 #include <skia/core/SkCanvas.h>
 #include <skia/core/SkPaint.h>
+#include <skia/core/SkFont.h>
+#include <skia/core/SkShader.h>
 #include <memory>
-#include <map>
 
 #define LOG_TAG "TrashPiles-Renderer"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
@@ -16,8 +19,19 @@ struct AAssetManager;
 
 namespace TrashPiles {
 
-// Forward declaration for card animation state
-struct CardState;
+// Card animation state structure
+struct CardState {
+    float rotation = 0.0f;
+    float scaleX = 1.0f;
+    float scaleY = 1.0f;
+    float alpha = 1.0f;
+    float x = 0.0f;
+    float y = 0.0f;
+    bool faceKnown = false;     // The event bus has said which face shows
+    bool faceUp = false;        // That face
+    bool flipFrom = false;      // The face shown before the last flip
+    int64_t eventNanos = 0;     // When an event last moved or flipped the card
+};
 
 /**
  * Renderer Wrapper - Interfaces with Skia Graphics Engine
@@ -34,26 +48,45 @@ public:
     // Initialization
     bool initialize(int width, int height);
     void cleanup();
+    bool isInitialized() const { return m_initialized; }
+    int getWidth() const { return m_width; }
+    int getHeight() const { return m_height; }
     
     // Rendering
     void beginFrame();
     void endFrame();
     void clear(float r, float g, float b, float a);
     
-    // Card rendering
+    // Card rendering; once the event bus has placed, dealt or flipped a
+    // card, its face comes from the bus and a flip animates, whatever
+    // faceUp the caller passes
     void renderCard(int cardId, float x, float y, float width, float height, bool faceUp);
     void renderCardBack(float x, float y, float width, float height);
     
     // UI rendering
     void renderButton(const char* buttonId, float x, float y, float width, float height);
     void renderText(const char* text, float x, float y, float size);
+    // Highlights a seat's area while it is that player's turn on the event bus
+    void renderTurnIndicator(int playerId, float x, float y, float width, float height);
     
     // Animation support
     void setCardRotation(int cardId, float angle);
     void setCardScale(int cardId, float scaleX, float scaleY);
     void setCardAlpha(int cardId, float alpha);
     
+    // Game events
+    // Drained at the start of every frame; card and turn events update the
+    // animation state directly instead of arriving through Kotlin
+    void attachEventBus(EventBus* bus);
+    
+    // Scratch memory for the current frame, emptied by beginFrame(); use
+    // from the render thread only
+    FrameArena& frameArena() { return m_frameArena; }
+    
 private:
+    // Card ids are suit * 13 + value
+    static constexpr int kCardCount = 52;
+    
     int m_width;
     int m_height;
     bool m_initialized;
@@ -67,25 +100,38 @@ private:
     SkPaint m_cardBorderPaint;
     SkPaint m_cardBackPaint;
     SkPaint m_textPaint;
+    SkPaint m_buttonPaint;
+    SkPaint m_buttonBorderPaint;
+    SkPaint m_patternPaint;
+    SkPaint m_turnPaint;
+    SkFont m_font;
+    
+    // Button gradient, rebuilt only when the button height changes
+    sk_sp<SkShader> m_buttonShader;
+    float m_buttonShaderHeight;
     
-    // Card animation states
-    std::map<int, CardState> m_cardStates;
+    // Card animation states, indexed by card id; ids out of range share
+    // the scratch entry
+    CardState m_cardStates[kCardCount];
+    CardState m_scratchCardState;
+    
+    FrameArena m_frameArena;
+    
+    // Event subscription, consumed on the render thread
+    EventBus* m_eventBus;
+    EventBus::Subscriber* m_eventSubscriber;
+    int m_activePlayer;
+    int64_t m_frameNanos;       // Steady clock at beginFrame(), as event times are
     
     // Helper methods
+    CardState& cardState(int cardId);
+    void resetCardStates();
     void drawCardValue(int cardId, float x, float y, float width, float height);
     void drawCardBackPattern(float x, float y, float width, float height);
     const char* getCardValueText(int value);
     const char* getSuitSymbol(int suit);
-};
-
-// Card animation state structure
-struct CardState {
-    float rotation = 0.0f;
-    float scaleX = 1.0f;
-    float scaleY = 1.0f;
-    float alpha = 1.0f;
-    float x = 0.0f;
-    float y = 0.0f;
+    void drainEvents();
+    void applyEvent(const GameEvent& event);
 };
 
 } // namespace TrashPiles
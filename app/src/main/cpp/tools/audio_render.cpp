@@ -0,0 +1,153 @@
+/**
+ * Offline audio render (host tool)
+ *
+ * Plays a scripted event timeline through the game's mixers on the offline
+ * backend and writes the mix to a float WAV. Same script and banks always
+ * give a bit-identical file, so renders can be diffed across mixer changes.
+ *
+ * Usage:
+ *   audio_render <script.txt> <output.wav> --bank <file.tpbank> [--bank ...] [--rate 48000]
+ *
+ * Every bank entry can be used both as a sound and as a music track. See
+ * mixer_timeline.h for the script format, e.g.:
+ *   0      music theme loop 0.7
+ *   4800   play card_flip
+ *   9600   play card_place 0.5
+ *   96000  end
+ */
+
+#include "audio_mixer.h"
+#include "mixer_timeline.h"
+#include "offline_backend.h"
+#include "resampler.h"
+#include "sound_bank.h"
+#include "wav_decoder.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: audio_render <script.txt> <output.wav> "
+                 "--bank <file.tpbank> [--bank ...] [--rate 48000]\n");
+    return 2;
+}
+
+bool readFile(const char* path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    const char* scriptPath = argv[1];
+    const char* outputPath = argv[2];
+    std::vector<const char*> bankPaths;
+    int sampleRate = 48000;
+
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--bank") == 0 && i + 1 < argc) {
+            bankPaths.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            sampleRate = std::atoi(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+    if (bankPaths.empty() || sampleRate <= 0) return usage();
+
+    // Bank images stay loaded: stores at the output rate borrow from them
+    std::vector<std::vector<uint8_t>> images(bankPaths.size());
+    std::vector<std::unique_ptr<AudioData>> voices;
+    std::vector<AudioData*> soundTable;
+    std::vector<AudioData*> trackTable;
+    std::map<std::string, int> ids;
+
+    for (size_t b = 0; b < bankPaths.size(); ++b) {
+        SoundBankView view;
+        if (!readFile(bankPaths[b], images[b]) || !view.open(images[b].data(), images[b].size())) {
+            std::fprintf(stderr, "error: cannot open bank %s\n", bankPaths[b]);
+            return 1;
+        }
+
+        for (size_t i = 0; i < view.entryCount(); ++i) {
+            SampleStore store = view.entryStore(i);
+            if (view.sampleRate() != sampleRate) {
+                PcmBuffer pcm;
+                store.decodeAll(pcm);
+                pcm.sampleRate = view.sampleRate();
+                Resampler::convert(pcm, sampleRate);
+                store = SampleStore::fromPcm(pcm, store.encoding());
+            }
+
+            // Separate voices for the sound and music roles, each with its own cursor
+            ids[view.entryName(i)] = static_cast<int>(soundTable.size());
+            for (std::vector<AudioData*>* table : {&soundTable, &trackTable}) {
+                voices.emplace_back(new AudioData());
+                voices.back()->store = store;
+                voices.back()->isLoaded = true;
+                table->push_back(voices.back().get());
+            }
+        }
+    }
+
+    std::ifstream scriptFile(scriptPath);
+    if (!scriptFile) {
+        std::fprintf(stderr, "error: cannot read %s\n", scriptPath);
+        return 1;
+    }
+    std::string script((std::istreambuf_iterator<char>(scriptFile)), std::istreambuf_iterator<char>());
+
+    MixerTimeline timeline;
+    std::string error;
+    if (!timeline.parse(script, ids, ids, &error)) {
+        std::fprintf(stderr, "error: %s: %s\n", scriptPath, error.c_str());
+        return 1;
+    }
+
+    SoundMixer sounds;
+    MusicMixer music;
+    MixBus bus;
+    bus.add(&sounds);
+    bus.add(&music);
+
+    OfflineBackend backend(sampleRate);
+    if (!backend.open(&bus) || !backend.start()) {
+        std::fprintf(stderr, "error: cannot open offline backend\n");
+        return 1;
+    }
+
+    int64_t lengthFrames = timeline.lengthFrames(sampleRate);
+    auto start = std::chrono::steady_clock::now();
+    timeline.run(sounds, music, soundTable, trackTable, backend, lengthFrames);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    backend.close();
+
+    if (!backend.writeWav(outputPath)) {
+        std::fprintf(stderr, "error: cannot write %s\n", outputPath);
+        return 1;
+    }
+
+    double audioSeconds = static_cast<double>(lengthFrames) / sampleRate;
+    std::printf("Rendered %s: %lld frames (%.2f s) in %.3f ms, %.0fx real time\n",
+                outputPath, static_cast<long long>(lengthFrames), audioSeconds,
+                seconds * 1000.0, seconds > 0.0 ? audioSeconds / seconds : 0.0);
+    return 0;
+}
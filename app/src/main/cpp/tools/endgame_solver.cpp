@@ -0,0 +1,56 @@
+/**
+ * Endgame solver (host tool)
+ *
+ * Solves every late-round position (one to three face-down slots, by the
+ * unseen naturals, wilds and cards) for the expected turns to finish and
+ * the best discard and wild choices, and writes the .tpend tablebase the
+ * AI maps straight from the APK. The image is checked by opening it the
+ * way the app will before it is written.
+ *
+ * Usage:
+ *   endgame_solver <output.tpend>
+ *
+ * Example (from app/src/main):
+ *   endgame_solver assets/endgame.tpend
+ */
+
+#include "endgame_table.h"
+
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+using namespace TrashPiles;
+
+int main(int argc, char** argv) {
+    if (argc != 2) {
+        std::fprintf(stderr, "usage: endgame_solver <output.tpend>\n");
+        return 2;
+    }
+
+    EndgameSolver solver;
+    std::vector<uint8_t> image;
+    solver.build(image);
+
+    EndgameTableView view;
+    EndgameTableView::OpenResult result = view.open(image.data(), image.size());
+    if (result != EndgameTableView::OpenResult::Ok) {
+        std::fprintf(stderr, "error: solved image does not open (%d)\n", static_cast<int>(result));
+        return 1;
+    }
+
+    size_t solved = 0;
+    for (uint32_t index = 0; index < EndgameTableFormat::kEntryCount; ++index) {
+        solved += solver.entry(index).turns != EndgameTableFormat::kUnsolvable;
+    }
+
+    std::ofstream output(argv[1], std::ios::binary);
+    if (!output.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::fprintf(stderr, "error: cannot write %s\n", argv[1]);
+        return 1;
+    }
+
+    std::printf("Wrote %s: %zu of %u positions solvable, %zu bytes\n", argv[1], solved,
+                EndgameTableFormat::kEntryCount, image.size());
+    return 0;
+}
@@ -0,0 +1,114 @@
+/**
+ * Job system benchmark (host tool)
+ *
+ * Runs a fixed amount of synthetic frame work through JobSystem::parallelFor
+ * with 1..N workers and reports the time per pass and the speedup over one
+ * worker, for a coarse grain (few large jobs, as for AI rollouts) and a fine
+ * one (many small jobs, as for animation advance).
+ *
+ * With --trace, also records the run and writes it as Chrome trace-event
+ * JSON for Perfetto UI; job spans need a TRASHPILES_TRACING build.
+ *
+ * Usage:
+ *   job_benchmark [--items 65536] [--passes 50] [--workers N] [--trace out.json]
+ */
+
+#include "job_system.h"
+#include "trace.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr, "usage: job_benchmark [--items 65536] [--passes 50] [--workers N] [--trace out.json]\n");
+    return 2;
+}
+
+// A few hundred nanoseconds of arithmetic per item
+float simulateItem(int index) {
+    float x = static_cast<float>(index & 1023) * 0.001f;
+    for (int i = 0; i < 64; ++i) {
+        x = std::sin(x) * 0.5f + std::cos(x * 1.3f) * 0.5f;
+    }
+    return x;
+}
+
+double timePasses(JobSystem& jobs, std::vector<float>& out, int grain, int passes) {
+    int count = static_cast<int>(out.size());
+    auto start = std::chrono::steady_clock::now();
+    for (int pass = 0; pass < passes; ++pass) {
+        jobs.parallelFor(count, grain, [&out](int begin, int end) {
+            for (int i = begin; i < end; ++i) out[i] = simulateItem(i);
+        });
+    }
+    return std::chrono::duration<double, std::micro>(
+        std::chrono::steady_clock::now() - start).count() / passes;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int items = 65536;
+    int passes = 50;
+    int maxWorkers = JobSystem::recommendedWorkerCount();
+    const char* tracePath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--items") == 0 && i + 1 < argc) {
+            items = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--passes") == 0 && i + 1 < argc) {
+            passes = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--workers") == 0 && i + 1 < argc) {
+            maxWorkers = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else {
+            return usage();
+        }
+    }
+    if (items <= 0 || passes <= 0 || maxWorkers <= 0) return usage();
+    if (maxWorkers > JobSystem::kMaxWorkers) maxWorkers = JobSystem::kMaxWorkers;
+
+    const struct {
+        const char* name;
+        int grain;
+    } grains[] = {
+        {"coarse", items / 8 > 0 ? items / 8 : 1},
+        {"fine", 64},
+    };
+    std::vector<float> out(items);
+    Tracer::setEnabled(tracePath != nullptr);
+
+    std::printf("recommended workers: %d\n", JobSystem::recommendedWorkerCount());
+    std::printf("%-7s %7s %12s %8s %8s\n", "grain", "workers", "us/pass", "speedup", "stolen");
+    for (const auto& grain : grains) {
+        double baseline = 0.0;
+        for (int workers = 1; workers <= maxWorkers; ++workers) {
+            JobSystem jobs(workers);
+            timePasses(jobs, out, grain.grain, 1);      // Warm up threads and caches
+            JobSystem::Stats before = jobs.stats();
+            double micros = timePasses(jobs, out, grain.grain, passes);
+            if (workers == 1) baseline = micros;
+
+            std::printf("%-7s %7d %12.1f %7.2fx %8llu\n", grain.name, workers, micros, baseline / micros,
+                        static_cast<unsigned long long>(jobs.stats().stolen - before.stolen));
+        }
+    }
+
+    if (tracePath) {
+        if (!Tracer::writeChromeJson(tracePath)) {
+            std::fprintf(stderr, "failed to write %s\n", tracePath);
+            return 1;
+        }
+        std::printf("trace: %s (%d threads)\n", tracePath, Tracer::threadCount());
+    }
+    return 0;
+}
@@ -0,0 +1,104 @@
+/**
+ * Mixer benchmark (host tool)
+ *
+ * Renders looping synthetic voices through SoundMixer on the offline backend
+ * with capture off, and reports the mixing cost in nanoseconds per output
+ * frame per voice for each storage encoding and channel layout.
+ *
+ * Usage:
+ *   mixer_benchmark [--seconds 10] [--rate 48000]
+ */
+
+#include "audio_mixer.h"
+#include "offline_backend.h"
+#include "wav_decoder.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr, "usage: mixer_benchmark [--seconds 10] [--rate 48000]\n");
+    return 2;
+}
+
+// One second of a detuned tone per channel, so ADPCM has real work to do
+PcmBuffer makeTone(int channelCount, int sampleRate) {
+    PcmBuffer pcm;
+    pcm.channelCount = channelCount;
+    pcm.sampleRate = sampleRate;
+    pcm.samples.resize(static_cast<size_t>(sampleRate) * channelCount);
+    for (int f = 0; f < sampleRate; ++f) {
+        for (int ch = 0; ch < channelCount; ++ch) {
+            double phase = 2.0 * M_PI * (440.0 + 3.0 * ch) * f / sampleRate;
+            pcm.samples[f * channelCount + ch] = static_cast<float>(0.25 * std::sin(phase));
+        }
+    }
+    return pcm;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    int seconds = 10;
+    int sampleRate = 48000;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            sampleRate = std::atoi(argv[++i]);
+        } else {
+            return usage();
+        }
+    }
+    if (seconds <= 0 || sampleRate <= 0) return usage();
+
+    const SampleEncoding encodings[] = {
+        SampleEncoding::Float32, SampleEncoding::Int16, SampleEncoding::ImaAdpcm
+    };
+    const int voiceCounts[] = {1, 8, 32};
+    int64_t frames = static_cast<int64_t>(seconds) * sampleRate;
+
+    std::printf("%-10s %3s %6s %14s %16s\n", "encoding", "ch", "voices", "ns/frame", "ns/frame/voice");
+    for (SampleEncoding encoding : encodings) {
+        for (int channelCount = 1; channelCount <= 2; ++channelCount) {
+            SampleStore store = SampleStore::fromPcm(makeTone(channelCount, sampleRate), encoding);
+
+            for (int voiceCount : voiceCounts) {
+                std::vector<std::unique_ptr<AudioData>> voices;
+                SoundMixer mixer;
+                for (int v = 0; v < voiceCount; ++v) {
+                    voices.emplace_back(new AudioData());
+                    voices.back()->store = store;
+                    voices.back()->isLoaded = true;
+                    voices.back()->isLooping = true;
+                    mixer.play(v, voices.back().get(), 1.0f / voiceCount);
+                }
+
+                OfflineBackend backend(sampleRate);
+                backend.setCapture(false);
+                backend.open(&mixer);
+                backend.start();
+
+                auto start = std::chrono::steady_clock::now();
+                backend.render(frames);
+                double nanos = std::chrono::duration<double, std::nano>(
+                    std::chrono::steady_clock::now() - start).count();
+
+                double perFrame = nanos / static_cast<double>(frames);
+                std::printf("%-10s %3d %6d %14.2f %16.2f\n", sampleEncodingText(encoding),
+                            channelCount, voiceCount, perFrame, perFrame / voiceCount);
+            }
+        }
+    }
+    return 0;
+}
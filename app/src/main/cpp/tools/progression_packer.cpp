@@ -0,0 +1,70 @@
+/**
+ * Progression packer (host tool)
+ *
+ * Compiles the text catalog written by ProgressionCatalogExport (skills and
+ * abilities, trophies, challenge sets) into a .tpprog image that the app
+ * maps straight from the APK instead of building the catalogs at startup.
+ * The image is checked by opening it the way the app will before it is
+ * written.
+ *
+ * Usage:
+ *   progression_packer <catalog.tsv> <output.tpprog>
+ *
+ * Example (from app/src/main):
+ *   progression_packer progression/catalog.tsv assets/progression.tpprog
+ */
+
+#include "progression_blob.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace TrashPiles;
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: progression_packer <catalog.tsv> <output.tpprog>\n");
+        return 2;
+    }
+
+    std::ifstream input(argv[1], std::ios::binary);
+    if (!input) {
+        std::fprintf(stderr, "error: cannot read %s\n", argv[1]);
+        return 1;
+    }
+    std::string text((std::istreambuf_iterator<char>(input)), std::istreambuf_iterator<char>());
+
+    ProgressionBlobWriter writer;
+    std::string error;
+    if (!writer.addCatalogText(text, &error)) {
+        std::fprintf(stderr, "error: %s: %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    std::vector<uint8_t> image;
+    if (!writer.build(image, &error)) {
+        std::fprintf(stderr, "error: %s\n", error.c_str());
+        return 1;
+    }
+
+    ProgressionBlobView view;
+    ProgressionBlobView::OpenResult result = view.open(image.data(), image.size());
+    if (result != ProgressionBlobView::OpenResult::Ok) {
+        std::fprintf(stderr, "error: packed image does not open (%d)\n", static_cast<int>(result));
+        return 1;
+    }
+
+    std::ofstream output(argv[2], std::ios::binary);
+    if (!output.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::fprintf(stderr, "error: cannot write %s\n", argv[2]);
+        return 1;
+    }
+
+    std::printf("Wrote %s: %d nodes, %d trophies, %d challenge sets (%d challenges), %zu bytes\n",
+                argv[2], view.nodeCount(), view.trophyCount(), view.challengeSetCount(),
+                view.challengeCount(), image.size());
+    return 0;
+}
@@ -0,0 +1,129 @@
+/**
+ * Sound bank packer (host tool)
+ *
+ * Builds a .tpbank from every .wav in a directory: decodes, resamples to the
+ * bank rate, encodes to the requested storage and writes one aligned image
+ * that AudioWrapper maps straight from the APK.
+ *
+ * Usage:
+ *   soundbank_packer <input_dir> <output.tpbank> [--rate 48000] [--encoding int16|adpcm|float]
+ *
+ * Example (from app/src/main):
+ *   soundbank_packer assets/sounds assets/sounds.tpbank --encoding int16
+ *   soundbank_packer assets/music assets/music.tpbank --encoding adpcm
+ */
+
+#include "wav_decoder.h"
+#include "resampler.h"
+#include "sample_store.h"
+#include "sound_bank.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace TrashPiles;
+namespace fs = std::filesystem;
+
+namespace {
+
+int usage() {
+    std::fprintf(stderr,
+                 "usage: soundbank_packer <input_dir> <output.tpbank> "
+                 "[--rate 48000] [--encoding int16|adpcm|float]\n");
+    return 2;
+}
+
+bool parseEncoding(const char* text, SampleEncoding& encoding) {
+    if (std::strcmp(text, "int16") == 0) encoding = SampleEncoding::Int16;
+    else if (std::strcmp(text, "adpcm") == 0) encoding = SampleEncoding::ImaAdpcm;
+    else if (std::strcmp(text, "float") == 0) encoding = SampleEncoding::Float32;
+    else return false;
+    return true;
+}
+
+bool readFile(const fs::path& path, std::vector<uint8_t>& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    out.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    if (argc < 3) return usage();
+
+    fs::path inputDir = argv[1];
+    fs::path outputPath = argv[2];
+    int sampleRate = 48000;
+    SampleEncoding encoding = SampleEncoding::Int16;
+
+    for (int i = 3; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--rate") == 0 && i + 1 < argc) {
+            sampleRate = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--encoding") == 0 && i + 1 < argc) {
+            if (!parseEncoding(argv[++i], encoding)) return usage();
+        } else {
+            return usage();
+        }
+    }
+    if (sampleRate <= 0 || !fs::is_directory(inputDir)) return usage();
+
+    // Sorted so the same inputs always produce a byte-identical bank
+    std::vector<fs::path> inputs;
+    for (const auto& item : fs::directory_iterator(inputDir)) {
+        if (item.is_regular_file() && item.path().extension() == ".wav") {
+            inputs.push_back(item.path());
+        }
+    }
+    std::sort(inputs.begin(), inputs.end());
+
+    SoundBankWriter writer(sampleRate);
+    size_t sourceBytes = 0;
+    for (const fs::path& path : inputs) {
+        std::vector<uint8_t> bytes;
+        if (!readFile(path, bytes)) {
+            std::fprintf(stderr, "error: cannot read %s\n", path.c_str());
+            return 1;
+        }
+        sourceBytes += bytes.size();
+
+        PcmBuffer pcm;
+        WavError error = WavError::None;
+        if (!decodeWav(bytes.data(), bytes.size(), pcm, &error)) {
+            std::fprintf(stderr, "error: %s: %s\n", path.c_str(), wavErrorText(error));
+            return 1;
+        }
+        int sourceRate = pcm.sampleRate;
+        Resampler::convert(pcm, sampleRate);
+
+        std::string name = path.stem().string();
+        SampleStore store = SampleStore::fromPcm(pcm, encoding);
+        std::printf("  %-24s %6d Hz -> %d Hz, %d ch, %8d frames, %8zu bytes\n",
+                    name.c_str(), sourceRate, sampleRate, store.channelCount(),
+                    store.frameCount(), store.memoryBytes());
+        if (!writer.add(name, std::move(store))) {
+            std::fprintf(stderr, "error: name too long for bank index: %s\n", name.c_str());
+            return 1;
+        }
+    }
+
+    std::vector<uint8_t> image = writer.build();
+    std::ofstream output(outputPath, std::ios::binary);
+    if (!output.write(reinterpret_cast<const char*>(image.data()), image.size())) {
+        std::fprintf(stderr, "error: cannot write %s\n", outputPath.c_str());
+        return 1;
+    }
+
+    std::printf("Wrote %s: %zu sounds, %s, %zu bytes (sources %zu bytes)\n",
+                outputPath.c_str(), inputs.size(), sampleEncodingText(encoding),
+                image.size(), sourceBytes);
+    return 0;
+}
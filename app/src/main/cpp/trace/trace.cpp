@@ -0,0 +1,226 @@
+#include "trace.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+
+namespace TrashPiles {
+
+static_assert((Tracer::kRingCapacity & (Tracer::kRingCapacity - 1)) == 0,
+              "Trace ring capacity must be a power of two");
+
+std::atomic<bool> Tracer::s_enabled{false};
+
+namespace {
+
+struct ThreadRing {
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[Tracer::kRingCapacity]};
+    std::atomic<uint64_t> head{0};          // Written by the owning thread only
+    std::atomic<uint64_t> clearedAt{0};     // Events before this were cleared
+    char name[Tracer::kMaxNameLength + 1] = {};
+    int id = 0;
+};
+
+// Rings live for the process so a trace can be exported after its threads exit
+ThreadRing* g_rings[Tracer::kMaxThreads] = {};
+std::atomic<int> g_ringCount{0};
+std::atomic<uint64_t> g_droppedThreads{0};
+
+char g_internedNames[Tracer::kMaxInternedNames][Tracer::kMaxNameLength + 1];
+int g_internedCount = 0;
+
+// Ring creation, thread names, interning and export; never the record path
+std::mutex g_registryLock;
+
+// Taken when no ring was free, so the thread stops asking
+ThreadRing g_noRing;
+
+thread_local ThreadRing* t_ring = nullptr;
+thread_local char t_pendingName[Tracer::kMaxNameLength + 1] = {};
+
+void copyName(char* out, const char* name) {
+    if (!name) name = "";
+    size_t length = strnlen(name, Tracer::kMaxNameLength);
+    std::memcpy(out, name, length);
+    out[length] = '\0';
+}
+
+ThreadRing* currentRing() {
+    if (t_ring) return t_ring;
+
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    int index = g_ringCount.load(std::memory_order_relaxed);
+    if (index >= Tracer::kMaxThreads) {
+        g_droppedThreads.fetch_add(1, std::memory_order_relaxed);
+        t_ring = &g_noRing;
+        return t_ring;
+    }
+
+    ThreadRing* ring = new ThreadRing();
+    ring->id = index + 1;
+    if (t_pendingName[0]) {
+        copyName(ring->name, t_pendingName);
+    } else {
+        std::snprintf(ring->name, sizeof(ring->name), "thread %d", ring->id);
+    }
+    g_rings[index] = ring;
+    g_ringCount.store(index + 1, std::memory_order_release);
+    t_ring = ring;
+    return ring;
+}
+
+int64_t nowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void appendEscaped(std::string& out, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        unsigned char ch = static_cast<unsigned char>(*c);
+        if (ch == '"' || ch == '\\') {
+            out += '\\';
+            out += *c;
+        } else if (ch < 0x20) {
+            char escaped[8];
+            std::snprintf(escaped, sizeof(escaped), "\\u%04x", ch);
+            out += escaped;
+        } else {
+            out += *c;
+        }
+    }
+}
+
+void appendEvent(std::string& out, const TraceEvent& event, int tid) {
+    static const char* const kPhases[] = {"B", "E", "C", "i"};
+
+    char fields[128];
+    std::snprintf(fields, sizeof(fields), "\",\"cat\":\"native\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":1,\"tid\":%d",
+                  kPhases[static_cast<int>(event.phase)], static_cast<double>(event.timeNanos) / 1000.0, tid);
+
+    out += ",\n{\"name\":\"";
+    appendEscaped(out, event.name ? event.name : "?");
+    out += fields;
+    if (event.phase == TracePhase::Counter) {
+        std::snprintf(fields, sizeof(fields), ",\"args\":{\"value\":%lld}", static_cast<long long>(event.value));
+        out += fields;
+    } else if (event.phase == TracePhase::Instant) {
+        out += ",\"s\":\"t\"";
+    }
+    out += '}';
+}
+
+} // namespace
+
+void Tracer::setEnabled(bool enabled) {
+    s_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void Tracer::record(TracePhase phase, const char* name, int64_t value) {
+    ThreadRing* ring = currentRing();
+    if (ring == &g_noRing) return;
+
+    uint64_t head = ring->head.load(std::memory_order_relaxed);
+    TraceEvent& event = ring->events[head & (kRingCapacity - 1)];
+    event.name = name;
+    event.timeNanos = nowNanos();
+    event.value = value;
+    event.phase = phase;
+    ring->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::setThreadName(const char* name) {
+    copyName(t_pendingName, name);
+
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    if (t_ring && t_ring != &g_noRing) copyName(t_ring->name, name);
+}
+
+const char* Tracer::intern(const char* name) {
+    if (!name) return nullptr;
+
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    for (int i = 0; i < g_internedCount; ++i) {
+        if (std::strncmp(g_internedNames[i], name, kMaxNameLength) == 0) return g_internedNames[i];
+    }
+    if (g_internedCount >= kMaxInternedNames) return nullptr;
+
+    copyName(g_internedNames[g_internedCount], name);
+    return g_internedNames[g_internedCount++];
+}
+
+std::string Tracer::exportChromeJson() {
+    std::lock_guard<std::mutex> lock(g_registryLock);
+
+    std::string out = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out += "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"args\":{\"name\":\"trash-piles-native\"}}";
+
+    int ringCount = g_ringCount.load(std::memory_order_acquire);
+    std::unique_ptr<TraceEvent[]> copy(new TraceEvent[kRingCapacity]);
+    for (int r = 0; r < ringCount; ++r) {
+        ThreadRing* ring = g_rings[r];
+
+        out += ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":";
+        out += std::to_string(ring->id);
+        out += ",\"args\":{\"name\":\"";
+        appendEscaped(out, ring->name);
+        out += "\"}}";
+
+        // Copy, then keep only what the owner cannot have overwritten meanwhile
+        uint64_t head = ring->head.load(std::memory_order_acquire);
+        uint64_t first = head > kRingCapacity ? head - kRingCapacity : 0;
+        uint64_t cleared = ring->clearedAt.load(std::memory_order_relaxed);
+        if (first < cleared) first = cleared;
+        for (uint64_t i = first; i < head; ++i) {
+            copy[i - first] = ring->events[i & (kRingCapacity - 1)];
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t headAfter = ring->head.load(std::memory_order_relaxed);
+        uint64_t intact = headAfter > kRingCapacity ? headAfter - kRingCapacity : 0;
+
+        for (uint64_t i = first < intact ? intact : first; i < head; ++i) {
+            appendEvent(out, copy[i - first], ring->id);
+        }
+    }
+
+    out += "\n]}\n";
+    return out;
+}
+
+bool Tracer::writeChromeJson(const char* path) {
+    std::string json = exportChromeJson();
+    FILE* file = std::fopen(path, "wb");
+    if (!file) return false;
+
+    bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+    ok = std::fclose(file) == 0 && ok;
+    return ok;
+}
+
+void Tracer::clear() {
+    std::lock_guard<std::mutex> lock(g_registryLock);
+    int ringCount = g_ringCount.load(std::memory_order_acquire);
+    for (int r = 0; r < ringCount; ++r) {
+        g_rings[r]->clearedAt.store(g_rings[r]->head.load(std::memory_order_acquire), std::memory_order_relaxed);
+    }
+}
+
+int Tracer::threadCount() {
+    return g_ringCount.load(std::memory_order_acquire);
+}
+
+uint64_t Tracer::recordedEvents() {
+    uint64_t total = 0;
+    int ringCount = g_ringCount.load(std::memory_order_acquire);
+    for (int r = 0; r < ringCount; ++r) {
+        total += g_rings[r]->head.load(std::memory_order_relaxed);
+    }
+    return total;
+}
+
+uint64_t Tracer::droppedThreads() {
+    return g_droppedThreads.load(std::memory_order_relaxed);
+}
+
+} // namespace TrashPiles
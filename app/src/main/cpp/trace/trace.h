@@ -0,0 +1,135 @@
+#ifndef TRASHPILES_TRACE_H
+#define TRASHPILES_TRACE_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace TrashPiles {
+
+enum class TracePhase : uint8_t {
+    Begin = 0,
+    End,
+    Counter,
+    Instant
+};
+
+struct TraceEvent {
+    const char* name = nullptr;     // Literal or Tracer::intern() result
+    int64_t timeNanos = 0;          // steady_clock
+    int64_t value = 0;              // Counter value
+    TracePhase phase = TracePhase::Instant;
+};
+
+/**
+ * Process-wide trace recorder
+ * Each thread records into a ring of its own, created on its first event,
+ * so a trace point costs a clock read and a few stores with no locks or
+ * shared cache lines. A ring keeps its thread's latest kRingCapacity
+ * events. Export merges the rings into Chrome trace-event JSON, which
+ * Perfetto UI and chrome://tracing load as one timeline.
+ *
+ * Recording is off until setEnabled(true). Use the TRACE_* macros below
+ * rather than record() directly: they compile to nothing unless
+ * TRASHPILES_TRACING is defined.
+ */
+class Tracer {
+public:
+    static constexpr uint32_t kRingCapacity = 8192;     // Events per thread, power of two
+    static constexpr int kMaxThreads = 32;
+    static constexpr int kMaxInternedNames = 256;
+    static constexpr int kMaxNameLength = 47;
+
+    static void setEnabled(bool enabled);
+    static bool isEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // Name must stay valid for the life of the process
+    static void record(TracePhase phase, const char* name, int64_t value = 0);
+
+    // Label for the calling thread's track; copied
+    static void setThreadName(const char* name);
+
+    // Stable copy of a runtime string, for names that are not literals.
+    // Equal strings share a copy. Null once the table is full.
+    static const char* intern(const char* name);
+
+    // Everything still in the rings, oldest first per thread
+    static std::string exportChromeJson();
+    static bool writeChromeJson(const char* path);
+
+    // Drop recorded events; rings stay registered with their threads
+    static void clear();
+
+    static int threadCount();
+    static uint64_t recordedEvents();       // Including overwritten ones
+    static uint64_t droppedThreads();       // Threads that found no free ring
+
+private:
+    static std::atomic<bool> s_enabled;
+};
+
+/**
+ * Begin/end pair for the enclosing scope
+ * Ends the span even if tracing was switched off inside it.
+ */
+class TraceScope {
+public:
+    explicit TraceScope(const char* name) : m_name(Tracer::isEnabled() ? name : nullptr) {
+        if (m_name) Tracer::record(TracePhase::Begin, m_name);
+    }
+
+    ~TraceScope() {
+        if (m_name) Tracer::record(TracePhase::End, m_name);
+    }
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    const char* m_name;
+};
+
+} // namespace TrashPiles
+
+#define TRASHPILES_TRACE_CONCAT_INNER(a, b) a##b
+#define TRASHPILES_TRACE_CONCAT(a, b) TRASHPILES_TRACE_CONCAT_INNER(a, b)
+
+#ifdef TRASHPILES_TRACING
+
+#define TRASHPILES_TRACE_RECORD(phase, name, value) \
+    do { \
+        if (::TrashPiles::Tracer::isEnabled()) { \
+            ::TrashPiles::Tracer::record(::TrashPiles::TracePhase::phase, (name), (value)); \
+        } \
+    } while (0)
+
+#define TRACE_SCOPE(name) \
+    ::TrashPiles::TraceScope TRASHPILES_TRACE_CONCAT(traceScope_, __LINE__)(name)
+#define TRACE_BEGIN(name) TRASHPILES_TRACE_RECORD(Begin, name, 0)
+#define TRACE_END(name) TRASHPILES_TRACE_RECORD(End, name, 0)
+#define TRACE_COUNTER(name, value) TRASHPILES_TRACE_RECORD(Counter, name, static_cast<int64_t>(value))
+#define TRACE_INSTANT(name) TRASHPILES_TRACE_RECORD(Instant, name, 0)
+
+// Names the calling thread the first time this line runs on it
+#define TRACE_THREAD_NAME(name) \
+    do { \
+        static thread_local bool TRASHPILES_TRACE_CONCAT(traceNamed_, __LINE__) = false; \
+        if (!TRASHPILES_TRACE_CONCAT(traceNamed_, __LINE__)) { \
+            ::TrashPiles::Tracer::setThreadName(name); \
+            TRASHPILES_TRACE_CONCAT(traceNamed_, __LINE__) = true; \
+        } \
+    } while (0)
+
+#else
+
+// Unevaluated, so arguments cost nothing but still count as used
+#define TRACE_SCOPE(name) do { (void)sizeof(name); } while (0)
+#define TRACE_BEGIN(name) do { (void)sizeof(name); } while (0)
+#define TRACE_END(name) do { (void)sizeof(name); } while (0)
+#define TRACE_COUNTER(name, value) do { (void)sizeof(name); (void)sizeof(value); } while (0)
+#define TRACE_INSTANT(name) do { (void)sizeof(name); } while (0)
+#define TRACE_THREAD_NAME(name) do { (void)sizeof(name); } while (0)
+
+#endif // TRASHPILES_TRACING
+
+#endif // TRASHPILES_TRACE_H
@@ -2,30 +2,54 @@ package com.trashpiles.game
 
 import com.trashpiles.gcms.*
 import com.trashpiles.native.AudioEngineBridge
+import com.trashpiles.native.NativeEventBus
 import com.trashpiles.utils.AssetLoader
 import kotlinx.coroutines.*
 import kotlinx.coroutines.flow.*
 import android.util.Log
+import java.util.concurrent.ConcurrentHashMap
 
 /**
  * Game Audio - Connects GCMS events to Oboe audio engine
  * 
  * Subscribes to GCMS events and triggers audio playback
  * Maps game events to sound effects and music
+ *
+ * With nativeEventSounds the game event sounds are bound once in the native
+ * mixer, which plays them straight off the native event bus; only explicit
+ * PlaySound events still come through here.
  */
 class GameAudio(
     private val gcms: GCMSController,
     private val audioBridge: AudioEngineBridge,
-    private val assetLoader: AssetLoader
+    private val assetLoader: AssetLoader,
+    private val nativeEventSounds: Boolean = false
 ) {
     
     companion object {
         private const val TAG = "GameAudio"
+        
+        // Native event type to sound and volume; mirrors handleEvent
+        private val EVENT_SOUNDS = listOf(
+            Triple(NativeEventBus.TYPE_GAME_STARTED, "button_click", 1.0f),
+            Triple(NativeEventBus.TYPE_CARD_DEALT, "card_deal", 0.5f),
+            Triple(NativeEventBus.TYPE_CARD_DRAWN, "card_draw", 1.0f),
+            Triple(NativeEventBus.TYPE_CARD_PLACED, "card_place", 1.0f),
+            Triple(NativeEventBus.TYPE_CARD_FLIPPED, "card_flip", 1.0f),
+            Triple(NativeEventBus.TYPE_CARD_DISCARDED, "card_place", 0.7f),
+            Triple(NativeEventBus.TYPE_TURN_STARTED, "button_click", 0.3f),
+            Triple(NativeEventBus.TYPE_ROUND_WON, "victory", 1.0f),
+            Triple(NativeEventBus.TYPE_GAME_ENDED, "victory", 0.8f)
+        )
     }
     
     private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
     private var eventJob: Job? = null
     
+    // Native sound ids, registered once per name; filled from the preload
+    // coroutine and from UI-thread play calls alike
+    private val soundIds = ConcurrentHashMap<String, Int>()
+    
     // Audio settings
     private var soundEnabled = true
     private var musicEnabled = true
@@ -38,6 +62,7 @@ class GameAudio(
     fun start() {
         // Load all sounds
         loadSounds()
+        bindEventSounds(soundEnabled)
         
         // Start background music
         if (musicEnabled) {
@@ -57,31 +82,61 @@ class GameAudio(
      */
     fun stop() {
         eventJob?.cancel()
+        bindEventSounds(false)
         stopBackgroundMusic()
+        logPerformanceStats()
     }
     
     /**
-     * Load all sound files
+     * Log output stream health (underruns, settled buffer size, latency)
+     * so field logs show which devices struggle
+     */
+    private fun logPerformanceStats() {
+        try {
+            val stats = audioBridge.getPerformanceStats()
+            val fieldsPerStream = stats.size / 2
+            listOf("sound", "music").forEachIndexed { index, stream ->
+                val base = index * fieldsPerStream
+                Log.i(TAG, "$stream stream: ${stats[base]} callbacks, ${stats[base + 1]} xruns, " +
+                        "buffer ${stats[base + 2]} frames (burst ${stats[base + 3]}, " +
+                        "lowest stable ${stats[base + 5]}), latency ${stats[base + 6]} us, " +
+                        "callback mean ${stats[base + 7]} us, max ${stats[base + 8]} us")
+            }
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to read audio performance stats", e)
+        }
+    }
+    
+    /**
+     * Sound files are preloaded natively from the packed sound bank when the
+     * audio engine initializes; nothing is loaded on the play path
      */
     private fun loadSounds() {
-        Log.d(TAG, "Loading sounds...")
-        
-        val sounds = mapOf(
-            "card_flip" to assetLoader.getAudioPath("card_flip"),
-            "card_deal" to assetLoader.getAudioPath("card_deal"),
-            "card_place" to assetLoader.getAudioPath("card_place"),
-            "button_click" to assetLoader.getAudioPath("button_click"),
-            "victory" to assetLoader.getAudioPath("victory"),
-            "background_music" to assetLoader.getAudioPath("background_music")
-        )
+        listOf("card_flip", "card_deal", "card_draw", "card_place", "button_click", "victory")
+            .forEach { soundId(it) }
+        Log.d(TAG, "Sound bank ready: ${audioBridge.isSoundBankReady()}")
+    }
+    
+    /**
+     * Resolve a sound name to its native id, registering it on first use
+     */
+    private fun soundId(name: String): Int {
+        // computeIfAbsent runs the registration at most once per name
+        return soundIds.computeIfAbsent(name) { audioBridge.registerSound(it) }
+    }
+    
+    /**
+     * Bind (or unbind) the game event sounds in the native mixer
+     */
+    private fun bindEventSounds(enabled: Boolean) {
+        if (!nativeEventSounds) return
         
-        sounds.forEach { (soundId, path) ->
-            if (path != null) {
-                audioBridge.loadSound(soundId, path)
-                Log.d(TAG, "Loaded sound: $soundId")
-            } else {
-                Log.w(TAG, "Sound path not found: $soundId")
+        try {
+            EVENT_SOUNDS.forEach { (type, name, volume) ->
+                audioBridge.bindEventSound(type, if (enabled) soundId(name) else -1, volume)
             }
+        } catch (e: Exception) {
+            Log.e(TAG, "Failed to bind event sounds", e)
         }
     }
     
@@ -91,6 +146,9 @@ class GameAudio(
     private fun handleEvent(event: GCMSEvent) {
         if (!soundEnabled) return
         
+        // Already played natively off the event bus
+        if (nativeEventSounds && event !is GCMSEvent.PlaySound) return
+        
         when (event) {
             is GCMSEvent.GameStarted -> {
                 Log.d(TAG, "Game started")
@@ -160,7 +218,10 @@ class GameAudio(
         if (!soundEnabled) return
         
         try {
-            audioBridge.playSound(soundId, volume)
+            val id = soundId(soundId)
+            if (id >= 0) {
+                audioBridge.playSound(id, volume)
+            }
         } catch (e: Exception) {
             Log.e(TAG, "Failed to play sound: $soundId", e)
         }
@@ -199,8 +260,8 @@ class GameAudio(
      */
     fun pauseMusic() {
         try {
-            // TODO: Implement music pause
-            // audioBridge.pauseMusic()
+            // Keeps the track position; resumeMusic continues from it
+            audioBridge.pauseMusic()
             Log.d(TAG, "Background music paused")
         } catch (e: Exception) {
             Log.e(TAG, "Failed to pause background music", e)
@@ -214,8 +275,7 @@ class GameAudio(
         if (!musicEnabled) return
         
         try {
-            // TODO: Implement music resume
-            // audioBridge.resumeMusic()
+            audioBridge.resumeMusic()
             Log.d(TAG, "Background music resumed")
         } catch (e: Exception) {
             Log.e(TAG, "Failed to resume background music", e)
@@ -227,6 +287,7 @@ class GameAudio(
      */
     fun setSoundEnabled(enabled: Boolean) {
         soundEnabled = enabled
+        bindEventSounds(enabled)
         Log.d(TAG, "Sound effects ${if (enabled) "enabled" else "disabled"}")
     }
     
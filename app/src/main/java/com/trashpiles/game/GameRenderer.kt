@@ -1,6 +1,7 @@
 package com.trashpiles.game
 
 import com.trashpiles.gcms.*
+import com.trashpiles.native.GameStateMirror
 import com.trashpiles.native.RendererBridge
 import com.trashpiles.utils.AssetLoader
 import kotlinx.coroutines.*
@@ -16,11 +17,16 @@ import android.util.Log
 class GameRenderer(
     private val gcms: GCMSController,
     private val rendererBridge: RendererBridge,
-    private val assetLoader: AssetLoader
+    private val assetLoader: AssetLoader,
+    private val stateMirror: GameStateMirror? = null
 ) {
     
     companion object {
         private const val TAG = "GameRenderer"
+        
+        private const val CARD_WIDTH = 100f
+        private const val CARD_HEIGHT = 140f
+        private const val SEAT_MARGIN = 8f
     }
     
     private val scope = CoroutineScope(Dispatchers.Main + SupervisorJob())
@@ -29,6 +35,11 @@ class GameRenderer(
     // Card positions cache
     private val cardPositions = mutableMapOf<String, CardPosition>()
     
+    // Mirror section versions already on screen, and read scratch
+    private val drawnVersions = IntArray(GameStateMirror.SECTION_COUNT) { -1 }
+    private val mirrorVersions = IntArray(GameStateMirror.SECTION_COUNT)
+    private val mirrorHands = ByteArray(GameStateMirror.MAX_PLAYERS * GameStateMirror.MAX_HAND_SLOTS)
+    
     /**
      * Start listening to GCMS events
      */
@@ -107,7 +118,11 @@ class GameRenderer(
             
             is GCMSEvent.StateChanged -> {
                 Log.d(TAG, "State changed, re-rendering")
-                renderGameState(event.stateSnapshot)
+                if (stateMirror != null) {
+                    renderChangedSections(stateMirror)
+                } else {
+                    renderGameState(event.stateSnapshot)
+                }
             }
             
             is GCMSEvent.GameEnded -> {
@@ -147,6 +162,76 @@ class GameRenderer(
         rendererBridge.present()
     }
     
+    /**
+     * Re-render only what changed since the last frame
+     * Reads the native state mirror in place and compares section versions,
+     * instead of walking a fresh GCMSState copy
+     */
+    private fun renderChangedSections(mirror: GameStateMirror) {
+        mirror.read { sectionVersions(mirrorVersions) }
+        
+        val turnChanged = mirrorVersions[GameStateMirror.SECTION_MATCH] != drawnVersions[GameStateMirror.SECTION_MATCH]
+        // A new turn moves the seat outline, so the table is cleared and redrawn whole
+        val pilesChanged = turnChanged || mirrorVersions[GameStateMirror.SECTION_PILES] != drawnVersions[GameStateMirror.SECTION_PILES]
+        val handsChanged = turnChanged || mirrorVersions[GameStateMirror.SECTION_HANDS] != drawnVersions[GameStateMirror.SECTION_HANDS]
+        if (!pilesChanged && !handsChanged) return
+        
+        rendererBridge.beginFrame()
+        if (turnChanged) {
+            rendererBridge.clear(0.05f, 0.35f, 0.15f, 1f)
+            val playerCount = mirror.read { playerCount }
+            for (playerIndex in 0 until playerCount) {
+                renderSeatIndicator(playerIndex)
+            }
+        }
+        
+        if (pilesChanged) {
+            val (deckCount, discardTop) = mirror.read { deckCount to discardTop }
+            renderDeckBack(deckCount)
+            renderDiscardTop(discardTop)
+        }
+        
+        if (handsChanged) {
+            mirror.read { copyHands(mirrorHands) }
+            for (playerIndex in 0 until GameStateMirror.MAX_PLAYERS) {
+                for (slotIndex in 0 until GameStateMirror.MAX_HAND_SLOTS) {
+                    val code = mirrorHands[playerIndex * GameStateMirror.MAX_HAND_SLOTS + slotIndex].toInt()
+                    if (code != GameStateMirror.NO_CARD) {
+                        renderHandSlot(playerIndex, slotIndex, code)
+                    }
+                }
+            }
+        }
+        
+        mirrorVersions.copyInto(drawnVersions)
+        rendererBridge.endFrame()
+    }
+    
+    /**
+     * Outline a seat's hand area; the renderer draws it only for the player
+     * whose turn the native event bus last started
+     */
+    private fun renderSeatIndicator(playerIndex: Int) {
+        val first = calculateCardPosition(playerIndex, 0)
+        val last = calculateCardPosition(playerIndex, GameStateMirror.MAX_HAND_SLOTS - 1)
+        rendererBridge.renderTurnIndicator(
+            playerIndex,
+            first.x - SEAT_MARGIN,
+            first.y - SEAT_MARGIN,
+            last.x + CARD_WIDTH - first.x + 2 * SEAT_MARGIN,
+            CARD_HEIGHT + 2 * SEAT_MARGIN
+        )
+    }
+    
+    /**
+     * Render the deck as a card back, or leave its spot empty
+     */
+    private fun renderDeckBack(cardCount: Int) {
+        if (cardCount <= 0) return
+        val position = getDeckPosition()
+        rendererBridge.renderCardBack(position.x, position.y, CARD_WIDTH, CARD_HEIGHT)
+    }
+    
     /**
      * Render background
      */
@@ -180,6 +265,35 @@ class GameRenderer(
         }
     }
     
+    /**
+     * Render top card of the discard pile from its mirror card code
+     */
+    private fun renderDiscardTop(cardCode: Int) {
+        val cardId = GameStateMirror.rendererCardId(cardCode) ?: return
+        val position = getDiscardPilePosition()
+        rendererBridge.renderCard(cardId, position.x, position.y, CARD_WIDTH, CARD_HEIGHT, true)
+    }
+    
+    /**
+     * Render one hand slot from its mirror card code
+     */
+    private fun renderHandSlot(playerIndex: Int, slotIndex: Int, cardCode: Int) {
+        val cardId = GameStateMirror.cardId(cardCode) ?: return
+        val rendererId = GameStateMirror.rendererCardId(cardCode) ?: return
+        val position = calculateCardPosition(playerIndex, slotIndex)
+        cardPositions[cardId] = position
+        
+        rendererBridge.setCardRotation(rendererId, position.rotation)
+        rendererBridge.renderCard(
+            rendererId,
+            position.x,
+            position.y,
+            CARD_WIDTH,
+            CARD_HEIGHT,
+            GameStateMirror.isFaceUp(cardCode)
+        )
+    }
+    
     /**
      * Render player's hand
      */
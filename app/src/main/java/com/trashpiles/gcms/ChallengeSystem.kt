@@ -163,6 +163,16 @@ object ChallengeSystem {
         generateChallengesForLevels(1..200)
     }
     
+    /**
+     * Install prebuilt challenge sets (e.g. from NativeProgressionCatalog)
+     * instead of generating them
+     */
+    fun loadChallengeSets(sets: List<LevelChallengeSet>) {
+        for (set in sets) {
+            challengeDefinitions[set.level] = set
+        }
+    }
+
     /**
      * Generate challenges for a range of levels
      */
@@ -1,9 +1,8 @@
 package com.trashpiles.gcms
 
 import kotlinx.coroutines.*
+import kotlinx.coroutines.channels.Channel
 import kotlinx.coroutines.flow.*
-import kotlinx.coroutines.sync.Mutex
-import kotlinx.coroutines.sync.withLock
 
 /**
  * GCMS Controller - The authoritative brain of the game
@@ -24,9 +23,22 @@ class GCMSController {
     private val _events = MutableSharedFlow<GCMSEvent>(replay = 0)
     val events: SharedFlow<GCMSEvent> = _events.asSharedFlow()
     
-    // Command queue with thread-safe access
-    private val commandQueue = mutableListOf<GCMSCommand>()
-    private val queueMutex = Mutex()
+    // Commands the native pipeline does not take, drained in order by one
+    // consumer coroutine
+    private val commandQueue = Channel<GCMSCommand>(Channel.UNLIMITED)
+    
+    // Offered every command first; returning true means it was queued on
+    // the native game core, which validates, executes and reports it as
+    // native events
+    var commandSink: ((GCMSCommand) -> Boolean)? = null
+    
+    // Receives the state after every executed command, e.g. to publish it
+    // into the native state mirror
+    var statePublisher: ((GCMSState) -> Unit)? = null
+    
+    // Receives every event synchronously before it is emitted on the flow,
+    // e.g. to forward it to the native event bus
+    var eventPublisher: ((GCMSEvent) -> Unit)? = null
     
     // State history for undo functionality
     private val stateHistory = mutableListOf<GCMSState>()
@@ -35,27 +47,31 @@ class GCMSController {
     // Coroutine scope for async operations
     private val scope = CoroutineScope(Dispatchers.Default + SupervisorJob())
     
+    init {
+        scope.launch {
+            for (command in commandQueue) {
+                handleCommand(command)
+            }
+        }
+    }
+    
     /**
      * Process a command asynchronously
+     * Never blocks or launches per command, so bursts of input queue cheaply
      */
     fun processCommand(command: GCMSCommand) {
-        scope.launch {
-            queueMutex.withLock {
-                commandQueue.add(command)
-            }
-            processQueue()
-        }
+        if (commandSink?.invoke(command) == true) return
+        commandQueue.trySend(command)
     }
     
     /**
-     * Process all commands in the queue
+     * Re-emit events produced by the native game core to Kotlin subscribers
+     * They already went out on the native bus, so eventPublisher is skipped
      */
-    private suspend fun processQueue() {
-        queueMutex.withLock {
-            while (commandQueue.isNotEmpty()) {
-                val command = commandQueue.removeAt(0)
-                handleCommand(command)
-            }
+    fun emitNativeEvents(events: List<GCMSEvent>) {
+        if (events.isEmpty()) return
+        scope.launch {
+            events.forEach { _events.emit(it) }
         }
     }
     
@@ -80,6 +96,9 @@ class GCMSController {
         
         // Step 3: Execute command and update state
         executeCommand(command)
+        
+        // Step 4: Mirror the new state
+        statePublisher?.invoke(_state)
     }
     
     /**
@@ -575,6 +594,7 @@ class GCMSController {
      * Emit an event to all subscribers
      */
     private suspend fun emitEvent(event: GCMSEvent) {
+        eventPublisher?.invoke(event)
         _events.emit(event)
     }
     
@@ -1,5 +1,9 @@
 package com.trashpiles.gcms
 
+import com.trashpiles.native.NativeCardTracker
+import com.trashpiles.native.NativeEndgameTable
+import com.trashpiles.native.NativeTrace
+
 /**
  * Game Rules - Trash Card Game Logic
  * 
@@ -252,8 +256,26 @@ object GameRules {
     
     /**
      * Get AI hint for next move
+     * With a card tracker following the match, a deck draw carries the real
+     * odds of drawing a card that fits as its confidence, and with the
+     * endgame table too, the last one to three face-down slots are played
+     * exactly.
      */
-    fun getAIHint(state: GCMSState, aiPlayerId: Int): AIHint {
+    fun getAIHint(
+        state: GCMSState,
+        aiPlayerId: Int,
+        tracker: NativeCardTracker? = null,
+        endgame: NativeEndgameTable? = null
+    ): AIHint = NativeTrace.section("ai.hint") {
+        computeAIHint(state, aiPlayerId, tracker, endgame)
+    }
+    
+    private fun computeAIHint(
+        state: GCMSState,
+        aiPlayerId: Int,
+        tracker: NativeCardTracker?,
+        endgame: NativeEndgameTable?
+    ): AIHint {
         val player = state.players.firstOrNull { it.id == aiPlayerId }
             ?: return AIHint(
                 action = "draw",
@@ -262,6 +284,17 @@ object GameRules {
                 confidence = 0.5
             )
         
+        if (tracker != null) {
+            endgame?.advise(player, tracker, state.discardPile.lastOrNull())?.let { advice ->
+                return AIHint(
+                    action = "draw",
+                    source = if (advice.takeDiscard) "discard" else "deck",
+                    targetSlot = advice.discardSlot,
+                    confidence = if (advice.takeDiscard) 1.0 else tracker.fitOdds(player).toDouble()
+                )
+            }
+        }
+        
         // Simple AI: Draw from discard if top card fits, otherwise draw from deck
         if (state.discardPile.isNotEmpty()) {
             val topCard = state.discardPile.last()
@@ -286,7 +319,7 @@ object GameRules {
             action = "draw",
             source = "deck",
             targetSlot = null,
-            confidence = 0.5
+            confidence = tracker?.fitOdds(player)?.toDouble() ?: 0.5
         )
     }
 }
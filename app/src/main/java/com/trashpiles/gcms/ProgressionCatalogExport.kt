@@ -0,0 +1,93 @@
+package com.trashpiles.gcms
+
+import java.io.File
+
+/**
+ * Progression Catalog Export - writes the catalogs as the packer's text input
+ *
+ * Dumps SkillAbilityDatabase, TrophySystem and ChallengeSystem in the
+ * tab-separated format tools/progression_packer reads (documented on
+ * ProgressionBlobWriter in progression/progression_blob.h). Enums are
+ * written as ordinals, nulls as "-". The packer turns the text into the
+ * progression.tpprog asset that NativeProgressionCatalog maps at startup.
+ *
+ * Challenges are generated randomly, so an export freezes one draw of
+ * every level's set; re-export to reroll them.
+ *
+ * Regenerate with the export test, then the host packer:
+ *   TRASHPILES_PROGRESSION_CATALOG=$PWD/app/src/main/progression/catalog.tsv \
+ *       ./gradlew testDebugUnitTest --tests '*ProgressionCatalogExportTest*'
+ *   cmake --build build-host --target progression_blob
+ */
+object ProgressionCatalogExport {
+
+    // Where the export test writes the catalog, if set
+    const val CATALOG_ENV = "TRASHPILES_PROGRESSION_CATALOG"
+
+    fun exportTo(file: File, levels: IntRange = 1..200) {
+        file.parentFile?.mkdirs()
+        file.bufferedWriter().use { write(it, levels) }
+    }
+
+    fun write(out: Appendable, levels: IntRange = 1..200) {
+        out.append("# Generated by ProgressionCatalogExport; pack with tools/progression_packer\n")
+
+        SkillAbilityDatabase.allSkillsAndAbilities.values.sortedBy { it.id }.forEach { node ->
+            val ability = node as? AbilityNode
+            val effect = when (node) {
+                is SkillNode -> node.effect.toString()
+                is AbilityNode -> node.effect.toString()
+            }
+            line(
+                out, "node", text(node.id), text(node.name), text(node.description), text(effect),
+                optional(node.trophyId), node.cost, node.levelRequired, node.xpReward, node.pointType.ordinal,
+                node.tier.ordinal, node.category.ordinal, ability?.usesPerMatch ?: "-",
+                ability?.usesPerRound ?: "-", list(node.prerequisites)
+            )
+        }
+
+        TrophySystem.getAllTrophyDefinitions().forEach { definition ->
+            val trophy = definition.trophy
+            val prereqs = definition.prerequisites
+            line(
+                out, "trophy", text(trophy.id), text(trophy.name), text(trophy.description), optional(trophy.icon),
+                trophy.rarity.ordinal, trophy.tier.ordinal, trophy.pointType?.ordinal ?: "-", trophy.xpReward,
+                trophy.pointReward, prereqs.requiredLevel ?: "-", prereqs.minTotalPoints ?: "-",
+                prereqs.minSP ?: "-", prereqs.minAP ?: "-", prereqs.minAbilitiesUnlocked ?: "-",
+                prereqs.minSkillsUnlocked ?: "-", list(prereqs.requiredSkills), list(prereqs.requiredAbilities)
+            )
+        }
+
+        for (level in levels) {
+            val set = ChallengeSystem.getChallengesForLevel(level) ?: ChallengeSystem.generateChallengesForLevel(level)
+            line(out, "set", set.level, set.requiredToComplete)
+            set.challenges.forEach { challenge ->
+                val requirements = challenge.requirements
+                val reward = challenge.reward
+                line(
+                    out, "challenge", text(challenge.id), text(challenge.name), text(challenge.description),
+                    text(reward.achievement), optional(reward.specialReward), challenge.type.ordinal,
+                    challenge.targetLevel, requirements.score, requirements.pointsEarned, requirements.comboCount,
+                    requirements.winStreak, requirements.cardsPlaced, requirements.maxTimeSeconds,
+                    requirements.perfectRounds, reward.pointsBonus, reward.xpBonus,
+                    requirements.abilitiesUsed.entries.joinToString(",") { "${text(it.key)}=${it.value}" }
+                        .ifEmpty { "-" },
+                    list(requirements.skillsUnlocked)
+                )
+            }
+        }
+    }
+
+    private fun line(out: Appendable, vararg fields: Any) {
+        fields.joinTo(out, "\t")
+        out.append('\n')
+    }
+
+    // Tabs, newlines and backslashes would break the record
+    private fun text(value: String): String =
+        value.replace("\\", "\\\\").replace("\t", "\\t").replace("\n", "\\n")
+
+    private fun optional(value: String?): String = if (value == null) "-" else text(value)
+
+    private fun list(ids: List<String>): String = if (ids.isEmpty()) "-" else ids.joinToString(",") { text(it) }
+}
@@ -14,62 +14,54 @@ object SkillAbilityEffectProcessor {
         val progress = state.skillAbilitySystem.playerProgress
         val unlockedSkills = SkillAbilitySystem.getUnlockedSkills(progress)
         
-        var modifiedState = state
-        
-        // Process each passive skill effect
+        // Only immunities change state here: fold every skill's into one
+        // set of flags and copy the state once, not once per effect
+        var immunities = 0
         for (skill in unlockedSkills) {
-            modifiedState = applySkillEffect(skill.effect, modifiedState)
+            immunities = immunities or passiveImmunities(skill.effect)
         }
+        if (immunities == 0) return state
         
-        return modifiedState
+        return state.copy(
+            immuneToDistraction = state.immuneToDistraction || immunities and IMMUNE_DISTRACTION != 0,
+            immuneToOffensiveAbilities = state.immuneToOffensiveAbilities || immunities and IMMUNE_OFFENSIVE != 0,
+            immuneToPenalties = state.immuneToPenalties || immunities and IMMUNE_PENALTIES != 0
+        )
     }
     
-    /**
-     * Apply a single skill effect
-     */
-    private fun applySkillEffect(effect: SkillEffect, state: GCMSState): GCMSState {
-        return when (effect) {
-            is SkillEffect.XP_BOOST -> state // Handled during match completion
-            is SkillEffect.TIMER_BOOST -> state // Handled by UI
-            is SkillEffect.PEEK_DECK -> state // Handled by UI
-            is SkillEffect.SP_BOOST -> state // Handled during match completion
-            is SkillEffect.AP_BOOST -> state // Handled during match completion
-            is SkillEffect.PENALTY_REDUCTION -> state // Handled during penalty calculation
-            is SkillEffect.DICE_BONUS -> state // Handled during dice roll
-            is SkillEffect.STREAK_BONUS -> state // Handled by UI
-            is SkillEffect.POINT_BOOST -> state // Handled during scoring
-            is SkillEffect.DRAW_BONUS -> state // Handled during deck shuffling
-            is SkillEffect.EXTRA_ACTION -> state // Handled during turn processing
-            is SkillEffect.STREAK_DICE_BONUS -> state // Handled during dice roll
-            is SkillEffect.AP_REGENERATION -> state // Handled during round end
-            is SkillEffect.ABILITY_USE_BOOST -> state // Handled during ability usage
-            is SkillEffect.SeeOpponentDiscards -> state // Handled by UI
-            is SkillEffect.SeeOpponentSlot -> state // Handled by UI
-            is SkillEffect.PeekOpponentCard -> state // Handled by UI
-            is SkillEffect.Immunity -> applyImmunityEffect(effect.immunityType, state)
-            else -> state // Effects handled by other systems
-        }
-    }
+    private const val IMMUNE_DISTRACTION = 1
+    private const val IMMUNE_OFFENSIVE = 2
+    private const val IMMUNE_PENALTIES = 4
     
     /**
-     * Apply immunity effect
+     * Immunity flags a passive skill effect grants
      */
-    private fun applyImmunityEffect(immunityType: ImmunityType, state: GCMSState): GCMSState {
-        return when (immunityType) {
-            ImmunityType.DISTRACTION -> state.copy(
-                immuneToDistraction = true
-            )
-            ImmunityType.OFFENSIVE_ABILITIES -> state.copy(
-                immuneToOffensiveAbilities = true
-            )
-            ImmunityType.PENALTIES -> state.copy(
-                immuneToPenalties = true
-            )
-            ImmunityType.ALL_EFFECTS -> state.copy(
-                immuneToDistraction = true,
-                immuneToOffensiveAbilities = true,
-                immuneToPenalties = true
-            )
+    private fun passiveImmunities(effect: SkillEffect): Int {
+        return when (effect) {
+            is SkillEffect.XP_BOOST -> 0 // Handled during match completion
+            is SkillEffect.TIMER_BOOST -> 0 // Handled by UI
+            is SkillEffect.PEEK_DECK -> 0 // Handled by UI
+            is SkillEffect.SP_BOOST -> 0 // Handled during match completion
+            is SkillEffect.AP_BOOST -> 0 // Handled during match completion
+            is SkillEffect.PENALTY_REDUCTION -> 0 // Handled during penalty calculation
+            is SkillEffect.DICE_BONUS -> 0 // Handled during dice roll
+            is SkillEffect.STREAK_BONUS -> 0 // Handled by UI
+            is SkillEffect.POINT_BOOST -> 0 // Handled during scoring
+            is SkillEffect.DRAW_BONUS -> 0 // Handled during deck shuffling
+            is SkillEffect.EXTRA_ACTION -> 0 // Handled during turn processing
+            is SkillEffect.STREAK_DICE_BONUS -> 0 // Handled during dice roll
+            is SkillEffect.AP_REGENERATION -> 0 // Handled during round end
+            is SkillEffect.ABILITY_USE_BOOST -> 0 // Handled during ability usage
+            is SkillEffect.SeeOpponentDiscards -> 0 // Handled by UI
+            is SkillEffect.SeeOpponentSlot -> 0 // Handled by UI
+            is SkillEffect.PeekOpponentCard -> 0 // Handled by UI
+            is SkillEffect.Immunity -> when (effect.immunityType) {
+                ImmunityType.DISTRACTION -> IMMUNE_DISTRACTION
+                ImmunityType.OFFENSIVE_ABILITIES -> IMMUNE_OFFENSIVE
+                ImmunityType.PENALTIES -> IMMUNE_PENALTIES
+                ImmunityType.ALL_EFFECTS -> IMMUNE_DISTRACTION or IMMUNE_OFFENSIVE or IMMUNE_PENALTIES
+            }
+            else -> 0 // Effects handled by other systems
         }
     }
     
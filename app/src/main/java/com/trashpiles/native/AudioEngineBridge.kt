@@ -1,26 +1,49 @@
 package com.trashpiles.native
 
+import android.content.res.AssetManager
+
 /**
  * JNI Bridge to Oboe Audio Engine
- * Handles all audio playback
+ * Handles all audio playback. The native audio engine is a singleton owned
+ * by the engine context, so no handle is passed.
  */
 class AudioEngineBridge {
     
-    // Initialization
+    // Initialization; set the asset manager before initAudioEngine so the
+    // sound banks can load
+    external fun setAssetManager(assetManager: AssetManager)
     external fun initAudioEngine(): Boolean
     external fun cleanup()
     
     // Sound effects
-    external fun playSound(soundName: String)
-    external fun stopSound(soundName: String)
+    // Register each name once; play/stop/query take the returned id
+    external fun registerSound(soundName: String): Int  // -1 if the table is full
+    external fun playSound(soundId: Int, volume: Float)
+    external fun stopSound(soundId: Int)
+    external fun isSoundPlaying(soundId: Int): Boolean
     external fun stopAllSounds()
     
+    // Plays soundId on the audio thread whenever a native event of this type
+    // (NativeEventBus.TYPE_*) is published; -1 unbinds
+    external fun bindEventSound(eventType: Int, soundId: Int, volume: Float)
+    
     // Background music
     external fun playMusic(musicName: String, loop: Boolean)
     external fun stopMusic()
     external fun pauseMusic()
     external fun resumeMusic()
     
+    // Audio clock
+    // Frames rendered on the sound stream; the *At calls start or stop exactly
+    // on a frame of this clock (FRAME_NOW for the next buffer)
+    external fun getFramePosition(): Long
+    external fun getOutputSampleRate(): Int
+    external fun playSoundAt(soundId: Int, frame: Long, volume: Float)
+    external fun stopSoundAt(soundId: Int, frame: Long)
+    external fun playMusicAt(musicName: String, frame: Long, loop: Boolean)
+    external fun crossfadeMusic(musicName: String, frame: Long, fadeFrames: Int, loop: Boolean)
+    external fun stopMusicAt(frame: Long, fadeFrames: Int)
+    
     // Volume control
     external fun setSoundVolume(volume: Float)  // 0.0 to 1.0
     external fun setMusicVolume(volume: Float)  // 0.0 to 1.0
@@ -28,8 +51,21 @@ class AudioEngineBridge {
     
     // State
     external fun isMusicPlaying(): Boolean
+    external fun isSoundBankReady(): Boolean  // Banks preload in the background
+    
+    // Resident sample memory: [soundCount, soundBytes, musicCount, musicBytes]
+    external fun getMemoryStats(): LongArray
+    
+    // Output stream health, sound stream then music stream, 25 values each:
+    // [callbackCount, xrunCount, bufferSizeFrames, framesPerBurst, bufferCapacityFrames,
+    //  lowestStableFrames, latencyMicros, callbackMeanMicros, callbackMaxMicros,
+    //  16 callback duration buckets (log2 microseconds)]
+    // xrunCount and latencyMicros are -1 where the device cannot report them
+    external fun getPerformanceStats(): LongArray
     
     companion object {
+        const val FRAME_NOW = -1L
+        
         init {
             // Library loaded by NativeEngineWrapper
         }
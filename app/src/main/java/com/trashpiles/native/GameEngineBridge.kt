@@ -1,5 +1,7 @@
 package com.trashpiles.native
 
+import java.nio.ByteBuffer
+
 /**
  * JNI Bridge to Game Engine
  * Provides native support functions for libGDX
@@ -22,6 +24,36 @@ class GameEngineBridge {
     external fun getDeltaTime(): Float
     external fun getFPS(): Int
     
+    // Shared game state block, wrapped by GameStateMirror
+    external fun getStateBuffer(): ByteBuffer
+    external fun publishState(fields: IntArray, hands: ByteArray, lastActionTime: Long): Boolean
+    
+    // Native event bus, wrapped by NativeEventBus
+    external fun publishEvent(type: Int, playerId: Int, card: Int, slot: Int, value: Int, volume: Float): Boolean
+    
+    // Native game core, wrapped by NativeCommandPipeline. Commands run on the
+    // next update(); pollEvents fills 5 ints per event and returns the count.
+    external fun submitCommand(type: Int, playerId: Int, card: Int, slot: Int, value: Int, flags: Int): Boolean
+    external fun pollEvents(out: IntArray): Int
+    // [queued, rejected by a full queue, ticks, executed, rejected by rules, largest batch]
+    external fun getCommandStats(): LongArray
+    // AI hint for the core's position: out = [1 take discard / 0 draw deck,
+    // target slot or -1, confidence]; false if the player is not in the match.
+    // Repeats for an unchanged position are cached. Call from the game thread
+    external fun requestHint(playerId: Int, out: FloatArray): Boolean
+    // [probes, hits, stores, stores that evicted another position, capacity]
+    external fun getHintCacheStats(): LongArray
+    // [workers (0 before the first update), frame tasks, jobs executed, stolen, run inline]
+    // Call from the game thread
+    external fun getJobStats(): LongArray
+    // Heap allocations per rendered frame; all zero unless the native library
+    // was built with TRASHPILES_ALLOC_TRACKING.
+    // [hooked (1/0), frames, allocation-free frames, most in one frame,
+    //  last frame allocations, last frame bytes,
+    //  last frame by subsystem (other, renderer, audio, game, jni, jobs),
+    //  frames with 0, 1, <=3, <=7, <=15, <=31, <=63, more allocations]
+    external fun getAllocStats(): LongArray
+    
     companion object {
         init {
             // Library loaded by NativeEngineWrapper
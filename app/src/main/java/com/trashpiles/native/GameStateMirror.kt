@@ -0,0 +1,241 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.CardState
+import com.trashpiles.gcms.DeckBuilder
+import com.trashpiles.gcms.GCMSState
+import com.trashpiles.gcms.GamePhase
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+/**
+ * Game State Mirror - zero-copy view of the native game state block
+ *
+ * The native core keeps a flat, seqlock-versioned copy of the game state
+ * (gcms/state_block.h) in memory exposed as a direct ByteBuffer. Accessors
+ * read straight from that memory; wrap them in read { } to get a consistent
+ * view. Each section carries the sequence at which it last changed, so the
+ * UI can skip everything it has already drawn.
+ */
+class GameStateMirror(private val bridge: GameEngineBridge) {
+
+    companion object {
+        // StateBlockData layout; pinned by static_asserts in state_block.cpp
+        private const val MAGIC = 0x42535054
+        private const val LAYOUT_VERSION = 1
+        private const val OFFSET_MAGIC = 0
+        private const val OFFSET_LAYOUT_VERSION = 4
+        private const val OFFSET_SEQUENCE = 8
+        private const val OFFSET_SECTION_VERSIONS = 12
+        private const val OFFSET_PHASE = 32
+        private const val OFFSET_CURRENT_PLAYER = 36
+        private const val OFFSET_ROUND = 40
+        private const val OFFSET_WINNER = 44
+        private const val OFFSET_INPUT_LOCKED = 48
+        private const val OFFSET_PLAYER_COUNT = 52
+        private const val OFFSET_LAST_ACTION_TIME = 56
+        private const val OFFSET_DECK_COUNT = 64
+        private const val OFFSET_DISCARD_COUNT = 68
+        private const val OFFSET_DISCARD_TOP = 72
+        private const val OFFSET_PLAYERS = 80
+        private const val PLAYER_STRIDE = 16
+        private const val OFFSET_HANDS = 144
+
+        const val MAX_PLAYERS = 4
+        const val MAX_HAND_SLOTS = 10
+
+        // Sections, versioned independently
+        const val SECTION_MATCH = 0
+        const val SECTION_PILES = 1
+        const val SECTION_PLAYERS = 2
+        const val SECTION_HANDS = 3
+        const val SECTION_COUNT = 4
+
+        // Card codes: rank index * 4 + suit index in DeckBuilder order
+        const val NO_CARD = -1
+        const val CARD_FACE_UP = 0x40
+
+        private const val PLAYER_IS_AI = 1
+        private const val PLAYER_FINISHED = 2
+
+        // Fields passed to publishState, see game_engine_jni.cpp
+        private const val MATCH_FIELDS = 9
+        private const val PLAYER_FIELDS = 4
+
+        fun cardCode(card: CardState): Int {
+            val rank = DeckBuilder.ranks.indexOf(card.rank)
+            val suit = DeckBuilder.suits.indexOf(card.suit)
+            if (rank < 0 || suit < 0) return NO_CARD
+            return rank * 4 + suit + if (card.isFaceUp) CARD_FACE_UP else 0
+        }
+
+        // From a card id string ("rank_of_suit"), as carried by events
+        fun cardCode(cardId: String, faceUp: Boolean = false): Int {
+            val separator = cardId.indexOf("_of_")
+            if (separator < 0) return NO_CARD
+            val rank = DeckBuilder.ranks.indexOf(cardId.substring(0, separator))
+            val suit = DeckBuilder.suits.indexOf(cardId.substring(separator + 4))
+            if (rank < 0 || suit < 0) return NO_CARD
+            return rank * 4 + suit + if (faceUp) CARD_FACE_UP else 0
+        }
+
+        fun cardId(code: Int): String? {
+            if (code == NO_CARD) return null
+            val index = code and (CARD_FACE_UP - 1)
+            return "${DeckBuilder.ranks[index / 4]}_of_${DeckBuilder.suits[index % 4]}"
+        }
+
+        fun isFaceUp(code: Int): Boolean = code != NO_CARD && (code and CARD_FACE_UP) != 0
+
+        // Renderer card id (suit * 13 + value, suits spades, hearts, diamonds,
+        // clubs), as rendererCardId in renderer_wrapper.cpp
+        fun rendererCardId(code: Int): Int? {
+            if (code == NO_CARD) return null
+            val index = code and (CARD_FACE_UP - 1)
+            return RENDERER_SUIT_ORDER[index % 4] * 13 + index / 4
+        }
+
+        private val RENDERER_SUIT_ORDER = intArrayOf(0, 1, 3, 2)
+    }
+
+    private val buffer: ByteBuffer = bridge.getStateBuffer().order(ByteOrder.nativeOrder())
+
+    // Publish scratch, reused since there is a single writer
+    private val publishFields = IntArray(MATCH_FIELDS + PLAYER_FIELDS * MAX_PLAYERS)
+    private val publishHands = ByteArray(MAX_PLAYERS * MAX_HAND_SLOTS)
+
+    // ByteBuffer has no acquire loads before API 33. Volatile accesses order
+    // the plain buffer reads around the sequence checks instead.
+    @Volatile
+    private var fence = 0
+
+    init {
+        require(buffer.getInt(OFFSET_MAGIC) == MAGIC && buffer.getInt(OFFSET_LAYOUT_VERSION) == LAYOUT_VERSION) {
+            "Native state block layout does not match"
+        }
+    }
+
+    // ========================================================================
+    // WRITER
+    // ========================================================================
+
+    /**
+     * Flatten a state snapshot into the native block
+     * Returns false if nothing the mirror carries changed
+     */
+    fun publish(state: GCMSState): Boolean {
+        val fields = publishFields
+        fields[0] = state.currentPhase.ordinal
+        fields[1] = state.currentPlayerIndex
+        fields[2] = state.currentRound
+        fields[3] = state.winnerId ?: -1
+        fields[4] = if (state.isInputLocked) 1 else 0
+        fields[5] = minOf(state.players.size, MAX_PLAYERS)
+        fields[6] = state.deck.size
+        fields[7] = state.discardPile.size
+        fields[8] = state.discardPile.lastOrNull()?.let { cardCode(it) } ?: NO_CARD
+
+        publishHands.fill(NO_CARD.toByte())
+        for (index in 0 until MAX_PLAYERS) {
+            val base = MATCH_FIELDS + index * PLAYER_FIELDS
+            val player = state.players.getOrNull(index)
+            fields[base] = player?.id ?: 0
+            fields[base + 1] = player?.score ?: 0
+            fields[base + 2] = if (player == null) 0 else
+                (if (player.isAI) PLAYER_IS_AI else 0) or (if (player.hasFinished) PLAYER_FINISHED else 0)
+            fields[base + 3] = player?.hand?.size ?: 0
+
+            player?.hand?.take(MAX_HAND_SLOTS)?.forEachIndexed { slot, card ->
+                publishHands[index * MAX_HAND_SLOTS + slot] = cardCode(card).toByte()
+            }
+        }
+
+        return bridge.publishState(fields, publishHands, state.lastActionTime ?: 0L)
+    }
+
+    // ========================================================================
+    // READER
+    // ========================================================================
+
+    /**
+     * Run a block of accessor reads against one consistent version of the
+     * state. The block may run more than once, so it must only read.
+     */
+    inline fun <T> read(block: GameStateMirror.() -> T): T {
+        while (true) {
+            val before = sequence()
+            acquireFence()
+            if (before and 1 != 0) {
+                Thread.yield()
+                continue
+            }
+
+            val result = block()
+            fullFence()
+            if (sequence() == before) return result
+        }
+    }
+
+    @PublishedApi
+    internal fun sequence(): Int = buffer.getInt(OFFSET_SEQUENCE)
+
+    @PublishedApi
+    internal fun acquireFence(): Int = fence
+
+    @PublishedApi
+    internal fun fullFence(): Int {
+        fence = 0
+        return fence
+    }
+
+    // Sequence at which a section last changed; unchanged sections keep theirs
+    fun sectionVersion(section: Int): Int = buffer.getInt(OFFSET_SECTION_VERSIONS + section * 4)
+
+    fun sectionVersions(out: IntArray) {
+        for (section in 0 until SECTION_COUNT) {
+            out[section] = sectionVersion(section)
+        }
+    }
+
+    // Match
+    val phase: GamePhase
+        get() = GamePhase.values()[buffer.getInt(OFFSET_PHASE)]
+    val currentPlayerIndex: Int
+        get() = buffer.getInt(OFFSET_CURRENT_PLAYER)
+    val currentRound: Int
+        get() = buffer.getInt(OFFSET_ROUND)
+    val winnerId: Int?
+        get() = buffer.getInt(OFFSET_WINNER).takeIf { it >= 0 }
+    val isInputLocked: Boolean
+        get() = buffer.getInt(OFFSET_INPUT_LOCKED) != 0
+    val playerCount: Int
+        get() = buffer.getInt(OFFSET_PLAYER_COUNT)
+    val lastActionTime: Long
+        get() = buffer.getLong(OFFSET_LAST_ACTION_TIME)
+
+    // Piles
+    val deckCount: Int
+        get() = buffer.getInt(OFFSET_DECK_COUNT)
+    val discardCount: Int
+        get() = buffer.getInt(OFFSET_DISCARD_COUNT)
+    val discardTop: Int
+        get() = buffer.getInt(OFFSET_DISCARD_TOP)
+
+    // Players
+    fun playerId(player: Int): Int = buffer.getInt(OFFSET_PLAYERS + player * PLAYER_STRIDE)
+    fun playerScore(player: Int): Int = buffer.getInt(OFFSET_PLAYERS + player * PLAYER_STRIDE + 4)
+    fun isPlayerAI(player: Int): Boolean = playerFlags(player) and PLAYER_IS_AI != 0
+    fun hasPlayerFinished(player: Int): Boolean = playerFlags(player) and PLAYER_FINISHED != 0
+    fun handCount(player: Int): Int = buffer.getInt(OFFSET_PLAYERS + player * PLAYER_STRIDE + 12)
+
+    private fun playerFlags(player: Int): Int = buffer.getInt(OFFSET_PLAYERS + player * PLAYER_STRIDE + 8)
+
+    // Hands
+    fun handCard(player: Int, slot: Int): Int =
+        buffer.get(OFFSET_HANDS + player * MAX_HAND_SLOTS + slot).toInt()
+
+    fun copyHands(out: ByteArray) {
+        for (i in 0 until MAX_PLAYERS * MAX_HAND_SLOTS) {
+            out[i] = buffer.get(OFFSET_HANDS + i)
+        }
+    }
+}
@@ -0,0 +1,121 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.CardDealtEvent
+import com.trashpiles.gcms.CardDiscardedEvent
+import com.trashpiles.gcms.CardDrawnEvent
+import com.trashpiles.gcms.CardFlippedEvent
+import com.trashpiles.gcms.CardPlacedEvent
+import com.trashpiles.gcms.GCMSEvent
+import com.trashpiles.gcms.GameStartedEvent
+import com.trashpiles.gcms.PlayerState
+
+/**
+ * Native Card Tracker - what each player can know about the unseen cards
+ *
+ * Follows the card events into a native tracker (gcms/card_tracker.h) that
+ * keeps, per seat, the cards whose place that seat knows: everything face
+ * up, plus the card it drew from the deck. The odds of the next deck card
+ * come from those in O(1) per event and query, rather than a rescan of the
+ * piles, for AI decisions and hint confidence.
+ *
+ * Seats follow the order of playerIds; any other id gets the public view.
+ * The native library must already be loaded (NativeEngineWrapper); call
+ * close() at the end of the match.
+ */
+class NativeCardTracker(playerIds: List<Int>) : AutoCloseable {
+
+    private val seats: Map<Int, Int> = playerIds.withIndex().associate { it.value to it.index }
+    private val odds = FloatArray(RANK_COUNT)
+    private var handle: Long
+
+    init {
+        require(playerIds.size <= MAX_OBSERVERS) { "Card tracker holds at most $MAX_OBSERVERS players" }
+        handle = nativeCreate()
+        check(handle != 0L) { "Native card tracker could not be created" }
+    }
+
+    /** A fresh shuffled deck, nothing seen */
+    fun reset() = nativeReset(handle)
+
+    /**
+     * Follow one event; anything but the round start and card events is
+     * ignored
+     */
+    fun observe(event: GCMSEvent) {
+        when (event) {
+            is GameStartedEvent -> send(NativeEventBus.TYPE_GAME_STARTED)
+            is CardDealtEvent -> send(NativeEventBus.TYPE_CARD_DEALT, seat(event.toPlayerId))
+            is CardDrawnEvent -> send(NativeEventBus.TYPE_CARD_DRAWN, seat(event.byPlayerId),
+                GameStateMirror.cardCode(event.cardId), if (event.fromPile == "discard") 1 else 0)
+            is CardPlacedEvent -> {
+                send(NativeEventBus.TYPE_CARD_PLACED, seat(event.playerId),
+                    GameStateMirror.cardCode(event.cardId, faceUp = true))
+                event.replacedCardId?.let {
+                    send(NativeEventBus.TYPE_CARD_FLIPPED, card = GameStateMirror.cardCode(it, faceUp = true), value = 1)
+                }
+            }
+            is CardFlippedEvent -> send(NativeEventBus.TYPE_CARD_FLIPPED,
+                card = GameStateMirror.cardCode(event.cardId), value = if (event.isFaceUp) 1 else 0)
+            is CardDiscardedEvent -> send(NativeEventBus.TYPE_CARD_DISCARDED, seat(event.byPlayerId),
+                GameStateMirror.cardCode(event.cardId, faceUp = true))
+            else -> Unit
+        }
+    }
+
+    /** The discard pile below its top card went back into the deck */
+    fun reshuffled() = send(NativeEventBus.TYPE_DECK_RESHUFFLED)
+
+    fun unseenCount(playerId: Int): Int = nativeUnseenCount(handle, seat(playerId))
+
+    /** Bit rank * 4 + suit set for each card the player knows the place of */
+    fun seenMask(playerId: Int): Long = nativeSeen(handle, seat(playerId))
+
+    /**
+     * Chance the next deck card has each rank, ace first; the returned array
+     * is reused by the next call
+     */
+    fun rankOdds(playerId: Int): FloatArray {
+        nativeRankOdds(handle, seat(playerId), odds)
+        return odds
+    }
+
+    /** Chance the next deck card can go in one of the player's face-down slots */
+    fun fitOdds(player: PlayerState): Float {
+        var emptySlots = 0
+        player.hand.forEachIndexed { slot, card -> if (!card.isFaceUp) emptySlots = emptySlots or (1 shl slot) }
+        return nativeFitOdds(handle, seat(player.id), emptySlots)
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    // For NativeEndgameTable, which reads the tracker natively
+    internal val nativeHandle: Long get() = handle
+
+    internal fun seat(playerId: Int): Int = seats[playerId] ?: NONE
+
+    private fun send(type: Int, player: Int = NONE, card: Int = GameStateMirror.NO_CARD, value: Int = 0) =
+        nativeObserve(handle, type, player, card, NONE, value)
+
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeReset(handle: Long)
+    private external fun nativeObserve(handle: Long, type: Int, player: Int, card: Int, slot: Int, value: Int)
+    private external fun nativeUnseenCount(handle: Long, observer: Int): Int
+    private external fun nativeSeen(handle: Long, observer: Int): Long
+    private external fun nativeRankOdds(handle: Long, observer: Int, odds: FloatArray)
+    private external fun nativeFitOdds(handle: Long, observer: Int, emptySlots: Int): Float
+
+    companion object {
+        // CardTracker::kMaxObservers
+        const val MAX_OBSERVERS = 4
+        // CardTracker::kRankCount
+        const val RANK_COUNT = 13
+
+        private const val NONE = -1
+    }
+}
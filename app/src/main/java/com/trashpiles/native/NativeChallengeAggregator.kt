@@ -0,0 +1,126 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.Challenge
+import com.trashpiles.gcms.LevelChallengeSet
+
+/**
+ * Native Challenge Aggregator - typed challenge progress for one level set
+ *
+ * Each ChallengeRequirements entry becomes a goal with its own counter in
+ * one flat native array, subscribed to the event that feeds it
+ * (progression/challenge_aggregator.h). Events arrive as typed calls
+ * instead of a String plus Map<String, Any>, touch only the counters that
+ * listen to them, and report a challenge the moment its last goal crosses
+ * its target; nothing is copied per event.
+ *
+ * Counters start at zero, as for a set fresh from
+ * ChallengeSystem.assignChallengesForLevel. The native library must already
+ * be loaded (NativeEngineWrapper); call close() when the set is replaced.
+ */
+class NativeChallengeAggregator(challengeSet: LevelChallengeSet) : AutoCloseable {
+
+    /** ChallengeEvent ordinals; names follow updateProgressForEvent */
+    enum class Event {
+        SCORE_EARNED,
+        ABILITY_USED,
+        SKILL_UNLOCKED,
+        POINTS_EARNED,
+        COMBO_ACHIEVED,
+        GAME_WON,
+        CARD_PLACED,
+        TIME_ELAPSED,
+        PERFECT_ROUND
+    }
+
+    /** Challenges by native challenge id */
+    val challenges: List<Challenge> = challengeSet.challenges
+
+    // Ability and skill ids interned as goal keys
+    private val keys = HashMap<String, Int>()
+    private var handle: Long
+
+    init {
+        require(challenges.size <= MAX_CHALLENGES) { "Aggregator holds at most $MAX_CHALLENGES challenges" }
+
+        val goals = ArrayList<Int>()
+        fun goal(challenge: Int, event: Event, target: Int, key: Int = -1, atMost: Boolean = false) {
+            goals.add(challenge)
+            goals.add(event.ordinal)
+            goals.add(key)
+            goals.add(target)
+            goals.add(if (atMost) 1 else 0)
+        }
+
+        challenges.forEachIndexed { id, challenge ->
+            val requirements = challenge.requirements
+            // Zero targets are met from the start and need no counter
+            if (requirements.score > 0) goal(id, Event.SCORE_EARNED, requirements.score)
+            requirements.abilitiesUsed.forEach { (abilityId, uses) ->
+                goal(id, Event.ABILITY_USED, uses, keyOf(abilityId))
+            }
+            requirements.skillsUnlocked.forEach { skillId ->
+                goal(id, Event.SKILL_UNLOCKED, 1, keyOf(skillId))
+            }
+            if (requirements.pointsEarned > 0) goal(id, Event.POINTS_EARNED, requirements.pointsEarned)
+            if (requirements.comboCount > 0) goal(id, Event.COMBO_ACHIEVED, requirements.comboCount)
+            if (requirements.winStreak > 0) goal(id, Event.GAME_WON, requirements.winStreak)
+            if (requirements.cardsPlaced > 0) goal(id, Event.CARD_PLACED, requirements.cardsPlaced)
+            if (requirements.maxTimeSeconds > 0) {
+                goal(id, Event.TIME_ELAPSED, requirements.maxTimeSeconds, atMost = true)
+            }
+            if (requirements.perfectRounds > 0) goal(id, Event.PERFECT_ROUND, requirements.perfectRounds)
+        }
+
+        handle = nativeCreate(challenges.size, goals.toIntArray())
+        check(handle != 0L) { "Native challenge aggregator rejected the challenge set" }
+    }
+
+    // Each call returns the challenges it completed
+    fun scoreEarned(score: Int): List<Challenge> = dispatch(Event.SCORE_EARNED, -1, score)
+    fun abilityUsed(abilityId: String): List<Challenge> = dispatch(Event.ABILITY_USED, keys[abilityId] ?: -1, 1)
+    fun skillUnlocked(skillId: String): List<Challenge> = dispatch(Event.SKILL_UNLOCKED, keys[skillId] ?: -1, 1)
+    fun pointsEarned(points: Int): List<Challenge> = dispatch(Event.POINTS_EARNED, -1, points)
+    fun comboAchieved(comboCount: Int): List<Challenge> = dispatch(Event.COMBO_ACHIEVED, -1, comboCount)
+    fun gameWon(currentStreak: Int): List<Challenge> = dispatch(Event.GAME_WON, -1, currentStreak)
+    fun cardPlaced(): List<Challenge> = dispatch(Event.CARD_PLACED, -1, 1)
+    fun timeElapsed(seconds: Int): List<Challenge> = dispatch(Event.TIME_ELAPSED, -1, seconds)
+    fun perfectRound(): List<Challenge> = dispatch(Event.PERFECT_ROUND, -1, 1)
+
+    fun completedChallenges(): List<Challenge> = challengesIn(nativeCompleted(handle))
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private fun keyOf(id: String): Int = keys.getOrPut(id) { keys.size }
+
+    private fun dispatch(event: Event, key: Int, amount: Int): List<Challenge> {
+        val completed = nativeDispatch(handle, event.ordinal, key, amount)
+        return if (completed == 0L) emptyList() else challengesIn(completed)
+    }
+
+    private fun challengesIn(bits: Long): List<Challenge> {
+        val result = ArrayList<Challenge>()
+        var remaining = bits
+        while (remaining != 0L) {
+            val id = java.lang.Long.numberOfTrailingZeros(remaining)
+            if (id < challenges.size) result.add(challenges[id])
+            remaining = remaining and (remaining - 1)
+        }
+        return result
+    }
+
+    private external fun nativeCreate(challengeCount: Int, goals: IntArray): Long
+    private external fun nativeDestroy(handle: Long)
+    // Challenge sets are one long, bit n for challenge n
+    private external fun nativeDispatch(handle: Long, event: Int, key: Int, amount: Int): Long
+    private external fun nativeCompleted(handle: Long): Long
+
+    companion object {
+        // ChallengeAggregator::kMaxChallenges
+        const val MAX_CHALLENGES = 64
+    }
+}
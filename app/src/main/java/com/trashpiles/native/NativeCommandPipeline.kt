@@ -0,0 +1,203 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.AIHint
+import com.trashpiles.gcms.CardDealtEvent
+import com.trashpiles.gcms.CardDiscardedEvent
+import com.trashpiles.gcms.CardDrawnEvent
+import com.trashpiles.gcms.CardFlippedEvent
+import com.trashpiles.gcms.CardPlacedEvent
+import com.trashpiles.gcms.DiscardCardCommand
+import com.trashpiles.gcms.DrawCardCommand
+import com.trashpiles.gcms.EndGameCommand
+import com.trashpiles.gcms.EndTurnCommand
+import com.trashpiles.gcms.FlipCardCommand
+import com.trashpiles.gcms.GCMSCommand
+import com.trashpiles.gcms.GCMSEvent
+import com.trashpiles.gcms.GameOverEvent
+import com.trashpiles.gcms.GameStartedEvent
+import com.trashpiles.gcms.InitializeGameCommand
+import com.trashpiles.gcms.InvalidMoveEvent
+import com.trashpiles.gcms.PauseGameCommand
+import com.trashpiles.gcms.PlaceCardCommand
+import com.trashpiles.gcms.ResetGameCommand
+import com.trashpiles.gcms.ResumeGameCommand
+import com.trashpiles.gcms.SkipTurnCommand
+import com.trashpiles.gcms.StartGameCommand
+import com.trashpiles.gcms.TurnEndedEvent
+import com.trashpiles.gcms.TurnStartedEvent
+
+/**
+ * Native Command Pipeline - routes game commands to the native game core
+ *
+ * Commands are pushed onto a lock-free native queue from any thread and
+ * drained in one batch per tick, where they are validated and executed
+ * against the native state (gcms/game_core.h). Results come back as native
+ * events: the audio and renderer consume them directly, and poll() turns
+ * them into GCMSEvents for Kotlin subscribers. State is read through
+ * GameStateMirror, which the core publishes once per batch.
+ */
+class NativeCommandPipeline(private val bridge: GameEngineBridge) {
+
+    companion object {
+        // GameCommandType values in gcms/command_queue.h
+        const val COMMAND_INITIALIZE_GAME = 0
+        const val COMMAND_START_GAME = 1
+        const val COMMAND_DRAW_CARD = 2
+        const val COMMAND_PLACE_CARD = 3
+        const val COMMAND_DISCARD_CARD = 4
+        const val COMMAND_FLIP_CARD = 5
+        const val COMMAND_END_TURN = 6
+        const val COMMAND_SKIP_TURN = 7
+        const val COMMAND_PAUSE_GAME = 8
+        const val COMMAND_RESUME_GAME = 9
+        const val COMMAND_END_GAME = 10
+        const val COMMAND_RESET_GAME = 11
+
+        // RulesVariant values in gcms/rules_policy.h
+        const val RULES_CLASSIC = 0
+        const val RULES_QUICK = 1
+
+        // CommandResult values in gcms/game_core.h, carried by InvalidMove events
+        private val REJECTION_REASONS = listOf(
+            "Ok", "Input is locked", "Not allowed in this phase", "Not your turn",
+            "Player not found", "Invalid player count", "Pile is empty", "Invalid slot index",
+            "Slot already filled", "Card does not match slot", "No card drawn",
+            "Card already drawn", "Unknown command", "Unknown rules variant"
+        )
+
+        private const val EVENT_FIELDS = 5
+        private const val MAX_EVENTS = 128
+        private const val NONE = -1
+    }
+
+    private val eventScratch = IntArray(EVENT_FIELDS * MAX_EVENTS)
+    private val hintScratch = FloatArray(3)
+    private var playerNames: List<String> = emptyList()
+
+    /**
+     * Rules for matches initialized from now on (RULES_*); the core compiles
+     * each variant's rules separately and picks them once per match
+     */
+    var rulesVariant: Int = RULES_CLASSIC
+
+    /**
+     * Queue a command natively
+     * Returns false for commands the core does not handle (they stay on the
+     * Kotlin path) or when the native queue is full
+     */
+    fun submit(command: GCMSCommand): Boolean = when (command) {
+        is InitializeGameCommand -> {
+            playerNames = command.playerNames
+            val aiMask = command.isAI.foldIndexed(0) { index, mask, isAI ->
+                if (isAI) mask or (1 shl index) else mask
+            }
+            send(COMMAND_INITIALIZE_GAME, slot = rulesVariant, value = command.playerCount, flags = aiMask)
+        }
+        is StartGameCommand -> send(COMMAND_START_GAME)
+        is DrawCardCommand -> send(COMMAND_DRAW_CARD, command.playerId,
+            value = if (command.fromPile == "discard") 1 else 0)
+        is PlaceCardCommand -> send(COMMAND_PLACE_CARD, command.playerId,
+            card = GameStateMirror.cardCode(command.cardId), slot = command.slotIndex)
+        is DiscardCardCommand -> send(COMMAND_DISCARD_CARD, command.playerId)
+        is FlipCardCommand -> send(COMMAND_FLIP_CARD, command.playerId, slot = command.slotIndex)
+        is EndTurnCommand -> send(COMMAND_END_TURN, command.playerId)
+        is SkipTurnCommand -> send(COMMAND_SKIP_TURN, command.playerId)
+        is PauseGameCommand -> send(COMMAND_PAUSE_GAME)
+        is ResumeGameCommand -> send(COMMAND_RESUME_GAME)
+        is EndGameCommand -> send(COMMAND_END_GAME)
+        is ResetGameCommand -> send(COMMAND_RESET_GAME)
+        else -> false
+    }
+
+    /**
+     * Run the core for one tick, then collect what it reported
+     * Call once per frame from the game thread
+     */
+    fun tick(deltaTime: Float): List<GCMSEvent> {
+        bridge.update(deltaTime)
+        return poll()
+    }
+
+    /**
+     * Events the core published since the last poll, as GCMSEvents
+     */
+    fun poll(): List<GCMSEvent> {
+        val events = ArrayList<GCMSEvent>()
+        while (true) {
+            val count = bridge.pollEvents(eventScratch)
+            for (i in 0 until count) {
+                toEvent(i * EVENT_FIELDS)?.let { events.add(it) }
+            }
+            if (count < MAX_EVENTS) return events
+        }
+    }
+
+    /**
+     * The core's hint for a player in the current native position, or null
+     * if the player is not in the match. A repeat request for an unchanged
+     * position (UI re-request, pause and resume) is answered from the native
+     * hint cache. Call from the game thread.
+     */
+    fun requestHint(playerId: Int): AIHint? {
+        if (!bridge.requestHint(playerId, hintScratch)) return null
+        val slot = hintScratch[1].toInt()
+        return AIHint(
+            action = "draw",
+            source = if (hintScratch[0] != 0f) "discard" else "deck",
+            targetSlot = if (slot >= 0) slot else null,
+            confidence = hintScratch[2].toDouble()
+        )
+    }
+
+    private fun toEvent(base: Int): GCMSEvent? {
+        val fields = eventScratch
+        val player = fields[base + 1]
+        val card = fields[base + 2]
+        val slot = fields[base + 3]
+        val value = fields[base + 4]
+        val cardId = GameStateMirror.cardId(card) ?: ""
+
+        return when (fields[base]) {
+            NativeEventBus.TYPE_GAME_STARTED -> GameStartedEvent()
+            NativeEventBus.TYPE_GAME_ENDED -> GameOverEvent(player, playerName(player), emptyMap())
+            NativeEventBus.TYPE_TURN_STARTED -> TurnStartedEvent(player, playerName(player), 0)
+            NativeEventBus.TYPE_TURN_ENDED -> TurnEndedEvent(player)
+            NativeEventBus.TYPE_CARD_DEALT -> CardDealtEvent(cardId, player, slot)
+            NativeEventBus.TYPE_CARD_DRAWN -> CardDrawnEvent(cardId, if (value != 0) "discard" else "deck", player)
+            NativeEventBus.TYPE_CARD_PLACED -> CardPlacedEvent(cardId, player, slot)
+            NativeEventBus.TYPE_CARD_FLIPPED -> CardFlippedEvent(cardId, value != 0)
+            NativeEventBus.TYPE_CARD_DISCARDED -> CardDiscardedEvent(cardId, player)
+            NativeEventBus.TYPE_INVALID_MOVE -> InvalidMoveEvent(
+                REJECTION_REASONS.getOrElse(value) { "Rejected" }, commandName(slot))
+            // Round wins are visible through the mirrored phase and winner
+            else -> null
+        }
+    }
+
+    private fun playerName(player: Int): String = playerNames.getOrElse(player) { "Player ${player + 1}" }
+
+    private fun commandName(type: Int): String = when (type) {
+        COMMAND_INITIALIZE_GAME -> "InitializeGame"
+        COMMAND_START_GAME -> "StartGame"
+        COMMAND_DRAW_CARD -> "DrawCard"
+        COMMAND_PLACE_CARD -> "PlaceCard"
+        COMMAND_DISCARD_CARD -> "DiscardCard"
+        COMMAND_FLIP_CARD -> "FlipCard"
+        COMMAND_END_TURN -> "EndTurn"
+        COMMAND_SKIP_TURN -> "SkipTurn"
+        COMMAND_PAUSE_GAME -> "PauseGame"
+        COMMAND_RESUME_GAME -> "ResumeGame"
+        COMMAND_END_GAME -> "EndGame"
+        COMMAND_RESET_GAME -> "ResetGame"
+        else -> "Unknown"
+    }
+
+    private fun send(
+        type: Int,
+        playerId: Int = NONE,
+        card: Int = GameStateMirror.NO_CARD,
+        slot: Int = NONE,
+        value: Int = 0,
+        flags: Int = 0
+    ): Boolean = bridge.submitCommand(type, playerId, card, slot, value, flags)
+}
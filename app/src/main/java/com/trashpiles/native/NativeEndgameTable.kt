@@ -0,0 +1,82 @@
+package com.trashpiles.native
+
+import android.content.res.AssetManager
+import com.trashpiles.gcms.CardState
+import com.trashpiles.gcms.PlayerState
+
+/**
+ * The solved play for a late-round position
+ */
+data class EndgameAdvice(
+    /** Under optimal play, counting this turn */
+    val expectedTurns: Float,
+    /** Take the discard top rather than draw from the deck */
+    val takeDiscard: Boolean,
+    /** Where a taken discard goes, null when drawing */
+    val discardSlot: Int?,
+    /** Where a wild drawn from the deck should go */
+    val wildSlot: Int?
+)
+
+/**
+ * Native Endgame Table - exact decisions for the last face-down slots
+ *
+ * endgame.tpend is solved offline (the endgame_table host target) and
+ * mapped read-only from the APK (gcms/endgame_table.h). With one to three
+ * slots face down, the position the card tracker sees for the player is
+ * looked up directly, so the AI's late-round choices cost a table read
+ * instead of a search.
+ *
+ * If the asset is missing or fails its checks, isAvailable is false and
+ * advise() returns null; callers fall back to their own heuristics. The
+ * native library must already be loaded (NativeEngineWrapper); call
+ * close() when the table is no longer read.
+ */
+class NativeEndgameTable(assets: AssetManager, path: String = ASSET_PATH) : AutoCloseable {
+
+    private var handle: Long = nativeOpen(assets, path)
+    private val scratch = IntArray(ADVICE_FIELDS)
+
+    val isAvailable: Boolean get() = handle != 0L
+
+    /**
+     * The table's play for player, as tracker sees the cards; null outside
+     * the table (more than three slots face down) or if the hand cannot
+     * finish
+     */
+    fun advise(player: PlayerState, tracker: NativeCardTracker, discardTop: CardState?): EndgameAdvice? {
+        if (handle == 0L) return null
+
+        var emptySlots = 0
+        player.hand.forEachIndexed { slot, card -> if (!card.isFaceUp) emptySlots = emptySlots or (1 shl slot) }
+        val top = discardTop?.let { GameStateMirror.cardCode(it) } ?: GameStateMirror.NO_CARD
+        if (!nativeAdvise(handle, tracker.nativeHandle, tracker.seat(player.id), emptySlots, top, scratch)) return null
+
+        return EndgameAdvice(
+            expectedTurns = scratch[0].toFloat() / TURN_SCALE,
+            takeDiscard = scratch[1] != 0,
+            discardSlot = scratch[2].takeIf { it >= 0 },
+            wildSlot = scratch[3].takeIf { it >= 0 }
+        )
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeClose(handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeOpen(assets: AssetManager, path: String): Long
+    private external fun nativeClose(handle: Long)
+    private external fun nativeAdvise(
+        handle: Long, tracker: Long, observer: Int, emptySlots: Int, discardTop: Int, out: IntArray
+    ): Boolean
+
+    companion object {
+        const val ASSET_PATH = "endgame.tpend"
+        // EndgameTableFormat::kTurnScale
+        private const val TURN_SCALE = 256f
+        private const val ADVICE_FIELDS = 4
+    }
+}
@@ -3,9 +3,37 @@ package com.trashpiles.native
 /**
  * Main wrapper - loads the native library
  * Individual engine bridges are in separate files
+ *
+ * Also drives the native startup graph: startEngine() brings up audio
+ * streams, the render surface and the game engine in parallel, and sound
+ * banks once the streams are open. Each stage can be awaited by name.
  */
 object NativeEngineWrapper {
     init {
         System.loadLibrary("trash-piles-native")
     }
-}
\ No newline at end of file
+    
+    // Startup stage names
+    const val STAGE_GAME_ENGINE = "game.engine"
+    const val STAGE_RENDERER_SURFACE = "renderer.surface"
+    const val STAGE_AUDIO_STREAMS = "audio.streams"
+    const val STAGE_SOUND_BANK = "audio.sound_bank"
+    const val STAGE_MUSIC_BANK = "audio.music_bank"
+    
+    // Startup
+    external fun startEngine(width: Int, height: Int): Boolean
+    external fun isStageReady(stage: String): Boolean
+    // Negative timeout waits until the stage completes
+    external fun awaitStage(stage: String, timeoutMs: Long): Boolean
+    
+    // Timing, all in ns since library load, -1 if not reached yet:
+    // [first frame, then per stage in getStartupStageNames() order:
+    //  state (0 pending, 1 running, 2 ready, 3 failed, 4 skipped), start, end]
+    external fun getStartupStageNames(): Array<String>
+    external fun getStartupTimings(): LongArray
+    
+    // Native event bus counters: [published, dropped by publishers, then per
+    // subscriber in getEventSubscriberNames() order: delivered, dropped, lag]
+    external fun getEventSubscriberNames(): Array<String>
+    external fun getEventBusStats(): LongArray
+}
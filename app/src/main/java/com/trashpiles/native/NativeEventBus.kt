@@ -0,0 +1,76 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.CardDealtEvent
+import com.trashpiles.gcms.CardDiscardedEvent
+import com.trashpiles.gcms.CardDrawnEvent
+import com.trashpiles.gcms.CardFlippedEvent
+import com.trashpiles.gcms.CardPlacedEvent
+import com.trashpiles.gcms.GCMSEvent
+import com.trashpiles.gcms.GameOverEvent
+import com.trashpiles.gcms.GameStartedEvent
+import com.trashpiles.gcms.InvalidMoveEvent
+import com.trashpiles.gcms.MatchCompletedEvent
+import com.trashpiles.gcms.TurnEndedEvent
+import com.trashpiles.gcms.TurnStartedEvent
+
+/**
+ * Native Event Bus - forwards game events to native subscribers
+ *
+ * Events go straight into the native ring (gcms/event_bus.h); the audio
+ * stream and the renderer pick them up on their own threads, so a bound
+ * sound starts without another JNI call or coroutine hop. Events the
+ * native side has no use for are not forwarded.
+ */
+class NativeEventBus(private val bridge: GameEngineBridge) {
+
+    companion object {
+        // GameEventType values in gcms/event_bus.h
+        const val TYPE_GAME_STARTED = 0
+        const val TYPE_GAME_ENDED = 1
+        const val TYPE_TURN_STARTED = 2
+        const val TYPE_TURN_ENDED = 3
+        const val TYPE_CARD_DEALT = 4
+        const val TYPE_CARD_DRAWN = 5
+        const val TYPE_CARD_PLACED = 6
+        const val TYPE_CARD_FLIPPED = 7
+        const val TYPE_CARD_DISCARDED = 8
+        const val TYPE_ROUND_WON = 9
+        const val TYPE_INVALID_MOVE = 10
+        const val TYPE_DECK_RESHUFFLED = 11
+
+        private const val NONE = -1
+    }
+
+    /**
+     * Publish an event if it has a native type
+     * Returns false if it was not forwarded or the ring dropped it
+     */
+    fun publish(event: GCMSEvent): Boolean = when (event) {
+        is GameStartedEvent -> send(TYPE_GAME_STARTED)
+        is GameOverEvent -> send(TYPE_GAME_ENDED, playerId = event.winnerId)
+        is TurnStartedEvent -> send(TYPE_TURN_STARTED, playerId = event.playerId)
+        is TurnEndedEvent -> send(TYPE_TURN_ENDED, playerId = event.playerId)
+        is CardDealtEvent -> send(TYPE_CARD_DEALT, event.toPlayerId,
+            GameStateMirror.cardCode(event.cardId), event.slotIndex)
+        is CardDrawnEvent -> send(TYPE_CARD_DRAWN, event.byPlayerId,
+            GameStateMirror.cardCode(event.cardId), value = if (event.fromPile == "discard") 1 else 0)
+        is CardPlacedEvent -> send(TYPE_CARD_PLACED, event.playerId,
+            GameStateMirror.cardCode(event.cardId, faceUp = true), event.slotIndex)
+        is CardFlippedEvent -> send(TYPE_CARD_FLIPPED, card = GameStateMirror.cardCode(event.cardId),
+            value = if (event.isFaceUp) 1 else 0)
+        is CardDiscardedEvent -> send(TYPE_CARD_DISCARDED, event.byPlayerId,
+            GameStateMirror.cardCode(event.cardId, faceUp = true))
+        is MatchCompletedEvent -> send(TYPE_ROUND_WON, playerId = event.winnerId.toIntOrNull() ?: NONE)
+        is InvalidMoveEvent -> send(TYPE_INVALID_MOVE)
+        else -> false
+    }
+
+    private fun send(
+        type: Int,
+        playerId: Int = NONE,
+        card: Int = GameStateMirror.NO_CARD,
+        slot: Int = NONE,
+        value: Int = 0,
+        volume: Float = 1.0f
+    ): Boolean = bridge.publishEvent(type, playerId, card, slot, value, volume)
+}
@@ -0,0 +1,241 @@
+package com.trashpiles.native
+
+import android.content.res.AssetManager
+import com.trashpiles.gcms.Challenge
+import com.trashpiles.gcms.ChallengeRequirements
+import com.trashpiles.gcms.ChallengeReward
+import com.trashpiles.gcms.ChallengeType
+import com.trashpiles.gcms.LevelChallengeSet
+import com.trashpiles.gcms.PointType
+import com.trashpiles.gcms.SkillCategory
+import com.trashpiles.gcms.Tier
+import com.trashpiles.gcms.Trophy
+import com.trashpiles.gcms.TrophyDefinition
+import com.trashpiles.gcms.TrophyPrerequisite
+import com.trashpiles.gcms.TrophyRarity
+
+/**
+ * Native Progression Catalog - the packed skill, trophy and challenge catalogs
+ *
+ * progression.tpprog is built offline (ProgressionCatalogExport, then the
+ * progression_blob host target) and mapped read-only from the APK, so the
+ * catalogs cost no object construction at startup
+ * (progression/progression_blob.h). The lists here are views: a record is
+ * read through JNI only when it is asked for, and each field only when it
+ * is read.
+ *
+ * If the asset is missing or fails its checks, isAvailable is false and the
+ * lists are empty; callers keep building the catalogs in Kotlin. The native
+ * library must already be loaded (NativeEngineWrapper); call close() when
+ * the catalog is no longer read.
+ */
+class NativeProgressionCatalog(assets: AssetManager, path: String = ASSET_PATH) : AutoCloseable {
+
+    private var handle: Long = nativeOpen(assets, path)
+
+    val isAvailable: Boolean get() = handle != 0L
+
+    /** Skills and abilities, sorted by id */
+    val nodes: List<NodeView> = SectionView(SECTION_NODES) { NodeView(it) }
+    val trophies: List<TrophyView> = SectionView(SECTION_TROPHIES) { TrophyView(it) }
+    /** Challenge sets, sorted by level */
+    val challengeSets: List<ChallengeSetView> = SectionView(SECTION_CHALLENGE_SETS) { ChallengeSetView(it) }
+
+    fun findNode(id: String): NodeView? {
+        val index = nativeFindNode(handle, id)
+        return if (index < 0) null else NodeView(index)
+    }
+
+    fun challengeSetForLevel(level: Int): ChallengeSetView? {
+        val index = nativeFindChallengeSet(handle, level)
+        return if (index < 0) null else ChallengeSetView(index)
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeClose(handle)
+            handle = 0L
+        }
+    }
+
+    inner class NodeView internal constructor(val index: Int) {
+        private val ints by lazy { ints(SECTION_NODES, index) }
+
+        val id: String get() = string(SECTION_NODES, index, FIELD_ID)!!
+        val name: String get() = string(SECTION_NODES, index, FIELD_NAME)!!
+        val description: String get() = string(SECTION_NODES, index, FIELD_DESCRIPTION)!!
+        /** The effect as Kotlin prints it, e.g. "XP_BOOST(percentage=10)" */
+        val effect: String get() = string(SECTION_NODES, index, FIELD_NODE_EFFECT)!!
+        val trophyId: String? get() = string(SECTION_NODES, index, FIELD_NODE_TROPHY_ID)
+        val cost: Int get() = ints[0]
+        val levelRequired: Int get() = ints[1]
+        val xpReward: Int get() = ints[2]
+        val pointType: PointType get() = PointType.values()[ints[3]]
+        val tier: Tier get() = Tier.values()[ints[4]]
+        val category: SkillCategory get() = SkillCategory.values()[ints[5]]
+        /** -1 for skills */
+        val usesPerMatch: Int get() = ints[6]
+        val usesPerRound: Int get() = ints[7]
+        /** Ids missing from the catalog read as "", which no unlocked set contains */
+        val prerequisites: List<String> get() = strings(SECTION_NODES, index, LIST_NODE_PREREQUISITES)
+    }
+
+    inner class TrophyView internal constructor(val index: Int) {
+        private val ints by lazy { ints(SECTION_TROPHIES, index) }
+
+        val id: String get() = string(SECTION_TROPHIES, index, FIELD_ID)!!
+        val name: String get() = string(SECTION_TROPHIES, index, FIELD_NAME)!!
+        val description: String get() = string(SECTION_TROPHIES, index, FIELD_DESCRIPTION)!!
+        val icon: String? get() = string(SECTION_TROPHIES, index, FIELD_TROPHY_ICON)
+        val rarity: TrophyRarity get() = TrophyRarity.values()[ints[0]]
+        val tier: Tier get() = Tier.values()[ints[1]]
+        val pointType: PointType? get() = if (ints[2] < 0) null else PointType.values()[ints[2]]
+        val xpReward: Int get() = ints[3]
+        val pointReward: Int get() = ints[4]
+        val requiredSkills: List<String> get() = strings(SECTION_TROPHIES, index, LIST_TROPHY_SKILLS)
+        val requiredAbilities: List<String> get() = strings(SECTION_TROPHIES, index, LIST_TROPHY_ABILITIES)
+
+        fun toDefinition(): TrophyDefinition = TrophyDefinition(
+            Trophy(id, name, description, rarity, tier, icon, xpReward, pointReward, pointType),
+            TrophyPrerequisite(
+                requiredLevel = threshold(THRESHOLD_LEVEL),
+                minTotalPoints = threshold(THRESHOLD_TOTAL_POINTS),
+                minSP = threshold(THRESHOLD_SKILL_POINTS),
+                minAP = threshold(THRESHOLD_ABILITY_POINTS),
+                requiredAbilities = requiredAbilities,
+                requiredSkills = requiredSkills,
+                minAbilitiesUnlocked = threshold(THRESHOLD_ABILITIES_UNLOCKED),
+                minSkillsUnlocked = threshold(THRESHOLD_SKILLS_UNLOCKED)
+            )
+        )
+
+        // Null where the prerequisite sets no minimum
+        private fun threshold(field: Int): Int? = ints[5 + field].takeIf { it != NO_VALUE }
+    }
+
+    inner class ChallengeSetView internal constructor(val index: Int) {
+        private val ints by lazy { ints(SECTION_CHALLENGE_SETS, index) }
+
+        val level: Int get() = ints[0]
+        /** -1 means all challenges */
+        val requiredToComplete: Int get() = ints[1]
+        val challenges: List<ChallengeView>
+            get() = object : AbstractList<ChallengeView>() {
+                override val size: Int get() = ints[3]
+                override fun get(index: Int): ChallengeView {
+                    if (index !in 0 until size) throw IndexOutOfBoundsException("$index of $size")
+                    return ChallengeView(ints[2] + index)
+                }
+            }
+
+        fun toLevelChallengeSet(): LevelChallengeSet =
+            LevelChallengeSet(level, challenges.map { it.toChallenge() }, requiredToComplete)
+    }
+
+    inner class ChallengeView internal constructor(val index: Int) {
+        private val ints by lazy { ints(SECTION_CHALLENGES, index) }
+
+        val id: String get() = string(SECTION_CHALLENGES, index, FIELD_ID)!!
+        val name: String get() = string(SECTION_CHALLENGES, index, FIELD_NAME)!!
+        val description: String get() = string(SECTION_CHALLENGES, index, FIELD_DESCRIPTION)!!
+        val type: ChallengeType get() = ChallengeType.values()[ints[0]]
+        val targetLevel: Int get() = ints[1]
+
+        fun toChallenge(): Challenge {
+            val abilityIds = strings(SECTION_CHALLENGES, index, LIST_CHALLENGE_ABILITY_GOALS)
+            return Challenge(
+                id = id,
+                name = name,
+                description = description,
+                type = type,
+                targetLevel = targetLevel,
+                requirements = ChallengeRequirements(
+                    score = ints[2],
+                    abilitiesUsed = abilityIds.withIndex().associate { it.value to ints[CHALLENGE_INTS + it.index] },
+                    skillsUnlocked = strings(SECTION_CHALLENGES, index, LIST_CHALLENGE_SKILLS),
+                    pointsEarned = ints[3],
+                    comboCount = ints[4],
+                    winStreak = ints[5],
+                    cardsPlaced = ints[6],
+                    maxTimeSeconds = ints[7],
+                    perfectRounds = ints[8]
+                ),
+                reward = ChallengeReward(
+                    achievement = string(SECTION_CHALLENGES, index, FIELD_CHALLENGE_ACHIEVEMENT)!!,
+                    pointsBonus = ints[9],
+                    xpBonus = ints[10],
+                    specialReward = string(SECTION_CHALLENGES, index, FIELD_CHALLENGE_SPECIAL_REWARD)
+                )
+            )
+        }
+    }
+
+    // A section as a List whose elements are made on access
+    private inner class SectionView<T>(
+        private val section: Int,
+        private val make: (Int) -> T
+    ) : AbstractList<T>() {
+        override val size: Int get() = nativeCount(handle, section)
+        override fun get(index: Int): T {
+            if (index !in 0 until size) throw IndexOutOfBoundsException("$index of $size")
+            return make(index)
+        }
+    }
+
+    private fun ints(section: Int, index: Int): IntArray =
+        checkNotNull(nativeInts(handle, section, index)) { "Progression catalog is closed" }
+
+    private fun string(section: Int, index: Int, field: Int): String? = nativeString(handle, section, index, field)
+
+    private fun strings(section: Int, index: Int, field: Int): List<String> =
+        nativeStrings(handle, section, index, field)?.asList() ?: emptyList()
+
+    private external fun nativeOpen(assets: AssetManager, path: String): Long
+    private external fun nativeClose(handle: Long)
+    private external fun nativeCount(handle: Long, section: Int): Int
+    // Every numeric field of one record, in record order (progression_jni.cpp)
+    private external fun nativeInts(handle: Long, section: Int, index: Int): IntArray?
+    private external fun nativeString(handle: Long, section: Int, index: Int, field: Int): String?
+    private external fun nativeStrings(handle: Long, section: Int, index: Int, field: Int): Array<String>?
+    private external fun nativeFindNode(handle: Long, id: String): Int
+    private external fun nativeFindChallengeSet(handle: Long, level: Int): Int
+
+    companion object {
+        const val ASSET_PATH = "progression.tpprog"
+
+        // ProgressionBlobFormat::Section
+        private const val SECTION_NODES = 0
+        private const val SECTION_TROPHIES = 2
+        private const val SECTION_CHALLENGE_SETS = 4
+        private const val SECTION_CHALLENGES = 5
+
+        // CatalogField strings and lists
+        private const val FIELD_ID = 0
+        private const val FIELD_NAME = 1
+        private const val FIELD_DESCRIPTION = 2
+        private const val FIELD_NODE_EFFECT = 3
+        private const val FIELD_NODE_TROPHY_ID = 4
+        private const val FIELD_TROPHY_ICON = 3
+        private const val FIELD_CHALLENGE_ACHIEVEMENT = 3
+        private const val FIELD_CHALLENGE_SPECIAL_REWARD = 4
+        private const val LIST_NODE_PREREQUISITES = 0
+        private const val LIST_TROPHY_SKILLS = 0
+        private const val LIST_TROPHY_ABILITIES = 1
+        private const val LIST_CHALLENGE_ABILITY_GOALS = 0
+        private const val LIST_CHALLENGE_SKILLS = 1
+
+        // ProgressionBlobFormat::TrophyThreshold
+        private const val THRESHOLD_LEVEL = 0
+        private const val THRESHOLD_TOTAL_POINTS = 1
+        private const val THRESHOLD_SKILL_POINTS = 2
+        private const val THRESHOLD_ABILITY_POINTS = 3
+        private const val THRESHOLD_ABILITIES_UNLOCKED = 4
+        private const val THRESHOLD_SKILLS_UNLOCKED = 5
+
+        // Fixed ints per challenge before the ability goal uses
+        private const val CHALLENGE_INTS = 11
+
+        // ProgressionBlobFormat::kNoValue
+        const val NO_VALUE = Int.MIN_VALUE
+    }
+}
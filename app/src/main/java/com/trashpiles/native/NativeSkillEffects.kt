@@ -0,0 +1,107 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.GCMSState
+import com.trashpiles.gcms.PlayerState
+import com.trashpiles.gcms.SkillEffect
+import com.trashpiles.gcms.SkillEffectType
+
+/**
+ * Native Skill Effects - active skill effects indexed by seat and type
+ *
+ * Holds the same effects as GCMSState.activeSkillEffects in a native table
+ * (gcms/skill_effect_table.h): adding follows addSkillEffect, advanceTurn()
+ * follows updateSkillEffects in one pass over every effect, and has/value
+ * answer hasSkillEffect/getSkillEffectValue without filtering the list.
+ * Score effects are compiled per seat as they change, so scoring the
+ * round for every seat is one call and a lookup each, matching
+ * GameRules.calculateScore.
+ *
+ * Seats follow the order of playerIds. The native library must already be
+ * loaded (NativeEngineWrapper); call close() at the end of the match.
+ */
+class NativeSkillEffects(playerIds: List<Int>) : AutoCloseable {
+
+    private val seats: Map<Int, Int> = playerIds.withIndex().associate { it.value to it.index }
+    private val baseScores = IntArray(playerIds.size)
+    private val scores = IntArray(playerIds.size)
+    private var handle: Long
+
+    init {
+        require(playerIds.size <= MAX_PLAYERS) { "Skill effects hold at most $MAX_PLAYERS players" }
+        handle = nativeCreate()
+        check(handle != 0L) { "Native skill effect table could not be created" }
+    }
+
+    /**
+     * Mirror addSkillEffect; false if the table is full or the player unknown
+     */
+    fun add(effect: SkillEffect): Boolean {
+        val seat = seats[effect.playerId] ?: return false
+        return nativeAdd(handle, seat, effect.effectType.ordinal, effect.value, effect.duration)
+    }
+
+    /**
+     * Replace the table with a state's effects, e.g. after a load
+     */
+    fun load(effects: List<SkillEffect>) {
+        nativeClear(handle)
+        effects.forEach { add(it) }
+    }
+
+    /** Mirror updateSkillEffects at the start of a turn */
+    fun advanceTurn() = nativeAdvanceTurn(handle)
+
+    fun has(playerId: Int, type: SkillEffectType): Boolean {
+        val seat = seats[playerId] ?: return false
+        return nativeHas(handle, seat, type.ordinal)
+    }
+
+    fun value(playerId: Int, type: SkillEffectType): Float {
+        val seat = seats[playerId] ?: return 1.0f
+        return nativeValue(handle, seat, type.ordinal)
+    }
+
+    /**
+     * GameRules.calculateScore for every seat at once; the returned array is
+     * reused by the next call
+     */
+    fun scores(players: List<PlayerState>): IntArray {
+        baseScores.fill(0)
+        players.forEach { player ->
+            val seat = seats[player.id] ?: return@forEach
+            baseScores[seat] = player.hand.count { !it.isFaceUp }
+        }
+        nativeScores(handle, baseScores, scores)
+        return scores
+    }
+
+    fun scores(state: GCMSState): IntArray = scores(state.players)
+
+    fun score(player: PlayerState, state: GCMSState): Int {
+        val seat = seats[player.id] ?: return 0
+        return scores(state)[seat]
+    }
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private external fun nativeCreate(): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeAdd(handle: Long, seat: Int, type: Int, value: Float, duration: Int): Boolean
+    private external fun nativeAdvanceTurn(handle: Long)
+    private external fun nativeClear(handle: Long)
+    private external fun nativeHas(handle: Long, seat: Int, type: Int): Boolean
+    private external fun nativeValue(handle: Long, seat: Int, type: Int): Float
+    private external fun nativeScores(handle: Long, baseScores: IntArray, scores: IntArray)
+
+    companion object {
+        // SkillEffectTable::kMaxPlayers
+        const val MAX_PLAYERS = 4
+        // SkillEffectTable::kMaxEffects
+        const val MAX_EFFECTS = 64
+    }
+}
@@ -0,0 +1,138 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.PlayerProgress
+import com.trashpiles.gcms.Tier
+import com.trashpiles.gcms.TreeNode
+
+/**
+ * Native Skill Tree - compiled index over the skill and ability catalog
+ *
+ * Nodes get dense ids (catalog ids in sorted order) and the native side
+ * keeps prerequisites and their transitive closures as bitsets, presorted
+ * by level, tier and cost (progression/skill_tree_index.h). Availability
+ * for the whole tree is then a few word-wide ANDs per query instead of a
+ * walk over every node's prerequisite list, so the skill-tree screen can
+ * recompute it on every unlock.
+ *
+ * Answers match TreeNode.canUnlock. The native library must already be
+ * loaded (NativeEngineWrapper); call close() when the catalog is dropped.
+ */
+class NativeSkillTree(catalog: Map<String, TreeNode>) : AutoCloseable {
+
+    /** Catalog ids by dense node id */
+    val ids: List<String> = catalog.keys.sorted()
+
+    private val nodes: List<TreeNode> = ids.map { catalog.getValue(it) }
+    private val denseIds: Map<String, Int> = ids.withIndex().associate { it.value to it.index }
+    private var handle: Long
+
+    init {
+        require(ids.size <= MAX_NODES) { "Skill tree holds at most $MAX_NODES nodes" }
+
+        val offsets = IntArray(nodes.size + 1)
+        val prerequisites = ArrayList<Int>()
+        nodes.forEachIndexed { id, node ->
+            // Unknown prerequisites stay as -1: no unlocked set contains them
+            node.prerequisites.mapTo(prerequisites) { denseIds[it] ?: -1 }
+            offsets[id + 1] = prerequisites.size
+        }
+
+        handle = nativeCreate(
+            IntArray(nodes.size) { nodes[it].levelRequired },
+            IntArray(nodes.size) { nodes[it].cost },
+            IntArray(nodes.size) { nodes[it].tier.ordinal },
+            IntArray(nodes.size) { nodes[it].pointType.ordinal },
+            offsets,
+            prerequisites.toIntArray()
+        )
+        check(handle != 0L) { "Native skill tree rejected the catalog" }
+    }
+
+    fun idOf(nodeId: String): Int = denseIds[nodeId] ?: -1
+
+    /**
+     * Every node the player could unlock right now
+     */
+    fun eligibleNodes(progress: PlayerProgress): List<TreeNode> {
+        val unlocked = bitsOf(progress.unlockedSkills + progress.unlockedAbilities)
+        return nodesIn(nativeEligible(handle, progress.level, progress.skillPoints, progress.abilityPoints, unlocked))
+    }
+
+    fun canUnlock(nodeId: String, progress: PlayerProgress): Boolean {
+        val id = idOf(nodeId)
+        if (id < 0) return false
+        val unlocked = bitsOf(progress.unlockedSkills + progress.unlockedAbilities)
+        return nativeCanUnlock(handle, id, progress.level, progress.skillPoints, progress.abilityPoints, unlocked)
+    }
+
+    fun arePrerequisitesMet(nodeId: String, unlockedNodes: Set<String>): Boolean {
+        val id = idOf(nodeId)
+        if (id < 0) return false
+        val met = nativePrerequisitesMet(handle, bitsOf(unlockedNodes)) ?: return false
+        return (met[id ushr 6] ushr (id and 63)) and 1L != 0L
+    }
+
+    /**
+     * Everything still to unlock beneath a node, however indirectly
+     */
+    fun missingPrerequisites(nodeId: String, unlockedNodes: Set<String>): List<TreeNode> {
+        val id = idOf(nodeId)
+        if (id < 0) return emptyList()
+        return nodesIn(nativeMissingFor(handle, id, bitsOf(unlockedNodes)))
+    }
+
+    fun nodesForLevel(level: Int): List<TreeNode> =
+        nativeNodesAtLevel(handle, level)?.map { nodes[it] } ?: emptyList()
+
+    fun nodesByTier(tier: Tier): List<TreeNode> =
+        nativeNodesInTier(handle, tier.ordinal)?.map { nodes[it] } ?: emptyList()
+
+    override fun close() {
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private fun bitsOf(nodeIds: Set<String>): LongArray {
+        val bits = LongArray(SET_WORDS)
+        for (nodeId in nodeIds) {
+            val id = denseIds[nodeId] ?: continue
+            bits[id ushr 6] = bits[id ushr 6] or (1L shl (id and 63))
+        }
+        return bits
+    }
+
+    private fun nodesIn(bits: LongArray?): List<TreeNode> {
+        if (bits == null) return emptyList()
+        val result = ArrayList<TreeNode>()
+        for (word in bits.indices) {
+            var remaining = bits[word]
+            while (remaining != 0L) {
+                val id = word * 64 + java.lang.Long.numberOfTrailingZeros(remaining)
+                if (id < nodes.size) result.add(nodes[id])
+                remaining = remaining and (remaining - 1)
+            }
+        }
+        return result
+    }
+
+    private external fun nativeCreate(
+        levels: IntArray, costs: IntArray, tiers: IntArray, pointTypes: IntArray,
+        prereqOffsets: IntArray, prereqIds: IntArray
+    ): Long
+    private external fun nativeDestroy(handle: Long)
+    // Node sets are SET_WORDS longs, bit n for dense id n
+    private external fun nativeEligible(handle: Long, level: Int, skillPoints: Int, abilityPoints: Int, unlocked: LongArray): LongArray?
+    private external fun nativeCanUnlock(handle: Long, node: Int, level: Int, skillPoints: Int, abilityPoints: Int, unlocked: LongArray): Boolean
+    private external fun nativePrerequisitesMet(handle: Long, unlocked: LongArray): LongArray?
+    private external fun nativeMissingFor(handle: Long, node: Int, unlocked: LongArray): LongArray?
+    private external fun nativeNodesAtLevel(handle: Long, level: Int): IntArray?
+    private external fun nativeNodesInTier(handle: Long, tier: Int): IntArray?
+
+    companion object {
+        // SkillTreeIndex::kMaxNodes and NodeSet::kWords
+        const val MAX_NODES = 256
+        const val SET_WORDS = MAX_NODES / 64
+    }
+}
@@ -0,0 +1,70 @@
+package com.trashpiles.native
+
+import java.util.concurrent.ConcurrentHashMap
+
+/**
+ * Native Trace - puts Kotlin sections on the native trace timeline
+ *
+ * Sections recorded here land in the same per-thread rings as the native
+ * frame, audio callback, JNI and job spans (trace/trace.h), and export
+ * together as Chrome trace-event JSON for Perfetto UI. Native trace points
+ * only exist in builds configured with TRASHPILES_TRACING; start() returns
+ * false otherwise, and every call here stays a cheap no-op until it
+ * succeeds, so game logic can be wrapped unconditionally.
+ */
+object NativeTrace {
+
+    @Volatile
+    var isRecording = false
+        private set
+
+    private val handles = ConcurrentHashMap<String, Long>()
+
+    /**
+     * Start recording; the native library must already be loaded
+     */
+    fun start(): Boolean {
+        if (!isCompiledIn()) return false
+        setEnabled(true)
+        isRecording = true
+        return true
+    }
+
+    fun stop() {
+        if (!isRecording) return
+        isRecording = false
+        setEnabled(false)
+    }
+
+    /**
+     * Write everything recorded so far as Chrome trace-event JSON
+     */
+    fun export(path: String): Boolean = isCompiledIn() && exportTrace(path)
+
+    inline fun <T> section(name: String, block: () -> T): T {
+        if (!isRecording) return block()
+        val handle = handleFor(name)
+        beginSection(handle)
+        try {
+            return block()
+        } finally {
+            endSection(handle)
+        }
+    }
+
+    fun count(name: String, value: Long) {
+        if (isRecording) counter(handleFor(name), value)
+    }
+
+    fun handleFor(name: String): Long = handles.getOrPut(name) { registerName(name) }
+
+    external fun isCompiledIn(): Boolean
+    external fun setEnabled(enabled: Boolean)
+    external fun registerName(name: String): Long
+    external fun beginSection(handle: Long)
+    external fun endSection(handle: Long)
+    external fun counter(handle: Long, value: Long)
+    external fun setThreadName(name: String)
+    external fun exportTrace(path: String): Boolean
+    external fun clear()
+}
@@ -0,0 +1,148 @@
+package com.trashpiles.native
+
+import com.trashpiles.gcms.PlayerProgress
+import com.trashpiles.gcms.TrophyDefinition
+
+/**
+ * Native Trophy Rules - incremental trophy eligibility
+ *
+ * Each TrophyPrerequisite is compiled once into minimum-value predicates
+ * over level, points and unlock counts plus a bitset of required skills
+ * and abilities (progression/trophy_rules.h). Per player, the native side
+ * remembers the last progress it saw and how many predicates each trophy
+ * still misses, so update() only revisits the trophies whose thresholds the
+ * change crossed or whose required unlocks flipped, and hands back the
+ * newly satisfied ones.
+ *
+ * Satisfied means TrophyPrerequisite.meetsRequirements; whether the player
+ * already owns the trophy stays with TrophySystem. The native library must
+ * already be loaded (NativeEngineWrapper); call close() when done.
+ */
+class NativeTrophyRules(definitions: List<TrophyDefinition>) : AutoCloseable {
+
+    /** Definitions by native trophy id */
+    val definitions: List<TrophyDefinition> = definitions.toList()
+
+    // Required skills and abilities interned as requirement keys
+    private val skillKeys = HashMap<String, Int>()
+    private val abilityKeys = HashMap<String, Int>()
+    private val trackers = HashMap<String, Long>()
+    private var handle: Long
+
+    init {
+        require(this.definitions.size <= MAX_TROPHIES) { "Trophy rules hold at most $MAX_TROPHIES trophies" }
+
+        val thresholds = IntArray(this.definitions.size * FIELD_COUNT) { NO_THRESHOLD }
+        val offsets = IntArray(this.definitions.size + 1)
+        val keys = ArrayList<Int>()
+        this.definitions.forEachIndexed { id, definition ->
+            val prereqs = definition.prerequisites
+            val base = id * FIELD_COUNT
+            prereqs.requiredLevel?.let { thresholds[base + FIELD_LEVEL] = it }
+            prereqs.minTotalPoints?.let { thresholds[base + FIELD_TOTAL_POINTS] = it }
+            prereqs.minSP?.let { thresholds[base + FIELD_SKILL_POINTS] = it }
+            prereqs.minAP?.let { thresholds[base + FIELD_ABILITY_POINTS] = it }
+            prereqs.minAbilitiesUnlocked?.let { thresholds[base + FIELD_ABILITIES_UNLOCKED] = it }
+            prereqs.minSkillsUnlocked?.let { thresholds[base + FIELD_SKILLS_UNLOCKED] = it }
+
+            prereqs.requiredSkills.mapTo(keys) { skillKeys.getOrPut(it) { skillKeys.size + abilityKeys.size } }
+            prereqs.requiredAbilities.mapTo(keys) { abilityKeys.getOrPut(it) { skillKeys.size + abilityKeys.size } }
+            offsets[id + 1] = keys.size
+        }
+        require(skillKeys.size + abilityKeys.size <= MAX_REQUIREMENTS) {
+            "Trophy rules track at most $MAX_REQUIREMENTS required skills and abilities"
+        }
+
+        handle = nativeCreate(thresholds, offsets, keys.toIntArray())
+        check(handle != 0L) { "Native trophy rules rejected the catalog" }
+    }
+
+    /**
+     * Record a player's current progress and return the trophies whose
+     * prerequisites it newly meets. The first call for a player returns
+     * everything they already meet.
+     */
+    fun update(playerId: String, progress: PlayerProgress): List<TrophyDefinition> {
+        val tracker = trackers.getOrPut(playerId) { nativeCreateTracker(handle) }
+        val fields = IntArray(FIELD_COUNT)
+        fields[FIELD_LEVEL] = progress.level
+        fields[FIELD_TOTAL_POINTS] = progress.totalSP + progress.totalAP
+        fields[FIELD_SKILL_POINTS] = progress.totalSP
+        fields[FIELD_ABILITY_POINTS] = progress.totalAP
+        fields[FIELD_ABILITIES_UNLOCKED] = progress.unlockedAbilities.size
+        fields[FIELD_SKILLS_UNLOCKED] = progress.unlockedSkills.size
+        return definitionsIn(nativeUpdate(tracker, fields, unlockedKeys(progress)))
+    }
+
+    /**
+     * Every trophy whose prerequisites the player's last update met
+     */
+    fun satisfied(playerId: String): List<TrophyDefinition> {
+        val tracker = trackers[playerId] ?: return emptyList()
+        return definitionsIn(nativeSatisfied(tracker))
+    }
+
+    fun forgetPlayer(playerId: String) {
+        trackers.remove(playerId)?.let { nativeDestroyTracker(it) }
+    }
+
+    override fun close() {
+        trackers.values.forEach { nativeDestroyTracker(it) }
+        trackers.clear()
+        if (handle != 0L) {
+            nativeDestroy(handle)
+            handle = 0L
+        }
+    }
+
+    private fun unlockedKeys(progress: PlayerProgress): LongArray {
+        val bits = LongArray(SET_WORDS)
+        fun mark(key: Int?) {
+            if (key != null) bits[key ushr 6] = bits[key ushr 6] or (1L shl (key and 63))
+        }
+        progress.unlockedSkills.forEach { mark(skillKeys[it]) }
+        progress.unlockedAbilities.forEach { mark(abilityKeys[it]) }
+        return bits
+    }
+
+    private fun definitionsIn(bits: LongArray?): List<TrophyDefinition> {
+        if (bits == null) return emptyList()
+        val result = ArrayList<TrophyDefinition>()
+        for (word in bits.indices) {
+            var remaining = bits[word]
+            while (remaining != 0L) {
+                val id = word * 64 + java.lang.Long.numberOfTrailingZeros(remaining)
+                if (id < definitions.size) result.add(definitions[id])
+                remaining = remaining and (remaining - 1)
+            }
+        }
+        return result
+    }
+
+    private external fun nativeCreate(thresholds: IntArray, reqOffsets: IntArray, reqKeys: IntArray): Long
+    private external fun nativeDestroy(handle: Long)
+    private external fun nativeCreateTracker(handle: Long): Long
+    private external fun nativeDestroyTracker(tracker: Long)
+    // Trophy and requirement sets are SET_WORDS longs, bit n for id n
+    private external fun nativeUpdate(tracker: Long, fields: IntArray, unlocked: LongArray): LongArray?
+    private external fun nativeSatisfied(tracker: Long): LongArray?
+
+    companion object {
+        // TrophyRules::kMaxTrophies, kMaxRequirements and TrophySet::kWords
+        const val MAX_TROPHIES = 256
+        const val MAX_REQUIREMENTS = 256
+        const val SET_WORDS = MAX_TROPHIES / 64
+
+        // ProgressField ordinals
+        const val FIELD_LEVEL = 0
+        const val FIELD_TOTAL_POINTS = 1
+        const val FIELD_SKILL_POINTS = 2
+        const val FIELD_ABILITY_POINTS = 3
+        const val FIELD_ABILITIES_UNLOCKED = 4
+        const val FIELD_SKILLS_UNLOCKED = 5
+        const val FIELD_COUNT = 6
+
+        // TrophyRules::kNoThreshold
+        const val NO_THRESHOLD = Int.MIN_VALUE
+    }
+}
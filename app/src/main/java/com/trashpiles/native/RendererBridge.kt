@@ -48,6 +48,16 @@ class RendererBridge {
         size: Float
     )
     
+    // Outlines a seat's area while it is that player's turn; the turn comes
+    // from the native event bus, so this draws nothing for other seats
+    external fun renderTurnIndicator(
+        playerId: Int,
+        x: Float,
+        y: Float,
+        width: Float,
+        height: Float
+    )
+    
     // Animation support
     external fun setCardRotation(cardId: Int, angle: Float)
     external fun setCardScale(cardId: Int, scaleX: Float, scaleY: Float)
@@ -69,12 +69,32 @@ class GameActivity : AppCompatActivity() {
         // Initialize native bridges (when ready)
         try {
             // TODO: Uncomment when native libraries are built
+            // NativeEngineWrapper.startEngine(1920, 1080)
+            
+            // Record a native trace (TRASHPILES_TRACING builds); export from
+            // onPause with NativeTrace.export("${filesDir}/trace.json")
+            // NativeTrace.start()
             // rendererBridge = RendererBridge(1920, 1080)
             // audioBridge = AudioEngineBridge()
             
+            // Mirror GCMS state into the native block the renderer reads
+            // val stateMirror = GameStateMirror(GameEngineBridge())
+            // gcms.statePublisher = { stateMirror.publish(it) }
+            
+            // Fan game events out to the native audio and renderer directly
+            // val nativeEvents = NativeEventBus(GameEngineBridge())
+            // gcms.eventPublisher = { nativeEvents.publish(it) }
+            
+            // Or run the card rules natively: commands go to the native core,
+            // which publishes state and events itself, so neither publisher
+            // above is set. Tick once per frame from the game loop.
+            // val pipeline = NativeCommandPipeline(GameEngineBridge())
+            // gcms.commandSink = { pipeline.submit(it) }
+            // gcms.emitNativeEvents(pipeline.tick(deltaTime))
+            
             // Create renderer and audio
-            // renderer = GameRenderer(gcms, rendererBridge!!, assetLoader)
-            // audio = GameAudio(gcms, audioBridge!!, assetLoader)
+            // renderer = GameRenderer(gcms, rendererBridge!!, assetLoader, stateMirror)
+            // audio = GameAudio(gcms, audioBridge!!, assetLoader, nativeEventSounds = true)
             
             // Start renderer and audio
             // renderer?.start()
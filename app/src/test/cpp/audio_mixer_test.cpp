@@ -0,0 +1,384 @@
+#include "audio_mixer.h"
+#include "mixer_timeline.h"
+#include "offline_backend.h"
+#include "wav_decoder.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+constexpr int kRate = 48000;
+
+// Int16 steps are exact in float, and the gains below are powers of two, so
+// every expected value is exact and comparisons can use ==
+PcmBuffer makeRamp(int frames, int channelCount, int step) {
+    PcmBuffer pcm;
+    pcm.channelCount = channelCount;
+    pcm.sampleRate = kRate;
+    for (int f = 0; f < frames; ++f) {
+        for (int ch = 0; ch < channelCount; ++ch) {
+            pcm.samples.push_back(static_cast<float>((f + 1) * step * (ch + 1)) / 32768.0f);
+        }
+    }
+    return pcm;
+}
+
+std::unique_ptr<AudioData> makeVoice(const PcmBuffer& pcm, SampleEncoding encoding = SampleEncoding::Int16) {
+    std::unique_ptr<AudioData> voice(new AudioData());
+    voice->store = SampleStore::fromPcm(pcm, encoding);
+    voice->isLoaded = true;
+    return voice;
+}
+
+struct Rig {
+    SoundMixer sounds;
+    MusicMixer music;
+    MixBus bus;
+    OfflineBackend backend{kRate, 64};
+    std::vector<AudioData*> soundTable;
+    std::vector<AudioData*> trackTable;
+
+    Rig() {
+        bus.add(&sounds);
+        bus.add(&music);
+        backend.open(&bus);
+        backend.start();
+    }
+
+    const std::vector<float>& run(const MixerTimeline& timeline, int64_t frames) {
+        timeline.run(sounds, music, soundTable, trackTable, backend, frames);
+        return backend.output();
+    }
+};
+
+MixerEvent event(int64_t frame, MixerEvent::Type type, int id = 0, float value = 1.0f, bool loop = false) {
+    MixerEvent e;
+    e.frame = frame;
+    e.type = type;
+    e.id = id;
+    e.value = value;
+    e.loop = loop;
+    return e;
+}
+
+} // namespace
+
+TEST(AudioMixerTest, SoundStartsOnItsExactFrame) {
+    PcmBuffer ramp = makeRamp(100, 1, 7);
+    auto voice = makeVoice(ramp);
+    Rig rig;
+    rig.soundTable.push_back(voice.get());
+
+    // 137 is deliberately not a multiple of the backend buffer size
+    MixerTimeline timeline;
+    timeline.add(event(137, MixerEvent::Type::PlaySound));
+    const std::vector<float>& out = rig.run(timeline, 400);
+
+    ASSERT_EQ(out.size(), 800u);
+    for (int f = 0; f < 400; ++f) {
+        float expected = (f >= 137 && f < 237) ? ramp.samples[f - 137] : 0.0f;
+        ASSERT_EQ(out[f * 2], expected) << "frame " << f;
+        ASSERT_EQ(out[f * 2 + 1], expected) << "frame " << f;
+    }
+    EXPECT_FALSE(rig.sounds.isPlaying(0));
+}
+
+TEST(AudioMixerTest, VoicesSumWithGain) {
+    PcmBuffer mono = makeRamp(300, 1, 3);
+    PcmBuffer stereo = makeRamp(300, 2, 5);
+    auto a = makeVoice(mono);
+    auto b = makeVoice(stereo);
+    Rig rig;
+    rig.soundTable = {a.get(), b.get()};
+
+    MixerTimeline timeline;
+    timeline.add(event(0, MixerEvent::Type::PlaySound, 0, 0.5f));
+    timeline.add(event(10, MixerEvent::Type::PlaySound, 1, 0.25f));
+    timeline.add(event(20, MixerEvent::Type::SetMasterVolume, 0, 0.5f));
+    const std::vector<float>& out = rig.run(timeline, 320);
+
+    for (int f = 0; f < 320; ++f) {
+        // Master volume applies from the first render after its frame
+        float master = f >= 20 ? 0.5f : 1.0f;
+        for (int ch = 0; ch < 2; ++ch) {
+            float expected = 0.0f;
+            if (f < 300) expected += mono.samples[f] * (0.5f * master);
+            if (f >= 10 && f < 310) expected += stereo.samples[(f - 10) * 2 + ch] * (0.25f * master);
+            ASSERT_EQ(out[f * 2 + ch], expected) << "frame " << f << " ch " << ch;
+        }
+    }
+
+    // Play gains stay with the voices; the assets keep their own level
+    EXPECT_EQ(a->volume.load(), 1.0f);
+    EXPECT_EQ(b->volume.load(), 1.0f);
+}
+
+TEST(AudioMixerTest, StopAndRetriggerAreFrameAccurate) {
+    PcmBuffer ramp = makeRamp(1000, 1, 1);
+    auto voice = makeVoice(ramp);
+    Rig rig;
+    rig.soundTable.push_back(voice.get());
+
+    MixerTimeline timeline;
+    timeline.add(event(0, MixerEvent::Type::PlaySound));
+    timeline.add(event(50, MixerEvent::Type::StopSound));
+    timeline.add(event(80, MixerEvent::Type::PlaySound));
+    timeline.add(event(90, MixerEvent::Type::PlaySound));
+    const std::vector<float>& out = rig.run(timeline, 200);
+
+    for (int f = 0; f < 200; ++f) {
+        float expected = 0.0f;
+        if (f < 50) expected = ramp.samples[f];
+        else if (f >= 80 && f < 90) expected = ramp.samples[f - 80];
+        else if (f >= 90) expected = ramp.samples[f - 90];
+        ASSERT_EQ(out[f * 2], expected) << "frame " << f;
+    }
+}
+
+TEST(AudioMixerTest, MusicLoopsUntilStopped) {
+    PcmBuffer loop = makeRamp(37, 2, 11);
+    auto track = makeVoice(loop);
+    Rig rig;
+    rig.trackTable.push_back(track.get());
+
+    MixerTimeline timeline;
+    timeline.add(event(5, MixerEvent::Type::PlayMusic, 0, 1.0f, true));
+    timeline.add(event(300, MixerEvent::Type::StopMusic));
+    const std::vector<float>& out = rig.run(timeline, 400);
+
+    for (int f = 0; f < 400; ++f) {
+        for (int ch = 0; ch < 2; ++ch) {
+            float expected = (f >= 5 && f < 300) ? loop.samples[((f - 5) % 37) * 2 + ch] : 0.0f;
+            ASSERT_EQ(out[f * 2 + ch], expected) << "frame " << f;
+        }
+    }
+}
+
+TEST(AudioMixerTest, AdpcmRenderMatchesDirectDecode) {
+    PcmBuffer ramp = makeRamp(1500, 2, 17);
+    auto voice = makeVoice(ramp, SampleEncoding::ImaAdpcm);
+    Rig rig;
+    rig.soundTable.push_back(voice.get());
+
+    MixerTimeline timeline;
+    timeline.add(event(3, MixerEvent::Type::PlaySound));
+    const std::vector<float>& out = rig.run(timeline, 1600);
+
+    // Block-wise decoding inside the mixer must agree with one straight decode
+    PcmBuffer decoded;
+    voice->store.decodeAll(decoded);
+    for (int f = 0; f < 1500; ++f) {
+        ASSERT_EQ(out[(f + 3) * 2], decoded.samples[f * 2]) << "frame " << f;
+        ASSERT_EQ(out[(f + 3) * 2 + 1], decoded.samples[f * 2 + 1]) << "frame " << f;
+    }
+}
+
+TEST(AudioMixerTest, RenderIsDeterministicAndSurvivesWavRoundTrip) {
+    PcmBuffer sfx = makeRamp(700, 1, 9);
+    PcmBuffer song = makeRamp(2000, 2, 4);
+    std::map<std::string, int> soundIds = {{"flip", 0}};
+    std::map<std::string, int> trackIds = {{"theme", 0}};
+    const std::string script =
+        "# music under two overlapping cues\n"
+        "0    music theme loop 0.5\n"
+        "100  play flip\n"
+        "450  play flip 0.25   # retrigger\n"
+        "2000 master 0.5\n"
+        "3000 end\n";
+
+    std::vector<float> renders[2];
+    for (auto& render : renders) {
+        auto flip = makeVoice(sfx);
+        auto theme = makeVoice(song, SampleEncoding::ImaAdpcm);
+        Rig rig;
+        rig.soundTable.push_back(flip.get());
+        rig.trackTable.push_back(theme.get());
+
+        MixerTimeline timeline;
+        std::string error;
+        ASSERT_TRUE(timeline.parse(script, soundIds, trackIds, &error)) << error;
+        ASSERT_EQ(timeline.lengthFrames(kRate), 3000);
+        render = rig.run(timeline, timeline.lengthFrames(kRate));
+
+        if (&render == &renders[1]) {
+            std::string path = testing::TempDir() + "audio_mixer_test.wav";
+            ASSERT_TRUE(rig.backend.writeWav(path.c_str()));
+
+            std::ifstream file(path, std::ios::binary);
+            std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+            std::remove(path.c_str());
+
+            PcmBuffer decoded;
+            ASSERT_TRUE(decodeWav(bytes.data(), bytes.size(), decoded));
+            EXPECT_EQ(decoded.sampleRate, kRate);
+            EXPECT_EQ(decoded.channelCount, 2);
+            ASSERT_EQ(decoded.samples.size(), render.size());
+            EXPECT_EQ(std::memcmp(decoded.samples.data(), render.data(), render.size() * sizeof(float)), 0);
+        }
+    }
+
+    ASSERT_EQ(renders[0].size(), 6000u);
+    EXPECT_EQ(std::memcmp(renders[0].data(), renders[1].data(), renders[0].size() * sizeof(float)), 0);
+}
+
+TEST(AudioMixerTest, ScriptErrorsReportTheLine) {
+    std::map<std::string, int> soundIds = {{"flip", 0}};
+    std::map<std::string, int> trackIds;
+    MixerTimeline timeline;
+    std::string error;
+
+    EXPECT_FALSE(timeline.parse("0 play flip\n\n10 play missing\n", soundIds, trackIds, &error));
+    EXPECT_EQ(error, "line 3: unknown sound 'missing'");
+    EXPECT_FALSE(timeline.parse("5 jump\n", soundIds, trackIds, &error));
+    EXPECT_EQ(error, "line 1: unknown command 'jump'");
+    EXPECT_FALSE(timeline.parse("play flip\n", soundIds, trackIds, &error));
+    EXPECT_EQ(error, "line 1: expected a frame number");
+}
+
+TEST(AudioMixerTest, ScheduledSoundLandsMidBuffer) {
+    PcmBuffer ramp = makeRamp(100, 1, 7);
+    auto voice = makeVoice(ramp);
+    SoundMixer mixer;
+    OfflineBackend backend(kRate, 192);
+    backend.open(&mixer);
+    backend.start();
+
+    // Scheduled up front, so the backend renders whole buffers across the cue
+    ASSERT_TRUE(mixer.schedulePlay(300, 0, voice.get(), 0.5f));
+    ASSERT_TRUE(mixer.scheduleStop(350, 0));
+    backend.render(576);
+    EXPECT_EQ(mixer.framePosition(), 576);
+
+    const std::vector<float>& out = backend.output();
+    for (int f = 0; f < 576; ++f) {
+        float expected = (f >= 300 && f < 350) ? ramp.samples[f - 300] * 0.5f : 0.0f;
+        ASSERT_EQ(out[f * 2], expected) << "frame " << f;
+    }
+
+    // A frame already rendered is late: it plays from the start of the next buffer
+    ASSERT_TRUE(mixer.schedulePlay(10, 0, voice.get(), 1.0f));
+    backend.render(192);
+    EXPECT_EQ(out[576 * 2], ramp.samples[0]);
+}
+
+TEST(AudioMixerTest, ScheduleQueueReportsOverflow) {
+    AudioData voice;
+    SoundMixer mixer;
+    for (uint32_t i = 0; i < ScheduledCommands::kMaxScheduled; ++i) {
+        ASSERT_TRUE(mixer.schedulePlay(1000 + i, 0, &voice, 1.0f));
+    }
+    EXPECT_FALSE(mixer.schedulePlay(5000, 0, &voice, 1.0f));
+    EXPECT_FALSE(mixer.schedulePlay(0, SoundMixer::kMaxVoices, &voice, 1.0f));
+
+    // Far-future commands never take the room immediate ones need
+    EXPECT_TRUE(mixer.schedulePlay(kFrameNow, 0, &voice, 1.0f));
+    EXPECT_TRUE(mixer.scheduleStop(kFrameNow, 0));
+}
+
+TEST(AudioMixerTest, MusicPauseKeepsPosition) {
+    PcmBuffer song = makeRamp(1000, 2, 3);
+    auto track = makeVoice(song);
+    Rig rig;
+    rig.trackTable.push_back(track.get());
+
+    MixerTimeline timeline;
+    timeline.add(event(0, MixerEvent::Type::PlayMusic, 0, 1.0f, false));
+    timeline.add(event(100, MixerEvent::Type::PauseMusic));
+    timeline.add(event(250, MixerEvent::Type::ResumeMusic));
+    const std::vector<float>& out = rig.run(timeline, 600);
+
+    for (int f = 0; f < 600; ++f) {
+        float expected = 0.0f;
+        if (f < 100) expected = song.samples[f * 2];
+        else if (f >= 250) expected = song.samples[(f - 150) * 2];
+        ASSERT_EQ(out[f * 2], expected) << "frame " << f;
+    }
+}
+
+TEST(AudioMixerTest, CrossfadeRampsBetweenTracks) {
+    PcmBuffer quiet;
+    PcmBuffer loud;
+    quiet.channelCount = loud.channelCount = 2;
+    quiet.sampleRate = loud.sampleRate = kRate;
+    quiet.samples.assign(2000, 0.25f);
+    loud.samples.assign(2000, 0.5f);
+    auto a = makeVoice(quiet);
+    auto b = makeVoice(loud);
+    Rig rig;
+    rig.trackTable = {a.get(), b.get()};
+
+    MixerTimeline timeline;
+    timeline.add(event(0, MixerEvent::Type::PlayMusic, 0, 1.0f, true));
+    MixerEvent fade = event(100, MixerEvent::Type::CrossfadeMusic, 1, 1.0f, true);
+    fade.fadeFrames = 64;
+    timeline.add(fade);
+    const std::vector<float>& out = rig.run(timeline, 400);
+
+    for (int f = 0; f < 400; ++f) {
+        float expected = 0.25f;
+        if (f >= 164) {
+            expected = 0.5f;
+        } else if (f >= 100) {
+            float t = static_cast<float>(f - 100) / 64.0f;
+            expected = 0.25f * (1.0f - t) + 0.5f * t;
+        }
+        ASSERT_NEAR(out[f * 2], expected, 1e-6f) << "frame " << f;
+        ASSERT_EQ(out[f * 2], out[f * 2 + 1]);
+    }
+}
+
+TEST(AudioMixerTest, CrossfadeDuringCrossfadeKeepsTheOutgoingRamp) {
+    PcmBuffer first;
+    PcmBuffer second;
+    PcmBuffer third;
+    first.channelCount = second.channelCount = third.channelCount = 2;
+    first.sampleRate = second.sampleRate = third.sampleRate = kRate;
+    first.samples.assign(2000, 0.25f);
+    second.samples.assign(2000, 0.5f);
+    third.samples.assign(2000, 0.125f);
+    auto a = makeVoice(first);
+    auto b = makeVoice(second);
+    auto c = makeVoice(third);
+    Rig rig;
+    rig.trackTable = {a.get(), b.get(), c.get()};
+
+    MixerTimeline timeline;
+    timeline.add(event(0, MixerEvent::Type::PlayMusic, 0, 1.0f, true));
+    MixerEvent toSecond = event(100, MixerEvent::Type::CrossfadeMusic, 1, 1.0f, true);
+    toSecond.fadeFrames = 64;
+    timeline.add(toSecond);
+    MixerEvent toThird = event(132, MixerEvent::Type::CrossfadeMusic, 2, 1.0f, true);
+    toThird.fadeFrames = 64;
+    timeline.add(toThird);
+    const std::vector<float>& out = rig.run(timeline, 300);
+
+    // The first track keeps its own ramp to silence; the second fades out
+    // from the half gain it had reached
+    for (int f = 0; f < 300; ++f) {
+        float expected = 0.25f;
+        if (f >= 100) {
+            float firstGain = std::max(0.0f, 1.0f - static_cast<float>(f - 100) / 64.0f);
+            float secondGain = static_cast<float>(f - 100) / 64.0f;
+            float thirdGain = 0.0f;
+            if (f >= 132) {
+                float t = std::min(1.0f, static_cast<float>(f - 132) / 64.0f);
+                secondGain = 0.5f * (1.0f - t);
+                thirdGain = t;
+            }
+            expected = 0.25f * firstGain + 0.5f * secondGain + 0.125f * thirdGain;
+        }
+        ASSERT_NEAR(out[f * 2], expected, 1e-6f) << "frame " << f;
+    }
+}
@@ -0,0 +1,117 @@
+#include "card_tracker.h"
+#include "game_core.h"
+#include "game_test_util.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+
+using namespace TrashPiles;
+using namespace TrashPiles::TestUtil;
+
+TEST(CardTracker, OddsFollowTheUnseenCards) {
+    CardTracker tracker;
+    for (int rank = 0; rank < CardTracker::kRankCount; ++rank) {
+        EXPECT_FLOAT_EQ(tracker.rankOdds(0, rank), 4.0f / 52.0f);
+    }
+
+    // Three aces face up, and player 1 drew the fourth
+    tracker.revealed(makeCardCode(0, 0, true));
+    tracker.discarded(makeCardCode(0, 1, true));
+    tracker.revealed(makeCardCode(0, 2, true));
+    tracker.drawn(1, makeCardCode(0, 3, false), false);
+
+    EXPECT_EQ(tracker.unseenCount(0), 49);
+    EXPECT_EQ(tracker.unseenOfRank(0, 0), 1);
+    EXPECT_FLOAT_EQ(tracker.rankOdds(0, 0), 1.0f / 49.0f);
+    EXPECT_EQ(tracker.unseenCount(1), 48);
+    EXPECT_FLOAT_EQ(tracker.rankOdds(1, 0), 0.0f);
+    // A spectator sees what player 0 sees
+    EXPECT_EQ(tracker.seen(-1), tracker.seen(0));
+    EXPECT_EQ(tracker.deckCount(), 51);
+
+    float odds[CardTracker::kRankCount];
+    tracker.rankOdds(1, odds);
+    float total = 0.0f;
+    for (float rankOdds : odds) total += rankOdds;
+    EXPECT_NEAR(total, 1.0f, 1e-6f);
+    EXPECT_FLOAT_EQ(odds[5], 4.0f / 48.0f);
+
+    // Slot 0 takes the last ace or any of the twelve wilds
+    EXPECT_FLOAT_EQ(tracker.fitOdds(0, 0x1), 13.0f / 49.0f);
+    EXPECT_FLOAT_EQ(tracker.fitOdds(0, 0x6), 20.0f / 49.0f);
+    EXPECT_FLOAT_EQ(tracker.fitOdds(0, 0), 0.0f);
+}
+
+TEST(CardTracker, ReshuffleForgetsTheReturnedCards) {
+    CardTracker tracker;
+    for (int i = 0; i < 10; ++i) tracker.dealt();
+    int first = makeCardCode(3, 0, false);
+    tracker.drawn(0, first, false);
+    tracker.discarded(first | kCardFaceUp);
+    tracker.discarded(makeCardCode(4, 0, true));
+    tracker.discarded(makeCardCode(5, 0, true));
+    tracker.drawn(1, kNoCard, true);
+    EXPECT_EQ(tracker.discardTop(), makeCardCode(4, 0, false));
+    EXPECT_EQ(tracker.unseenCount(0), 49);
+
+    tracker.reshuffled();
+    EXPECT_EQ(tracker.discardCount(), 1);
+    EXPECT_EQ(tracker.deckCount(), 42);
+    // Only the kept top card and the one player 1 took stay seen
+    EXPECT_EQ(tracker.seen(0), CardTracker::cardBit(makeCardCode(4, 0, false)) |
+                               CardTracker::cardBit(makeCardCode(5, 0, false)));
+    EXPECT_EQ(tracker.unseenOfRank(0, 3), 4);
+}
+
+TEST(CardTracker, GameCoreTrackerMatchesARescan) {
+    StateBlock block;
+    GameCore core(block, nullptr, 47);
+    std::mt19937 random(74);
+    startGame(core, 4);
+
+    int reshuffles = 0;
+    int lastDeck = core.deckCount();
+    for (int turn = 0; turn < 400 && core.phase() == GamePhase::Playing; ++turn) {
+        int player = core.currentPlayer();
+        bool fromDiscard = core.discardCount() > 0 && random() % 3 == 0;
+        core.apply(makeCommand(GameCommandType::DrawCard, player, -1, fromDiscard ? 1 : 0));
+        reshuffles += core.deckCount() > lastDeck;
+
+        const CardTracker& tracker = core.tracker();
+        int held = core.heldCard();
+        ASSERT_EQ(tracker.deckCount(), core.deckCount()) << "turn " << turn;
+        ASSERT_EQ(tracker.discardCount(), core.discardCount()) << "turn " << turn;
+
+        // Rescan: the face-up hand cards are public, the face-down ones unseen
+        // by everyone, and only the drawer knows a card from the deck
+        int faceDown = 0;
+        uint64_t faceUpCards = 0;
+        for (int seat = 0; seat < core.playerCount(); ++seat) {
+            for (int slot = 0; slot < core.handCount(seat); ++slot) {
+                int card = core.handCard(seat, slot);
+                if (card & kCardFaceUp) {
+                    faceUpCards |= CardTracker::cardBit(card);
+                } else {
+                    ++faceDown;
+                    for (int observer = -1; observer < core.playerCount(); ++observer) {
+                        ASSERT_FALSE(tracker.seen(observer) & CardTracker::cardBit(card)) << "turn " << turn;
+                    }
+                }
+            }
+        }
+        ASSERT_EQ(tracker.seen(-1) & faceUpCards, faceUpCards) << "turn " << turn;
+        ASSERT_EQ(tracker.unseenCount(-1), core.deckCount() + faceDown + (fromDiscard ? 0 : 1)) << "turn " << turn;
+        ASSERT_TRUE(tracker.seen(player) & CardTracker::cardBit(held)) << "turn " << turn;
+        ASSERT_EQ(tracker.unseenCount(player), core.deckCount() + faceDown) << "turn " << turn;
+
+        // Mostly discard, so the deck runs out and reshuffles
+        uint32_t slots = core.placeableSlots(player, held);
+        if (slots && random() % 4 == 0) {
+            core.apply(makeCommand(GameCommandType::PlaceCard, player, __builtin_ctz(slots)));
+        }
+        if (core.phase() == GamePhase::Playing) core.apply(makeCommand(GameCommandType::EndTurn, player));
+        lastDeck = core.deckCount();
+    }
+    EXPECT_GT(reshuffles, 0);
+}
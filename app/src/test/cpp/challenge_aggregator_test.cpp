@@ -0,0 +1,180 @@
+#include "challenge_aggregator.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+using ChallengeSet = ChallengeAggregator::ChallengeSet;
+
+ChallengeGoal goalOf(int challenge, ChallengeEvent event, int32_t target, int32_t key = -1, bool atMost = false) {
+    ChallengeGoal goal;
+    goal.challenge = challenge;
+    goal.event = event;
+    goal.key = key;
+    goal.target = target;
+    goal.atMost = atMost;
+    return goal;
+}
+
+ChallengeSet setOf(std::initializer_list<int> ids) {
+    ChallengeSet set;
+    for (int id : ids) set.set(id);
+    return set;
+}
+
+} // namespace
+
+TEST(ChallengeAggregator, CountersFoldAsTheKotlinEventsDo) {
+    std::vector<ChallengeGoal> goals = {
+        goalOf(0, ChallengeEvent::ScoreEarned, 150),
+        goalOf(1, ChallengeEvent::ComboAchieved, 4),
+        goalOf(2, ChallengeEvent::CardPlaced, 3),
+        goalOf(3, ChallengeEvent::AbilityUsed, 2, 7),
+        goalOf(3, ChallengeEvent::SkillUnlocked, 1, 2),
+    };
+
+    ChallengeAggregator aggregator;
+    ASSERT_EQ(aggregator.build(4, goals.data(), static_cast<int>(goals.size())), ChallengeAggregator::BuildResult::Ok);
+
+    EXPECT_TRUE(aggregator.dispatch(ChallengeEvent::ScoreEarned, -1, 100).none());
+    EXPECT_EQ(aggregator.dispatch(ChallengeEvent::ScoreEarned, -1, 60), setOf({0}));
+    EXPECT_EQ(aggregator.counter(0), 160);
+
+    // Combos keep the best, not the sum
+    aggregator.dispatch(ChallengeEvent::ComboAchieved, -1, 3);
+    EXPECT_TRUE(aggregator.dispatch(ChallengeEvent::ComboAchieved, -1, 2).none());
+    EXPECT_EQ(aggregator.counter(1), 3);
+    EXPECT_EQ(aggregator.dispatch(ChallengeEvent::ComboAchieved, -1, 4), setOf({1}));
+
+    // Cards count events and ignore the amount
+    aggregator.dispatch(ChallengeEvent::CardPlaced, -1, 50);
+    aggregator.dispatch(ChallengeEvent::CardPlaced, -1, 0);
+    EXPECT_EQ(aggregator.dispatch(ChallengeEvent::CardPlaced, -1, 0), setOf({2}));
+
+    // Keyed goals only hear their own key
+    aggregator.dispatch(ChallengeEvent::AbilityUsed, 7, 0);
+    aggregator.dispatch(ChallengeEvent::AbilityUsed, 8, 0);
+    aggregator.dispatch(ChallengeEvent::SkillUnlocked, 2, 0);
+    EXPECT_EQ(aggregator.unmetGoals(3), 1);
+    EXPECT_EQ(aggregator.dispatch(ChallengeEvent::AbilityUsed, 7, 0), setOf({3}));
+    EXPECT_EQ(aggregator.completed(), setOf({0, 1, 2, 3}));
+}
+
+TEST(ChallengeAggregator, EventsVisitOnlyTheirSubscribers) {
+    std::vector<ChallengeGoal> goals;
+    for (int challenge = 0; challenge < 40; ++challenge) {
+        goals.push_back(goalOf(challenge, ChallengeEvent::PointsEarned, 1000));
+        goals.push_back(goalOf(challenge, ChallengeEvent::AbilityUsed, 5, challenge % 4));
+    }
+    goals.push_back(goalOf(40, ChallengeEvent::PerfectRound, 1));
+
+    ChallengeAggregator aggregator;
+    ASSERT_EQ(aggregator.build(41, goals.data(), static_cast<int>(goals.size())), ChallengeAggregator::BuildResult::Ok);
+
+    aggregator.dispatch(ChallengeEvent::PerfectRound, -1, 0);
+    EXPECT_EQ(aggregator.lastVisited(), 1);
+    aggregator.dispatch(ChallengeEvent::AbilityUsed, 1, 0);
+    EXPECT_EQ(aggregator.lastVisited(), 10);
+    aggregator.dispatch(ChallengeEvent::AbilityUsed, 9, 0);
+    EXPECT_EQ(aggregator.lastVisited(), 0);
+    aggregator.dispatch(ChallengeEvent::CardPlaced, -1, 0);
+    EXPECT_EQ(aggregator.lastVisited(), 0);
+
+    // Completed challenges drop out
+    aggregator.dispatch(ChallengeEvent::PerfectRound, -1, 0);
+    EXPECT_EQ(aggregator.lastVisited(), 0);
+}
+
+TEST(ChallengeAggregator, TimeLimitsAndTrivialChallenges) {
+    std::vector<ChallengeGoal> goals = {
+        goalOf(0, ChallengeEvent::TimeElapsed, 90, -1, true),
+        goalOf(0, ChallengeEvent::PerfectRound, 1),
+        goalOf(1, ChallengeEvent::ScoreEarned, 0),
+    };
+
+    ChallengeAggregator aggregator;
+    ASSERT_EQ(aggregator.build(3, goals.data(), static_cast<int>(goals.size())), ChallengeAggregator::BuildResult::Ok);
+    EXPECT_EQ(aggregator.unmetGoals(0), 1);
+
+    // Nothing left to meet: complete on the first event of any kind
+    EXPECT_EQ(aggregator.dispatch(ChallengeEvent::TimeElapsed, -1, 120), setOf({1, 2}));
+    EXPECT_EQ(aggregator.unmetGoals(0), 2);
+    EXPECT_TRUE(aggregator.dispatch(ChallengeEvent::PerfectRound, -1, 0).none());
+    aggregator.dispatch(ChallengeEvent::TimeElapsed, -1, 80);
+    EXPECT_TRUE(aggregator.completed().test(0));
+}
+
+TEST(ChallengeAggregator, RejectsBadGoals) {
+    ChallengeAggregator aggregator;
+    ChallengeGoal unkeyed = goalOf(0, ChallengeEvent::SkillUnlocked, 1);
+    EXPECT_EQ(aggregator.build(1, &unkeyed, 1), ChallengeAggregator::BuildResult::BadGoal);
+
+    ChallengeGoal stray = goalOf(3, ChallengeEvent::ScoreEarned, 1);
+    EXPECT_EQ(aggregator.build(2, &stray, 1), ChallengeAggregator::BuildResult::BadGoal);
+    EXPECT_EQ(aggregator.build(ChallengeAggregator::kMaxChallenges + 1, nullptr, 0),
+              ChallengeAggregator::BuildResult::TooManyChallenges);
+    EXPECT_EQ(aggregator.challengeCount(), 0);
+}
+
+TEST(ChallengeAggregator, MatchesFullRecheckOnRandomEvents) {
+    std::mt19937 random(41);
+    std::vector<ChallengeGoal> goals;
+    for (int challenge = 0; challenge < 30; ++challenge) {
+        for (int g = 0, n = 1 + static_cast<int>(random() % 3); g < n; ++g) {
+            auto event = static_cast<ChallengeEvent>(random() % ChallengeAggregator::kEventCount);
+            int32_t key = ChallengeAggregator::isKeyed(event) ? static_cast<int32_t>(random() % 5) : -1;
+            bool atMost = event == ChallengeEvent::TimeElapsed;
+            goals.push_back(goalOf(challenge, event, 1 + static_cast<int32_t>(random() % 40), key, atMost));
+        }
+    }
+
+    ChallengeAggregator aggregator;
+    ASSERT_EQ(aggregator.build(30, goals.data(), static_cast<int>(goals.size())), ChallengeAggregator::BuildResult::Ok);
+
+    // Reference: one counter per goal, every goal re-checked after every event
+    std::vector<int32_t> counters(goals.size(), 0);
+    ChallengeSet done;
+    for (int step = 0; step < 400; ++step) {
+        auto event = static_cast<ChallengeEvent>(random() % ChallengeAggregator::kEventCount);
+        int32_t key = static_cast<int32_t>(random() % 5);
+        int32_t amount = static_cast<int32_t>(random() % 12);
+
+        ChallengeSet newly = aggregator.dispatch(event, key, amount);
+
+        ChallengeSet expectedNew;
+        for (size_t g = 0; g < goals.size(); ++g) {
+            const ChallengeGoal& goal = goals[g];
+            if (goal.event != event || (ChallengeAggregator::isKeyed(event) && goal.key != key)) continue;
+            if (done.test(goal.challenge)) continue;
+            switch (event) {
+                case ChallengeEvent::ScoreEarned:
+                case ChallengeEvent::PointsEarned: counters[g] += amount; break;
+                case ChallengeEvent::ComboAchieved:
+                case ChallengeEvent::GameWon: counters[g] = std::max(counters[g], amount); break;
+                case ChallengeEvent::TimeElapsed: counters[g] = amount; break;
+                case ChallengeEvent::SkillUnlocked: counters[g] = 1; break;
+                default: counters[g] += 1; break;
+            }
+        }
+        for (int challenge = 0; challenge < 30; ++challenge) {
+            if (done.test(challenge)) continue;
+            bool complete = true;
+            for (size_t g = 0; g < goals.size(); ++g) {
+                if (goals[g].challenge != challenge) continue;
+                const ChallengeGoal& goal = goals[g];
+                if (goal.atMost ? counters[g] > goal.target : counters[g] < goal.target) complete = false;
+            }
+            if (complete) expectedNew.set(challenge);
+        }
+        done |= expectedNew;
+
+        ASSERT_EQ(newly, expectedNew) << "step " << step;
+        ASSERT_EQ(aggregator.completed(), done) << "step " << step;
+    }
+}
@@ -0,0 +1,196 @@
+#include "endgame_table.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+#include <tuple>
+#include <vector>
+
+using namespace TrashPiles;
+using namespace EndgameTableFormat;
+
+namespace {
+
+using State = std::tuple<std::vector<int>, int, int>;
+
+// Value iteration over the same turn model, written from the rules rather
+// than the solver's closed form: each turn the discard top is a random
+// unseen card, taken if that is better than drawing; a fitting card fills a
+// slot and leaves the unseen cards
+double referenceTurns(const std::vector<int>& naturals, int wilds, int unseen, std::map<State, double>& memo) {
+    if (naturals.empty()) return 0.0;
+    State key(naturals, wilds, unseen);
+    auto found = memo.find(key);
+    if (found != memo.end()) return found->second;
+
+    // Every slot without naturals left needs a wild of its own
+    const double infinity = std::numeric_limits<double>::infinity();
+    if (std::count(naturals.begin(), naturals.end(), 0) > wilds) return infinity;
+    int slots = static_cast<int>(naturals.size());
+    auto without = [&](int skip) {
+        std::vector<int> rest(naturals);
+        rest.erase(rest.begin() + skip);
+        return rest;
+    };
+
+    std::vector<double> natural(slots, infinity);
+    for (int i = 0; i < slots; ++i) {
+        if (naturals[i] > 0) natural[i] = referenceTurns(without(i), wilds, unseen - 1, memo);
+    }
+    double wild = infinity;
+    for (int j = 0; wilds > 0 && j < slots; ++j) {
+        wild = std::min(wild, referenceTurns(without(j), wilds - 1, unseen - 1, memo));
+    }
+
+    double miss = 1.0;
+    for (int count : naturals) miss -= static_cast<double>(count) / unseen;
+    miss -= static_cast<double>(wilds) / unseen;
+
+    double turns = 0.0;
+    for (int iteration = 0; iteration < 100000; ++iteration) {
+        double draw = miss * turns;
+        for (int i = 0; i < slots; ++i) {
+            if (naturals[i] > 0) draw += static_cast<double>(naturals[i]) / unseen * natural[i];
+        }
+        if (wilds > 0) draw += static_cast<double>(wilds) / unseen * wild;
+
+        double next = 1.0 + miss * draw;
+        for (int i = 0; i < slots; ++i) {
+            if (naturals[i] > 0) next += static_cast<double>(naturals[i]) / unseen * std::min(natural[i], draw);
+        }
+        if (wilds > 0) next += static_cast<double>(wilds) / unseen * std::min(wild, draw);
+
+        bool settled = std::fabs(next - turns) < 1e-12;
+        turns = next;
+        if (settled || std::isinf(turns)) break;
+    }
+    memo.emplace(key, turns);
+    return turns;
+}
+
+uint32_t indexOf(const std::vector<int>& naturals, int wilds, int unseen) {
+    uint8_t counts[kMaxOpenSlots] = {};
+    for (size_t i = 0; i < naturals.size(); ++i) counts[i] = static_cast<uint8_t>(naturals[i]);
+    return entryIndex(static_cast<int>(naturals.size()), counts, wilds, unseen);
+}
+
+} // namespace
+
+TEST(EndgameTable, MatchesValueIteration) {
+    EndgameSolver solver;
+
+    // One slot with one natural left among ten cards: each turn has two
+    // looks, so it finishes within a turn with chance 1 - 0.9^2
+    EXPECT_NEAR(solver.expectedTurns(indexOf({1}, 0, 10)), 1.0 / 0.19, 1e-9);
+    EXPECT_TRUE(std::isinf(solver.expectedTurns(indexOf({0, 2}, 0, 20))));
+
+    std::map<State, double> memo;
+    int checked = 0;
+    for (int unseen : {6, 13, 31}) {
+        for (int wilds : {0, 1, 3}) {
+            for (int a = 0; a <= kMaxNaturals; ++a) {
+                for (int b = 0; b <= kMaxNaturals; ++b) {
+                    for (std::vector<int> naturals : {std::vector<int>{a}, std::vector<int>{a, b},
+                                                      std::vector<int>{a, b, (a + b) % 3}}) {
+                        int fitting = wilds;
+                        for (int count : naturals) fitting += count;
+                        if (fitting > unseen || fitting == 0) continue;
+
+                        double expected = referenceTurns(naturals, wilds, unseen, memo);
+                        double solved = solver.expectedTurns(indexOf(naturals, wilds, unseen));
+                        if (std::isinf(expected)) {
+                            ASSERT_TRUE(std::isinf(solved));
+                        } else {
+                            ASSERT_NEAR(solved, expected, 1e-6 * expected)
+                                << naturals.size() << " slots, " << wilds << " wilds, " << unseen << " unseen";
+                            ++checked;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    EXPECT_GT(checked, 100);
+}
+
+TEST(EndgameTable, AdvisesFromTheTrackedPosition) {
+    EndgameSolver solver;
+    std::vector<uint8_t> image;
+    solver.build(image);
+    EndgameTableView view;
+    ASSERT_EQ(view.open(image.data(), image.size()), EndgameTableView::OpenResult::Ok);
+
+    // Slots 2, 5 and 7 face down; every five has been seen, and two eights
+    CardTracker tracker;
+    for (int suit = 0; suit < 4; ++suit) tracker.revealed(makeCardCode(4, suit, true));
+    tracker.revealed(makeCardCode(7, 0, true));
+    tracker.discarded(makeCardCode(7, 1, true));
+    HandBits hand;
+    hand.slots = HandKernels::kFullHand;
+    hand.faceUp = static_cast<uint16_t>(HandKernels::kFullHand & ~((1u << 2) | (1u << 5) | (1u << 7)));
+
+    EndgamePosition position;
+    ASSERT_TRUE(EndgamePosition::from(hand, tracker, 0, &position));
+    ASSERT_EQ(position.openSlots, 3);
+    EXPECT_EQ(position.slots[1], 5);
+    EXPECT_EQ(position.naturals[0], 4);
+    EXPECT_EQ(position.naturals[1], 4);
+    EXPECT_EQ(position.naturals[2], 2);
+    EXPECT_EQ(position.wilds, 12);
+    EXPECT_EQ(position.unseen, 46);
+
+    // A wild fills the slot whose naturals are scarcest
+    EndgameAdvice advice;
+    ASSERT_TRUE(view.advise(position, makeCardCode(11, 2, true), &advice));
+    EXPECT_TRUE(advice.takeDiscard);
+    EXPECT_EQ(advice.wildSlot, 7);
+    EXPECT_EQ(advice.discardSlot, 7);
+    EXPECT_NEAR(advice.expectedTurns, solver.expectedTurns(indexOf({4, 4, 2}, 12, 46)), 1.0 / kTurnScale);
+
+    // A fitting natural is taken, anything else is not
+    ASSERT_TRUE(view.advise(position, makeCardCode(2, 0, true), &advice));
+    EXPECT_TRUE(advice.takeDiscard);
+    EXPECT_EQ(advice.discardSlot, 2);
+    ASSERT_TRUE(view.advise(position, makeCardCode(3, 0, true), &advice));
+    EXPECT_FALSE(advice.takeDiscard);
+    ASSERT_TRUE(view.advise(position, kNoCard, &advice));
+    EXPECT_FALSE(advice.takeDiscard);
+
+    // Outside the table: too many slots open, or no way to finish
+    hand.faceUp = 0;
+    EXPECT_FALSE(EndgamePosition::from(hand, tracker, 0, &position));
+    position = EndgamePosition();
+    position.openSlots = 1;
+    position.unseen = 20;
+    EXPECT_FALSE(view.advise(position, kNoCard, &advice));
+}
+
+TEST(EndgameTable, RejectsMalformedImages) {
+    EndgameSolver solver;
+    std::vector<uint8_t> image;
+    solver.build(image);
+    EndgameTableView view;
+
+    EXPECT_EQ(view.open(image.data(), sizeof(Header) - 1), EndgameTableView::OpenResult::TooSmall);
+    EXPECT_EQ(view.open(image.data(), image.size() - 4), EndgameTableView::OpenResult::BadSize);
+
+    std::vector<uint8_t> copy(image);
+    copy[0] = 'X';
+    EXPECT_EQ(view.open(copy.data(), copy.size()), EndgameTableView::OpenResult::BadMagic);
+
+    copy = image;
+    reinterpret_cast<Header*>(copy.data())->maxOpenSlots = 4;
+    EXPECT_EQ(view.open(copy.data(), copy.size()), EndgameTableView::OpenResult::BadShape);
+
+    copy = image;
+    reinterpret_cast<Header*>(copy.data())->entriesOffset = sizeof(Header) + 4;
+    EXPECT_EQ(view.open(copy.data(), copy.size()), EndgameTableView::OpenResult::BadSection);
+    EXPECT_FALSE(view.isOpen());
+
+    std::vector<uint8_t> shifted(image.size() + 1);
+    std::copy(image.begin(), image.end(), shifted.begin() + 1);
+    EXPECT_EQ(view.open(shifted.data() + 1, image.size()), EndgameTableView::OpenResult::Misaligned);
+}
@@ -0,0 +1,121 @@
+#include "event_bus.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+GameEvent makeEvent(GameEventType type, int32_t value, int32_t playerId = 0) {
+    GameEvent event;
+    event.type = type;
+    event.value = value;
+    event.playerId = playerId;
+    return event;
+}
+
+} // namespace
+
+TEST(EventBus, EverySubscriberSeesEveryEventInOrder) {
+    EventBus bus;
+    EventBus::Subscriber* audio = bus.subscribe("audio");
+    EventBus::Subscriber* renderer = bus.subscribe("renderer");
+    ASSERT_NE(audio, nullptr);
+    ASSERT_NE(renderer, nullptr);
+
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(bus.publish(makeEvent(GameEventType::CardPlaced, i)));
+    }
+
+    for (EventBus::Subscriber* subscriber : {audio, renderer}) {
+        GameEvent event;
+        for (int i = 0; i < 10; ++i) {
+            ASSERT_TRUE(bus.poll(subscriber, event));
+            EXPECT_EQ(event.value, i);
+        }
+        EXPECT_FALSE(bus.poll(subscriber, event));
+        EXPECT_EQ(subscriber->delivered.load(), 10u);
+        EXPECT_EQ(subscriber->dropped.load(), 0u);
+        EXPECT_EQ(bus.lag(subscriber), 0u);
+    }
+    EXPECT_EQ(bus.published(), 10u);
+}
+
+TEST(EventBus, SubscribersStartAtTheNextEventAndFilterByType) {
+    EventBus bus;
+    bus.publish(makeEvent(GameEventType::GameStarted, 0));
+
+    EventBus::Subscriber* turns = bus.subscribe("turns",
+        gameEventBit(GameEventType::TurnStarted) | gameEventBit(GameEventType::TurnEnded));
+    bus.publish(makeEvent(GameEventType::TurnStarted, 1));
+    bus.publish(makeEvent(GameEventType::CardDrawn, 2));
+    bus.publish(makeEvent(GameEventType::TurnEnded, 3));
+
+    GameEvent event;
+    ASSERT_TRUE(bus.poll(turns, event));
+    EXPECT_EQ(event.type, GameEventType::TurnStarted);
+    ASSERT_TRUE(bus.poll(turns, event));
+    EXPECT_EQ(event.type, GameEventType::TurnEnded);
+    EXPECT_FALSE(bus.poll(turns, event));
+}
+
+TEST(EventBus, LappedSubscriberSkipsAheadAndCountsDrops) {
+    EventBus bus;
+    EventBus::Subscriber* slow = bus.subscribe("slow");
+
+    const int total = static_cast<int>(EventBus::kCapacity) + 10;
+    for (int i = 0; i < total; ++i) {
+        bus.publish(makeEvent(GameEventType::CardDealt, i));
+    }
+
+    GameEvent event;
+    ASSERT_TRUE(bus.poll(slow, event));
+    EXPECT_EQ(event.value, 10);
+    EXPECT_EQ(slow->dropped.load(), 10u);
+
+    int received = 1;
+    while (bus.poll(slow, event)) ++received;
+    EXPECT_EQ(received, static_cast<int>(EventBus::kCapacity));
+    EXPECT_EQ(event.value, total - 1);
+}
+
+TEST(EventBus, ConcurrentProducersKeepPerProducerOrder) {
+    EventBus bus;
+    EventBus::Subscriber* consumer = bus.subscribe("consumer");
+    const int perProducer = 5000;
+    std::atomic<int> finished{0};
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < 2; ++p) {
+        producers.emplace_back([&bus, &finished, p, perProducer]() {
+            for (int i = 0; i < perProducer; ++i) {
+                bus.publish(makeEvent(GameEventType::CardDrawn, i, p));
+            }
+            ++finished;
+        });
+    }
+
+    int last[2] = {-1, -1};
+    int outOfOrder = 0;
+    GameEvent event;
+    for (;;) {
+        bool done = finished.load() == 2;
+        while (bus.poll(consumer, event)) {
+            if (event.value <= last[event.playerId]) ++outOfOrder;
+            last[event.playerId] = event.value;
+        }
+        if (done) break;
+        std::this_thread::yield();
+    }
+    for (auto& producer : producers) producer.join();
+
+    EXPECT_EQ(outOfOrder, 0);
+    // Every ticket is either read or skipped; a publish that lost its slot
+    // leaves a ticket the consumer skips
+    EXPECT_EQ(consumer->delivered.load() + consumer->dropped.load(), static_cast<uint64_t>(2 * perProducer));
+    EXPECT_LE(bus.publishDropped(), consumer->dropped.load());
+}
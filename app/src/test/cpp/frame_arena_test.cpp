@@ -0,0 +1,137 @@
+#include "frame_arena.h"
+#include "alloc_tracker.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+using namespace TrashPiles;
+
+namespace {
+
+// Keeps the compiler from pairing up and eliding a test's new and delete
+void* volatile g_sink;
+
+void allocateAndFree(size_t size) {
+    char* block = new char[size];
+    g_sink = block;
+    delete[] static_cast<char*>(g_sink);
+}
+
+} // namespace
+
+TEST(FrameArena, AllocationsAreAlignedAndResetTogether) {
+    FrameArena arena(256);
+
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(8, 8);
+    void* c = arena.allocate(16, 16);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    ASSERT_NE(c, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(b) % 8, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(c) % 16, 0u);
+    EXPECT_GE(arena.used(), 27u);
+
+    size_t used = arena.used();
+    arena.reset();
+    EXPECT_EQ(arena.used(), 0u);
+    EXPECT_EQ(arena.highWater(), used);
+
+    // The next frame gets the same memory back
+    EXPECT_EQ(arena.allocate(3, 1), a);
+    EXPECT_EQ(arena.highWater(), used);
+}
+
+TEST(FrameArena, FullArenaFailsInsteadOfGrowing) {
+    FrameArena arena(64);
+
+    ASSERT_NE(arena.allocate(60, 1), nullptr);
+    EXPECT_EQ(arena.allocate(8, 1), nullptr);
+    EXPECT_EQ(arena.allocateArray<int>(4), nullptr);
+    EXPECT_EQ(arena.overflows(), 2u);
+    EXPECT_EQ(arena.used(), 60u);
+
+    arena.reset();
+    int* values = arena.allocateArray<int>(16);
+    ASSERT_NE(values, nullptr);
+    EXPECT_EQ(arena.allocateArray<int>(1), nullptr);
+    EXPECT_EQ(arena.overflows(), 3u);
+}
+
+TEST(FrameArena, CopyStringTerminates) {
+    FrameArena arena(32);
+
+    const char* text = "ace of spades";
+    char* copy = arena.copyString(text, 3);
+    ASSERT_NE(copy, nullptr);
+    EXPECT_STREQ(copy, "ace");
+    EXPECT_EQ(arena.used(), 4u);
+
+    EXPECT_EQ(arena.copyString(text, 40), nullptr);
+}
+
+TEST(AllocTracker, SizeBucketsDoubleFromSixteenBytes) {
+    EXPECT_EQ(AllocTracker::sizeBucket(0), 0);
+    EXPECT_EQ(AllocTracker::sizeBucket(16), 0);
+    EXPECT_EQ(AllocTracker::sizeBucket(17), 1);
+    EXPECT_EQ(AllocTracker::sizeBucket(32), 1);
+    EXPECT_EQ(AllocTracker::sizeBucket(33), 2);
+    EXPECT_EQ(AllocTracker::sizeBucket(32 * 1024), AllocTracker::kSizeBuckets - 2);
+    EXPECT_EQ(AllocTracker::sizeBucket(32 * 1024 + 1), AllocTracker::kSizeBuckets - 1);
+    EXPECT_EQ(AllocTracker::sizeBucket(size_t(1) << 40), AllocTracker::kSizeBuckets - 1);
+}
+
+TEST(AllocTracker, ScopesChargeTheirSubsystem) {
+    // This test binary links the operator new hooks
+    ASSERT_TRUE(AllocTracker::isHooked());
+    AllocTracker::reset();
+
+    {
+        AllocScope renderer(AllocSubsystem::Renderer);
+        allocateAndFree(24);
+        {
+            AllocScope audio(AllocSubsystem::Audio);
+            allocateAndFree(100);
+            allocateAndFree(100);
+        }
+        allocateAndFree(24);
+    }
+    EXPECT_EQ(AllocTracker::currentSubsystem(), AllocSubsystem::Other);
+
+    AllocTracker::Counts renderer = AllocTracker::total(AllocSubsystem::Renderer);
+    AllocTracker::Counts audio = AllocTracker::total(AllocSubsystem::Audio);
+    EXPECT_EQ(renderer.allocations, 2u);
+    EXPECT_EQ(renderer.bytes, 48u);
+    EXPECT_EQ(audio.allocations, 2u);
+    EXPECT_EQ(audio.bytes, 200u);
+    EXPECT_GE(AllocTracker::sizeBucketCount(AllocTracker::sizeBucket(24)), 2u);
+    EXPECT_GE(AllocTracker::sizeBucketCount(AllocTracker::sizeBucket(100)), 2u);
+    EXPECT_GE(AllocTracker::frees(), 4u);
+}
+
+TEST(AllocTracker, FramesReportTheirOwnAllocations) {
+    ASSERT_TRUE(AllocTracker::isHooked());
+    AllocTracker::reset();
+
+    {
+        AllocScope scope(AllocSubsystem::Renderer);
+        for (int i = 0; i < 5; ++i) allocateAndFree(64);
+    }
+    AllocTracker::markFrame();
+
+    AllocTracker::FrameStats stats = AllocTracker::frameStats();
+    EXPECT_EQ(stats.frames, 1u);
+    EXPECT_EQ(stats.lastFrameBySubsystem[static_cast<int>(AllocSubsystem::Renderer)].allocations, 5u);
+    EXPECT_EQ(stats.lastFrameBySubsystem[static_cast<int>(AllocSubsystem::Renderer)].bytes, 320u);
+    EXPECT_GE(stats.maxFrameAllocations, 5u);
+
+    // Nothing allocated in between: a steady frame
+    AllocTracker::markFrame();
+    stats = AllocTracker::frameStats();
+    EXPECT_EQ(stats.frames, 2u);
+    EXPECT_EQ(stats.lastFrame.allocations, 0u);
+    EXPECT_EQ(stats.allocationFreeFrames, 1u);
+    EXPECT_EQ(stats.frameHistogram[0], 1u);
+    EXPECT_GE(stats.maxFrameAllocations, 5u);
+}
@@ -0,0 +1,261 @@
+#include "game_core.h"
+#include "game_test_util.h"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace TrashPiles;
+using namespace TrashPiles::TestUtil;
+
+namespace {
+
+std::vector<GameEvent> drainEvents(EventBus& bus, EventBus::Subscriber* subscriber) {
+    std::vector<GameEvent> events;
+    GameEvent event;
+    while (bus.poll(subscriber, event)) events.push_back(event);
+    return events;
+}
+
+} // namespace
+
+TEST(CommandQueue, KeepsEachProducersOrderAcrossThreads) {
+    CommandQueue queue;
+    constexpr int kProducers = 4;
+    constexpr int kPerProducer = 5000;
+
+    std::vector<std::thread> producers;
+    for (int p = 0; p < kProducers; ++p) {
+        producers.emplace_back([&queue, p]() {
+            for (int i = 0; i < kPerProducer; ++i) {
+                GameCommand command = makeCommand(GameCommandType::DrawCard, p, -1, i);
+                while (!queue.push(command)) std::this_thread::yield();
+            }
+        });
+    }
+
+    int next[kProducers] = {};
+    int received = 0;
+    GameCommand batch[32];
+    while (received < kProducers * kPerProducer) {
+        int count = queue.drain(batch, 32);
+        for (int i = 0; i < count; ++i) {
+            EXPECT_EQ(batch[i].value, next[batch[i].playerId]++);
+        }
+        received += count;
+    }
+    for (auto& producer : producers) producer.join();
+
+    EXPECT_EQ(queue.pushed(), static_cast<uint64_t>(kProducers * kPerProducer));
+}
+
+TEST(CommandQueue, RejectsWhenFull) {
+    CommandQueue queue;
+    for (uint32_t i = 0; i < CommandQueue::kCapacity; ++i) {
+        ASSERT_TRUE(queue.push(makeCommand(GameCommandType::EndTurn)));
+    }
+    EXPECT_FALSE(queue.push(makeCommand(GameCommandType::EndTurn)));
+    EXPECT_EQ(queue.rejected(), 1u);
+
+    GameCommand batch[4];
+    EXPECT_EQ(queue.drain(batch, 4), 4);
+    EXPECT_TRUE(queue.push(makeCommand(GameCommandType::EndTurn)));
+}
+
+TEST(GameCore, StartDealsHandsAndPublishesState) {
+    StateBlock block;
+    EventBus bus;
+    EventBus::Subscriber* subscriber = bus.subscribe("test");
+    GameCore core(block, &bus, 7);
+
+    ASSERT_TRUE(core.submit(makeCommand(GameCommandType::InitializeGame, -1, -1, 2)));
+    ASSERT_TRUE(core.submit(makeCommand(GameCommandType::StartGame)));
+    EXPECT_EQ(core.tick(), 2);
+
+    EXPECT_EQ(core.phase(), GamePhase::Playing);
+    EXPECT_EQ(core.deckCount(), GameCore::kDeckSize - 20);
+
+    GameStateFields fields;
+    ASSERT_TRUE(block.read(fields));
+    EXPECT_EQ(fields.match.phase, static_cast<int32_t>(GamePhase::Playing));
+    EXPECT_EQ(fields.match.playerCount, 2);
+    EXPECT_EQ(fields.players[1].handCount, 10);
+    EXPECT_EQ(fields.hands[1][9], core.handCard(1, 9));
+
+    int dealt = 0;
+    for (const GameEvent& event : drainEvents(bus, subscriber)) {
+        if (event.type == GameEventType::CardDealt) ++dealt;
+    }
+    EXPECT_EQ(dealt, 20);
+}
+
+TEST(GameCore, RejectsOutOfTurnAndMismatchedPlacement) {
+    StateBlock block;
+    EventBus bus;
+    GameCore core(block, &bus, 11);
+    startGame(core, 2);
+    EventBus::Subscriber* subscriber = bus.subscribe("test");
+
+    EXPECT_EQ(core.apply(makeCommand(GameCommandType::DrawCard, 1)), CommandResult::NotYourTurn);
+    EXPECT_EQ(core.apply(makeCommand(GameCommandType::PlaceCard, 0, 0)), CommandResult::NoHeldCard);
+
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::DrawCard, 0)), CommandResult::Ok);
+    int held = core.heldCard();
+    int wrongSlot = GameCore::isWild(held) ? -1 : (GameCore::rankOf(held) + 1) % 10;
+    if (wrongSlot >= 0) {
+        EXPECT_EQ(core.apply(makeCommand(GameCommandType::PlaceCard, 0, wrongSlot)), CommandResult::CardMismatch);
+    }
+
+    std::vector<GameEvent> events = drainEvents(bus, subscriber);
+    ASSERT_GE(events.size(), 3u);
+    EXPECT_EQ(events[0].type, GameEventType::InvalidMove);
+    EXPECT_EQ(events[0].value, static_cast<int32_t>(CommandResult::NotYourTurn));
+    EXPECT_EQ(events[2].type, GameEventType::CardDrawn);
+    EXPECT_EQ(events[2].card, held);
+}
+
+TEST(GameCore, PlacesDrawnCardsUntilTheRoundIsWon) {
+    StateBlock block;
+    GameCore core(block, nullptr, 3);
+    startGame(core, 2);
+
+    // Each player places whatever fits and discards the rest
+    for (int turn = 0; turn < 2000 && core.phase() == GamePhase::Playing; ++turn) {
+        int player = core.currentPlayer();
+        ASSERT_EQ(core.apply(makeCommand(GameCommandType::DrawCard, player)), CommandResult::Ok);
+
+        int held = core.heldCard();
+        for (int slot = 0; slot < core.handCount(player); ++slot) {
+            if (!(core.handCard(player, slot) & kCardFaceUp) && GameCore::fitsSlot(held, slot)) {
+                ASSERT_EQ(core.apply(makeCommand(GameCommandType::PlaceCard, player, slot)), CommandResult::Ok);
+                break;
+            }
+        }
+        if (core.phase() == GamePhase::Playing) {
+            ASSERT_EQ(core.apply(makeCommand(GameCommandType::EndTurn, player)), CommandResult::Ok);
+        }
+    }
+
+    ASSERT_EQ(core.phase(), GamePhase::RoundEnd);
+    for (int slot = 0; slot < core.handCount(core.winner()); ++slot) {
+        EXPECT_TRUE(core.handCard(core.winner(), slot) & kCardFaceUp);
+    }
+
+    // The winner's next round deals one card fewer
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::StartGame)), CommandResult::Ok);
+    EXPECT_EQ(core.round(), 2);
+    EXPECT_EQ(core.handCount(0), 9);
+}
+
+TEST(GameCore, RulesQueriesMatchTheHand) {
+    StateBlock block;
+    GameCore core(block, nullptr, 5);
+    startGame(core, 2);
+
+    for (int player = 0; player < 2; ++player) {
+        EXPECT_EQ(core.penaltyScore(player), 10);
+        EXPECT_FALSE(core.hasWon(player));
+
+        for (int card = 0; card < GameCore::kDeckSize; ++card) {
+            uint32_t expected = 0;
+            for (int slot = 0; slot < core.handCount(player); ++slot) {
+                if (GameCore::fitsSlot(card, slot)) expected |= 1u << slot;
+            }
+            EXPECT_EQ(core.placeableSlots(player, card), expected);
+        }
+    }
+
+    // A wild card fits every face-down slot; placing one closes that slot
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::DrawCard, 0)), CommandResult::Ok);
+    uint32_t slots = core.placeableSlots(0, core.heldCard());
+    if (slots) {
+        int slot = __builtin_ctz(slots);
+        ASSERT_EQ(core.apply(makeCommand(GameCommandType::PlaceCard, 0, slot)), CommandResult::Ok);
+        EXPECT_EQ(core.penaltyScore(0), 9);
+        EXPECT_EQ(core.placeableSlots(0, GameCore::kWildRankStart * 4) & (1u << slot), 0u);
+        EXPECT_EQ(__builtin_popcount(core.placeableSlots(0, GameCore::kWildRankStart * 4)), 9);
+    }
+}
+
+TEST(GameCore, BurstIsOneBatchAndOneStatePublish) {
+    StateBlock block;
+    GameCore core(block, nullptr, 5);
+    startGame(core, 2);
+    uint32_t before = block.sequence();
+
+    // Rapid taps: flips across the hand plus turn changes
+    for (int i = 0; i < 10; ++i) {
+        ASSERT_TRUE(core.submit(makeCommand(GameCommandType::FlipCard, i % 2, i)));
+    }
+    ASSERT_TRUE(core.submit(makeCommand(GameCommandType::EndTurn, 0)));
+    ASSERT_TRUE(core.submit(makeCommand(GameCommandType::EndTurn, 1)));
+
+    EXPECT_EQ(core.tick(), 12);
+    EXPECT_EQ(block.sequence(), before + 2);
+    EXPECT_EQ(core.stats().maxBatch, 12);
+    EXPECT_EQ(core.currentPlayer(), 0);
+    EXPECT_EQ(core.tick(), 0);
+}
+
+TEST(RulesPolicy, VariantsFixTheirShapeAtCompileTime) {
+    static_assert(ClassicRules<4>::cardsForRound(1) == 10, "classic deals ten");
+    static_assert(ClassicRules<4>::cardsForRound(12) == 1, "at least one card");
+    static_assert(QuickRules<2>::cardsForRound(1) == 5, "quick deals five");
+    static_assert(QuickRules<2>::cardsForRound(4) == 2, "one fewer each round");
+    // A two-deck, six-player table holds each card code twice
+    using BigTable = RulesPolicy<6, 10, 2>;
+    static_assert(BigTable::kDeckSize == 104, "two decks");
+
+    HandBits hand;
+    hand.slots = QuickRules<2>::kFullHand;
+    hand.faceUp = 0x4;
+    // Ranks past the fifth slot fit nowhere; wilds fit every face-down slot
+    EXPECT_EQ(QuickRules<2>::placeableSlots(hand, 1), 0x2u);
+    EXPECT_EQ(QuickRules<2>::placeableSlots(hand, 2), 0u);
+    EXPECT_EQ(QuickRules<2>::placeableSlots(hand, 7), 0u);
+    EXPECT_EQ(QuickRules<2>::placeableSlots(hand, 11), 0x1Bu);
+    // Only kings wild
+    EXPECT_EQ((RulesPolicy<2, 10, 1, 12>::placeableSlots(hand, 11)), 0u);
+    EXPECT_FALSE((RulesPolicy<2, 10, 1, 12>::isWild(makeCardCode(11, 0, false))));
+}
+
+TEST(GameCore, QuickVariantDealsFiveSlotsAndRotatesThreePlayers) {
+    StateBlock block;
+    GameCore core(block, nullptr, 23);
+    GameCommand initialize = makeCommand(GameCommandType::InitializeGame, -1, 99, 3);
+    EXPECT_EQ(core.apply(initialize), CommandResult::UnknownRules);
+
+    initialize.slot = static_cast<int32_t>(RulesVariant::Quick);
+    ASSERT_EQ(core.apply(initialize), CommandResult::Ok);
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::StartGame)), CommandResult::Ok);
+    EXPECT_EQ(core.rulesVariant(), RulesVariant::Quick);
+    EXPECT_EQ(core.slotCount(), 5);
+    EXPECT_EQ(core.deckCount(), GameCore::kDeckSize - 15);
+    for (int player = 0; player < 3; ++player) {
+        EXPECT_EQ(core.handCount(player), 5);
+        EXPECT_EQ(core.handBits(player).slots, QuickRules<3>::kFullHand);
+    }
+    EXPECT_EQ(core.apply(makeCommand(GameCommandType::FlipCard, 0, 5)), CommandResult::InvalidSlot);
+
+    // Every held card fits one of the five slots or none
+    for (int turn = 0; turn < 6; ++turn) {
+        int player = core.currentPlayer();
+        EXPECT_EQ(player, turn % 3);
+        ASSERT_EQ(core.apply(makeCommand(GameCommandType::DrawCard, player)), CommandResult::Ok);
+        int held = core.heldCard();
+        uint32_t slots = core.placeableSlots(player, held);
+        EXPECT_EQ(slots & ~0x1Fu, 0u);
+        if (GameCore::rankOf(held) >= 5 && !GameCore::isWild(held)) {
+            EXPECT_EQ(slots, 0u);
+            EXPECT_EQ(core.apply(makeCommand(GameCommandType::PlaceCard, player, 0)), CommandResult::CardMismatch);
+        }
+        ASSERT_EQ(core.apply(makeCommand(GameCommandType::EndTurn, player)), CommandResult::Ok);
+    }
+
+    // Without a variant, a match is classic
+    GameCore classic(block, nullptr, 23);
+    ASSERT_EQ(classic.apply(makeCommand(GameCommandType::InitializeGame, -1, -1, 3)), CommandResult::Ok);
+    EXPECT_EQ(classic.rulesVariant(), RulesVariant::Classic);
+    EXPECT_EQ(classic.slotCount(), 10);
+}
@@ -0,0 +1,29 @@
+#ifndef TRASHPILES_GAME_TEST_UTIL_H
+#define TRASHPILES_GAME_TEST_UTIL_H
+
+#include "game_core.h"
+
+#include <gtest/gtest.h>
+
+namespace TrashPiles {
+namespace TestUtil {
+
+inline GameCommand makeCommand(GameCommandType type, int32_t playerId = -1, int32_t slot = -1, int32_t value = 0) {
+    GameCommand command;
+    command.type = type;
+    command.playerId = playerId;
+    command.slot = slot;
+    command.value = value;
+    return command;
+}
+
+// A classic match of the given size, first round dealt, first player to move
+inline void startGame(GameCore& core, int players) {
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::InitializeGame, -1, -1, players)), CommandResult::Ok);
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::StartGame)), CommandResult::Ok);
+}
+
+} // namespace TestUtil
+} // namespace TrashPiles
+
+#endif // TRASHPILES_GAME_TEST_UTIL_H
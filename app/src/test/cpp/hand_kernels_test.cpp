@@ -0,0 +1,119 @@
+#include "game_core.h"
+#include "hand_kernels.h"
+#include "game_test_util.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+using namespace TrashPiles::TestUtil;
+
+namespace {
+
+// A random hand of count cards, each face up with probability faceUpOdds/4
+std::vector<int8_t> randomHand(std::mt19937& random, int count, unsigned faceUpOdds) {
+    std::vector<int8_t> cards(kStateMaxHandSlots, kNoCard);
+    for (int slot = 0; slot < count; ++slot) {
+        int rank = (random() % 2) ? slot : static_cast<int>(random() % 13);
+        cards[slot] = makeCardCode(rank, static_cast<int>(random() % 4), random() % 4 < faceUpOdds);
+    }
+    return cards;
+}
+
+} // namespace
+
+TEST(HandKernels, MatchTheCardWalks) {
+    std::mt19937 random(46);
+    for (int trial = 0; trial < 2000; ++trial) {
+        int count = static_cast<int>(random() % (kStateMaxHandSlots + 1));
+        std::vector<int8_t> cards = randomHand(random, count, trial % 5);
+        HandBits hand = HandKernels::fromCards(cards.data(), kStateMaxHandSlots);
+
+        // As GameRules walks List<CardState>
+        int faceDown = 0;
+        bool ordered = count == kStateMaxHandSlots;
+        uint16_t wildTargets = 0;
+        for (int slot = 0; slot < count; ++slot) {
+            bool faceUp = cards[slot] & kCardFaceUp;
+            if (!faceUp) {
+                ++faceDown;
+                wildTargets |= static_cast<uint16_t>(1u << slot);
+            }
+            if (!faceUp || GameCore::rankOf(cards[slot]) != slot) ordered = false;
+        }
+
+        ASSERT_EQ(HandKernels::penalty(hand), faceDown);
+        ASSERT_EQ(HandKernels::emptySlots(hand), wildTargets);
+        ASSERT_EQ(HandKernels::isComplete(hand), count > 0 && faceDown == 0);
+        ASSERT_EQ(HandKernels::isOrderedWin(hand), ordered);
+        for (int rank = 0; rank < 13; ++rank) {
+            uint16_t expected = 0;
+            for (int slot = 0; slot < count; ++slot) {
+                if (!(cards[slot] & kCardFaceUp) && (rank >= 10 || rank == slot)) expected |= 1u << slot;
+            }
+            ASSERT_EQ(HandKernels::placeableSlots(hand, rank), expected) << "rank " << rank;
+        }
+    }
+}
+
+TEST(HandKernels, BatchesMatchSingleHands) {
+    std::mt19937 random(64);
+    // Not a multiple of the vector width, so the tail runs too
+    const size_t count = 203;
+    std::vector<uint16_t> slots(count), faceUp(count);
+    std::vector<HandBits> hands(count);
+    for (size_t i = 0; i < count; ++i) {
+        int dealt = static_cast<int>(random() % (kStateMaxHandSlots + 1));
+        std::vector<int8_t> cards = randomHand(random, dealt, i % 5);
+        hands[i] = HandKernels::fromCards(cards.data(), kStateMaxHandSlots);
+        slots[i] = hands[i].slots;
+        faceUp[i] = hands[i].faceUp;
+    }
+
+    std::vector<uint8_t> penalties(count), complete(count);
+    std::vector<uint16_t> placeable(count);
+    HandKernels::penalties(slots.data(), faceUp.data(), penalties.data(), count);
+    size_t completeCount = HandKernels::completeHands(slots.data(), faceUp.data(), complete.data(), count);
+
+    size_t expectedComplete = 0;
+    for (size_t i = 0; i < count; ++i) {
+        ASSERT_EQ(penalties[i], HandKernels::penalty(hands[i])) << "hand " << i;
+        ASSERT_EQ(complete[i] != 0, HandKernels::isComplete(hands[i])) << "hand " << i;
+        expectedComplete += HandKernels::isComplete(hands[i]) ? 1 : 0;
+    }
+    EXPECT_EQ(completeCount, expectedComplete);
+    EXPECT_GT(completeCount, 0u);
+
+    for (int rank : {0, 4, 9, 10, 12}) {
+        HandKernels::placeableSlots(slots.data(), faceUp.data(), rank, placeable.data(), count);
+        for (size_t i = 0; i < count; ++i) {
+            ASSERT_EQ(placeable[i], HandKernels::placeableSlots(hands[i], rank)) << "hand " << i;
+        }
+    }
+}
+
+TEST(HandKernels, GameCoreKeepsItsBitboardsInStep) {
+    StateBlock block;
+    GameCore core(block, nullptr, 46);
+    startGame(core, 3);
+
+    for (int turn = 0; turn < 120 && core.phase() == GamePhase::Playing; ++turn) {
+        int player = core.currentPlayer();
+        core.apply(makeCommand(GameCommandType::DrawCard, player));
+        uint32_t slots = core.placeableSlots(player, core.heldCard());
+        if (slots) core.apply(makeCommand(GameCommandType::PlaceCard, player, __builtin_ctz(slots)));
+        if (core.phase() == GamePhase::Playing) core.apply(makeCommand(GameCommandType::EndTurn, player));
+
+        for (int seat = 0; seat < core.playerCount(); ++seat) {
+            int8_t cards[kStateMaxHandSlots];
+            for (int slot = 0; slot < kStateMaxHandSlots; ++slot) cards[slot] = core.handCard(seat, slot);
+            HandBits expected = HandKernels::fromCards(cards, core.handCount(seat));
+            HandBits kept = core.handBits(seat);
+            ASSERT_EQ(kept.slots, expected.slots) << "turn " << turn;
+            ASSERT_EQ(kept.faceUp, expected.faceUp) << "turn " << turn;
+            ASSERT_EQ(kept.correct, expected.correct) << "turn " << turn;
+        }
+    }
+}
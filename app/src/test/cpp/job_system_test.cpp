@@ -0,0 +1,131 @@
+#include "job_system.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+struct Trace {
+    std::atomic<int> step{0};
+    int firstDone = -1;
+    int secondStarted = -1;
+};
+
+void recordFirst(void* context, int, int) {
+    Trace* trace = static_cast<Trace*>(context);
+    trace->firstDone = trace->step.fetch_add(1);
+}
+
+void recordSecond(void* context, int, int) {
+    Trace* trace = static_cast<Trace*>(context);
+    trace->secondStarted = trace->step.fetch_add(1);
+}
+
+struct Handoff {
+    std::atomic<bool> signalled{false};
+    std::atomic<bool> received{false};
+};
+
+void signalHandoff(void* context, int, int) {
+    static_cast<Handoff*>(context)->signalled = true;
+}
+
+// Gives up after a second so a missing steal fails instead of hanging
+void awaitHandoff(void* context, int, int) {
+    Handoff* handoff = static_cast<Handoff*>(context);
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!handoff->signalled.load()) {
+        if (std::chrono::steady_clock::now() > deadline) return;
+        std::this_thread::yield();
+    }
+    handoff->received = true;
+}
+
+} // namespace
+
+TEST(JobSystem, ParallelForVisitsEveryIndexOnce) {
+    JobSystem jobs(4);
+    std::vector<std::atomic<int>> visits(10000);
+
+    jobs.parallelFor(static_cast<int>(visits.size()), 16, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) visits[i].fetch_add(1);
+    });
+
+    for (const auto& count : visits) {
+        ASSERT_EQ(count.load(), 1);
+    }
+    EXPECT_GT(jobs.stats().executed, 1u);
+}
+
+TEST(JobSystem, NestedParallelForCompletes) {
+    JobSystem jobs(4);
+    std::atomic<int> total{0};
+
+    jobs.parallelFor(8, 1, [&](int begin, int end) {
+        for (int i = begin; i < end; ++i) {
+            jobs.parallelFor(1000, 10, [&](int innerBegin, int innerEnd) {
+                total.fetch_add(innerEnd - innerBegin);
+            });
+        }
+    });
+
+    EXPECT_EQ(total.load(), 8000);
+}
+
+TEST(JobSystem, ContinuationsRunAfterTheirDependency) {
+    JobSystem jobs(3);
+
+    for (int round = 0; round < 100; ++round) {
+        Trace trace;
+        JobCounter first;
+        JobCounter second;
+
+        jobs.run(jobs.create(&recordFirst, &trace, 0, 0, &first));
+        jobs.runAfter(first, jobs.create(&recordSecond, &trace, 0, 0, &second));
+        jobs.wait(second);
+
+        ASSERT_TRUE(first.isDone());
+        ASSERT_LT(trace.firstDone, trace.secondStarted);
+    }
+}
+
+TEST(JobSystem, IdleWorkersStealQueuedWork) {
+    JobSystem jobs(2);
+    Handoff handoff;
+    JobCounter counter;
+
+    // The caller pops the waiting job first (LIFO), so the job that releases
+    // it can only run if the other worker steals it
+    jobs.run(jobs.create(&signalHandoff, &handoff, 0, 0, &counter));
+    jobs.run(jobs.create(&awaitHandoff, &handoff, 0, 0, &counter));
+    jobs.wait(counter);
+
+    EXPECT_TRUE(handoff.received.load());
+    EXPECT_GT(jobs.stats().stolen, 0u);
+}
+
+TEST(JobSystem, CreateIsRefusedOffWorkerThreads) {
+    JobSystem jobs(2);
+    Job* job = nullptr;
+    std::thread outsider([&]() { job = jobs.create(&recordFirst, nullptr); });
+    outsider.join();
+    EXPECT_EQ(job, nullptr);
+}
+
+TEST(JobSystem, WorkerCountSkipsTheLittleCluster) {
+    // 4 LITTLE + 3 big + 1 prime
+    EXPECT_EQ(JobSystem::selectWorkerCount({1800000, 1800000, 1800000, 1800000,
+                                            2400000, 2400000, 2400000, 3000000}), 4);
+    // Homogeneous
+    EXPECT_EQ(JobSystem::selectWorkerCount({2000000, 2000000, 2000000, 2000000}), 4);
+    // Frequencies unreadable
+    EXPECT_EQ(JobSystem::selectWorkerCount({0, 0, 0}), 3);
+    EXPECT_EQ(JobSystem::selectWorkerCount({}), 1);
+    EXPECT_EQ(JobSystem::selectWorkerCount(std::vector<int64_t>(64, 1000000)), JobSystem::kMaxWorkers);
+}
@@ -0,0 +1,187 @@
+#include "progression_blob.h"
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace TrashPiles;
+using namespace TrashPiles::ProgressionBlobFormat;
+
+namespace {
+
+// Two skills (one behind the other and a node the catalog lacks), an
+// ability, a trophy and two challenge sets written out of level order
+const char* kCatalog =
+    "# kind\tfields...\n"
+    "node\tskill_b\tSecond\tNeeds the first\\tand more\tSCORE_BOOST(value=5)\t-\t3\t2\t20\t0\t1\t0\t-\t-\tskill_a,ghost\n"
+    "node\tskill_a\tFirst\tLine one\\nline two\tXP_BOOST(value=10)\ttrophy_first\t1\t1\t10\t0\t0\t0\t-\t-\t-\n"
+    "node\tability_x\tBlast\tBack\\\\slash\tREVEAL(count=2)\t-\t2\t4\t15\t1\t0\t1\t2\t1\tskill_a\n"
+    "trophy\ttrophy_first\tFirst Steps\tUnlock a skill\t-\t0\t0\t-\t50\t25\t5\t-\t10\t-\t-\t1\tskill_a\tability_x\n"
+    "set\t2\t1\n"
+    "challenge\tc2\tLate\tScore big\tBig Scorer\t-\t0\t2\t500\t0\t0\t0\t0\t0\t0\t5\t20\tability_x=3\tskill_b\n"
+    "set\t1\t2\n"
+    "challenge\tc1a\tEarly\tPlace cards\tPlacer\tgolden_pile\t1\t1\t0\t0\t0\t0\t8\t90\t0\t2\t10\t-\t-\n"
+    "challenge\tc1b\tCombo\tChain three\tComboist\t-\t2\t1\t0\t0\t3\t0\t0\t0\t0\t2\t10\t-\t-\n";
+
+std::vector<uint8_t> buildImage() {
+    ProgressionBlobWriter writer;
+    std::string error;
+    EXPECT_TRUE(writer.addCatalogText(kCatalog, &error)) << error;
+    std::vector<uint8_t> image;
+    EXPECT_TRUE(writer.build(image, &error)) << error;
+    return image;
+}
+
+Header& headerOf(std::vector<uint8_t>& image) {
+    return *reinterpret_cast<Header*>(image.data());
+}
+
+} // namespace
+
+TEST(ProgressionBlob, RoundTripsTheCatalog) {
+    std::vector<uint8_t> image = buildImage();
+    ProgressionBlobView view;
+    ASSERT_EQ(view.open(image.data(), image.size()), ProgressionBlobView::OpenResult::Ok);
+    EXPECT_EQ(view.nodeCount(), 3);
+    EXPECT_EQ(view.trophyCount(), 1);
+    EXPECT_EQ(view.challengeSetCount(), 2);
+    EXPECT_EQ(view.challengeCount(), 3);
+
+    // Nodes are sorted by id
+    EXPECT_STREQ(view.string(view.node(0).id), "ability_x");
+    EXPECT_STREQ(view.string(view.node(1).id), "skill_a");
+    EXPECT_STREQ(view.string(view.node(2).id), "skill_b");
+
+    const ProgressionBlobView::NodeRecord& first = view.node(1);
+    EXPECT_STREQ(view.string(first.description), "Line one\nline two");
+    EXPECT_STREQ(view.string(first.effect), "XP_BOOST(value=10)");
+    EXPECT_STREQ(view.string(first.trophyId), "trophy_first");
+    EXPECT_EQ(first.cost, 1);
+    EXPECT_EQ(first.xpReward, 10);
+    EXPECT_EQ(first.usesPerMatch, -1);
+    EXPECT_EQ(first.prerequisiteCount, 0);
+
+    const ProgressionBlobView::NodeRecord& ability = view.node(0);
+    EXPECT_STREQ(view.string(ability.description), "Back\\slash");
+    EXPECT_EQ(ability.pointType, 1);
+    EXPECT_EQ(ability.category, 1);
+    EXPECT_EQ(ability.usesPerMatch, 2);
+    EXPECT_EQ(ability.usesPerRound, 1);
+    EXPECT_EQ(view.string(view.node(2).trophyId), nullptr);
+
+    const ProgressionBlobView::TrophyRecord& trophy = view.trophy(0);
+    EXPECT_STREQ(view.string(trophy.name), "First Steps");
+    EXPECT_EQ(view.string(trophy.icon), nullptr);
+    EXPECT_EQ(trophy.pointType, kNoEnum);
+    EXPECT_EQ(trophy.xpReward, 50);
+    EXPECT_EQ(trophy.pointReward, 25);
+    EXPECT_EQ(trophy.thresholds[RequiredLevel], 5);
+    EXPECT_EQ(trophy.thresholds[MinTotalPoints], kNoValue);
+    EXPECT_EQ(trophy.thresholds[MinSkillPoints], 10);
+    EXPECT_EQ(trophy.thresholds[MinSkillsUnlocked], 1);
+    ASSERT_EQ(trophy.skillCount, 1);
+    EXPECT_STREQ(view.requirement(trophy.skillStart), "skill_a");
+    ASSERT_EQ(trophy.abilityCount, 1);
+    EXPECT_STREQ(view.requirement(trophy.abilityStart), "ability_x");
+}
+
+TEST(ProgressionBlob, ResolvesPrerequisitesAndChallengeSets) {
+    std::vector<uint8_t> image = buildImage();
+    ProgressionBlobView view;
+    ASSERT_EQ(view.open(image.data(), image.size()), ProgressionBlobView::OpenResult::Ok);
+
+    EXPECT_EQ(view.findNode("skill_a"), 1);
+    EXPECT_EQ(view.findNode("skill_b"), 2);
+    EXPECT_EQ(view.findNode("ghost"), -1);
+
+    // Prerequisites become node indices; unknown ids can never be met
+    const ProgressionBlobView::NodeRecord& second = view.node(2);
+    ASSERT_EQ(second.prerequisiteCount, 2);
+    EXPECT_EQ(view.prerequisite(second.prerequisiteStart), 1);
+    EXPECT_EQ(view.prerequisite(second.prerequisiteStart + 1), kMissingNode);
+
+    // Sets are sorted by level and own their challenges in catalog order
+    ASSERT_EQ(view.findChallengeSet(1), 0);
+    ASSERT_EQ(view.findChallengeSet(2), 1);
+    EXPECT_EQ(view.findChallengeSet(3), -1);
+
+    const ProgressionBlobView::ChallengeSetRecord& early = view.challengeSet(0);
+    EXPECT_EQ(early.requiredToComplete, 2);
+    ASSERT_EQ(early.challengeCount, 2);
+    const ProgressionBlobView::ChallengeRecord& placer = view.challenge(early.challengeStart);
+    EXPECT_STREQ(view.string(placer.id), "c1a");
+    EXPECT_STREQ(view.string(placer.specialReward), "golden_pile");
+    EXPECT_EQ(placer.cardsPlaced, 8);
+    EXPECT_EQ(placer.maxTimeSeconds, 90);
+    EXPECT_EQ(view.challenge(early.challengeStart + 1).comboCount, 3);
+
+    const ProgressionBlobView::ChallengeRecord& late = view.challenge(view.challengeSet(1).challengeStart);
+    EXPECT_EQ(late.score, 500);
+    ASSERT_EQ(late.abilityGoalCount, 1);
+    EXPECT_STREQ(view.string(view.abilityGoal(late.abilityGoalStart).abilityId), "ability_x");
+    EXPECT_EQ(view.abilityGoal(late.abilityGoalStart).uses, 3);
+    ASSERT_EQ(late.skillCount, 1);
+    EXPECT_STREQ(view.requirement(late.skillStart), "skill_b");
+}
+
+TEST(ProgressionBlob, RejectsDamagedImages) {
+    using OpenResult = ProgressionBlobView::OpenResult;
+    std::vector<uint8_t> good = buildImage();
+    ProgressionBlobView view;
+
+    std::vector<uint8_t> image = good;
+    headerOf(image).magic[0] = 'X';
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadMagic);
+
+    image = good;
+    headerOf(image).version = kVersion + 1;
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadVersion);
+
+    // Truncated in transit
+    EXPECT_EQ(view.open(good.data(), good.size() - 8), OpenResult::BadSize);
+    EXPECT_EQ(view.open(good.data(), sizeof(Header) - 1), OpenResult::TooSmall);
+
+    image = good;
+    headerOf(image).sections[Trophies].count = 1000;
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadSection);
+
+    image = good;
+    headerOf(image).sections[Nodes].offset += 4;
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadSection);
+
+    // An unterminated string table
+    image = good;
+    image[headerOf(image).stringsOffset + headerOf(image).stringsSize - 1] = 'x';
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadString);
+
+    // A string offset past the table
+    image = good;
+    reinterpret_cast<NodeRecord*>(image.data() + headerOf(image).sections[Nodes].offset)->name =
+        headerOf(image).stringsSize;
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadReference);
+
+    // A prerequisite index past the nodes
+    image = good;
+    uint16_t* prerequisites = reinterpret_cast<uint16_t*>(image.data() + headerOf(image).sections[Prerequisites].offset);
+    prerequisites[0] = 3;
+    EXPECT_EQ(view.open(image.data(), image.size()), OpenResult::BadReference);
+
+    // Records are read in place, so the mapping must be aligned
+    std::vector<uint8_t> shifted(good.size() + 1);
+    std::memcpy(shifted.data() + 1, good.data(), good.size());
+    EXPECT_EQ(view.open(shifted.data() + 1, good.size()), OpenResult::Misaligned);
+    EXPECT_FALSE(view.isOpen());
+}
+
+TEST(ProgressionBlob, ReportsTheMalformedLine) {
+    ProgressionBlobWriter writer;
+    std::string error;
+    EXPECT_FALSE(writer.addCatalogText("set\t1\t1\nchallenge\tc\tshort\n", &error));
+    EXPECT_NE(error.find("line 2"), std::string::npos) << error;
+
+    EXPECT_FALSE(writer.addCatalogText("node\tskill\tName\tDesc\tfx\t-\tcheap\t1\t1\t0\t0\t0\t-\t-\t-\n", &error));
+    EXPECT_NE(error.find("skill"), std::string::npos) << error;
+    EXPECT_FALSE(writer.addCatalogText("badge\tx\n", &error));
+}
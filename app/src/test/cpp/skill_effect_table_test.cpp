@@ -0,0 +1,169 @@
+#include "skill_effect_table.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+// Line-for-line port of the list functions in GameRules.kt
+struct KotlinEffect {
+    int playerId;
+    SkillEffectKind type;
+    float value;
+    int32_t duration;
+    int32_t remainingTurns;
+};
+
+struct KotlinEffects {
+    std::vector<KotlinEffect> list;
+
+    void add(int playerId, SkillEffectKind type, float value, int32_t duration) {
+        list.erase(std::remove_if(list.begin(), list.end(), [&](const KotlinEffect& it) {
+            return it.playerId == playerId && it.type == type && it.remainingTurns <= 0;
+        }), list.end());
+        list.push_back({playerId, type, value, duration, duration});
+    }
+
+    void update() {
+        std::vector<KotlinEffect> updated;
+        for (KotlinEffect effect : list) {
+            if (effect.duration > 0) effect.remainingTurns -= 1;
+            if (effect.remainingTurns > 0 || effect.duration == -1) updated.push_back(effect);
+        }
+        list = updated;
+    }
+
+    bool has(int playerId, SkillEffectKind type) const {
+        for (const KotlinEffect& it : list) {
+            if (it.playerId == playerId && it.type == type && (it.remainingTurns > 0 || it.duration == -1)) return true;
+        }
+        return false;
+    }
+
+    float value(int playerId, SkillEffectKind type) const {
+        for (const KotlinEffect& it : list) {
+            if (it.playerId == playerId && it.type == type && (it.remainingTurns > 0 || it.duration == -1)) {
+                return it.value;
+            }
+        }
+        return 1.0f;
+    }
+
+    int32_t calculateScore(int playerId, int32_t score) const {
+        int32_t finalScore = score;
+        for (const KotlinEffect& effect : list) {
+            if (effect.playerId != playerId) continue;
+            switch (effect.type) {
+                case SkillEffectKind::ScoreMultiplier:
+                    finalScore = static_cast<int32_t>(static_cast<float>(finalScore) * effect.value);
+                    break;
+                case SkillEffectKind::DoublePoints: finalScore *= 2; break;
+                case SkillEffectKind::Shield: finalScore = std::max(0, finalScore - 1); break;
+                default: break;
+            }
+        }
+        return finalScore;
+    }
+};
+
+} // namespace
+
+TEST(SkillEffectTable, ScoresApplyEffectsInListOrder) {
+    SkillEffectTable table;
+    EXPECT_EQ(table.score(0, 7), 7);
+
+    // Shield then double: (7 - 1) * 2; the other order would give 13
+    table.add(0, SkillEffectKind::Shield, 1.0f, 3);
+    table.add(0, SkillEffectKind::DoublePoints, 2.0f, 2);
+    EXPECT_EQ(table.score(0, 7), 12);
+
+    // Float multiply then truncate, as Int * Float .toInt()
+    table.add(1, SkillEffectKind::ScoreMultiplier, 1.5f, SkillEffectTable::kPermanent);
+    EXPECT_EQ(table.score(1, 5), 7);
+    EXPECT_EQ(table.score(1, 25), 37);
+
+    // Non-score effects leave scores alone
+    table.add(2, SkillEffectKind::DrawBonus, 3.0f, 5);
+    int32_t base[] = {7, 5, 4, 0};
+    int32_t out[4] = {};
+    table.scores(base, out, 4);
+    EXPECT_EQ(out[0], 12);
+    EXPECT_EQ(out[1], 7);
+    EXPECT_EQ(out[2], 4);
+    EXPECT_EQ(out[3], 0);
+}
+
+TEST(SkillEffectTable, TurnsExpireTimedEffects) {
+    SkillEffectTable table;
+    table.add(0, SkillEffectKind::DoublePoints, 2.0f, 2);
+    table.add(0, SkillEffectKind::LuckyDraw, 0.25f, SkillEffectTable::kPermanent);
+    EXPECT_TRUE(table.has(0, SkillEffectKind::DoublePoints));
+    EXPECT_FLOAT_EQ(table.value(0, SkillEffectKind::LuckyDraw), 0.25f);
+    EXPECT_FLOAT_EQ(table.value(1, SkillEffectKind::LuckyDraw), 1.0f);
+
+    table.advanceTurn();
+    EXPECT_EQ(table.score(0, 3), 6);
+    table.advanceTurn();
+    EXPECT_FALSE(table.has(0, SkillEffectKind::DoublePoints));
+    EXPECT_EQ(table.score(0, 3), 3);
+    EXPECT_EQ(table.activeCount(), 1);
+
+    // A zero-turn effect scores until the next turn but never counts as active
+    table.add(1, SkillEffectKind::Shield, 1.0f, 0);
+    EXPECT_FALSE(table.has(1, SkillEffectKind::Shield));
+    EXPECT_EQ(table.score(1, 3), 2);
+    table.advanceTurn();
+    EXPECT_EQ(table.score(1, 3), 3);
+}
+
+TEST(SkillEffectTable, RejectsWhenFull) {
+    SkillEffectTable table;
+    for (int i = 0; i < SkillEffectTable::kMaxEffects; ++i) {
+        ASSERT_TRUE(table.add(i % 4, SkillEffectKind::DrawBonus, 1.0f, 5));
+    }
+    EXPECT_FALSE(table.add(0, SkillEffectKind::Shield, 1.0f, 5));
+    EXPECT_FALSE(table.add(SkillEffectTable::kMaxPlayers, SkillEffectKind::Shield, 1.0f, 5));
+    table.clear();
+    EXPECT_EQ(table.activeCount(), 0);
+    EXPECT_TRUE(table.add(0, SkillEffectKind::Shield, 1.0f, 5));
+}
+
+TEST(SkillEffectTable, MatchesKotlinOnRandomTurns) {
+    std::mt19937 random(45);
+    const float values[] = {0.5f, 1.0f, 1.25f, 1.5f, 2.0f, 3.0f};
+    const int32_t durations[] = {-1, 0, 1, 2, 3, 5, -2};
+
+    SkillEffectTable table;
+    KotlinEffects reference;
+    for (int step = 0; step < 2000; ++step) {
+        if (random() % 3 == 0) {
+            table.advanceTurn();
+            reference.update();
+        } else if (reference.list.size() < SkillEffectTable::kMaxEffects) {
+            int player = static_cast<int>(random() % SkillEffectTable::kMaxPlayers);
+            auto type = static_cast<SkillEffectKind>(random() % SkillEffectTable::kTypeCount);
+            float value = values[random() % 6];
+            int32_t duration = durations[random() % 7];
+            ASSERT_TRUE(table.add(player, type, value, duration));
+            reference.add(player, type, value, duration);
+        }
+
+        ASSERT_EQ(table.activeCount(), static_cast<int>(reference.list.size())) << "step " << step;
+        for (int player = 0; player < SkillEffectTable::kMaxPlayers; ++player) {
+            for (int type = 0; type < SkillEffectTable::kTypeCount; ++type) {
+                auto kind = static_cast<SkillEffectKind>(type);
+                ASSERT_EQ(table.has(player, kind), reference.has(player, kind)) << "step " << step;
+                ASSERT_EQ(table.value(player, kind), reference.value(player, kind)) << "step " << step;
+            }
+            for (int32_t base = 0; base <= SkillEffectTable::kMaxBaseScore + 2; ++base) {
+                ASSERT_EQ(table.score(player, base), reference.calculateScore(player, base))
+                    << "step " << step << " player " << player << " base " << base;
+            }
+        }
+    }
+}
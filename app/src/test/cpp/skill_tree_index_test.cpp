@@ -0,0 +1,216 @@
+#include "skill_tree_index.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+using NodeSet = SkillTreeIndex::NodeSet;
+
+struct TreeBuilder {
+    std::vector<SkillNodeSpec> nodes;
+    std::vector<std::vector<int32_t>> prerequisites;
+
+    int add(int level, int cost, int tier, PointKind kind, std::vector<int32_t> needs = {}) {
+        SkillNodeSpec node;
+        node.level = level;
+        node.cost = cost;
+        node.tier = static_cast<uint8_t>(tier);
+        node.pointKind = kind;
+        nodes.push_back(node);
+        prerequisites.push_back(std::move(needs));
+        return static_cast<int>(nodes.size()) - 1;
+    }
+
+    SkillTreeIndex::BuildResult build(SkillTreeIndex& index) const {
+        std::vector<int32_t> offsets(1, 0);
+        std::vector<int32_t> ids;
+        for (const auto& list : prerequisites) {
+            ids.insert(ids.end(), list.begin(), list.end());
+            offsets.push_back(static_cast<int32_t>(ids.size()));
+        }
+        return index.build(nodes.data(), static_cast<int>(nodes.size()), offsets.data(), ids.data());
+    }
+};
+
+NodeSet setOf(std::initializer_list<int> ids) {
+    NodeSet set;
+    for (int id : ids) set.set(id);
+    return set;
+}
+
+// TreeNode.canUnlock, one node at a time
+bool canUnlockDirect(const TreeBuilder& tree, int id, int level, int skillPoints, int abilityPoints,
+                     const NodeSet& unlocked) {
+    const SkillNodeSpec& node = tree.nodes[id];
+    if (unlocked.test(id) || level < node.level) return false;
+    for (int32_t prerequisite : tree.prerequisites[id]) {
+        if (prerequisite < 0 || !unlocked.test(prerequisite)) return false;
+    }
+    switch (node.pointKind) {
+        case PointKind::Skill: return skillPoints >= node.cost;
+        case PointKind::Ability: return abilityPoints >= node.cost;
+        default: return false;
+    }
+}
+
+} // namespace
+
+TEST(BitSet, AlgebraAndIterationAcrossWords) {
+    BitSet<130> a;
+    a.set(0);
+    a.set(63);
+    a.set(64);
+    a.set(129);
+    EXPECT_EQ(a.count(), 4);
+    EXPECT_TRUE(a.test(64));
+    EXPECT_FALSE(a.test(65));
+
+    BitSet<130> b;
+    b.set(64);
+    b.set(100);
+    EXPECT_TRUE(a.intersects(b));
+    EXPECT_FALSE(b.isSubsetOf(a));
+    EXPECT_EQ((a & b).count(), 1);
+    EXPECT_EQ((a | b).count(), 5);
+
+    std::vector<int> seen;
+    a.subtract(b);
+    a.forEach([&seen](int id) { seen.push_back(id); });
+    EXPECT_EQ(seen, (std::vector<int>{0, 63, 129}));
+
+    // Words past the last bit stay clear
+    b.setWord(BitSet<130>::kWords - 1, ~uint64_t(0));
+    EXPECT_EQ(b.count(), 2 + 2);
+}
+
+TEST(SkillTreeIndex, ClosuresFollowEveryPath) {
+    TreeBuilder tree;
+    int root = tree.add(1, 1, 0, PointKind::Skill);
+    int left = tree.add(5, 2, 0, PointKind::Skill, {root});
+    int right = tree.add(6, 2, 0, PointKind::Ability, {root});
+    int top = tree.add(30, 10, 1, PointKind::Ability, {left, right});
+    int loose = tree.add(2, 1, 0, PointKind::Skill);
+
+    SkillTreeIndex index;
+    ASSERT_EQ(tree.build(index), SkillTreeIndex::BuildResult::Ok);
+    EXPECT_EQ(index.prerequisites(top), setOf({left, right}));
+    EXPECT_EQ(index.requirementClosure(top), setOf({root, left, right}));
+    EXPECT_TRUE(index.requirementClosure(loose).none());
+    EXPECT_EQ(index.missingFor(top, setOf({root, right})), setOf({left}));
+}
+
+TEST(SkillTreeIndex, EligibleNeedsLevelPointsAndPrerequisites) {
+    TreeBuilder tree;
+    int root = tree.add(1, 3, 0, PointKind::Skill);
+    int child = tree.add(5, 5, 0, PointKind::Ability, {root});
+    int expensive = tree.add(1, 50, 0, PointKind::Skill);
+    int invalid = tree.add(1, 0, 0, PointKind::Invalid);
+    int outside = tree.add(1, 0, 0, PointKind::Skill, {-1});
+
+    SkillTreeIndex index;
+    ASSERT_EQ(tree.build(index), SkillTreeIndex::BuildResult::Ok);
+
+    EXPECT_EQ(index.eligible(1, 3, 0, NodeSet()), setOf({root}));
+    EXPECT_EQ(index.eligible(1, 2, 0, NodeSet()), NodeSet());
+    EXPECT_EQ(index.eligible(5, 3, 5, NodeSet()), setOf({root}));
+    EXPECT_EQ(index.eligible(5, 3, 5, setOf({root})), setOf({child}));
+    EXPECT_EQ(index.eligible(4, 3, 5, setOf({root})), NodeSet());
+    EXPECT_EQ(index.eligible(200, 100, 100, setOf({root, child})), setOf({expensive}));
+
+    EXPECT_TRUE(index.canUnlock(child, 5, 0, 5, setOf({root})));
+    EXPECT_FALSE(index.canUnlock(child, 5, 5, 4, setOf({root})));
+    EXPECT_FALSE(index.canUnlock(invalid, 200, 100, 100, NodeSet()));
+    EXPECT_FALSE(index.canUnlock(outside, 200, 100, 100, NodeSet()));
+    EXPECT_FALSE(index.eligible(200, 100, 100, NodeSet()).test(outside));
+}
+
+TEST(SkillTreeIndex, PresortedLevelAndTierViews) {
+    TreeBuilder tree;
+    tree.add(20, 1, 0, PointKind::Skill);
+    tree.add(3, 1, 0, PointKind::Skill);
+    tree.add(20, 1, 0, PointKind::Ability);
+    tree.add(60, 1, 2, PointKind::Skill);
+    tree.add(25, 1, 1, PointKind::Skill);
+
+    SkillTreeIndex index;
+    ASSERT_EQ(tree.build(index), SkillTreeIndex::BuildResult::Ok);
+
+    SkillTreeIndex::NodeRange level20 = index.nodesAtLevel(20);
+    ASSERT_EQ(level20.count, 2);
+    EXPECT_EQ(level20.ids[0], 0);
+    EXPECT_EQ(level20.ids[1], 2);
+    EXPECT_EQ(index.nodesAtLevel(21).count, 0);
+
+    SkillTreeIndex::NodeRange newbie = index.nodesInTier(0);
+    ASSERT_EQ(newbie.count, 3);
+    EXPECT_EQ(newbie.ids[0], 1);
+    EXPECT_EQ(newbie.ids[1], 0);
+    EXPECT_EQ(newbie.ids[2], 2);
+    EXPECT_EQ(index.nodesInTier(1).count, 1);
+    EXPECT_EQ(index.nodesInTier(6).count, 0);
+
+    EXPECT_EQ(index.upToLevel(20), setOf({0, 1, 2}));
+    EXPECT_EQ(index.upToLevel(2), NodeSet());
+    EXPECT_EQ(index.upToLevel(1000), index.allNodes());
+}
+
+TEST(SkillTreeIndex, RejectsCyclesAndBadIds) {
+    SkillTreeIndex index;
+
+    TreeBuilder cycle;
+    cycle.add(1, 1, 0, PointKind::Skill, {2});
+    cycle.add(1, 1, 0, PointKind::Skill, {0});
+    cycle.add(1, 1, 0, PointKind::Skill, {1});
+    EXPECT_EQ(cycle.build(index), SkillTreeIndex::BuildResult::Cycle);
+    EXPECT_EQ(index.nodeCount(), 0);
+
+    TreeBuilder self;
+    self.add(1, 1, 0, PointKind::Skill, {0});
+    EXPECT_EQ(self.build(index), SkillTreeIndex::BuildResult::BadPrerequisite);
+
+    TreeBuilder range;
+    range.add(1, 1, 0, PointKind::Skill, {7});
+    EXPECT_EQ(range.build(index), SkillTreeIndex::BuildResult::BadPrerequisite);
+
+    TreeBuilder tier;
+    tier.add(1, 1, SkillTreeIndex::kTierCount, PointKind::Skill);
+    EXPECT_EQ(tier.build(index), SkillTreeIndex::BuildResult::BadNode);
+}
+
+TEST(SkillTreeIndex, MatchesNodeByNodeChecksOnARandomTree) {
+    std::mt19937 random(17);
+    TreeBuilder tree;
+    for (int id = 0; id < 150; ++id) {
+        std::vector<int32_t> needs;
+        for (int r = 0, n = id ? static_cast<int>(random() % 3) : 0; r < n; ++r) {
+            needs.push_back(static_cast<int32_t>(random() % id));
+        }
+        int level = 1 + static_cast<int>(random() % 200);
+        tree.add(level, static_cast<int>(random() % 60), std::min(level / 30, 6),
+                 random() % 2 ? PointKind::Skill : PointKind::Ability, needs);
+    }
+
+    SkillTreeIndex index;
+    ASSERT_EQ(tree.build(index), SkillTreeIndex::BuildResult::Ok);
+
+    for (int trial = 0; trial < 200; ++trial) {
+        NodeSet unlocked;
+        for (int id = 0; id < 150; ++id) {
+            if (random() % 3 == 0) unlocked.set(id);
+        }
+        int level = static_cast<int>(random() % 220);
+        int skillPoints = static_cast<int>(random() % 70);
+        int abilityPoints = static_cast<int>(random() % 70);
+
+        NodeSet expected;
+        for (int id = 0; id < 150; ++id) {
+            if (canUnlockDirect(tree, id, level, skillPoints, abilityPoints, unlocked)) expected.set(id);
+        }
+        ASSERT_EQ(index.eligible(level, skillPoints, abilityPoints, unlocked), expected) << "trial " << trial;
+    }
+}
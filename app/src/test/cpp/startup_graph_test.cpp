@@ -0,0 +1,101 @@
+#include "startup_graph.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+using namespace TrashPiles;
+
+namespace {
+
+// Spins until the flag is set or a second passes; false on timeout
+bool waitFor(const std::atomic<bool>& flag) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+    while (!flag.load()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        std::this_thread::yield();
+    }
+    return true;
+}
+
+} // namespace
+
+TEST(StartupGraph, IndependentStagesRunConcurrently) {
+    // Each stage only succeeds if the other is running at the same time
+    std::atomic<bool> aRunning{false};
+    std::atomic<bool> bRunning{false};
+
+    StartupGraph graph;
+    graph.addStage("a", [&]() { aRunning = true; return waitFor(bRunning); });
+    graph.addStage("b", [&]() { bRunning = true; return waitFor(aRunning); });
+
+    ASSERT_TRUE(graph.start(2));
+    EXPECT_TRUE(graph.join());
+}
+
+TEST(StartupGraph, DependentsWaitForTheirDependencies) {
+    std::atomic<int> order{0};
+    int streamsOrder = -1;
+    int soundOrder = -1;
+    int musicOrder = -1;
+
+    StartupGraph graph;
+    auto streams = graph.addStage("streams", [&]() { streamsOrder = order++; return true; });
+    graph.addStage("sound", [&]() { soundOrder = order++; return true; }, {streams});
+    graph.addStage("music", [&]() { musicOrder = order++; return true; }, {streams});
+
+    ASSERT_TRUE(graph.start(3));
+    EXPECT_TRUE(graph.ready(graph.find("music")).get());
+    EXPECT_TRUE(graph.join());
+
+    EXPECT_EQ(streamsOrder, 0);
+    EXPECT_GT(soundOrder, 0);
+    EXPECT_GT(musicOrder, 0);
+
+    auto timings = graph.timings();
+    ASSERT_EQ(timings.size(), 3u);
+    for (size_t i = 1; i < timings.size(); ++i) {
+        EXPECT_GE(timings[i].startNanos, timings[0].endNanos);
+        EXPECT_EQ(timings[i].state, StartupGraph::State::Succeeded);
+    }
+}
+
+TEST(StartupGraph, FailureSkipsEverythingDownstream) {
+    bool skippedRan = false;
+
+    StartupGraph graph;
+    auto streams = graph.addStage("streams", []() { return false; });
+    auto bank = graph.addStage("bank", [&]() { skippedRan = true; return true; }, {streams});
+    auto warmup = graph.addStage("warmup", [&]() { skippedRan = true; return true; }, {bank});
+    auto surface = graph.addStage("surface", []() { return true; });
+
+    ASSERT_TRUE(graph.start(2));
+    EXPECT_FALSE(graph.ready(warmup).get());
+    EXPECT_FALSE(graph.join());
+
+    EXPECT_FALSE(skippedRan);
+    EXPECT_EQ(graph.state(streams), StartupGraph::State::Failed);
+    EXPECT_EQ(graph.state(bank), StartupGraph::State::Skipped);
+    EXPECT_EQ(graph.state(warmup), StartupGraph::State::Skipped);
+    EXPECT_TRUE(graph.isReady(surface));
+
+    // Skipped stages never started
+    EXPECT_EQ(graph.timings()[bank].startNanos, -1);
+    EXPECT_GE(graph.timings()[bank].endNanos, 0);
+}
+
+TEST(StartupGraph, RejectsUnknownDependenciesAndLateStages) {
+    StartupGraph graph;
+    EXPECT_EQ(graph.addStage("orphan", nullptr, {3}), -1);
+
+    auto only = graph.addStage("only", nullptr);
+    EXPECT_EQ(graph.find("only"), only);
+    EXPECT_EQ(graph.find("missing"), -1);
+
+    ASSERT_TRUE(graph.start(4));
+    EXPECT_FALSE(graph.start(4));
+    EXPECT_EQ(graph.addStage("late", nullptr), -1);
+    EXPECT_TRUE(graph.join());
+}
@@ -0,0 +1,92 @@
+#include "state_block.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <cstring>
+#include <thread>
+
+using namespace TrashPiles;
+
+TEST(StateBlock, HeaderIsReadableFromRawMemory) {
+    StateBlock block;
+    uint32_t header[3];
+    std::memcpy(header, block.data(), sizeof(header));
+
+    EXPECT_EQ(header[0], kStateBlockMagic);
+    EXPECT_EQ(header[1], kStateBlockLayoutVersion);
+    EXPECT_EQ(header[2], 0u);
+    EXPECT_EQ(block.size(), sizeof(StateBlockData));
+}
+
+TEST(StateBlock, PublishBumpsOnlyChangedSections) {
+    StateBlock block;
+    GameStateFields state;
+    state.match.playerCount = 2;
+    state.piles.deckCount = 52;
+    ASSERT_TRUE(block.publish(state));
+
+    uint32_t matchVersion = block.sectionVersion(kSectionMatch);
+    uint32_t pilesVersion = block.sectionVersion(kSectionPiles);
+    EXPECT_EQ(block.sequence(), 2u);
+    EXPECT_EQ(matchVersion, 2u);
+    EXPECT_EQ(pilesVersion, 2u);
+    EXPECT_EQ(block.sectionVersion(kSectionPlayers), 0u);
+    EXPECT_EQ(block.sectionVersion(kSectionHands), 0u);
+
+    // Same snapshot again: nothing to do
+    EXPECT_FALSE(block.publish(state));
+    EXPECT_EQ(block.sequence(), 2u);
+
+    state.hands[1][3] = makeCardCode(12, 3, true);
+    ASSERT_TRUE(block.publish(state));
+    EXPECT_EQ(block.sectionVersion(kSectionMatch), matchVersion);
+    EXPECT_EQ(block.sectionVersion(kSectionPiles), pilesVersion);
+    EXPECT_EQ(block.sectionVersion(kSectionHands), 4u);
+
+    GameStateFields copy;
+    uint32_t versions[kSectionCount];
+    ASSERT_TRUE(block.read(copy, versions));
+    EXPECT_EQ(copy.piles.deckCount, 52);
+    EXPECT_EQ(copy.hands[1][3], 12 * 4 + 3 + kCardFaceUp);
+    EXPECT_EQ(copy.hands[0][0], kNoCard);
+    EXPECT_EQ(versions[kSectionHands], 4u);
+}
+
+TEST(StateBlock, ConcurrentReadsAreNeverTorn) {
+    StateBlock block;
+    std::atomic<bool> done{false};
+
+    // Every snapshot keeps all of these fields equal
+    GameStateFields initial;
+    initial.piles.deckCount = initial.match.currentRound;
+    for (auto& player : initial.players) player.score = initial.match.currentRound;
+    block.publish(initial);
+
+    std::thread writer([&]() {
+        GameStateFields state;
+        for (int32_t i = 2; i <= 20000; ++i) {
+            state.match.currentRound = i;
+            state.piles.deckCount = i;
+            for (auto& player : state.players) player.score = i;
+            block.publish(state);
+        }
+        done = true;
+    });
+
+    int reads = 0;
+    int torn = 0;
+    while (!done || reads == 0) {
+        GameStateFields copy;
+        if (!block.read(copy)) continue;
+        ++reads;
+        bool consistent = copy.piles.deckCount == copy.match.currentRound;
+        for (const auto& player : copy.players) {
+            consistent = consistent && player.score == copy.match.currentRound;
+        }
+        if (!consistent) ++torn;
+    }
+    writer.join();
+    EXPECT_GT(reads, 0);
+    EXPECT_EQ(torn, 0);
+}
@@ -0,0 +1,117 @@
+#ifndef TRASHPILES_TRACING
+#define TRASHPILES_TRACING 1
+#endif
+#include "trace.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <thread>
+
+using namespace TrashPiles;
+
+namespace {
+
+int countOf(const std::string& text, const std::string& needle) {
+    int count = 0;
+    for (size_t at = text.find(needle); at != std::string::npos; at = text.find(needle, at + 1)) ++count;
+    return count;
+}
+
+// Thread id of the first event matching needle, empty if there is none
+std::string tidOf(const std::string& json, const std::string& needle) {
+    size_t at = json.find(needle);
+    if (at == std::string::npos) return "";
+    at = json.find("\"tid\":", at);
+    if (at == std::string::npos) return "";
+    at += 6;
+    return json.substr(at, json.find_first_not_of("0123456789", at) - at);
+}
+
+// Tracer state is process-wide: every test starts from an empty, enabled trace
+class TraceTest : public ::testing::Test {
+protected:
+    void SetUp() override {
+        Tracer::clear();
+        Tracer::setEnabled(true);
+    }
+
+    void TearDown() override {
+        Tracer::setEnabled(false);
+    }
+};
+
+} // namespace
+
+TEST_F(TraceTest, ScopesCountersAndInstantsExportAsChromeJson) {
+    TRACE_THREAD_NAME("test.main");
+    {
+        TRACE_SCOPE("frame");
+        TRACE_COUNTER("voices", 3);
+        TRACE_INSTANT("input.touchDown");
+    }
+
+    std::string json = Tracer::exportChromeJson();
+    EXPECT_EQ(json.rfind("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", 0), 0u);
+    EXPECT_EQ(countOf(json, "\"name\":\"frame\",\"cat\":\"native\",\"ph\":\"B\""), 1);
+    EXPECT_EQ(countOf(json, "\"name\":\"frame\",\"cat\":\"native\",\"ph\":\"E\""), 1);
+    EXPECT_EQ(countOf(json, "\"ph\":\"C\""), 1);
+    EXPECT_NE(json.find("\"args\":{\"value\":3}"), std::string::npos);
+    EXPECT_NE(json.find("\"ph\":\"i\""), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"test.main\"}"), std::string::npos);
+    EXPECT_EQ(json.substr(json.size() - 4), "\n]}\n");
+}
+
+TEST_F(TraceTest, NothingIsRecordedWhileDisabled) {
+    Tracer::setEnabled(false);
+    uint64_t before = Tracer::recordedEvents();
+    {
+        TRACE_SCOPE("ignored");
+        TRACE_INSTANT("ignored");
+    }
+    EXPECT_EQ(Tracer::recordedEvents(), before);
+    EXPECT_EQ(Tracer::exportChromeJson().find("ignored"), std::string::npos);
+}
+
+TEST_F(TraceTest, ScopeEndsEvenIfDisabledInside) {
+    {
+        TRACE_SCOPE("loading");
+        Tracer::setEnabled(false);
+    }
+    std::string json = Tracer::exportChromeJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"loading\""), 2);
+}
+
+TEST_F(TraceTest, EachThreadGetsItsOwnTrack) {
+    std::thread audio([]() {
+        TRACE_THREAD_NAME("test.audio");
+        TRACE_SCOPE("audio.callback");
+    });
+    audio.join();
+    {
+        TRACE_SCOPE("game.update");
+    }
+
+    std::string json = Tracer::exportChromeJson();
+    std::string audioTid = tidOf(json, "\"name\":\"audio.callback\"");
+    ASSERT_FALSE(audioTid.empty());
+    EXPECT_NE(tidOf(json, "\"name\":\"game.update\""), audioTid);
+    EXPECT_NE(json.find("\"tid\":" + audioTid + ",\"args\":{\"name\":\"test.audio\"}"), std::string::npos);
+}
+
+TEST_F(TraceTest, RingKeepsTheLatestEventsAndClearDropsThem) {
+    const char* name = Tracer::intern("ring.overflow");
+    ASSERT_NE(name, nullptr);
+    EXPECT_EQ(Tracer::intern("ring.overflow"), name);
+
+    for (uint32_t i = 0; i < Tracer::kRingCapacity + 100; ++i) {
+        TRACE_COUNTER(name, i);
+    }
+    std::string json = Tracer::exportChromeJson();
+    EXPECT_EQ(countOf(json, "\"name\":\"ring.overflow\""), static_cast<int>(Tracer::kRingCapacity));
+    EXPECT_EQ(json.find("\"args\":{\"value\":99}"), std::string::npos);
+    EXPECT_NE(json.find("\"args\":{\"value\":100}"), std::string::npos);
+
+    Tracer::clear();
+    EXPECT_EQ(Tracer::exportChromeJson().find("ring.overflow"), std::string::npos);
+}
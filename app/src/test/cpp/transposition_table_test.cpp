@@ -0,0 +1,249 @@
+#include "game_core.h"
+#include "hint_advisor.h"
+#include "transposition_table.h"
+#include "game_test_util.h"
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+using namespace TrashPiles;
+using namespace TrashPiles::TestUtil;
+
+namespace {
+
+TranspositionEntry makeEntry(float value, uint16_t move, uint8_t depth) {
+    TranspositionEntry entry;
+    entry.value = value;
+    entry.move = move;
+    entry.depth = depth;
+    return entry;
+}
+
+} // namespace
+
+TEST(PositionHash, IncrementalHashMatchesARecompute) {
+    StateBlock block;
+    GameCore core(block, nullptr, 49);
+    std::mt19937 random(94);
+    startGame(core, 3);
+    ASSERT_EQ(core.positionHash(), core.computePositionHash());
+
+    for (int turn = 0; turn < 400 && core.phase() == GamePhase::Playing; ++turn) {
+        int player = core.currentPlayer();
+        if (random() % 8 == 0) {
+            core.apply(makeCommand(GameCommandType::FlipCard, player, random() % core.handCount(player)));
+            ASSERT_EQ(core.positionHash(), core.computePositionHash()) << "turn " << turn;
+        }
+        bool fromDiscard = core.discardCount() > 0 && random() % 3 == 0;
+        core.apply(makeCommand(GameCommandType::DrawCard, player, -1, fromDiscard ? 1 : 0));
+        ASSERT_EQ(core.positionHash(), core.computePositionHash()) << "turn " << turn;
+
+        uint32_t slots = core.placeableSlots(player, core.heldCard());
+        if (slots && random() % 4 == 0) {
+            core.apply(makeCommand(GameCommandType::PlaceCard, player, __builtin_ctz(slots)));
+            ASSERT_EQ(core.positionHash(), core.computePositionHash()) << "turn " << turn;
+        }
+        if (core.phase() == GamePhase::Playing) core.apply(makeCommand(GameCommandType::EndTurn, player));
+        ASSERT_EQ(core.positionHash(), core.computePositionHash()) << "turn " << turn;
+    }
+}
+
+TEST(PositionHash, SamePositionByAnotherRouteHashesEqual) {
+    StateBlock blockA;
+    StateBlock blockB;
+    GameCore a(blockA, nullptr, 7);
+    GameCore b(blockB, nullptr, 7);
+    for (GameCore* core : {&a, &b}) {
+        startGame(*core, 2);
+    }
+    uint64_t dealt = a.positionHash();
+    ASSERT_EQ(dealt, b.positionHash());
+
+    a.apply(makeCommand(GameCommandType::FlipCard, 1, 2));
+    a.apply(makeCommand(GameCommandType::FlipCard, 1, 5));
+    b.apply(makeCommand(GameCommandType::FlipCard, 1, 5));
+    EXPECT_NE(b.positionHash(), a.positionHash());
+    b.apply(makeCommand(GameCommandType::FlipCard, 1, 2));
+    EXPECT_EQ(b.positionHash(), a.positionHash());
+    EXPECT_NE(a.positionHash(), dealt);
+
+    // A full round of turns comes back to the same player to move
+    uint64_t before = a.positionHash();
+    a.apply(makeCommand(GameCommandType::SkipTurn, 0));
+    EXPECT_NE(a.positionHash(), before);
+    a.apply(makeCommand(GameCommandType::SkipTurn, 1));
+    EXPECT_EQ(a.positionHash(), before);
+}
+
+TEST(TranspositionTable, KeepsTheDeepestAndNewestEntries) {
+    // One bucket, so every key competes for the same four entries
+    TranspositionTable table(0);
+    ASSERT_EQ(table.capacity(), 4u);
+    for (uint64_t key = 1; key <= 4; ++key) {
+        table.store(key, makeEntry(key * 0.5f, static_cast<uint16_t>(key), static_cast<uint8_t>(key)));
+    }
+    TranspositionEntry entry;
+    for (uint64_t key = 1; key <= 4; ++key) {
+        ASSERT_TRUE(table.probe(key, &entry));
+        EXPECT_FLOAT_EQ(entry.value, key * 0.5f);
+        EXPECT_EQ(entry.move, key);
+        EXPECT_EQ(entry.depth, key);
+    }
+
+    // A fifth position evicts the shallowest
+    table.store(5, makeEntry(2.5f, 5, 5));
+    EXPECT_FALSE(table.probe(1, &entry));
+    EXPECT_TRUE(table.probe(5, &entry));
+
+    // After a new search, the old entries go first however deep
+    table.newGeneration();
+    table.store(6, makeEntry(3.0f, 6, 0));
+    EXPECT_FALSE(table.probe(2, &entry));
+    EXPECT_TRUE(table.probe(5, &entry));
+
+    // The same position keeps the deeper result of one search
+    table.store(6, makeEntry(4.0f, 7, 3));
+    table.store(6, makeEntry(5.0f, 8, 1));
+    ASSERT_TRUE(table.probe(6, &entry));
+    EXPECT_EQ(entry.move, 7);
+    EXPECT_EQ(entry.depth, 3);
+
+    TranspositionTable::Stats stats = table.stats();
+    EXPECT_EQ(stats.probes, 9u);
+    EXPECT_EQ(stats.hits, 7u);
+    EXPECT_EQ(stats.stores, 7u);
+    EXPECT_EQ(stats.replaced, 2u);
+    EXPECT_DOUBLE_EQ(stats.hitRate(), 7.0 / 9.0);
+
+    table.clear();
+    EXPECT_FALSE(table.probe(6, &entry));
+    EXPECT_EQ(table.stats().hits, 0u);
+}
+
+TEST(TranspositionTable, ConcurrentSearchersNeverSeeTornEntries) {
+    constexpr int kThreads = 4;
+    constexpr int kOperations = 50000;
+    // Small, so threads keep overwriting each other's buckets
+    TranspositionTable table(4);
+    std::atomic<int> torn{0};
+
+    std::vector<std::thread> searchers;
+    for (int t = 0; t < kThreads; ++t) {
+        searchers.emplace_back([&table, &torn, t] {
+            std::mt19937_64 random(t + 1);
+            for (int i = 0; i < kOperations; ++i) {
+                // Every field derives from the key, so a mixed entry shows
+                uint64_t key = random() % 512 * 0x9E3779B97F4A7C15ull;
+                TranspositionEntry entry;
+                if (table.probe(key, &entry)) {
+                    if (entry.move != static_cast<uint16_t>(key >> 48) ||
+                        entry.depth != static_cast<uint8_t>(key >> 40) ||
+                        entry.value != static_cast<float>(key >> 52)) {
+                        torn.fetch_add(1);
+                    }
+                } else {
+                    table.store(key, makeEntry(static_cast<float>(key >> 52), static_cast<uint16_t>(key >> 48),
+                                               static_cast<uint8_t>(key >> 40)));
+                }
+            }
+        });
+    }
+    for (std::thread& searcher : searchers) searcher.join();
+
+    EXPECT_EQ(torn.load(), 0);
+    TranspositionTable::Stats stats = table.stats();
+    EXPECT_EQ(stats.probes, static_cast<uint64_t>(kThreads * kOperations));
+    EXPECT_GT(stats.hits, 0u);
+    EXPECT_EQ(stats.hits + stats.stores, stats.probes);
+}
+
+TEST(HintAdvisor, RepeatedRequestsComeFromTheTable) {
+    StateBlock block;
+    GameCore core(block, nullptr, 11);
+    startGame(core, 2);
+    core.apply(makeCommand(GameCommandType::DrawCard, 0, -1, 0));
+    core.apply(makeCommand(GameCommandType::EndTurn, 0));
+
+    TranspositionTable table;
+    HintAdvisor advisor(table);
+    HintMove expected = HintAdvisor::evaluate(core, 1);
+    for (int request = 0; request < 3; ++request) {
+        HintMove move = advisor.hint(core, 1);
+        EXPECT_EQ(move.fromDiscard, expected.fromDiscard);
+        EXPECT_EQ(move.slot, expected.slot);
+        EXPECT_FLOAT_EQ(move.confidence, expected.confidence);
+    }
+    EXPECT_EQ(table.stats().hits, 2u);
+    EXPECT_EQ(table.stats().stores, 1u);
+
+    // The discard top decides: it either fits a face-down slot or the deck is drawn
+    int top = core.discardTop();
+    uint32_t slots = core.placeableSlots(1, top);
+    EXPECT_EQ(expected.fromDiscard, slots != 0);
+    if (slots) EXPECT_TRUE(slots & (1u << expected.slot));
+    else EXPECT_FLOAT_EQ(expected.confidence, core.tracker().fitOdds(1, HandKernels::emptySlots(core.handBits(1))));
+
+    // The other player asks about the same position under another key
+    advisor.hint(core, 0);
+    EXPECT_EQ(table.stats().stores, 2u);
+}
+
+TEST(HintAdvisor, DiscardHistoryIsPartOfTheKey) {
+    StateBlock block;
+    GameCore core(block, nullptr, 13);
+    startGame(core, 2);
+    core.apply(makeCommand(GameCommandType::DrawCard, 0, -1, 0));
+    core.apply(makeCommand(GameCommandType::EndTurn, 0));
+
+    // The same position, reached after one more card went through the discard pile
+    uint64_t seen = core.tracker().seen(1);
+    uint64_t unseen = ~seen & CardTracker::kAllCards;
+    uint64_t otherHistory = seen | (unseen & (0 - unseen));
+    EXPECT_NE(HintAdvisor::key(core.positionHash(), otherHistory, 1), HintAdvisor::key(core, 1));
+
+    // What the other history cached is not this position's hint
+    TranspositionTable table;
+    HintAdvisor advisor(table);
+    table.store(HintAdvisor::key(core.positionHash(), otherHistory, 1), makeEntry(-1.0f, 0x107, 1));
+    HintMove expected = HintAdvisor::evaluate(core, 1);
+    HintMove move = advisor.hint(core, 1);
+    EXPECT_EQ(table.stats().hits, 0u);
+    EXPECT_EQ(move.fromDiscard, expected.fromDiscard);
+    EXPECT_EQ(move.slot, expected.slot);
+    EXPECT_FLOAT_EQ(move.confidence, expected.confidence);
+}
+
+TEST(HintAdvisor, EachDealStartsATableGeneration) {
+    StateBlock block;
+    GameCore core(block, nullptr, 17);
+    TranspositionTable table;
+    HintAdvisor advisor(table);
+    startGame(core, 2);
+
+    uint32_t generation = table.generation();
+    advisor.hint(core, 0);
+    uint32_t dealt = table.generation();
+    EXPECT_NE(dealt, generation);
+    advisor.hint(core, 1);
+    EXPECT_EQ(table.generation(), dealt);
+
+    // Play the round out, placing whatever fits; the next round deals again
+    for (int turn = 0; turn < 2000 && core.phase() == GamePhase::Playing; ++turn) {
+        int player = core.currentPlayer();
+        core.apply(makeCommand(GameCommandType::DrawCard, player));
+        uint32_t slots = core.placeableSlots(player, core.heldCard());
+        if (slots) core.apply(makeCommand(GameCommandType::PlaceCard, player, __builtin_ctz(slots)));
+        if (core.phase() == GamePhase::Playing) core.apply(makeCommand(GameCommandType::EndTurn, player));
+        advisor.hint(core, player);
+    }
+    ASSERT_EQ(core.phase(), GamePhase::RoundEnd);
+    EXPECT_EQ(table.generation(), dealt);
+
+    ASSERT_EQ(core.apply(makeCommand(GameCommandType::StartGame)), CommandResult::Ok);
+    advisor.hint(core, 0);
+    EXPECT_NE(table.generation(), dealt);
+}
@@ -0,0 +1,193 @@
+#include "trophy_rules.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+using namespace TrashPiles;
+
+namespace {
+
+using TrophySet = TrophyRules::TrophySet;
+using RequirementSet = TrophyRules::RequirementSet;
+
+constexpr int kFields = TrophyRules::kFieldCount;
+
+struct CatalogBuilder {
+    std::vector<int32_t> thresholds;
+    std::vector<std::vector<int32_t>> requirements;
+
+    int add(std::initializer_list<std::pair<ProgressField, int32_t>> minimums, std::vector<int32_t> keys = {}) {
+        size_t base = thresholds.size();
+        thresholds.resize(base + kFields, TrophyRules::kNoThreshold);
+        for (const auto& minimum : minimums) {
+            thresholds[base + static_cast<int>(minimum.first)] = minimum.second;
+        }
+        requirements.push_back(std::move(keys));
+        return static_cast<int>(requirements.size()) - 1;
+    }
+
+    TrophyRules::BuildResult build(TrophyRules& rules) const {
+        std::vector<int32_t> offsets(1, 0);
+        std::vector<int32_t> keys;
+        for (const auto& list : requirements) {
+            keys.insert(keys.end(), list.begin(), list.end());
+            offsets.push_back(static_cast<int32_t>(keys.size()));
+        }
+        return rules.build(static_cast<int>(requirements.size()), thresholds.data(), offsets.data(), keys.data());
+    }
+};
+
+struct Progress {
+    int32_t fields[kFields] = {};
+    RequirementSet unlocked;
+
+    Progress& with(ProgressField field, int32_t value) {
+        fields[static_cast<int>(field)] = value;
+        return *this;
+    }
+};
+
+TrophySet setOf(std::initializer_list<int> ids) {
+    TrophySet set;
+    for (int id : ids) set.set(id);
+    return set;
+}
+
+} // namespace
+
+TEST(TrophyRules, ThresholdsAndRequiredUnlocks) {
+    CatalogBuilder catalog;
+    int firstSteps = catalog.add({{ProgressField::Level, 2}});
+    int collector = catalog.add({{ProgressField::SkillPoints, 50}, {ProgressField::AbilityPoints, 50}});
+    int combo = catalog.add({{ProgressField::Level, 10}}, {3, 7, 3});
+    int unconditional = catalog.add({});
+
+    TrophyRules rules;
+    ASSERT_EQ(catalog.build(rules), TrophyRules::BuildResult::Ok);
+    EXPECT_EQ(rules.predicateCount(collector), 2);
+    EXPECT_EQ(rules.predicateCount(combo), 3);
+    EXPECT_EQ(rules.predicateCount(unconditional), 0);
+
+    TrophyTracker tracker(rules);
+    Progress progress;
+    progress.with(ProgressField::Level, 1);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({unconditional}));
+
+    progress.with(ProgressField::Level, 12);
+    progress.unlocked.set(3);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({firstSteps}));
+    EXPECT_EQ(tracker.unmetCount(combo), 1);
+
+    progress.unlocked.set(7);
+    progress.with(ProgressField::SkillPoints, 50).with(ProgressField::AbilityPoints, 49);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({combo}));
+    EXPECT_EQ(tracker.satisfied(), setOf({firstSteps, combo, unconditional}));
+}
+
+TEST(TrophyRules, UpdatesTouchOnlyWhatChanged) {
+    CatalogBuilder catalog;
+    for (int level = 1; level <= 200; ++level) {
+        catalog.add({{ProgressField::Level, level}});
+    }
+    int needsKey = catalog.add({}, {42});
+
+    TrophyRules rules;
+    ASSERT_EQ(catalog.build(rules), TrophyRules::BuildResult::Ok);
+
+    TrophyTracker tracker(rules);
+    Progress progress;
+    progress.with(ProgressField::Level, 5);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked).count(), 5);
+
+    // One level-up crosses one threshold
+    progress.with(ProgressField::Level, 6);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({5}));
+    EXPECT_EQ(tracker.lastAdjusted(), 1);
+
+    EXPECT_TRUE(tracker.update(progress.fields, progress.unlocked).none());
+    EXPECT_EQ(tracker.lastAdjusted(), 0);
+
+    progress.unlocked.set(42);
+    progress.unlocked.set(43);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({needsKey}));
+    EXPECT_EQ(tracker.lastAdjusted(), 1);
+}
+
+TEST(TrophyRules, LosingProgressRevokesEligibility) {
+    CatalogBuilder catalog;
+    int points = catalog.add({{ProgressField::TotalPoints, 100}});
+    int skill = catalog.add({}, {0});
+
+    TrophyRules rules;
+    ASSERT_EQ(catalog.build(rules), TrophyRules::BuildResult::Ok);
+
+    TrophyTracker tracker(rules);
+    Progress progress;
+    progress.with(ProgressField::TotalPoints, 100);
+    progress.unlocked.set(0);
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({points, skill}));
+
+    Progress spent;
+    spent.with(ProgressField::TotalPoints, 60);
+    EXPECT_TRUE(tracker.update(spent.fields, spent.unlocked).none());
+    EXPECT_TRUE(tracker.satisfied().none());
+
+    // Satisfied again counts as new
+    EXPECT_EQ(tracker.update(progress.fields, progress.unlocked), setOf({points, skill}));
+}
+
+TEST(TrophyRules, RejectsBadKeys) {
+    CatalogBuilder catalog;
+    catalog.add({}, {TrophyRules::kMaxRequirements});
+
+    TrophyRules rules;
+    EXPECT_EQ(catalog.build(rules), TrophyRules::BuildResult::BadRequirement);
+    EXPECT_EQ(rules.trophyCount(), 0);
+}
+
+TEST(TrophyRules, MatchesFullReevaluationOnARandomWalk) {
+    std::mt19937 random(29);
+    CatalogBuilder catalog;
+    for (int id = 0; id < 120; ++id) {
+        int first = static_cast<int>(random() % kFields);
+        int second = static_cast<int>(random() % kFields);
+        std::vector<int32_t> keys;
+        for (int k = 0, n = static_cast<int>(random() % 3); k < n; ++k) {
+            keys.push_back(static_cast<int32_t>(random() % 40));
+        }
+        catalog.add({{static_cast<ProgressField>(first), static_cast<int32_t>(random() % 100)},
+                     {static_cast<ProgressField>(second), static_cast<int32_t>(random() % 100)}},
+                    keys);
+    }
+
+    TrophyRules rules;
+    ASSERT_EQ(catalog.build(rules), TrophyRules::BuildResult::Ok);
+
+    TrophyTracker tracker(rules);
+    Progress progress;
+    TrophySet previous;
+    for (int step = 0; step < 300; ++step) {
+        // Mostly small moves up, sometimes down
+        int field = static_cast<int>(random() % kFields);
+        progress.fields[field] = std::max(0, progress.fields[field] + static_cast<int32_t>(random() % 15) - 4);
+        if (random() % 4 == 0) {
+            int key = static_cast<int>(random() % 40);
+            if (progress.unlocked.test(key)) progress.unlocked.reset(key);
+            else progress.unlocked.set(key);
+        }
+
+        TrophySet newly = tracker.update(progress.fields, progress.unlocked);
+
+        TrophySet expected;
+        for (int id = 0; id < rules.trophyCount(); ++id) {
+            if (rules.meets(id, progress.fields, progress.unlocked)) expected.set(id);
+        }
+        ASSERT_EQ(tracker.satisfied(), expected) << "step " << step;
+        TrophySet expectedNew = expected;
+        ASSERT_EQ(newly, expectedNew.subtract(previous)) << "step " << step;
+        previous = expected;
+    }
+}
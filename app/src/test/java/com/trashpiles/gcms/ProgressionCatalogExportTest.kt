@@ -0,0 +1,51 @@
+package com.trashpiles.gcms
+
+import org.junit.Test
+import org.junit.Assert.*
+import java.io.File
+
+/**
+ * Tests for the progression catalog export
+ *
+ * Verifies every record has the field count tools/progression_packer
+ * expects, and writes the catalog when TRASHPILES_PROGRESSION_CATALOG is set.
+ */
+class ProgressionCatalogExportTest {
+
+    // Fields per record kind, including the kind (ProgressionBlobWriter)
+    private val fieldCounts = mapOf("node" to 15, "trophy" to 18, "set" to 3, "challenge" to 19)
+
+    @Test
+    fun `test every record has the packer's field count`() {
+        val text = StringBuilder().also { ProgressionCatalogExport.write(it, 1..10) }.toString()
+        val records = text.lines().filter { it.isNotEmpty() && !it.startsWith("#") }.map { it.split('\t') }
+
+        records.forEach { fields ->
+            assertEquals("fields in ${fields[0]} ${fields[1]}", fieldCounts[fields[0]], fields.size)
+        }
+        assertEquals(SkillAbilityDatabase.allSkillsAndAbilities.size, records.count { it[0] == "node" })
+        assertEquals(TrophySystem.getAllTrophyDefinitions().size, records.count { it[0] == "trophy" })
+        assertEquals(10, records.count { it[0] == "set" })
+    }
+
+    @Test
+    fun `test nodes are written sorted with prerequisites`() {
+        val text = StringBuilder().also { ProgressionCatalogExport.write(it, 1..1) }.toString()
+        val nodes = text.lines().filter { it.startsWith("node\t") }.map { it.split('\t') }
+
+        assertEquals(nodes.map { it[1] }.sorted(), nodes.map { it[1] })
+        nodes.forEach { fields ->
+            val node = SkillAbilityDatabase.getNodeById(fields[1])
+            assertNotNull(node)
+            val prerequisites = if (fields[14] == "-") emptyList() else fields[14].split(',')
+            assertEquals(node!!.prerequisites, prerequisites)
+        }
+    }
+
+    @Test
+    fun `test export writes the catalog when asked`() {
+        val path = System.getenv(ProgressionCatalogExport.CATALOG_ENV) ?: return
+        ProgressionCatalogExport.exportTo(File(path))
+        assertTrue(File(path).length() > 0)
+    }
+}